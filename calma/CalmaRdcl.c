@@ -226,6 +226,7 @@ calmaExact()
     Plane **parray;
     int gdsCopyPaintFunc();	/* Forward reference */
 
+    CIFReadFlushRects();
     parray = (Plane **)mallocMagic(MAXCIFRLAYERS * sizeof(Plane *));
 
     for (pNum = 0; pNum < MAXCIFRLAYERS; pNum++)
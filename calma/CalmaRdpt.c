@@ -277,8 +277,7 @@ calmaElementBoundary()
     /* Paint the rectangles (if any) */
     for (; rp != NULL ; rp = rp->r_next)
     {
-	if (plane)
-	    DBPaintPlane(plane, &rp->r_r, CIFPaintTable, (PaintUndoInfo *)NULL);
+	CIFReadPaintRect(plane, &rp->r_r);
 	freeMagic((char *) rp);
     }
 
@@ -398,7 +397,7 @@ calmaElementBox()
     }
 
     /* Paint the rectangle */
-    DBPaintPlane(plane, &r, CIFPaintTable, (PaintUndoInfo *)NULL);
+    CIFReadPaintRect(plane, &r);
 }
 
 /*
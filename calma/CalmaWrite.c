@@ -97,8 +97,8 @@ typedef struct {
 #define GDS_PROCESSED	1
 
 #define PUSHTILE(tp) \
-    if ((tp)->ti_client == (ClientData) GDS_UNPROCESSED) { \
-	(tp)->ti_client = (ClientData) GDS_PENDING; \
+    if (TiGetClient((tp)) == (ClientData) GDS_UNPROCESSED) { \
+	TiSetClient((tp), (ClientData) GDS_PENDING); \
 	STACKPUSH((ClientData) (tp), SegStack); \
     }
 
@@ -1691,7 +1691,7 @@ calmaMergePaintFunc(tile, cos)
     BoundaryTop *bounds = NULL;
 
     /* Quick check for tiles that have already been processed */
-    if (tile->ti_client == (ClientData)GDS_PROCESSED) return 0;
+    if (TiGetClient(tile) == (ClientData)GDS_PROCESSED) return 0;
 
     if (SegStack == (Stack *)NULL)
 	SegStack = StackNew(64);
@@ -1700,8 +1700,8 @@ calmaMergePaintFunc(tile, cos)
     while (!StackEmpty(SegStack))
     {
 	t = (Tile *) STACKPOP(SegStack);
-	if (t->ti_client != (ClientData)GDS_PENDING) continue;
-	t->ti_client = (ClientData)GDS_PROCESSED;
+	if (TiGetClient(t) != (ClientData)GDS_PENDING) continue;
+	TiSetClient(t, (ClientData)GDS_PROCESSED);
 
 	split_type = -1;
 	if (IsSplit(t))
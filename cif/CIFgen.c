@@ -867,8 +867,8 @@ endbloat:
 #define CIF_IGNORE   	2
 
 #define PUSHTILE(tp, stack) \
-    if ((tp)->ti_client == (ClientData) CIF_UNPROCESSED) { \
-	(tp)->ti_client = (ClientData) CIF_PENDING; \
+    if (TiGetClient((tp)) == (ClientData) CIF_UNPROCESSED) { \
+	TiSetClient((tp), (ClientData) CIF_PENDING); \
 	STACKPUSH((ClientData) (tp), stack); \
     }
 
@@ -904,8 +904,8 @@ cifBloatAllFunc(tile, op)
     while (!StackEmpty(BloatStack))
     {
 	t = (Tile *) STACKPOP(BloatStack);
-	if (t->ti_client != (ClientData)CIF_PENDING) continue;
-        t->ti_client = (ClientData)CIF_PROCESSED;
+	if (TiGetClient(t) != (ClientData)CIF_PENDING) continue;
+        TiSetClient(t, (ClientData)CIF_PROCESSED);
 	
 	/* Get the tile into CIF coordinates. */
 
@@ -941,7 +941,7 @@ cifBloatAllFunc(tile, op)
 
     /* Clear the tiles that were processed */
 
-    tile->ti_client = (ClientData)CIF_UNPROCESSED;
+    TiSetClient(tile, (ClientData)CIF_UNPROCESSED);
     STACKPUSH(tile, BloatStack);
     while (!StackEmpty(BloatStack))
     {
@@ -949,33 +949,33 @@ cifBloatAllFunc(tile, op)
 
 	/* Top */
 	for (tp = RT(t); RIGHT(tp) > LEFT(t); tp = BL(tp))
-	    if (tp->ti_client != (ClientData)CIF_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)CIF_UNPROCESSED)
 	    {
-		tp->ti_client = (ClientData)CIF_UNPROCESSED;
+		TiSetClient(tp, (ClientData)CIF_UNPROCESSED);
 		STACKPUSH(tp, BloatStack);
 	    }
 
 	/* Left */
 	for (tp = BL(t); BOTTOM(tp) < TOP(t); tp = RT(tp))
-	    if (tp->ti_client != (ClientData)CIF_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)CIF_UNPROCESSED)
 	    {
-		tp->ti_client = (ClientData)CIF_UNPROCESSED;
+		TiSetClient(tp, (ClientData)CIF_UNPROCESSED);
 		STACKPUSH(tp, BloatStack);
 	    }
 
 	/* Bottom */
 	for (tp = LB(t); LEFT(tp) < RIGHT(t); tp = TR(tp))
-	    if (tp->ti_client != (ClientData)CIF_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)CIF_UNPROCESSED)
 	    {
-		tp->ti_client = (ClientData)CIF_UNPROCESSED;
+		TiSetClient(tp, (ClientData)CIF_UNPROCESSED);
 		STACKPUSH(tp, BloatStack);
 	    }
 
 	/* Right */
 	for (tp = TR(t); TOP(tp) > BOTTOM(t); tp = LB(tp))
-	    if (tp->ti_client != (ClientData)CIF_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)CIF_UNPROCESSED)
 	    {
-		tp->ti_client = (ClientData)CIF_UNPROCESSED;
+		TiSetClient(tp, (ClientData)CIF_UNPROCESSED);
 		STACKPUSH(tp, BloatStack);
 	    }
     }
@@ -1024,7 +1024,7 @@ cifSquaresInitFunc(tile, clientData)
     Tile *tile;
     ClientData clientData;
 {
-    if (tile->ti_client == (ClientData) CIF_UNPROCESSED)
+    if (TiGetClient(tile) == (ClientData) CIF_UNPROCESSED)
 	return 1;
     else
 	return 0;
@@ -1176,7 +1176,7 @@ cifSquaresResetFunc(tile, clientData)
     Tile *tile;
     ClientData clientData;	/* unused */
 {
-    tile->ti_client = (ClientData) CIF_UNPROCESSED;
+    TiSetClient(tile, (ClientData) CIF_UNPROCESSED);
     return 0;
 }
 
@@ -1201,7 +1201,7 @@ cifUnconnectFunc(tile, clientData)
     TileType t = TiGetTypeExact(tile);
     if (t == TT_SPACE) return 1;
     else if (t & TT_DIAGONAL) return 1;
-    else if (tile->ti_client != (ClientData)CIF_PROCESSED) return 1;
+    else if (TiGetClient(tile) != (ClientData)CIF_PROCESSED) return 1;
     return 0;
 }
 
@@ -1254,8 +1254,8 @@ cifRectBoundingBox(op, cellDef, plane)
 	while (!StackEmpty(BoxStack))
 	{
 	    t = (Tile *) STACKPOP(BoxStack);
-	    if (t->ti_client != (ClientData)CIF_PENDING) continue;
-            t->ti_client = (ClientData)CIF_PROCESSED;
+	    if (TiGetClient(t) != (ClientData)CIF_PENDING) continue;
+            TiSetClient(t, (ClientData)CIF_PROCESSED);
 	
 	    /* Adjust bounding box */
 	    TiToRect(t, &area);
@@ -1318,7 +1318,7 @@ cifRectBoundingBox(op, cellDef, plane)
 
 	/* Clear the tiles that were processed in this set */
 
-	tile->ti_client = (ClientData)CIF_IGNORE;
+	TiSetClient(tile, (ClientData)CIF_IGNORE);
 	STACKPUSH(tile, BoxStack);
 	while (!StackEmpty(BoxStack))
 	{
@@ -1326,33 +1326,33 @@ cifRectBoundingBox(op, cellDef, plane)
 
 	    /* Top */
 	    for (tp = RT(t); RIGHT(tp) > LEFT(t); tp = BL(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, BoxStack);
 		}
 
 	    /* Left */
 	    for (tp = BL(t); BOTTOM(tp) < TOP(t); tp = RT(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, BoxStack);
 		}
 
 	    /* Bottom */
 	    for (tp = LB(t); LEFT(tp) < RIGHT(t); tp = TR(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, BoxStack);
 		}
 
 	    /* Right */
 	    for (tp = TR(t); TOP(tp) > BOTTOM(t); tp = LB(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, BoxStack);
 		}
 	}
@@ -1527,8 +1527,8 @@ cifSquaresFillArea(op, cellDef, plane)
 	while (!StackEmpty(CutStack))
 	{
 	    t = (Tile *) STACKPOP(CutStack);
-	    if (t->ti_client != (ClientData)CIF_PENDING) continue;
-            t->ti_client = (ClientData)CIF_PROCESSED;
+	    if (TiGetClient(t) != (ClientData)CIF_PENDING) continue;
+            TiSetClient(t, (ClientData)CIF_PROCESSED);
 	
 	    /* Adjust bounding box */
 	    TiToRect(t, &area);
@@ -1653,7 +1653,7 @@ cifSquaresFillArea(op, cellDef, plane)
 
 	/* Clear the tiles that were processed */
 
-	tile->ti_client = (ClientData)CIF_IGNORE;
+	TiSetClient(tile, (ClientData)CIF_IGNORE);
 	STACKPUSH(tile, CutStack);
 	while (!StackEmpty(CutStack))
 	{
@@ -1661,33 +1661,33 @@ cifSquaresFillArea(op, cellDef, plane)
 
 	    /* Top */
 	    for (tp = RT(t); RIGHT(tp) > LEFT(t); tp = BL(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, CutStack);
 		}
 
 	    /* Left */
 	    for (tp = BL(t); BOTTOM(tp) < TOP(t); tp = RT(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, CutStack);
 		}
 
 	    /* Bottom */
 	    for (tp = LB(t); LEFT(tp) < RIGHT(t); tp = TR(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, CutStack);
 		}
 
 	    /* Right */
 	    for (tp = TR(t); TOP(tp) > BOTTOM(t); tp = LB(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, CutStack);
 		}
 	}
@@ -1869,8 +1869,8 @@ cifSlotsFillArea(op, cellDef, plane)
 	while (!StackEmpty(CutStack))
 	{
 	    t = (Tile *) STACKPOP(CutStack);
-	    if (t->ti_client != (ClientData)CIF_PENDING) continue;
-            t->ti_client = (ClientData)CIF_PROCESSED;
+	    if (TiGetClient(t) != (ClientData)CIF_PENDING) continue;
+            TiSetClient(t, (ClientData)CIF_PROCESSED);
 	
 	    /* Adjust bounding box */
 	    TiToRect(t, &area);
@@ -2013,7 +2013,7 @@ cifSlotsFillArea(op, cellDef, plane)
 
 	/* Clear the tiles that were processed */
 
-	tile->ti_client = (ClientData)CIF_IGNORE;
+	TiSetClient(tile, (ClientData)CIF_IGNORE);
 	STACKPUSH(tile, CutStack);
 	while (!StackEmpty(CutStack))
 	{
@@ -2021,33 +2021,33 @@ cifSlotsFillArea(op, cellDef, plane)
 
 	    /* Top */
 	    for (tp = RT(t); RIGHT(tp) > LEFT(t); tp = BL(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, CutStack);
 		}
 
 	    /* Left */
 	    for (tp = BL(t); BOTTOM(tp) < TOP(t); tp = RT(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, CutStack);
 		}
 
 	    /* Bottom */
 	    for (tp = LB(t); LEFT(tp) < RIGHT(t); tp = TR(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, CutStack);
 		}
 
 	    /* Right */
 	    for (tp = TR(t); TOP(tp) > BOTTOM(t); tp = LB(tp))
-		if (tp->ti_client == (ClientData)CIF_PROCESSED)
+		if (TiGetClient(tp) == (ClientData)CIF_PROCESSED)
 		{
-		    tp->ti_client = (ClientData)CIF_IGNORE;
+		    TiSetClient(tp, (ClientData)CIF_IGNORE);
 		    STACKPUSH(tp, CutStack);
 		}
 	}
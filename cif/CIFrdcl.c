@@ -307,6 +307,7 @@ CIFScalePlanes(scalen, scaled, planearray)
     int pNum;
     Plane *newplane;
 
+    CIFReadFlushRects();
     for (pNum = 0; pNum < MAXCIFRLAYERS; pNum++)
     {
 	if (planearray[pNum] != NULL)
@@ -562,6 +563,7 @@ CIFPaintCurrent()
     Plane *plane, *swapplane;
     int i;
 
+    CIFReadFlushRects();
     for (i = 0; i < cifCurReadStyle->crs_nLayers; i++)
     {
 	TileType type;
@@ -1324,6 +1326,7 @@ CIFReadCellCleanup(type)
     MagWindow *window;
     int flags;
 
+    CIFReadFlushRects();
     if (cifSubcellBeingRead)
     {
 	if (type == 0)
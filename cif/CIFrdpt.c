@@ -36,6 +36,154 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "cif/CIFint.h"
 #include "cif/CIFread.h"
 
+/*
+ * Rectangles read from a CIF or GDS file are not painted one at a
+ * time as they are parsed.  Instead they are collected per plane and
+ * painted in bulk by DBPaintPlaneBatch(), which is much faster for the
+ * large numbers of small, overlapping boxes that layout generators
+ * tend to write.  This is safe because CIFPaintTable only ever forms
+ * the union of what is painted, so the order of painting does not
+ * matter.  Anything that looks at, copies, scales, or frees a read
+ * plane must call CIFReadFlushRects() first.
+ */
+
+typedef struct
+{
+    Plane *cpr_plane;		/* Plane the rectangles belong to */
+    Rect  *cpr_rects;		/* Rectangles waiting to be painted */
+    int    cpr_count;		/* Number of entries used in cpr_rects */
+    int    cpr_size;		/* Number of entries allocated */
+} cifPendingRects;
+
+/* Most rectangles that may wait for any one plane */
+#define	CIF_MAXPENDING	65536
+
+static cifPendingRects *cifPending = NULL;	/* One entry per plane */
+static int cifNPending = 0;			/* Entries used */
+static int cifPendingSize = 0;			/* Entries allocated */
+static int cifPendingLast = 0;			/* Most recently used entry */
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * CIFReadPaintRect --
+ *
+ * 	Paint a rectangle into one of the CIF read planes with
+ *	CIFPaintTable.  The paint is deferred until the next call to
+ *	CIFReadFlushRects(), or until enough rectangles have collected
+ *	for the plane.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The rectangle is recorded, and may be painted later.  Nothing
+ *	happens if the plane is NULL.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+CIFReadPaintRect(plane, rect)
+    Plane *plane;		/* CIF plane to paint */
+    Rect *rect;			/* Area to be painted */
+{
+    cifPendingRects *cpr;
+    int i;
+
+    if (plane == NULL) return;
+
+    /* Successive rectangles nearly always go to the same plane */
+    if (cifPendingLast < cifNPending
+	    && cifPending[cifPendingLast].cpr_plane == plane)
+	cpr = &cifPending[cifPendingLast];
+    else
+    {
+	for (i = 0; i < cifNPending; i++)
+	    if (cifPending[i].cpr_plane == plane)
+		break;
+	if (i == cifNPending)
+	{
+	    if (cifNPending == cifPendingSize)
+	    {
+		cifPendingRects *newlist;
+
+		cifPendingSize = (cifPendingSize == 0) ? 8 : cifPendingSize * 2;
+		newlist = (cifPendingRects *) mallocMagic(cifPendingSize
+			* sizeof (cifPendingRects));
+		for (i = 0; i < cifNPending; i++)
+		    newlist[i] = cifPending[i];
+		if (cifPending != NULL) freeMagic((char *) cifPending);
+		cifPending = newlist;
+	    }
+	    i = cifNPending++;
+	    cifPending[i].cpr_plane = plane;
+	    cifPending[i].cpr_rects = NULL;
+	    cifPending[i].cpr_count = 0;
+	    cifPending[i].cpr_size = 0;
+	}
+	cifPendingLast = i;
+	cpr = &cifPending[i];
+    }
+
+    if (cpr->cpr_count == cpr->cpr_size)
+    {
+	Rect *newrects;
+
+	if (cpr->cpr_size >= CIF_MAXPENDING)
+	{
+	    DBPaintPlaneBatch(plane, cpr->cpr_rects, cpr->cpr_count,
+			CIFPaintTable, (PaintUndoInfo *) NULL);
+	    cpr->cpr_count = 0;
+	}
+	else
+	{
+	    cpr->cpr_size = (cpr->cpr_size == 0) ? 64 : cpr->cpr_size * 2;
+	    newrects = (Rect *) mallocMagic(cpr->cpr_size * sizeof (Rect));
+	    for (i = 0; i < cpr->cpr_count; i++)
+		newrects[i] = cpr->cpr_rects[i];
+	    if (cpr->cpr_rects != NULL) freeMagic((char *) cpr->cpr_rects);
+	    cpr->cpr_rects = newrects;
+	}
+    }
+    cpr->cpr_rects[cpr->cpr_count++] = *rect;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * CIFReadFlushRects --
+ *
+ * 	Paint all rectangles deferred by CIFReadPaintRect().
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Modifies the CIF read planes.  Storage for the deferred
+ *	rectangles is released.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+CIFReadFlushRects()
+{
+    cifPendingRects *cpr;
+    int i;
+
+    for (i = 0; i < cifNPending; i++)
+    {
+	cpr = &cifPending[i];
+	if (cpr->cpr_count > 0)
+	    DBPaintPlaneBatch(cpr->cpr_plane, cpr->cpr_rects, cpr->cpr_count,
+			CIFPaintTable, (PaintUndoInfo *) NULL);
+	if (cpr->cpr_rects != NULL) freeMagic((char *) cpr->cpr_rects);
+    }
+    cifNPending = 0;
+    cifPendingLast = 0;
+}
+
 
 /*
  * ----------------------------------------------------------------------------
@@ -143,7 +291,7 @@ CIFParseBox()
     r2.r_xtop = (r2.r_xtop + center.p_x) / 2;
     r2.r_ytop = (r2.r_ytop + center.p_y) / 2;
 
-    DBPaintPlane(cifReadPlane, &r2, CIFPaintTable, (PaintUndoInfo *) NULL);
+    CIFReadPaintRect(cifReadPlane, &r2);
     return TRUE;
 }
 
@@ -213,8 +361,7 @@ CIFParseFlash()
     rectangle.r_ybot = (center.p_y - diameter) / 2;
     rectangle.r_xtop = (center.p_x + diameter) / 2;
     rectangle.r_ytop = (center.p_y + diameter) / 2;
-    DBPaintPlane(cifReadPlane, &rectangle, CIFPaintTable,
-	    (PaintUndoInfo *) NULL);
+    CIFReadPaintRect(cifReadPlane, &rectangle);
     return TRUE;
 }
 
@@ -757,8 +904,7 @@ CIFParsePoly()
     }
     for (; rectp != NULL ; rectp = rectp->r_next)
     {
-	DBPaintPlane(cifReadPlane, &rectp->r_r, CIFPaintTable,
-		(PaintUndoInfo *) NULL);
+	CIFReadPaintRect(cifReadPlane, &rectp->r_r);
 	freeMagic((char *) rectp);
     }
     return TRUE;
@@ -162,6 +162,7 @@ extern void CIFSkipToSemi(), CIFSkipSep(), CIFSkipBlanks();
 extern void CIFFreePath(), CIFCleanPath();
 extern void CIFReadCellInit(), CIFReadCellCleanup();
 extern LinkedRect *CIFPolyToRects();
+extern void CIFReadPaintRect(), CIFReadFlushRects();
 extern Transform *CIFDirectionToTrans();
 extern int CIFReadNameToType();
 
@@ -531,6 +531,64 @@ selGetArrayFunc(selUse, use, trans, arg)
     return 0;
 }
 
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * CmdBincache --
+ *
+ * Implement the "bincache" command:  enable or disable the binary
+ * copies of cell paint kept next to .mag files.
+ *
+ * Usage:
+ *	bincache [yes|no]
+ *
+ * Results:
+ *	None.  The Tcl version returns the current setting when no
+ *	argument is given.
+ *
+ * Side effects:
+ *	Sets DBBinaryCache.  While it is set, each cell saved also gets
+ *	a .magb file holding its paint, and cells read in take their
+ *	paint from an up-to-date .magb file instead of the .mag file.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+CmdBincache(w, cmd)
+    MagWindow *w;
+    TxCommand *cmd;
+{
+    int option;
+    static char *cmdBincacheYesNo[] = { "no", "false", "off",
+		"yes", "true", "on", 0 };
+
+    if (cmd->tx_argc == 1)
+    {
+#ifdef MAGIC_WRAPPER
+	Tcl_SetObjResult(magicinterp, Tcl_NewBooleanObj(DBBinaryCache));
+#else
+	TxPrintf("Binary copies of cell paint are %s.\n",
+		(DBBinaryCache) ? "enabled" : "disabled");
+#endif
+	return;
+    }
+    else if (cmd->tx_argc != 2)
+    {
+	TxError("Usage: %s [yes|no]\n", cmd->tx_argv[0]);
+	return;
+    }
+
+    option = Lookup(cmd->tx_argv[1], cmdBincacheYesNo);
+    if (option < 0)
+    {
+	TxError("Usage: %s [yes|no]\n", cmd->tx_argv[0]);
+	return;
+    }
+    DBBinaryCache = (option < 3) ? FALSE : TRUE;
+}
+
 
 /*
  * ----------------------------------------------------------------------------
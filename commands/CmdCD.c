@@ -2890,7 +2890,10 @@ CmdCrash(w, cmd)
 
     switch(option) {
 	case 0:			/* save */
+	    /* Periodic backups (no filename) are finished in the	*/
+	    /* background;  an explicit save completes before return.	*/
 	    DBWriteBackup(filename);
+	    if (filename != NULL) DBBackupWait();
 	    break;
 	case 1:			/* recover */
 	    DBFileRecovery(filename);
@@ -3136,7 +3139,8 @@ cmdDownEnumFunc(selUse, use, transform, area)
 #define PRINTRULES	14
 #define RULESTATS	15
 #define STATISTICS	16
-#define WHY		17
+#define STORE		17
+#define WHY		18
 
 void
 CmdDrc(w, cmd)
@@ -3183,6 +3187,7 @@ CmdDrc(w, cmd)
 	"printrules [file]      print out design rules in file or on tty",
 	"rulestats              print out stats about design rule database",
 	"statistics             print out statistics gathered by checker",
+	"store [on|off]         keep results of checks in files next to cells",
 	"why                    print out reasons for errors under box",
 	NULL
     };
@@ -3222,7 +3227,7 @@ CmdDrc(w, cmd)
 	if ((argc > 2) && (option != PRINTRULES) && (option != FIND)
 	    && (option != SHOWINT) && (option != DRC_HELP) && (option != EUCLIDEAN)
 	    && (option != DRC_STEPSIZE) && (option != DRC_HALO) && (option != COUNT)
-	    && (option != DRC_STYLE))
+	    && (option != DRC_STYLE) && (option != STORE))
 	{
 	    badusage:
 	    TxError("Wrong arguments in \"drc %s\" command:\n", argv[1]);
@@ -3532,6 +3537,24 @@ CmdDrc(w, cmd)
 	    DRCPrintStats();
 	    break;
 
+	case STORE:
+	    if (argc == 2)
+	    {
+#ifdef MAGIC_WRAPPER
+		Tcl_SetObjResult(magicinterp, Tcl_NewBooleanObj(DRCStoreFiles));
+#else
+		TxPrintf("Results of checks are %s with cells.\n",
+			DRCStoreFiles ? "saved" : "not saved");
+#endif
+	    }
+	    else if (argc > 3) goto badusage;
+	    else if (!strcmp(argv[2], "on"))
+		DRCStoreFiles = TRUE;
+	    else if (!strcmp(argv[2], "off"))
+		DRCStoreFiles = FALSE;
+	    else goto badusage;
+	    break;
+
 	case DRC_STEPSIZE:
 	    if (argc == 3)
 	    {
@@ -1956,7 +1956,7 @@ CmdFlatten(w, cmd)
     scx.scx_area = scx.scx_use->cu_def->cd_bbox;
     scx.scx_trans = GeoIdentityTransform;
 
-    DBCellCopyAllPaint(&scx, &DBAllButSpaceAndDRCBits, xMask, flatDestUse);
+    DBCellShareAllPaint(&scx, &DBAllButSpaceAndDRCBits, xMask, flatDestUse);
     if (dolabels)
 	FlatCopyAllLabels(&scx, &DBAllTypeBits, xMask, flatDestUse);
     else if (toplabels)
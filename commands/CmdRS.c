@@ -1521,6 +1521,7 @@ cmdLabelRotateFunc(label, cellUse, transform, value)
 	DBWLabelChanged(cellDef, label, DBW_ALLWINDOWS);
 	label->lab_rotate = *value;
 	DBFontLabelSetBBox(label);
+	DBLabelIndexUpdate(cellDef, label);
 	DBUndoPutLabel(cellDef, label);
 	DBWLabelChanged(cellDef, label, DBW_ALLWINDOWS);
     }
@@ -1556,6 +1557,7 @@ cmdLabelSizeFunc(label, cellUse, transform, value)
 	DBWLabelChanged(cellDef, label, DBW_ALLWINDOWS);
 	label->lab_size = *value;
 	DBFontLabelSetBBox(label);
+	DBLabelIndexUpdate(cellDef, label);
 	DBUndoPutLabel(cellDef, label);
 	DBWLabelChanged(cellDef, label, DBW_ALLWINDOWS);
     }
@@ -1591,6 +1593,7 @@ cmdLabelJustFunc(label, cellUse, transform, value)
 	DBWLabelChanged(cellDef, label, DBW_ALLWINDOWS);
 	label->lab_just = *value;
 	DBFontLabelSetBBox(label);
+	DBLabelIndexUpdate(cellDef, label);
 	DBUndoPutLabel(cellDef, label);
 	DBWLabelChanged(cellDef, label, DBW_ALLWINDOWS);
     }
@@ -1709,6 +1712,7 @@ cmdLabelOffsetFunc(label, cellUse, transform, point)
 	DBWLabelChanged(cellDef, label, DBW_ALLWINDOWS);
 	label->lab_offset = *point;
 	DBFontLabelSetBBox(label);
+	DBLabelIndexUpdate(cellDef, label);
 	DBUndoPutLabel(cellDef, label);
 	DBWLabelChanged(cellDef, label, DBW_ALLWINDOWS);
     }
@@ -1751,6 +1755,7 @@ cmdLabelFontFunc(label, cellUse, transform, font)
 	label->lab_font = *font;
 	if ((*font > -1) && (label->lab_size == 0)) label->lab_size = DBLambda[1];
 	DBFontLabelSetBBox(label);
+	DBLabelIndexUpdate(cellDef, label);
 	DBUndoPutLabel(cellDef, label);
 	DBWLabelChanged(cellDef, label, DBW_ALLWINDOWS);
     }
@@ -48,6 +48,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "utils/netlist.h"
 #include "netmenu/netmenu.h"
 #include "utils/tech.h"
+#include "utils/workers.h"
 #include "drc/drc.h"
 
 #ifdef	LLNL
@@ -607,6 +608,70 @@ usage2:
     return;
 }
 
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * CmdThreads --
+ *
+ * 	Implement the "threads" command:  set the number of threads that
+ *	share the work of parallel operations (see utils/workers.c), such
+ *	as the batch design-rule check and reading a hierarchy.
+ *
+ * Usage:
+ *	threads [count|default]
+ *
+ * Results:
+ *	None.  The Tcl version returns the number of threads in use when
+ *	no argument is given.
+ *
+ * Side effects:
+ *	Sets the thread count.  A count of 1 runs everything in the
+ *	calling thread;  "default" (or 0) goes back to one thread for
+ *	each processor.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+CmdThreads(w, cmd)
+    MagWindow *w;		/* Window in which command was invoked. */
+    TxCommand *cmd;		/* Info about command options. */
+{
+    int count;
+
+    if (cmd->tx_argc == 1)
+    {
+#ifdef MAGIC_WRAPPER
+	Tcl_SetObjResult(magicinterp, Tcl_NewIntObj(WorkerGetCount()));
+#else
+	TxPrintf("Parallel operations use %d thread%s.\n", WorkerGetCount(),
+		(WorkerGetCount() == 1) ? "" : "s");
+#endif
+	return;
+    }
+
+    if (cmd->tx_argc != 2)
+	goto usage;
+    if (strcmp(cmd->tx_argv[1], "default") == 0)
+	count = 0;
+    else if (StrIsInt(cmd->tx_argv[1]) && (count = atoi(cmd->tx_argv[1])) >= 0)
+    {
+	if (count > WORKER_MAX)
+	{
+	    TxError("At most %d threads can be used.\n", WORKER_MAX);
+	    count = WORKER_MAX;
+	}
+    }
+    else
+	goto usage;
+
+    WorkerSetCount(count);
+    return;
+
+usage:
+    TxError("Usage: %s [count|default]\n", cmd->tx_argv[0]);
+}
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -1702,6 +1767,16 @@ CmdWire(w, cmd)
     }
 }
 
+/* Cells collected by "writeall force" ahead of writing them */
+
+typedef struct
+{
+    TxCommand	 *wl_cmd;	/* Command being executed */
+    CellDef	**wl_defs;	/* Cells that will be written */
+    int		  wl_num;	/* Number of entries in wl_defs */
+    int		  wl_max;	/* Allocated size of wl_defs */
+} CmdWriteList;
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -1733,9 +1808,10 @@ CmdWriteall(w, cmd)
     MagWindow *w;
     TxCommand *cmd;
 {
-    int cmdWriteallFunc();
+    int cmdWriteallFunc(), cmdWriteallListFunc();
     static char *force[] = { "force", 0 };
     int argc;
+    CmdWriteList wl;
 
     if ((cmd->tx_argc >= 2) && (Lookup(cmd->tx_argv[1], force) < 0))
     {
@@ -1745,9 +1821,69 @@ CmdWriteall(w, cmd)
 
     DBUpdateStamps();
     argc = cmd->tx_argc;
+
+    /*
+     * When no questions will be asked, the set of cells to be written
+     * is known in advance, so their paint can be rendered to text
+     * in parallel before the (serial) writes begin.
+     */
+    wl.wl_cmd = cmd;
+    wl.wl_defs = NULL;
+    wl.wl_num = wl.wl_max = 0;
+    if (argc >= 2)
+    {
+	(void) DBCellSrDefs(CDMODIFIED|CDBOXESCHANGED|CDSTAMPSCHANGED,
+		cmdWriteallListFunc, (ClientData) &wl);
+	if (wl.wl_num > 1)
+	    DBCellWritePrepare(wl.wl_defs, wl.wl_num);
+    }
+
     (void) DBCellSrDefs(CDMODIFIED|CDBOXESCHANGED|CDSTAMPSCHANGED,
 		cmdWriteallFunc, (ClientData)cmd);
     cmd->tx_argc = argc;
+
+    if (wl.wl_defs != NULL)
+    {
+	DBCellWriteUnprepare();
+	freeMagic((char *) wl.wl_defs);
+    }
+}
+
+/*
+ * Filter function used by CmdWriteall() above to collect the cells
+ * that "writeall force" is going to write.
+ */
+
+int
+cmdWriteallListFunc(def, wl)
+    CellDef *def;
+    CmdWriteList *wl;
+{
+    TxCommand *cmd = wl->wl_cmd;
+    CellDef **newDefs;
+    int i;
+
+    if (def->cd_flags & CDINTERNAL) return 0;
+    if (cmd->tx_argc > 2)
+    {
+	for (i = 2; i < cmd->tx_argc; i++)
+	    if (!strcmp(cmd->tx_argv[i], def->cd_name))
+		break;
+	if (i == cmd->tx_argc) return 0;
+    }
+
+    if (wl->wl_num == wl->wl_max)
+    {
+	wl->wl_max = (wl->wl_max == 0) ? 32 : wl->wl_max * 2;
+	newDefs = (CellDef **) mallocMagic((unsigned)
+		(wl->wl_max * sizeof (CellDef *)));
+	for (i = 0; i < wl->wl_num; i++)
+	    newDefs[i] = wl->wl_defs[i];
+	if (wl->wl_defs != NULL) freeMagic((char *) wl->wl_defs);
+	wl->wl_defs = newDefs;
+    }
+    wl->wl_defs[wl->wl_num++] = def;
+    return 0;
 }
 
 /*
@@ -29,6 +29,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include <sys/types.h>
 #include <sys/times.h>
 
+#include "tcltk/tclmagic.h"
 #include "utils/magic.h"
 #include "utils/geometry.h"
 #include "utils/malloc.h"
@@ -722,6 +723,174 @@ cmdStatsOutput(def, cc)
     return (0);
 }
 
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * CmdParsearch --
+ *
+ * Check DBSrPaintAreaParallel() against DBSrPaintArea().  The paint
+ * of the edit cell under the box is searched both ways, and the
+ * number of tiles found, their total area, and a checksum of their
+ * planes, types and positions are compared.  The checksum doesn't
+ * depend on the order in which tiles are found, only on which tiles
+ * they are and on how many times each is found.
+ *
+ * Usage:
+ *	parsearch [layers]
+ *
+ * Results:
+ *	None.  The Tcl version returns a list of the number of tiles,
+ *	their area, and 1 if the searches agree (0 if not).
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+typedef struct
+{
+    int		ps_pNum;	/* Plane being searched (serially) */
+    int		ps_tiles;	/* Number of tiles found */
+    dlong	ps_area;	/* Their total area */
+    unsigned long ps_sum;	/* Checksum of the tiles */
+} ParSearchStats;
+
+void
+cmdParsearchAdd(stats, pNum, tile)
+    ParSearchStats *stats;
+    int pNum;
+    Tile *tile;
+{
+    unsigned long h;
+    Rect r;
+
+    TiToRect(tile, &r);
+    h = (unsigned long) pNum;
+    h = h * 1000003 + TiGetLeftType(tile);
+    h = h * 1000003 + TiGetRightType(tile);
+    h = h * 1000003 + (unsigned) r.r_xbot;
+    h = h * 1000003 + (unsigned) r.r_ybot;
+    h = h * 1000003 + (unsigned) r.r_xtop;
+    h = h * 1000003 + (unsigned) r.r_ytop;
+    stats->ps_tiles++;
+    stats->ps_area += (dlong) (r.r_xtop - r.r_xbot) * (r.r_ytop - r.r_ybot);
+    stats->ps_sum += h ^ (h >> 29);
+}
+
+int
+cmdParsearchSerialFunc(tile, stats)
+    Tile *tile;
+    ParSearchStats *stats;
+{
+    cmdParsearchAdd(stats, stats->ps_pNum, tile);
+    return 0;
+}
+
+int
+cmdParsearchTileFunc(tile, dinfo, task)
+    Tile *tile;
+    TileType dinfo;
+    DBSearchTask *task;
+{
+    ParSearchStats *stats = (ParSearchStats *) task->dst_result;
+
+    if (stats == NULL)
+    {
+	stats = (ParSearchStats *) mallocMagic(sizeof (ParSearchStats));
+	stats->ps_tiles = 0;
+	stats->ps_area = 0;
+	stats->ps_sum = 0;
+	task->dst_result = (ClientData) stats;
+    }
+    cmdParsearchAdd(stats, task->dst_pNum, tile);
+    return 0;
+}
+
+int
+cmdParsearchMergeFunc(task, total)
+    DBSearchTask *task;
+    ParSearchStats *total;
+{
+    ParSearchStats *stats = (ParSearchStats *) task->dst_result;
+
+    if (stats == NULL) return 0;
+    total->ps_tiles += stats->ps_tiles;
+    total->ps_area += stats->ps_area;
+    total->ps_sum += stats->ps_sum;
+    freeMagic((char *) stats);
+    return 0;
+}
+
+void
+CmdParsearch(w, cmd)
+    MagWindow *w;
+    TxCommand *cmd;
+{
+    TileTypeBitMask mask;
+    ParSearchStats serial, parallel;
+    PlaneMask planes;
+    CellDef *def;
+    Rect area;
+    bool same;
+#ifdef MAGIC_WRAPPER
+    Tcl_Obj *lobj;
+#endif
+
+    if (cmd->tx_argc > 2)
+    {
+	TxError("Usage: %s [layers]\n", cmd->tx_argv[0]);
+	return;
+    }
+    if (cmd->tx_argc == 2)
+    {
+	if (!CmdParseLayers(cmd->tx_argv[1], &mask))
+	    return;
+    }
+    else mask = DBAllButSpaceBits;
+
+    if (EditCellUse == NULL || !ToolGetEditBox(&area)) return;
+    def = EditCellUse->cu_def;
+    planes = DBTechTypesToPlanes(&mask);
+
+    serial.ps_tiles = 0;
+    serial.ps_area = 0;
+    serial.ps_sum = 0;
+    for (serial.ps_pNum = PL_PAINTBASE; serial.ps_pNum < DBNumPlanes;
+		serial.ps_pNum++)
+	if (PlaneMaskHasPlane(planes, serial.ps_pNum))
+	    (void) DBSrPaintArea((Tile *) NULL, def->cd_planes[serial.ps_pNum],
+			&area, &mask, cmdParsearchSerialFunc,
+			(ClientData) &serial);
+
+    parallel.ps_tiles = 0;
+    parallel.ps_area = 0;
+    parallel.ps_sum = 0;
+    (void) DBSrPaintAreaParallel(def, planes, (TileType) 0, &area, &mask,
+		cmdParsearchTileFunc, cmdParsearchMergeFunc,
+		(ClientData) &parallel);
+
+    same = (serial.ps_tiles == parallel.ps_tiles)
+		&& (serial.ps_area == parallel.ps_area)
+		&& (serial.ps_sum == parallel.ps_sum);
+
+#ifdef MAGIC_WRAPPER
+    lobj = Tcl_NewListObj(0, NULL);
+    Tcl_ListObjAppendElement(magicinterp, lobj,
+		Tcl_NewIntObj(serial.ps_tiles));
+    Tcl_ListObjAppendElement(magicinterp, lobj,
+		Tcl_NewWideIntObj((Tcl_WideInt) serial.ps_area));
+    Tcl_ListObjAppendElement(magicinterp, lobj, Tcl_NewBooleanObj(same));
+    Tcl_SetObjResult(magicinterp, lobj);
+#else
+    TxPrintf("DBSrPaintArea: %d tiles, area %"DLONG_PREFIX"d\n",
+		serial.ps_tiles, serial.ps_area);
+    TxPrintf("DBSrPaintAreaParallel: %d tiles, area %"DLONG_PREFIX"d\n",
+		parallel.ps_tiles, parallel.ps_area);
+    TxPrintf("The searches %s.\n", same ? "agree" : "DIFFER");
+#endif
+}
+
 /*
  * ----------------------------------------------------------------------------
  *
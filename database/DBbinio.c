@@ -0,0 +1,671 @@
+/*
+ * DBbinio.c --
+ *
+ * Binary companion files holding the paint of cells.
+ *
+ * When DBBinaryCache is set, DBCellWrite() also writes, next to each
+ * cell's .mag file, a file of the same name with a "b" appended
+ * (cell.magb) containing the tiles of the cell's paint planes exactly
+ * as they are in the database, corner stitches and all.  When the cell
+ * is read back in, the tiles are just allocated and filled in from
+ * the binary file, and the rectangles in the text file are skipped
+ * over instead of being parsed and painted one at a time.
+ *
+ * The .mag file stays the only authoritative copy of the cell.  Cell
+ * uses, labels, and properties are always read from it, and the binary
+ * file is used only if it was written from the very .mag file being
+ * read (same size, modification time, inode, and timestamp line) under
+ * the same technology, type table, and scale.  Anything else, including
+ * a .magb file that is missing, truncated, or out of date, is silently
+ * ignored and the paint is read from the text.
+ *
+ * File layout;  all values are native-endian ints unless noted:
+ *
+ *	header	 DBB_MAGIC, DBB_VERSION, timestamp, DBLambda[0],
+ *		 DBLambda[1], DBNumTypes, DBNumPlanes
+ *	identity size, modification time, inode, and device of the
+ *		 .mag file (dlongs)
+ *	names	 byte count, then the technology name and the long names
+ *		 of all types and planes, each a length and its characters,
+ *		 padded to a multiple of 8 bytes
+ *	planes	 for each plane from PL_PAINTBASE up, the number of tiles,
+ *		 the TR, BL, LB, and RT stitches of the plane's left, right,
+ *		 top, and bottom boundary tiles, and then one record per
+ *		 tile, in the order of TiSrArea():
+ *		 { xbot, ybot, body, TR, RT, BL, LB }.
+ *		 Stitches are indices of tiles in the plane's list, or
+ *		 one of DBB_LEFT, DBB_RIGHT, DBB_TOP, or DBB_BOTTOM for
+ *		 the boundary tiles.
+ *	trailer	 DBB_MAGIC
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "utils/magic.h"
+#include "utils/geometry.h"
+#include "utils/malloc.h"
+#include "tiles/tile.h"
+#include "utils/hash.h"
+#include "database/database.h"
+#include "database/databaseInt.h"
+
+/* If TRUE, DBCellWrite() writes .magb files and cell reads use them */
+bool DBBinaryCache = FALSE;
+
+#define DBB_MAGIC	0x4d414742	/* "MAGB" */
+#define DBB_VERSION	1
+
+#define DBB_HEADER	7		/* Ints in the header */
+#define DBB_IDENT	4		/* Dlongs identifying the .mag file */
+#define DBB_RECORD	7		/* Ints in one tile record */
+
+/* Stitches to the boundary tiles of a plane are stored as these */
+
+#define DBB_LEFT	-1
+#define DBB_RIGHT	-2
+#define DBB_TOP		-3
+#define DBB_BOTTOM	-4
+
+/* Client data for dbBinTileFunc():  all the tiles of a plane */
+
+typedef struct
+{
+    Tile **bt_tiles;
+    int    bt_count;
+    int    bt_size;
+} BinTiles;
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbBinName --
+ *
+ * Form the name of the binary file that goes with a .mag file.
+ *
+ * Results:
+ *	The name, in memory allocated by mallocMagic().  The caller
+ *	must free it.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+char *
+dbBinName(textName)
+    char *textName;	/* Full name of the .mag file */
+{
+    char *binName;
+
+    binName = (char *) mallocMagic((unsigned) (strlen(textName) + 2));
+    (void) sprintf(binName, "%sb", textName);
+    return binName;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbBinNames --
+ *
+ * Generate the names block of a binary file for the current technology.
+ *
+ * Results:
+ *	The number of bytes in the block, which is always a multiple
+ *	of 8.  If buf is NULL, nothing is stored and only the size is
+ *	returned.
+ *
+ * Side effects:
+ *	Fills in buf.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbBinNames(buf)
+    char *buf;		/* Where to put the block, or NULL */
+{
+    int size, len, i, n;
+    char *name;
+
+    n = 1 + DBNumTypes + DBNumPlanes;
+    size = 0;
+    for (i = 0; i < n; i++)
+    {
+	if (i == 0)
+	    name = DBTechName;
+	else if (i <= DBNumTypes)
+	    name = DBTypeLongNameTbl[i - 1];
+	else
+	    name = DBPlaneLongNameTbl[i - 1 - DBNumTypes];
+	len = (name == NULL) ? 0 : strlen(name);
+	if (buf != NULL)
+	{
+	    memcpy(buf + size, &len, sizeof (int));
+	    if (len > 0) memcpy(buf + size + sizeof (int), name, len);
+	}
+	size += sizeof (int) + len;
+    }
+    while (size % 8 != 0)
+    {
+	if (buf != NULL) buf[size] = '\0';
+	size++;
+    }
+    return size;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbBinIdent --
+ *
+ * Get the values that identify the contents of a .mag file.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Fills in ident[0..DBB_IDENT-1].
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbBinIdent(sbuf, ident)
+    struct stat *sbuf;
+    dlong ident[];
+{
+    ident[0] = (dlong) sbuf->st_size;
+    ident[1] = (dlong) sbuf->st_mtime;
+    ident[2] = (dlong) sbuf->st_ino;
+    ident[3] = (dlong) sbuf->st_dev;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbBinTileFunc --
+ *
+ * Called by TiSrArea() for each tile of a plane being written out.
+ *
+ * Results:
+ *	Always 0.
+ *
+ * Side effects:
+ *	Adds the tile to the list in bt.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbBinTileFunc(tile, bt)
+    Tile *tile;
+    BinTiles *bt;
+{
+    Tile **newtiles;
+
+    if (bt->bt_count == bt->bt_size)
+    {
+	bt->bt_size = (bt->bt_size == 0) ? 1024 : bt->bt_size * 2;
+	newtiles = (Tile **) mallocMagic((unsigned)
+		(bt->bt_size * sizeof (Tile *)));
+	if (bt->bt_count > 0)
+	    memcpy(newtiles, bt->bt_tiles, bt->bt_count * sizeof (Tile *));
+	if (bt->bt_tiles != NULL) freeMagic((char *) bt->bt_tiles);
+	bt->bt_tiles = newtiles;
+    }
+    bt->bt_tiles[bt->bt_count++] = tile;
+    return 0;
+}
+
+/* Tiles sorted by address, for finding the index of a stitch */
+
+typedef struct
+{
+    Tile *bi_tile;
+    int   bi_index;
+} BinIndex;
+
+static int
+dbBinCmpIndex(i1, i2)
+    BinIndex *i1, *i2;
+{
+    return (i1->bi_tile < i2->bi_tile) ? -1 :
+		(i1->bi_tile > i2->bi_tile) ? 1 : 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbBinStitch --
+ *
+ * Find the value to store for a stitch pointing to tp.
+ *
+ * Results:
+ *	The index of tp among the plane's tiles, or one of DBB_LEFT,
+ *	DBB_RIGHT, DBB_TOP, or DBB_BOTTOM if it is a boundary tile.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbBinStitch(plane, index, n, tp)
+    Plane *plane;
+    BinIndex *index;	/* Tiles of plane sorted by address */
+    int n;		/* Number of entries in index */
+    Tile *tp;
+{
+    BinIndex key, *found;
+
+    if (tp == plane->pl_left) return DBB_LEFT;
+    if (tp == plane->pl_right) return DBB_RIGHT;
+    if (tp == plane->pl_top) return DBB_TOP;
+    if (tp == plane->pl_bottom) return DBB_BOTTOM;
+
+    key.bi_tile = tp;
+    found = (BinIndex *) bsearch((char *) &key, (char *) index, n,
+		sizeof (BinIndex), dbBinCmpIndex);
+    return found->bi_index;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbBinWritePlane --
+ *
+ * Write out the tiles of one plane, with their stitches.
+ *
+ * Results:
+ *	TRUE on success, FALSE on a write error.
+ *
+ * Side effects:
+ *	Writes to f.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+dbBinWritePlane(f, plane)
+    FILE *f;
+    Plane *plane;
+{
+    BinTiles bt;
+    BinIndex *index;
+    Tile *tp;
+    int rec[DBB_RECORD], bound[4], i, n;
+    bool result = TRUE;
+
+    bt.bt_tiles = NULL;
+    bt.bt_count = bt.bt_size = 0;
+    (void) TiSrArea((Tile *) NULL, plane, &TiPlaneRect, dbBinTileFunc,
+		(ClientData) &bt);
+    n = bt.bt_count;
+
+    index = (BinIndex *) mallocMagic((unsigned) (n * sizeof (BinIndex)));
+    for (i = 0; i < n; i++)
+    {
+	index[i].bi_tile = bt.bt_tiles[i];
+	index[i].bi_index = i;
+    }
+    qsort((char *) index, n, sizeof (BinIndex), dbBinCmpIndex);
+
+    bound[0] = dbBinStitch(plane, index, n, TR(plane->pl_left));
+    bound[1] = dbBinStitch(plane, index, n, BL(plane->pl_right));
+    bound[2] = dbBinStitch(plane, index, n, LB(plane->pl_top));
+    bound[3] = dbBinStitch(plane, index, n, RT(plane->pl_bottom));
+    if (fwrite(&n, sizeof (int), 1, f) != 1
+	    || fwrite(bound, sizeof (int), 4, f) != 4)
+	result = FALSE;
+
+    for (i = 0; i < n && result; i++)
+    {
+	tp = bt.bt_tiles[i];
+	rec[0] = LEFT(tp);
+	rec[1] = BOTTOM(tp);
+	rec[2] = TiGetTypeExact(tp) & ~TT_SIDE;
+	rec[3] = dbBinStitch(plane, index, n, TR(tp));
+	rec[4] = dbBinStitch(plane, index, n, RT(tp));
+	rec[5] = dbBinStitch(plane, index, n, BL(tp));
+	rec[6] = dbBinStitch(plane, index, n, LB(tp));
+	if (fwrite(rec, sizeof (int), DBB_RECORD, f) != DBB_RECORD)
+	    result = FALSE;
+    }
+
+    freeMagic((char *) index);
+    if (bt.bt_tiles != NULL) freeMagic((char *) bt.bt_tiles);
+    return result;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbBinWrite --
+ *
+ * Write the binary companion of a .mag file that has just been
+ * written out for cellDef.  The file is written under a temporary
+ * name and renamed into place, so a reader never sees a partial file.
+ *
+ * Results:
+ *	TRUE on success, FALSE if the file couldn't be written.  A
+ *	failure is not an error as far as saving the cell goes.
+ *
+ * Side effects:
+ *	Writes the .magb file.  If it can't be written, any old one
+ *	is removed.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+dbBinWrite(cellDef, textName)
+    CellDef *cellDef;	/* Cell just written */
+    char *textName;	/* Full name of the .mag file written */
+{
+    struct stat sbuf;
+    char *binName, *tmpName, *names;
+    int header[DBB_HEADER], size, pNum, magic;
+    dlong ident[DBB_IDENT];
+    FILE *f;
+    bool ok, result = FALSE;
+
+    if (stat(textName, &sbuf) != 0)
+	return FALSE;
+
+    binName = dbBinName(textName);
+    tmpName = (char *) mallocMagic((unsigned) (strlen(binName) + 5));
+    (void) sprintf(tmpName, "%s.tmp", binName);
+    if ((f = fopen(tmpName, "w")) == NULL)
+    {
+	(void) unlink(binName);
+	freeMagic(tmpName);
+	freeMagic(binName);
+	return FALSE;
+    }
+
+    header[0] = DBB_MAGIC;
+    header[1] = DBB_VERSION;
+    header[2] = cellDef->cd_timestamp;
+    header[3] = DBLambda[0];
+    header[4] = DBLambda[1];
+    header[5] = DBNumTypes;
+    header[6] = DBNumPlanes;
+    dbBinIdent(&sbuf, ident);
+
+    size = dbBinNames((char *) NULL);
+    names = (char *) mallocMagic((unsigned) size);
+    (void) dbBinNames(names);
+
+    ok = (fwrite(header, sizeof (int), DBB_HEADER, f) == DBB_HEADER
+	    && fwrite(ident, sizeof (dlong), DBB_IDENT, f) == DBB_IDENT
+	    && fwrite(&size, sizeof (int), 1, f) == 1
+	    && fwrite(names, 1, size, f) == size);
+    freeMagic(names);
+
+    for (pNum = PL_PAINTBASE; pNum < DBNumPlanes && ok; pNum++)
+	ok = dbBinWritePlane(f, cellDef->cd_planes[pNum]);
+
+    magic = DBB_MAGIC;
+    if (ok && fwrite(&magic, sizeof (int), 1, f) != 1)
+	ok = FALSE;
+    if (fclose(f) != 0)
+	ok = FALSE;
+
+    if (ok && rename(tmpName, binName) == 0)
+	result = TRUE;
+    else
+    {
+	(void) unlink(tmpName);
+	(void) unlink(binName);
+    }
+    freeMagic(tmpName);
+    freeMagic(binName);
+    return result;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbBinCheckPlane --
+ *
+ * Check that the tile records of one plane in a binary file describe
+ * a sane plane:  stitches in range and pointing the right way, tiles
+ * of positive size, and types that exist.
+ *
+ * Results:
+ *	TRUE if the plane is usable, FALSE if not.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+dbBinCheckPlane(recs, n, bound)
+    int *recs;		/* Records of the plane */
+    int n;		/* Number of records */
+    int *bound;		/* Stitches of the boundary tiles */
+{
+    int i, *rec, s, right, top;
+    TileType body;
+
+    if (n < 1) return FALSE;
+    for (i = 0; i < 4; i++)
+	if (bound[i] < 0 || bound[i] >= n)
+	    return FALSE;
+
+    for (i = 0; i < n; i++)
+    {
+	rec = recs + i * DBB_RECORD;
+	body = rec[2];
+	if ((body & TT_LEFTMASK) >= DBNumTypes) return FALSE;
+	if ((body & TT_DIAGONAL) && ((body & TT_RIGHTMASK) >> 14) >= DBNumTypes)
+	    return FALSE;
+
+	/* TR and RT give the upper right corner */
+	s = rec[3];
+	if (s == DBB_RIGHT)
+	    right = INFINITY;
+	else if (s >= 0 && s < n)
+	    right = recs[s * DBB_RECORD];
+	else
+	    return FALSE;
+	s = rec[4];
+	if (s == DBB_TOP)
+	    top = INFINITY;
+	else if (s >= 0 && s < n)
+	    top = recs[s * DBB_RECORD + 1];
+	else
+	    return FALSE;
+	if (right <= rec[0] || top <= rec[1]) return FALSE;
+
+	s = rec[5];
+	if (s != DBB_LEFT && (s < 0 || s >= n)) return FALSE;
+	s = rec[6];
+	if (s != DBB_BOTTOM && (s < 0 || s >= n)) return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbBinRead --
+ *
+ * Try to read the paint of cellDef from the binary companion of the
+ * .mag file open as f.  The paint planes of cellDef must be empty.
+ *
+ * Results:
+ *	TRUE if the paint was read, in which case the caller must
+ *	skip over the paint in the .mag file.  FALSE if there is no
+ *	usable binary file;  the cell is then left untouched.
+ *
+ * Side effects:
+ *	Fills in the paint planes of cellDef.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+dbBinRead(cellDef, f, stamp)
+    CellDef *cellDef;	/* Cell being read */
+    FILE *f;		/* The .mag file, open for reading */
+    int stamp;		/* Timestamp from the .mag file */
+{
+    struct stat sbuf, bbuf;
+    char *binName, *buf = NULL, *names = NULL, *cp, *end, *planes;
+    int header[DBB_HEADER], n, size, pNum, magic, i, *recs, *rec, *bound;
+    dlong ident[DBB_IDENT], fident[DBB_IDENT];
+    Tile **tiles;
+    Plane *plane;
+    Tile *tp;
+    FILE *bf;
+    bool result = FALSE;
+
+#define	BINTILE(s) \
+	(((s) >= 0) ? tiles[s] : ((s) == DBB_LEFT) ? plane->pl_left : \
+	((s) == DBB_RIGHT) ? plane->pl_right : \
+	((s) == DBB_TOP) ? plane->pl_top : plane->pl_bottom)
+
+    if (cellDef->cd_file == NULL || fstat(fileno(f), &sbuf) != 0)
+	return FALSE;
+
+    binName = dbBinName(cellDef->cd_file);
+    bf = fopen(binName, "r");
+    freeMagic(binName);
+    if (bf == NULL) return FALSE;
+
+    /* Read the whole file in and check it before touching the cell */
+
+    if (fstat(fileno(bf), &bbuf) != 0
+	    || bbuf.st_size < (off_t) (DBB_HEADER * sizeof (int)
+		+ DBB_IDENT * sizeof (dlong) + 2 * sizeof (int)))
+	goto done;
+    buf = (char *) mallocMagic((unsigned) bbuf.st_size);
+    if (fread(buf, 1, (size_t) bbuf.st_size, bf) != (size_t) bbuf.st_size)
+	goto done;
+    cp = buf;
+    end = buf + bbuf.st_size;
+
+    memcpy(header, cp, sizeof header);
+    cp += sizeof header;
+    if (header[0] != DBB_MAGIC || header[1] != DBB_VERSION
+	    || header[2] != stamp
+	    || header[3] != DBLambda[0] || header[4] != DBLambda[1]
+	    || header[5] != DBNumTypes || header[6] != DBNumPlanes)
+	goto done;
+
+    memcpy(ident, cp, sizeof ident);
+    cp += sizeof ident;
+    dbBinIdent(&sbuf, fident);
+    for (i = 0; i < DBB_IDENT; i++)
+	if (ident[i] != fident[i])
+	    goto done;
+
+    memcpy(&size, cp, sizeof (int));
+    cp += sizeof (int);
+    if (size != dbBinNames((char *) NULL) || end - cp < size)
+	goto done;
+    names = (char *) mallocMagic((unsigned) size);
+    (void) dbBinNames(names);
+    if (memcmp(names, cp, size) != 0)
+	goto done;
+    cp += size;
+
+    /*
+     * The records are ints at an offset that is a multiple of 8,
+     * so they can be used in place.
+     */
+    planes = cp;
+    for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
+    {
+	/* The plane must still be the single tile it started as */
+	plane = cellDef->cd_planes[pNum];
+	tp = TR(plane->pl_left);
+	if (TR(tp) != plane->pl_right || RT(tp) != plane->pl_top
+		|| LB(tp) != plane->pl_bottom || BL(tp) != plane->pl_left)
+	    goto done;
+
+	if (end - cp < 5 * sizeof (int)) goto done;
+	n = ((int *) cp)[0];
+	bound = (int *) cp + 1;
+	cp += 5 * sizeof (int);
+	if (n < 1 || (end - cp) / (DBB_RECORD * sizeof (int)) < n)
+	    goto done;
+	if (!dbBinCheckPlane((int *) cp, n, bound))
+	    goto done;
+	cp += n * DBB_RECORD * sizeof (int);
+    }
+    if (end - cp != sizeof (int)) goto done;
+    memcpy(&magic, cp, sizeof (int));
+    if (magic != DBB_MAGIC) goto done;
+
+    /*
+     * The file is good.  Each plane is made directly from its tiles,
+     * keeping the plane's original tile as the first one.
+     */
+
+    cp = planes;
+    for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
+    {
+	plane = cellDef->cd_planes[pNum];
+	TiPlaneModify(plane);
+	n = ((int *) cp)[0];
+	bound = (int *) cp + 1;
+	recs = (int *) cp + 5;
+	cp += (5 + n * DBB_RECORD) * sizeof (int);
+
+	tiles = (Tile **) mallocMagic((unsigned) (n * sizeof (Tile *)));
+	tiles[0] = TR(plane->pl_left);
+	for (i = 1; i < n; i++)
+	    tiles[i] = TiPlaneAlloc(plane);
+
+	for (i = 0; i < n; i++)
+	{
+	    rec = recs + i * DBB_RECORD;
+	    tp = tiles[i];
+	    LEFT(tp) = rec[0];
+	    BOTTOM(tp) = rec[1];
+	    TiSetBody(tp, (ClientData)(spointertype) rec[2]);
+	    TiSetClient(tp, CLIENTDEFAULT);
+	    TiSetTR(tp, BINTILE(rec[3]));
+	    TiSetRT(tp, BINTILE(rec[4]));
+	    TiSetBL(tp, BINTILE(rec[5]));
+	    TiSetLB(tp, BINTILE(rec[6]));
+	}
+	TiSetTR(plane->pl_left, tiles[bound[0]]);
+	TiSetBL(plane->pl_right, tiles[bound[1]]);
+	TiSetLB(plane->pl_top, tiles[bound[2]]);
+	TiSetRT(plane->pl_bottom, tiles[bound[3]]);
+	plane->pl_hint = tiles[0];
+
+	freeMagic((char *) tiles);
+    }
+    result = TRUE;
+
+done:
+    if (names != NULL) freeMagic(names);
+    if (buf != NULL) freeMagic(buf);
+    (void) fclose(bf);
+    return result;
+}
@@ -24,6 +24,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "utils/magic.h"
 #include "utils/geometry.h"
 #include "database/database.h"
+#include "database/databaseInt.h"
 #include "tiles/tile.h"
 
 
@@ -45,61 +46,40 @@ DBBoundCellPlane(def, extended, rect)
     bool extended;
     Rect *rect;
 {
-    TreeFilter filter;
     DBCellBoundStruct cbs;
     int dbCellBoundFunc();
-    Plane *plane;
     
-    filter.tf_func = NULL;
-    filter.tf_arg = (ClientData)&cbs;
-
     cbs.area = rect;
     cbs.extended = extended;
     cbs.found = FALSE;
 
     *rect = GeoNullRect;
-    if (TiSrArea((Tile *)NULL, def->cd_planes[PL_CELL],
-		&TiPlaneRect, dbCellBoundFunc, (ClientData) &filter) == 0)
+    if (dbCellIndexSearch(def, (Rect *) NULL, dbCellBoundFunc,
+		(ClientData) &cbs) == 0)
 	return cbs.found;
     else
 	return -1;
 }
 
 int
-dbCellBoundFunc(tile, fp)
-    Tile *tile;
-    TreeFilter *fp;
-{
+dbCellBoundFunc(use, cbs)
     CellUse *use;
-    CellTileBody *body;
-    Rect *bbox;
     DBCellBoundStruct *cbs;
-
-    cbs = (DBCellBoundStruct *)fp->tf_arg;
-
-    for (body = (CellTileBody *) TiGetBody(tile); body != NULL;
-		body = body->ctb_next)
+{
+    if (cbs->found)
+    {
+	if (cbs->extended)
+	    GeoInclude(&use->cu_extended, cbs->area);
+	else
+	    GeoInclude(&use->cu_bbox, cbs->area);
+    }
+    else
     {
-	use = body->ctb_use;
-	bbox = &use->cu_bbox;
-	if ((BOTTOM(tile) <= bbox->r_ybot) && (RIGHT(tile) >= bbox->r_xtop))
- 	{
-	    if (cbs->found)
-	    {
-		if (cbs->extended)
-		    GeoInclude(&use->cu_extended, cbs->area);
-		else
-		    GeoInclude(&use->cu_bbox, cbs->area);
-	    }
-	    else
-	    {
-		if (cbs->extended)
-		    *cbs->area = use->cu_extended;
-		else
-		    *cbs->area = use->cu_bbox;
-		cbs->found = TRUE;
-	    }
-	}
+	if (cbs->extended)
+	    *cbs->area = use->cu_extended;
+	else
+	    *cbs->area = use->cu_bbox;
+	cbs->found = TRUE;
     }
     return 0;
 }
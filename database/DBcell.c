@@ -86,29 +86,40 @@ DBCellFindDup(use, parent)
 				 * something identical to use?
 				 */
 {
-    Tile *tile;
-    CellTileBody *body;
+    Rect corner;
+    CellUse *dupUse;
+    int dbFindDupFunc();
+
+    corner.r_ll = corner.r_ur = use->cu_bbox.r_ll;
+    dupUse = use;
+    if (dbCellIndexSearch(parent, &corner, dbFindDupFunc, (ClientData) &dupUse))
+	return dupUse;
+    return (CellUse *) NULL;
+}
+
+/*
+ * Filter function called via dbCellIndexSearch() by DBCellFindDup().
+ * On entry *pUse is the use being checked;  if checkUse is identical
+ * to it, *pUse is changed to checkUse and the search is stopped.
+ */
+
+int
+dbFindDupFunc(checkUse, pUse)
     CellUse *checkUse;
+    CellUse **pUse;
+{
+    CellUse *use = *pUse;
 
-    tile = TiSrPoint((Tile *) NULL, parent->cd_planes[PL_CELL],
-	    &use->cu_bbox.r_ll);
-    
-    for (body = (CellTileBody *) TiGetBody(tile);
-	body != NULL;
-	body = body->ctb_next)
-    {
-	checkUse = body->ctb_use;
-	if (use->cu_def != checkUse->cu_def) continue;
-	if ((use->cu_bbox.r_xbot != checkUse->cu_bbox.r_xbot)
-	    || (use->cu_bbox.r_xtop != checkUse->cu_bbox.r_xtop)
-	    || (use->cu_bbox.r_ybot != checkUse->cu_bbox.r_ybot)
-	    || (use->cu_bbox.r_ytop != checkUse->cu_bbox.r_ytop))
-	    continue;
-	return checkUse;
-    }
-    return (CellUse *) NULL;
+    if (use->cu_def != checkUse->cu_def) return 0;
+    if ((use->cu_bbox.r_xbot != checkUse->cu_bbox.r_xbot)
+	|| (use->cu_bbox.r_xtop != checkUse->cu_bbox.r_xtop)
+	|| (use->cu_bbox.r_ybot != checkUse->cu_bbox.r_ybot)
+	|| (use->cu_bbox.r_ytop != checkUse->cu_bbox.r_ytop))
+	return 0;
+    *pUse = checkUse;
+    return 1;
 }
-
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -154,6 +165,7 @@ DBPlaceCell (celluse, targetcell)
     SigDisableInterrupts();
     (void) TiSrArea((Tile *) NULL, plane, &rect, placeCellFunc,
 	(ClientData) &arg);
+    dbCellIndexInsert(targetcell, celluse);
     targetcell->cd_flags |= CDMODIFIED|CDGETNEWSTAMP;
     if (UndoIsEnabled())
 	DBUndoCellUse(celluse, UNDO_CELL_PLACE);
@@ -198,6 +210,7 @@ DBDeleteCell (celluse)
     SigDisableInterrupts();
     (void) TiSrArea((Tile *) NULL, plane, &rect, deleteCellFunc,
 	(ClientData) &arg);
+    dbCellIndexDelete(celluse->cu_parent, celluse);
     celluse->cu_parent->cd_flags |= CDMODIFIED|CDGETNEWSTAMP;
     if (UndoIsEnabled())
 	DBUndoCellUse(celluse, UNDO_CELL_DELETE);
@@ -29,6 +29,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "utils/hash.h"
 #include "database/database.h"
 #include "database/databaseInt.h"
+#include "utils/undo.h"
 #include "textio/textio.h"
 #include "windows/windows.h"
 #include "dbwind/dbwind.h"
@@ -38,9 +39,14 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
  * The following variable points to the tables currently used for
  * painting.  The paint tables are occasionally switched, by clients
  * like the design-rule checker, by calling DBNewPaintTable.  This
- * paint table applies only to the routine in this module.
+ * paint table applies only to the routine in this module.  NULL
+ * stands for the standard paint table, whose rows are stored
+ * differently (see DBPaintResultTbl).
  */
-static PaintResultType (*dbCurPaintTbl)[NT][NT] = DBPaintResultTbl;
+static PaintResultType (*dbCurPaintTbl)[NT][NT] = NULL;
+
+#define	dbCurPaintRow(p, t) \
+	((dbCurPaintTbl == NULL) ? DBStdPaintTbl(t, p) : dbCurPaintTbl[p][t])
 
 /*
  * The following variable points to the version of DBPaintPlane used
@@ -60,6 +66,10 @@ struct copyAllArg
 					 * targetUse coords).  Used only when
 					 * copying cells.
 					 */
+    TileBuilder		*caa_builder;	/* Builder for an empty target plane.
+					 * Used only by DBCellCopyPaint.
+					 */
+    int			 caa_nsplit;	/* Split tiles skipped by the builder */
 };
 
     /* Structure passed to DBSrPaintArea() */
@@ -109,7 +119,7 @@ DBPaintPlaneWrapper(def, pNum, type, area, undo)
 
     undo->pu_pNum = pNum;
     DBNMPaintPlane(def->cd_planes[pNum], type, area,
-		dbCurPaintTbl[pNum][loctype], undo);
+		dbCurPaintRow(pNum, loctype), undo);
     GEO_EXPAND(area, 1, &expand);
     DBMergeNMTiles(def->cd_planes[pNum], &expand, undo);
 }
@@ -138,7 +148,7 @@ DBPaintPlaneMark(def, pNum, type, area, undo)
 
     undo->pu_pNum = pNum;
     DBNMPaintPlane0(def->cd_planes[pNum], type, area,
-		dbCurPaintTbl[pNum][loctype], undo, (unsigned char)PAINT_MARK);
+		dbCurPaintRow(pNum, loctype), undo, (unsigned char)PAINT_MARK);
 }
 
 /*
@@ -159,7 +169,7 @@ DBPaintPlaneXor(def, pNum, type, area, undo)
 
     undo->pu_pNum = pNum;
     DBNMPaintPlane0(def->cd_planes[pNum], type, area,
-		dbCurPaintTbl[pNum][loctype], undo, (unsigned char)PAINT_XOR);
+		dbCurPaintRow(pNum, loctype), undo, (unsigned char)PAINT_XOR);
 }
 
 /*
@@ -290,6 +300,179 @@ DBCellCopyAllPaint(scx, mask, xMask, targetUse)
     DBTreeSrTiles(scx, &locMask, xMask, dbCopyAllPaint, (ClientData) &arg);
 }
 
+/*
+ *-----------------------------------------------------------------------------
+ *
+ * DBCellShareAllPaint --
+ *
+ * Like DBCellCopyAllPaint(), but where a whole plane of the root cell
+ * scx->scx_use would be copied unchanged into an empty plane of
+ * targetUse, the target plane shares the tiles of the root cell's
+ * plane instead (see TiSharePlane()).  This takes no time, and either
+ * plane gets a copy of its own when it is next painted, e.g. by the
+ * paint of the subcells, which is copied as usual afterwards.  It is
+ * meant for yank buffers and new cells whose paint is only changed
+ * through the paint procedures of the database.  As the tiles are
+ * shared, so are their ti_client fields.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Updates the paint planes in targetUse.
+ *
+ *-----------------------------------------------------------------------------
+ */
+
+struct shareAllArg
+{
+    TileTypeBitMask	*saa_mask;	/* Mask of tile types to be copied */
+    int			 saa_xMask;	/* Expansion state mask */
+    CellUse		*saa_targetUse;	/* Use to which tiles are copied */
+};
+
+void
+DBCellShareAllPaint(scx, mask, xMask, targetUse)
+    SearchContext *scx;		/* Describes root cell to search, area to
+				 * copy, transform from root cell to coords
+				 * of targetUse.
+				 */
+    TileTypeBitMask *mask;	/* Types of tiles to be yanked/stuffed */
+    int xMask;			/* Expansion state mask to be used in search */
+    CellUse *targetUse;		/* Cell into which material is to be stuffed */
+{
+    CellDef *def = scx->scx_use->cu_def;
+    CellDef *targetDef = targetUse->cu_def;
+    TileTypeBitMask locMask;
+    struct copyAllArg arg;
+    struct shareAllArg sarg;
+    PlaneMask planeMask;
+    TreeContext cxp;
+    TreeFilter filter;
+    int pNum;
+    int dbCopyAllPaint(), dbShareAllChildFunc();
+    bool dbCopyCanShare();
+
+    if (!DBDescendSubcell(scx->scx_use, xMask))
+	return;
+    if ((def->cd_flags & CDAVAILABLE) == 0)
+	if (!DBCellRead(def, (char *) NULL, TRUE, NULL)) return;
+
+    arg.caa_mask = mask;
+    arg.caa_targetUse = targetUse;
+    GEOTRANSRECT(&scx->scx_trans, &scx->scx_area, &arg.caa_rect);
+
+    /* Add any stacking types for the search (but not to mask passed as arg!) */
+    locMask = *mask;
+    DBMaskAddStacking(&locMask);
+
+    /* Build dummy TreeContext, as DBTreeSrTiles() would */
+    cxp.tc_scx = scx;
+    cxp.tc_filter = &filter;
+    filter.tf_arg = (ClientData) &arg;
+
+    /* Paint of the root cell */
+    planeMask = DBTechTypesToPlanes(&locMask);
+    for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
+	if (PlaneMaskHasPlane(planeMask, pNum))
+	{
+	    if (dbCopyCanShare(scx, mask, targetUse, pNum))
+	    {
+		TiSharePlane(targetDef->cd_planes[pNum], def->cd_planes[pNum]);
+		targetDef->cd_flags |= CDMODIFIED|CDGETNEWSTAMP;
+		continue;
+	    }
+	    cxp.tc_plane = pNum;
+	    (void) DBSrPaintArea((Tile *) NULL, def->cd_planes[pNum],
+		&scx->scx_area, &locMask, dbCopyAllPaint, (ClientData) &cxp);
+	}
+
+    /* Paint of the subcells */
+    sarg.saa_mask = mask;
+    sarg.saa_xMask = xMask;
+    sarg.saa_targetUse = targetUse;
+    (void) DBCellSrArea(scx, dbShareAllChildFunc, (ClientData) &sarg);
+}
+
+/*
+ * Called by DBCellSrArea() on behalf of DBCellShareAllPaint() for each
+ * subcell of the root cell, to copy the paint of its whole subtree.
+ */
+
+int
+dbShareAllChildFunc(scx, sarg)
+    SearchContext *scx;
+    struct shareAllArg *sarg;
+{
+    DBCellCopyAllPaint(scx, sarg->saa_mask, sarg->saa_xMask,
+		sarg->saa_targetUse);
+    return 0;
+}
+
+/*
+ *-----------------------------------------------------------------------------
+ *
+ * dbCopyCanShare --
+ *
+ * Decide whether plane pNum of targetUse can simply share the tiles of
+ * the same plane of scx->scx_use, instead of getting a copy of them.
+ * This is the case if the copy would be exact:  the transform is the
+ * identity, the area includes all paint on the plane, every type found
+ * on the plane is copied, and painting it into the empty target plane
+ * with the current paint procedure and table gives the type itself.
+ * Nothing may be recorded for undo.
+ *
+ * Results:
+ *	TRUE if the plane can be shared, FALSE otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ *-----------------------------------------------------------------------------
+ */
+
+bool
+dbCopyCanShare(scx, mask, targetUse, pNum)
+    SearchContext *scx;		/* Source cell, area, and transform */
+    TileTypeBitMask *mask;	/* Types to be copied */
+    CellUse *targetUse;		/* Cell into which they are copied */
+    int pNum;			/* Plane to be checked */
+{
+    Transform *t = &scx->scx_trans;
+    Plane *src = scx->scx_use->cu_def->cd_planes[pNum];
+    Plane *dst = targetUse->cu_def->cd_planes[pNum];
+    Tile *tile;
+    TileType type;
+    Rect bbox;
+
+    if (dbCurPaintPlane != DBPaintPlaneWrapper || dbCurPaintTbl != NULL
+	    || UndoIsEnabled())
+	return FALSE;
+    if (t->t_a != 1 || t->t_b != 0 || t->t_c != 0
+	    || t->t_d != 0 || t->t_e != 1 || t->t_f != 0)
+	return FALSE;
+    if (src == dst)
+	return FALSE;
+
+    /* The target plane must be empty */
+    tile = TR(dst->pl_left);
+    if (TR(tile) != dst->pl_right || RT(tile) != dst->pl_top
+	    || LB(tile) != dst->pl_bottom || BL(tile) != dst->pl_left
+	    || TiGetTypeExact(tile) != TT_SPACE)
+	return FALSE;
+
+    /* Nothing in the source plane may be clipped away */
+    if (!DBBoundPlane(src, &bbox) || !GEO_SURROUND(&scx->scx_area, &bbox))
+	return FALSE;
+
+    for (type = TT_SPACE + 1; type < DBNumTypes; type++)
+	if (PlaneMaskHasPlane(DBTypePlaneMaskTbl[type], pNum))
+	    if (!TTMaskHasType(mask, type)
+		    || DBStdPaintEntry(TT_SPACE, type, pNum) != type)
+		return FALSE;
+    return TRUE;
+}
+
 /*
  *-----------------------------------------------------------------------------
  *
@@ -421,7 +604,7 @@ DBCellCopyPaint(scx, mask, xMask, targetUse)
     TreeContext cxp;
     TreeFilter filter;
     struct copyAllArg arg;
-    int dbCopyAllPaint();
+    int dbCopyAllPaint(), dbCopyBuildPaint(), dbCopySplitPaint();
 
     if (!DBDescendSubcell(scx->scx_use, xMask))
 	return;
@@ -442,6 +625,32 @@ DBCellCopyPaint(scx, mask, xMask, targetUse)
 	if (PlaneMaskHasPlane(planeMask, pNum))
 	{
 	    cxp.tc_plane = pNum; /* not used? */
+
+	    /*
+	     * Yank buffers and flattening cells are usually cleared
+	     * before the copy, and don't record undo events.  An empty
+	     * target plane is then built in one pass, and only split
+	     * tiles need to be painted afterwards.
+	     */
+	    arg.caa_builder = NULL;
+	    arg.caa_nsplit = 0;
+	    if (dbCurPaintPlane == DBPaintPlaneWrapper && !UndoIsEnabled())
+		arg.caa_builder =
+			TiBuildStart(targetUse->cu_def->cd_planes[pNum]);
+	    if (arg.caa_builder != NULL)
+	    {
+		(void) DBSrPaintArea((Tile *) NULL,
+			scx->scx_use->cu_def->cd_planes[pNum], &scx->scx_area,
+			mask, dbCopyBuildPaint, (ClientData) &cxp);
+		TiBuildFinish(arg.caa_builder);
+		arg.caa_builder = NULL;
+		if (arg.caa_nsplit > 0)
+		    (void) DBSrPaintArea((Tile *) NULL,
+			scx->scx_use->cu_def->cd_planes[pNum], &scx->scx_area,
+			mask, dbCopySplitPaint, (ClientData) &cxp);
+		continue;
+	    }
+
 	    (void) DBSrPaintArea((Tile *) NULL,
 		scx->scx_use->cu_def->cd_planes[pNum], &scx->scx_area,
 		mask, dbCopyAllPaint, (ClientData) &cxp);
@@ -574,6 +783,144 @@ dbCopyManhattanPaint(tile, cxp)
 }
 
 
+/*
+ *-----------------------------------------------------------------------------
+ *
+ * dbCopyPaintType --
+ *
+ * Decide which type to paint in the target when copying a tile of
+ * type "type" on plane pNum, given the mask of types being copied.
+ * If "type" itself is not in the mask, a residue of it on pNum may be.
+ *
+ * Results:
+ *	The type to paint, or TT_SPACE if nothing is to be copied.
+ *
+ * Side effects:
+ *	None.
+ *
+ *-----------------------------------------------------------------------------
+ */
+
+TileType
+dbCopyPaintType(type, typeMask, pNum)
+    TileType type;
+    TileTypeBitMask *typeMask;
+    int pNum;
+{
+    if (!TTMaskHasType(typeMask, type))
+    {
+	TileTypeBitMask rMask, *tmask;
+
+	/* Simple case---typeMask has a residue of type on pNum */
+	tmask = DBResidueMask(type);
+	TTMaskAndMask3(&rMask, typeMask, tmask);
+	TTMaskAndMask(&rMask, &DBPlaneTypes[pNum]);
+	if (!TTMaskIsZero(&rMask))
+	{
+	    for (type = TT_TECHDEPBASE; type < DBNumUserLayers; type++)
+		if (TTMaskHasType(&rMask, type))
+		    break;
+	    if (type == DBNumUserLayers) return TT_SPACE; /* shouldn't happen */
+
+	    /* Hopefully there's always just one type here---sanity check */
+	    TTMaskClearType(&rMask, type);
+	    if (!TTMaskIsZero(&rMask))
+	    {
+		/* Diagnostic */
+		TxError("Bad assumption:  Multiple types to paint!  Fix me!\n");
+	    }
+	}
+	else
+	{
+	    type = DBPlaneToResidue(type, pNum);
+	    if (!TTMaskHasType(typeMask, type)) return TT_SPACE;
+	}
+    }
+    return type;
+}
+
+/*
+ *-----------------------------------------------------------------------------
+ *
+ * dbCopyBuildPaint --
+ *
+ * Filter function for DBCellCopyPaint() when the target plane is
+ * empty.  Manhattan tiles are clipped, transformed, and given to the
+ * plane builder in arg->caa_builder;  split tiles are only counted,
+ * and are painted by dbCopySplitPaint() once the plane is built.
+ *
+ * Results:
+ *	Always returns 0 to keep the search going.
+ *
+ * Side effects:
+ *	Adds a rectangle to the plane builder.
+ *
+ *-----------------------------------------------------------------------------
+ */
+
+int
+dbCopyBuildPaint(tile, cxp)
+    Tile *tile;
+    TreeContext *cxp;
+{
+    SearchContext *scx = cxp->tc_scx;
+    struct copyAllArg *arg = (struct copyAllArg *) cxp->tc_filter->tf_arg;
+    int pNum = cxp->tc_plane;
+    Rect sourceRect, targetRect;
+    TileType type;
+
+    if (IsSplit(tile))
+    {
+	arg->caa_nsplit++;
+	return 0;
+    }
+
+    type = dbCopyPaintType(TiGetTypeExact(tile), arg->caa_mask, pNum);
+    if (type == TT_SPACE)
+	return 0;
+
+    TITORECT(tile, &sourceRect);
+    GEOTRANSRECT(&scx->scx_trans, &sourceRect, &targetRect);
+    GEOCLIP(&targetRect, &arg->caa_rect);
+    if (GEO_RECTNULL(&targetRect))
+	return 0;
+
+    arg->caa_targetUse->cu_def->cd_flags |= CDMODIFIED|CDGETNEWSTAMP;
+    TiBuildRect(arg->caa_builder, &targetRect,
+		(ClientData)(spointertype) dbCurPaintRow(pNum, type)[TT_SPACE]);
+    return 0;
+}
+
+int dbCopyAllPaint();
+
+/*
+ *-----------------------------------------------------------------------------
+ *
+ * dbCopySplitPaint --
+ *
+ * Filter function for the second pass of DBCellCopyPaint() over a
+ * plane filled by the plane builder:  paint the split tiles that
+ * dbCopyBuildPaint() left out.
+ *
+ * Results:
+ *	Always returns 0 to keep the search going.
+ *
+ * Side effects:
+ *	Paints into the target plane.
+ *
+ *-----------------------------------------------------------------------------
+ */
+
+int
+dbCopySplitPaint(tile, cxp)
+    Tile *tile;
+    TreeContext *cxp;
+{
+    if (!IsSplit(tile))
+	return 0;
+    return dbCopyAllPaint(tile, cxp);
+}
+
 /***
  *** Filter function for paint
  ***/
@@ -617,35 +964,9 @@ dbCopyAllPaint(tile, cxp)
     typeMask = arg->caa_mask;
 
     /* Resolve what type we're going to paint, based on the type and mask */
-    if (!TTMaskHasType(typeMask, type))
-    {
-	TileTypeBitMask rMask, *tmask;
-
-	/* Simple case---typeMask has a residue of type on pNum */
-	tmask = DBResidueMask(type);
-	TTMaskAndMask3(&rMask, typeMask, tmask);
-	TTMaskAndMask(&rMask, &DBPlaneTypes[pNum]);
-	if (!TTMaskIsZero(&rMask))
-	{
-	    for (type = TT_TECHDEPBASE; type < DBNumUserLayers; type++)
-		if (TTMaskHasType(&rMask, type))
-		    break;
-	    if (type == DBNumUserLayers) return 0;	/* shouldn't happen */
-
-	    /* Hopefully there's always just one type here---sanity check */
-	    TTMaskClearType(&rMask, type);
-	    if (!TTMaskIsZero(&rMask))
-	    {
-		/* Diagnostic */
-		TxError("Bad assumption:  Multiple types to paint!  Fix me!\n");
-	    }
-	}
-	else
-	{
-	    type = DBPlaneToResidue(type, pNum);
-	    if (!TTMaskHasType(typeMask, type)) return 0;
-	}
-    }
+    type = dbCopyPaintType(type, typeMask, pNum);
+    if (type == TT_SPACE)
+	return 0;
 
     /* Construct the rect for the tile in source coordinates */
     TITORECT(tile, &sourceRect);
@@ -978,9 +1299,8 @@ dbCellCopyCellsFunc(scx, arg)
  *	value with another call to this procedure.
  *
  * Side effects:
- *	A new paint table takes effect.  However, if newTable is NULL,
- *	then the old paint table remains active.  This allows one to
- *	get a pointer to the active paint table without altering it.
+ *	A new paint table takes effect.  If newTable is NULL, the
+ *	standard paint table (DBPaintResultTbl) takes effect.
  *
  * ----------------------------------------------------------------------------
  */
@@ -990,7 +1310,7 @@ DBNewPaintTable(newTable))[NT][NT]
     PaintResultType (*newTable)[NT][NT];  /* Address of new paint table. */
 {
     PaintResultType (*oldTable)[NT][NT] = dbCurPaintTbl;
-    if (newTable) dbCurPaintTbl = newTable;
+    dbCurPaintTbl = newTable;
     return oldTable;
 }
 
@@ -0,0 +1,541 @@
+/*
+ * DBcellindex.c --
+ *
+ * Spatial index of the subcell uses of a CellDef.
+ *
+ * The subcell tile plane of a CellDef splits into many small tiles
+ * wherever uses overlap, and every tile carries a list of all the
+ * uses covering it.  With thousands of abutting or overlapping
+ * standard cells this makes area searches over the subcells slow.
+ * The index kept here is used instead for the searches themselves
+ * (DBCellSrArea(), DBCellEnum(), and friends);  the tile plane is
+ * still maintained for code that walks its tiles.
+ *
+ * The index is a stack of uniform bin grids over the area occupied
+ * by the uses.  The bins of level 0 have size ci_size[0], and each
+ * further level has bins twice the size of the level below.  Each
+ * use is kept in exactly one bin:  the one containing the lower-left
+ * corner of its bounding box, at the lowest level whose bins are at
+ * least as large as the use.  An area search then only needs to look
+ * at the bins within one bin size of the search area at each level.
+ * Uses that don't fit in the grids, e.g. because they were placed
+ * outside the area covered, are kept on a separate list, and the
+ * grids are rebuilt when the index has grown enough.
+ *
+ * Defs with only a few uses don't get any grids at all;  their uses
+ * are just kept on the separate list.
+ *
+ * Searches report the uses they find in the order in which the uses
+ * were placed in the def, which for a def read from disk is the order
+ * of the .mag file.  So the order in which uses are visited, and with
+ * it the output of the extractor and of the layout writers, doesn't
+ * depend on how the uses happen to fall into bins.
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/magic.h"
+#include "utils/geometry.h"
+#include "utils/malloc.h"
+#include "tiles/tile.h"
+#include "utils/hash.h"
+#include "database/database.h"
+#include "database/databaseInt.h"
+
+/* Maximum number of bin levels */
+#define CI_MAXLEVELS	30
+
+/* Number of uses a def may have before any grids are built */
+#define CI_MINUSES	32
+
+typedef struct cellindex
+{
+    Rect	  ci_area;		/* Area covered by the grids */
+    int		  ci_levels;		/* Number of grid levels */
+    int		  ci_size[CI_MAXLEVELS];  /* Bin size at each level */
+    int		  ci_nx[CI_MAXLEVELS];	  /* Bins across at each level */
+    int		  ci_ny[CI_MAXLEVELS];	  /* Bins up at each level */
+    CellUse	**ci_bins[CI_MAXLEVELS];  /* Bin lists, row by row */
+    CellUse	 *ci_other;		/* Uses not in any bin */
+    int		  ci_count;		/* Number of uses in the index */
+    int		  ci_lastCount;		/* ci_count at the last rebuild */
+    int		  ci_otherAdds;		/* Uses put on ci_other since then */
+    int		  ci_otherBase;		/* Size of ci_other after rebuild */
+    unsigned int  ci_nextOrder;		/* cu_order of the next use placed */
+} CellIndex;
+
+/* Number of uses a search can collect before it allocates memory */
+#define CI_FOUND	64
+
+/* Link a use at the head of a bin list */
+#define	CI_LINK(use, head) \
+    { \
+	if (((use)->cu_binNext = *(head)) != NULL) \
+	    (*(head))->cu_binPrev = &(use)->cu_binNext; \
+	*(head) = (use); \
+	(use)->cu_binPrev = (head); \
+    }
+
+/*
+ * Add a use to the array being collected in the local variables of
+ * dbCellIndexSearch(), moving it to a larger block when it is full.
+ */
+#define	CI_FOUNDUSE(u) \
+    { \
+	if (n == max) \
+	{ \
+	    newuses = (CellUse **) mallocMagic(2 * max * sizeof (CellUse *)); \
+	    memcpy((char *) newuses, (char *) uses, max * sizeof (CellUse *)); \
+	    if (uses != found) freeMagic((char *) uses); \
+	    uses = newuses; \
+	    max *= 2; \
+	} \
+	uses[n++] = (u); \
+    }
+
+void dbCellIndexRebuild();
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbCellIndexBin --
+ *
+ * Find the bin list in which a use belongs.
+ *
+ * Results:
+ *	Pointer to the head of the bin list, or to ci->ci_other if
+ *	the use doesn't fit in any of the grids.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+CellUse **
+dbCellIndexBin(ci, use)
+    CellIndex *ci;
+    CellUse *use;
+{
+    Rect *bbox = &use->cu_bbox;
+    int level, size, ix, iy;
+
+    if (ci->ci_levels == 0
+	    || bbox->r_xbot < ci->ci_area.r_xbot
+	    || bbox->r_xbot >= ci->ci_area.r_xtop
+	    || bbox->r_ybot < ci->ci_area.r_ybot
+	    || bbox->r_ybot >= ci->ci_area.r_ytop)
+	return &ci->ci_other;
+
+    for (level = 0; level < ci->ci_levels; level++)
+    {
+	size = ci->ci_size[level];
+	if ((dlong) bbox->r_xtop - bbox->r_xbot <= size
+		&& (dlong) bbox->r_ytop - bbox->r_ybot <= size)
+	{
+	    ix = (int)(((dlong) bbox->r_xbot - ci->ci_area.r_xbot) / size);
+	    iy = (int)(((dlong) bbox->r_ybot - ci->ci_area.r_ybot) / size);
+	    return &ci->ci_bins[level][iy * ci->ci_nx[level] + ix];
+	}
+    }
+    return &ci->ci_other;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbCellIndexInsert --
+ *
+ * Add a use to the index of its parent def.  Called by DBPlaceCell().
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Allocates the index if the def doesn't have one yet.  May
+ *	rebuild the grids of the index.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbCellIndexInsert(def, use)
+    CellDef *def;	/* Parent def */
+    CellUse *use;	/* Use being placed in def */
+{
+    CellIndex *ci = def->cd_cellIndex;
+    CellUse **head;
+
+    if (ci == NULL)
+    {
+	ci = (CellIndex *) mallocMagic(sizeof (CellIndex));
+	bzero((char *) ci, sizeof (CellIndex));
+	def->cd_cellIndex = ci;
+    }
+
+    /*
+     * A use that was taken out and put back, as when its bounding box
+     * changes or it is moved, keeps its old place in the order.
+     */
+    if (use->cu_order == 0)
+	use->cu_order = ++ci->ci_nextOrder;
+    else if (use->cu_order > ci->ci_nextOrder)
+	ci->ci_nextOrder = use->cu_order;
+    head = dbCellIndexBin(ci, use);
+    CI_LINK(use, head);
+    ci->ci_count++;
+    if (head == &ci->ci_other)
+	ci->ci_otherAdds++;
+
+    /*
+     * Rebuild once the number of uses has doubled, or too many uses
+     * have missed the grids.  Searches collect the uses they find
+     * before visiting any of them, so this is safe even when called
+     * from a search.
+     */
+
+    if (ci->ci_count > CI_MINUSES
+	    && (ci->ci_count > 2 * ci->ci_lastCount
+		|| ci->ci_otherAdds > ci->ci_otherBase + ci->ci_count / 8
+				+ CI_MINUSES))
+	dbCellIndexRebuild(def);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbCellIndexDelete --
+ *
+ * Remove a use from the index of its parent def.  Called by
+ * DBDeleteCell().
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Unlinks the use from its bin.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbCellIndexDelete(def, use)
+    CellDef *def;	/* Parent def */
+    CellUse *use;	/* Use being removed from def */
+{
+    CellIndex *ci = def->cd_cellIndex;
+
+    if (ci == NULL || use->cu_binPrev == NULL)
+	return;
+
+    if ((*use->cu_binPrev = use->cu_binNext) != NULL)
+	use->cu_binNext->cu_binPrev = use->cu_binPrev;
+    use->cu_binNext = NULL;
+    use->cu_binPrev = NULL;
+    ci->ci_count--;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbCellIndexFree --
+ *
+ * Throw away the index of a def.  Used when all of the def's subcells
+ * are being deleted, so the uses themselves are not touched.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Frees the index, and sets def->cd_cellIndex to NULL.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbCellIndexFree(def)
+    CellDef *def;
+{
+    CellIndex *ci = def->cd_cellIndex;
+    int level;
+
+    if (ci == NULL)
+	return;
+    for (level = 0; level < ci->ci_levels; level++)
+	freeMagic((char *) ci->ci_bins[level]);
+    freeMagic((char *) ci);
+    def->cd_cellIndex = (CellIndex *) NULL;
+}
+
+/*
+ * Comparison procedure for qsort() used by dbCellIndexRebuild()
+ */
+
+int
+dbCellIndexSizeCmp(p1, p2)
+    int *p1, *p2;
+{
+    return (*p1 < *p2) ? -1 : (*p1 > *p2) ? 1 : 0;
+}
+
+/*
+ * Comparison procedure for qsort() used by dbCellIndexSearch()
+ */
+
+int
+dbCellIndexOrderCmp(p1, p2)
+    CellUse **p1, **p2;
+{
+    char *id1, *id2;
+
+    if ((*p1)->cu_order != (*p2)->cu_order)
+	return ((*p1)->cu_order < (*p2)->cu_order) ? -1 : 1;
+
+    /* Only a use moved in from another parent can tie */
+    id1 = (*p1)->cu_id ? (*p1)->cu_id : "";
+    id2 = (*p2)->cu_id ? (*p2)->cu_id : "";
+    return strcmp(id1, id2);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbCellIndexRebuild --
+ *
+ * Recompute the grids of a def's index from scratch, to fit the
+ * current positions and sizes of its uses.  This is called
+ * automatically as the index grows, and must be called explicitly
+ * by anything that changes the bounding boxes of placed uses
+ * behind the back of DBPlaceCell()/DBDeleteCell().
+ *
+ * The level 0 bin size is the median size of the uses, enlarged
+ * if need be so that there are not many more bins than uses.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Reallocates the bin lists.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbCellIndexRebuild(def)
+    CellDef *def;
+{
+    CellIndex *ci = def->cd_cellIndex;
+    CellUse **uses, *use, **head;
+    int *sizes;
+    int n, i, level, nbins;
+    dlong width, height, size, w, h;
+    Rect area;
+
+    if (ci == NULL)
+	return;
+
+    /* Collect all the uses, from the grids and from the other list */
+    uses = (CellUse **) mallocMagic((ci->ci_count + 1) * sizeof (CellUse *));
+    sizes = (int *) mallocMagic((ci->ci_count + 1) * sizeof (int));
+    n = 0;
+    for (level = 0; level < ci->ci_levels; level++)
+    {
+	nbins = ci->ci_nx[level] * ci->ci_ny[level];
+	for (i = 0; i < nbins; i++)
+	    for (use = ci->ci_bins[level][i]; use; use = use->cu_binNext)
+		uses[n++] = use;
+	freeMagic((char *) ci->ci_bins[level]);
+    }
+    for (use = ci->ci_other; use; use = use->cu_binNext)
+	uses[n++] = use;
+    ASSERT(n == ci->ci_count, "dbCellIndexRebuild");
+
+    ci->ci_levels = 0;
+    ci->ci_other = NULL;
+    ci->ci_lastCount = n;
+    ci->ci_otherAdds = 0;
+
+    /* Area covered by the lower-left corners, and median use size */
+    area = GeoNullRect;
+    for (i = 0; i < n; i++)
+    {
+	Rect *bbox = &uses[i]->cu_bbox;
+
+	w = (dlong) bbox->r_xtop - bbox->r_xbot;
+	h = (dlong) bbox->r_ytop - bbox->r_ybot;
+	sizes[i] = (int) MIN(MAX(w, h), INFINITY);
+	if (i == 0)
+	{
+	    area.r_ll = bbox->r_ll;
+	    area.r_ur = bbox->r_ll;
+	}
+	else
+	    GeoIncludePoint(&bbox->r_ll, &area);
+    }
+
+    if (n > CI_MINUSES)
+    {
+	area.r_xtop++;
+	area.r_ytop++;
+	width = (dlong) area.r_xtop - area.r_xbot;
+	height = (dlong) area.r_ytop - area.r_ybot;
+
+	qsort((char *) sizes, n, sizeof (int), dbCellIndexSizeCmp);
+	size = MAX(sizes[n / 2], 1);
+	while (((width + size - 1) / size) * ((height + size - 1) / size)
+		> 2 * (dlong) n)
+	    size *= 2;
+
+	ci->ci_area = area;
+	for (level = 0; level < CI_MAXLEVELS && size <= INFINITY; level++)
+	{
+	    ci->ci_size[level] = (int) size;
+	    ci->ci_nx[level] = (int)((width + size - 1) / size);
+	    ci->ci_ny[level] = (int)((height + size - 1) / size);
+	    nbins = ci->ci_nx[level] * ci->ci_ny[level];
+	    ci->ci_bins[level] = (CellUse **)
+			mallocMagic(nbins * sizeof (CellUse *));
+	    bzero((char *) ci->ci_bins[level], nbins * sizeof (CellUse *));
+	    ci->ci_levels = level + 1;
+
+	    /* Stop at the first level large enough for every use */
+	    if (size >= sizes[n - 1]) break;
+	    size *= 2;
+	}
+    }
+
+    for (i = 0; i < n; i++)
+    {
+	head = dbCellIndexBin(ci, uses[i]);
+	CI_LINK(uses[i], head);
+	if (head == &ci->ci_other)
+	    ci->ci_otherAdds++;
+    }
+    ci->ci_otherBase = ci->ci_otherAdds;
+    ci->ci_otherAdds = 0;
+
+    freeMagic((char *) uses);
+    freeMagic((char *) sizes);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbCellIndexSearch --
+ *
+ * Apply a procedure to each use in a def whose bounding box touches
+ * or overlaps an area.  The area is in the coordinates of the def;
+ * if it is NULL, every use in the def is visited.  Uses are visited
+ * in the order in which they were placed in the def.  The procedure
+ * should be of the following form:
+ *
+ *	int
+ *	func(use, cdarg)
+ *	    CellUse *use;
+ *	    ClientData cdarg;
+ *	{
+ *	}
+ *
+ * Func returns 0 normally, or 1 to abort the search.  It may delete
+ * the use it was passed, but no other use of the same def.  Uses it
+ * places in the def are not visited.
+ *
+ * Results:
+ *	0 if the search completed, 1 if it was aborted.
+ *
+ * Side effects:
+ *	Whatever func does.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbCellIndexSearch(def, area, func, cdarg)
+    CellDef *def;		/* Def whose subcells are searched */
+    Rect *area;			/* Area to search, or NULL */
+    int (*func)();		/* Applied to each use found */
+    ClientData cdarg;		/* Passed to func */
+{
+    CellIndex *ci = def->cd_cellIndex;
+    CellUse *found[CI_FOUND], **uses, **newuses, *use;
+    int level, size, nx, ix, iy, ixlo, ixhi, iylo, iyhi;
+    int n, max, i;
+    int result = 0;
+
+    if (ci == NULL)
+	return 0;
+
+    uses = found;
+    max = CI_FOUND;
+    n = 0;
+
+    for (level = 0; level < ci->ci_levels; level++)
+    {
+	size = ci->ci_size[level];
+	nx = ci->ci_nx[level];
+	if (area == NULL)
+	{
+	    ixlo = iylo = 0;
+	    ixhi = nx - 1;
+	    iyhi = ci->ci_ny[level] - 1;
+	}
+	else
+	{
+	    /*
+	     * Uses at this level are no larger than a bin, so the ones
+	     * reaching the area have their lower-left corner no more
+	     * than one bin size to the left of or below it.
+	     */
+	    if (area->r_xtop < ci->ci_area.r_xbot
+		    || area->r_ytop < ci->ci_area.r_ybot)
+		break;
+	    ixlo = (int) MAX(((dlong) area->r_xbot - size
+			- ci->ci_area.r_xbot) / size, 0);
+	    iylo = (int) MAX(((dlong) area->r_ybot - size
+			- ci->ci_area.r_ybot) / size, 0);
+	    ixhi = (int) MIN(((dlong) area->r_xtop
+			- ci->ci_area.r_xbot) / size, nx - 1);
+	    iyhi = (int) MIN(((dlong) area->r_ytop
+			- ci->ci_area.r_ybot) / size, ci->ci_ny[level] - 1);
+	}
+
+	for (iy = iylo; iy <= iyhi; iy++)
+	    for (ix = ixlo; ix <= ixhi; ix++)
+		for (use = ci->ci_bins[level][iy * nx + ix]; use;
+			use = use->cu_binNext)
+		    if (area == NULL || GEO_TOUCH(&use->cu_bbox, area))
+			CI_FOUNDUSE(use);
+    }
+
+    for (use = ci->ci_other; use; use = use->cu_binNext)
+	if (area == NULL || GEO_TOUCH(&use->cu_bbox, area))
+	    CI_FOUNDUSE(use);
+
+    if (n > 1)
+	qsort((char *) uses, n, sizeof (CellUse *), dbCellIndexOrderCmp);
+
+    for (i = 0; i < n; i++)
+	if ((*func)(uses[i], cdarg))
+	{
+	    result = 1;
+	    break;
+	}
+
+    if (uses != found)
+	freeMagic((char *) uses);
+    return result;
+}
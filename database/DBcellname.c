@@ -1317,6 +1317,9 @@ DBCellDefAlloc()
     cellDef->cd_timestamp = 0;
     TTMaskZero(&cellDef->cd_types);
     HashInit(&cellDef->cd_idHash, 16, HT_STRINGKEYS);
+    cellDef->cd_cellIndex = NULL;
+    cellDef->cd_connIndex = NULL;
+    cellDef->cd_labelIndex = NULL;
 
     cellDef->cd_planes[PL_CELL] = DBNewPlane((ClientData) NULL);
     for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
@@ -1379,6 +1382,9 @@ DBCellNewUse(cellDef, useName)
      * they like, but should restore its value to CLIENTDEFAULT before exiting.) 
      */
     cellUse->cu_client = (ClientData) CLIENTDEFAULT;
+    cellUse->cu_binNext = (CellUse *) NULL;
+    cellUse->cu_binPrev = (CellUse **) NULL;
+    cellUse->cu_order = 0;
 
     cellDef->cd_parents = cellUse;
     DBComputeUseBbox(cellUse);
@@ -1514,6 +1520,8 @@ DBCellDefFree(cellDef)
     SigDisableInterrupts();
     DBFreeCellPlane(cellDef->cd_planes[PL_CELL]);
     TiFreePlane(cellDef->cd_planes[PL_CELL]);
+    dbCellIndexFree(cellDef);
+    DBConnIndexFree(cellDef);
 
     for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
     {
@@ -1522,6 +1530,7 @@ DBCellDefFree(cellDef)
 	cellDef->cd_planes[pNum] = (Plane *) NULL;
     }
 
+    DBLabelIndexFree(cellDef);
     for (lab = cellDef->cd_labels; lab; lab = lab->lab_next)
 	freeMagic((char *) lab);
     SigEnableInterrupts();
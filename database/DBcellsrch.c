@@ -21,6 +21,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #endif  /* not lint */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "utils/magic.h"
 #include "utils/malloc.h"
@@ -35,6 +36,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "windows/windows.h"
 #include "utils/main.h"
 #include "mzrouter/mzrouter.h"
+#include "utils/workers.h"
 
 /* Quick hack for dbScalePlanes() access to the CIF/GDS paint table */
 
@@ -42,6 +44,18 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 extern PaintResultType CIFPaintTable[];
 #endif
 
+/*
+ * DBCellSrArea() and DBCellEnum() normally find subcells through the
+ * cell index (DBcellindex.c), and visit them in the order they were
+ * placed.  While DBCellPlaneSearch is TRUE they walk the subcell tile
+ * plane instead, and visit the uses in the order of its tiles.  That
+ * is slower, but it is the order that magic has always used.  The
+ * extractor depends on it (see extCellFile()).  Note that within a tile
+ * the uses are kept sorted by address (see DBcell.c), so this order
+ * is only as repeatable as the heap layout.
+ */
+bool DBCellPlaneSearch = FALSE;
+
 /*
  * The following structure is used to accumulate information about
  * the types of tiles visible underneath a given point in the database.
@@ -516,6 +530,7 @@ DBTreeSrLabels(scx, mask, xMask, tpath, flags, func, cdarg)
 {
     SearchContext scx2;
     Label *lab;
+    LabelSearch ls;
     Rect *r = &scx->scx_area;
     CellUse *cellUse = scx->scx_use;
     CellDef *def = cellUse->cu_def;
@@ -528,7 +543,7 @@ DBTreeSrLabels(scx, mask, xMask, tpath, flags, func, cdarg)
     if ((def->cd_flags & CDAVAILABLE) == 0)
 	if (!DBCellRead(def, (char *) NULL, TRUE, NULL)) return 0;
 
-    for (lab = def->cd_labels; lab; lab = lab->lab_next)
+    for (lab = dbLabelSrFirst(def, r, &ls); lab; lab = dbLabelSrNext(&ls))
     {
 	if (SigInterruptPending) break;
 	is_touching = FALSE;
@@ -574,8 +589,12 @@ DBTreeSrLabels(scx, mask, xMask, tpath, flags, func, cdarg)
 
 	if (is_touching && TTMaskHasType(mask, lab->lab_type))
 	    if ((*func)(scx, lab, tpath, cdarg))
+	    {
+		dbLabelSrDone(&ls);
 		return (1);
+	    }
     }
+    dbLabelSrDone(&ls);
 
     filter.tf_func = func;
     filter.tf_arg = cdarg;
@@ -617,6 +636,7 @@ dbCellLabelSrFunc(scx, fp)
     TreeFilter *fp;
 {
     Label *lab;
+    LabelSearch ls;
     Rect *r = &scx->scx_area;
     TileTypeBitMask *mask = fp->tf_mask;
     CellDef *def = scx->scx_use->cu_def;
@@ -646,7 +666,7 @@ dbCellLabelSrFunc(scx, fp)
     /* Apply the function first to any of the labels in this def. */
 
     result = 0;
-    for (lab = def->cd_labels; lab; lab = lab->lab_next)
+    for (lab = dbLabelSrFirst(def, r, &ls); lab; lab = dbLabelSrNext(&ls))
     {
 	has_overlap = FALSE;
 	if ((lab->lab_font < 0) || (fp->tf_flags & TF_LABEL_ATTACH))
@@ -658,11 +678,13 @@ dbCellLabelSrFunc(scx, fp)
 	{
 	    if ((*fp->tf_func)(scx, lab, fp->tf_tpath, fp->tf_arg))
 	    {
+		dbLabelSrDone(&ls);
 		result = 1;
 		goto cleanup;
 	    }
 	}
     }
+    dbLabelSrDone(&ls);
 
     /* Now visit each child use recursively */
     if (DBCellSrArea(scx, dbCellLabelSrFunc, (ClientData) fp))
@@ -983,8 +1005,9 @@ DBIsAncestor(cellDef1, cellDef2)
  * DBCellSrArea --
  *
  * Apply the supplied procedure to each of the cellUses found in the
- * given area in the subcell plane of the child def of the supplied
- * search context.
+ * given area in the cell index of the child def of the supplied
+ * search context (or in its subcell tile plane, if DBCellPlaneSearch
+ * is set).
  *
  * The procedure is applied to each array element in each cell use that
  * overlaps the clipping rectangle.  The scx_x and scx_y parts of
@@ -1031,7 +1054,7 @@ DBCellSrArea(scx, func, cdarg)
     TreeFilter filter;
     TreeContext context;
     Rect expanded;
-    int dbCellSrFunc();
+    int dbCellSrFunc(), dbCellPlaneSrFunc();
 
     filter.tf_func = func;
     filter.tf_arg = cdarg;
@@ -1041,40 +1064,122 @@ DBCellSrArea(scx, func, cdarg)
     if ((scx->scx_use->cu_def->cd_flags & CDAVAILABLE) == 0)
 	if (!DBCellRead(scx->scx_use->cu_def, (char *) NULL, TRUE, NULL))
 	    return 0;
-    
-    /* In order to make this work with zero-size areas, we first expand
-     * the area by before searching the tile plane.  DbCellSrFunc will
-     * check carefully to throw out things that don't overlap the original
-     * area.  The expansion is tricky because we mustn't expand infinities.
-     */
 
-    expanded = scx->scx_area;
-    if (expanded.r_xbot > TiPlaneRect.r_xbot) expanded.r_xbot -= 1;
-    if (expanded.r_ybot > TiPlaneRect.r_ybot) expanded.r_ybot -= 1;
-    if (expanded.r_xtop < TiPlaneRect.r_xtop) expanded.r_xtop += 1;
-    if (expanded.r_ytop < TiPlaneRect.r_ytop) expanded.r_ytop += 1;
+    if (DBCellPlaneSearch)
+    {
+	/* In order to make this work with zero-size areas, we first
+	 * expand the area by one before searching the tile plane.
+	 * dbCellPlaneSrFunc will check carefully to throw out things
+	 * that don't overlap the original area.  The expansion is
+	 * tricky because we mustn't expand infinities.
+	 */
 
-    if (TiSrArea((Tile *) NULL, scx->scx_use->cu_def->cd_planes[PL_CELL],
-		&expanded, dbCellSrFunc, (ClientData) &context))
-	return 1;
-    else return 0;
+	expanded = scx->scx_area;
+	if (expanded.r_xbot > TiPlaneRect.r_xbot) expanded.r_xbot -= 1;
+	if (expanded.r_ybot > TiPlaneRect.r_ybot) expanded.r_ybot -= 1;
+	if (expanded.r_xtop < TiPlaneRect.r_xtop) expanded.r_xtop += 1;
+	if (expanded.r_ytop < TiPlaneRect.r_ytop) expanded.r_ytop += 1;
+
+	if (TiSrArea((Tile *) NULL, scx->scx_use->cu_def->cd_planes[PL_CELL],
+		&expanded, dbCellPlaneSrFunc, (ClientData) &context))
+	    return 1;
+	else return 0;
+    }
+
+    return dbCellIndexSearch(scx->scx_use->cu_def, &scx->scx_area,
+		dbCellSrFunc, (ClientData) &context);
 }
-
+
 /*
  *-----------------------------------------------------------------------------
  *
  * dbCellSrFunc --
  *
  * Filter procedure for DBCellSrArea.  Applies the procedure given
- * to DBCellSrArea to any of the CellUses in the tile that are
- * enumerable.
+ * to DBCellSrArea to each array element of a CellUse found in the
+ * cell index that overlaps the search area.
+ *
+ * The index also reports uses that only touch the search area;
+ * these are skipped here.  Zero-size search areas are handled by
+ * the same test:  a use is found if the area lies inside it.
+ *
+ * Results:
+ *	0 is normally returned, and 1 is returned if an abort occurred.
+ *
+ * Side effects:
+ *	Whatever side effects are brought about by applying the
+ *	procedure supplied.
+ *
+ *-----------------------------------------------------------------------------
+ */
+
+int
+dbCellSrFunc(use, cxp)
+    CellUse *use;
+    TreeContext *cxp;
+{
+    TreeFilter *fp = cxp->tc_filter;
+    SearchContext *scx = cxp->tc_scx;
+    SearchContext newScx;
+    Transform t, tinv;
+    int xlo, xhi, ylo, yhi, xbase, ybase, xsep, ysep, clientResult;
+
+    if (!GEO_OVERLAP(&use->cu_bbox, &scx->scx_area)) return 0;
+    newScx.scx_use = use;
+
+    /* If not an array element, life is much simpler */
+    if (use->cu_xlo == use->cu_xhi && use->cu_ylo == use->cu_yhi)
+    {
+	newScx.scx_x = use->cu_xlo, newScx.scx_y = use->cu_yhi;
+	if (SigInterruptPending) return 1;
+	GEOINVERTTRANS(&use->cu_transform, &tinv);
+	GeoTransTrans(&use->cu_transform, &scx->scx_trans,
+			&newScx.scx_trans);
+	GEOTRANSRECT(&tinv, &scx->scx_area, &newScx.scx_area);
+	if ((*fp->tf_func)(&newScx, fp->tf_arg) == 1)
+	    return 1;
+	return 0;
+    }
+
+    /*
+     * More than a single array element;
+     * check to see which ones overlap our search area.
+     */
+    DBArrayOverlap(use, &scx->scx_area, &xlo, &xhi, &ylo, &yhi);
+    xsep = (use->cu_xlo > use->cu_xhi) ? -use->cu_xsep : use->cu_xsep;
+    ysep = (use->cu_ylo > use->cu_yhi) ? -use->cu_ysep : use->cu_ysep;
+    for (newScx.scx_y = ylo; newScx.scx_y <= yhi; newScx.scx_y++)
+	for (newScx.scx_x = xlo; newScx.scx_x <= xhi; newScx.scx_x++)
+	{
+	    if (SigInterruptPending) return 1;
+	    xbase = xsep * (newScx.scx_x - use->cu_xlo);
+	    ybase = ysep * (newScx.scx_y - use->cu_ylo);
+	    GeoTransTranslate(xbase, ybase, &use->cu_transform, &t);
+	    GEOINVERTTRANS(&t, &tinv);
+	    GeoTransTrans(&t, &scx->scx_trans, &newScx.scx_trans);
+	    GEOTRANSRECT(&tinv, &scx->scx_area, &newScx.scx_area);
+	    clientResult = (*fp->tf_func)(&newScx, fp->tf_arg);
+	    if (clientResult == 2) return 0;
+	    else if (clientResult == 1) return 1;
+	}
+    return 0;
+}
+
+/*
+ *-----------------------------------------------------------------------------
+ *
+ * dbCellPlaneSrFunc --
+ *
+ * Filter procedure for DBCellSrArea when DBCellPlaneSearch is set.
+ * Applies the procedure given to DBCellSrArea to any of the CellUses
+ * in the tile that are enumerable.
  *
  * Since subcells are allowed to overlap, a single tile body may
  * refer to many subcells and a single subcell may be referred to
  * by many tile bodies.  To insure that each CellUse is enumerated
  * exactly once, the procedure given to DBCellSrArea is only applied
  * to a CellUse when its lower right corner is contained in the
- * tile to dbCellSrFunc (or otherwise at the last tile encountered
+ * tile to dbCellPlaneSrFunc (or otherwise at the last tile encountered
  * in the event the lower right corner of the CellUse is outside the
  * search rectangle).
  *
@@ -1089,20 +1194,16 @@ DBCellSrArea(scx, func, cdarg)
  */
 
 int
-dbCellSrFunc(tile, cxp)
+dbCellPlaneSrFunc(tile, cxp)
     Tile *tile;
     TreeContext *cxp;
 {
-    TreeFilter *fp = cxp->tc_filter;
     SearchContext *scx = cxp->tc_scx;
     CellUse *use;
     Rect *bbox;
     CellTileBody *body;
-    SearchContext newScx;
-    Transform t, tinv;
     Rect tileArea;
     int srchBot, srchRight;
-    int xlo, xhi, ylo, yhi, xbase, ybase, xsep, ysep, clientResult;
 
     srchBot = scx->scx_area.r_ybot;
     srchRight = scx->scx_area.r_xtop;
@@ -1119,8 +1220,8 @@ dbCellSrFunc(tile, cxp)
 	    body != NULL;
 	    body = body->ctb_next)
     {
-	use = newScx.scx_use = body->ctb_use;
-	ASSERT(use != (CellUse *) NULL, "dbCellSrFunc");
+	use = body->ctb_use;
+	ASSERT(use != (CellUse *) NULL, "dbCellPlaneSrFunc");
 
 	/* The check below is to ensure that we only enumerate each
 	 * cell once, even though it appears in many different tiles
@@ -1133,55 +1234,22 @@ dbCellSrFunc(tile, cxp)
 	    && (tileArea.r_xtop >= bbox->r_xtop ||
 		(tileArea.r_xtop >= srchRight && bbox->r_xtop >= srchRight)))
 	{
-	    /* If not an array element, life is much simpler */
-	    if (use->cu_xlo == use->cu_xhi && use->cu_ylo == use->cu_yhi)
-	    {
-		newScx.scx_x = use->cu_xlo, newScx.scx_y = use->cu_yhi;
-		if (SigInterruptPending) return 1;
-		GEOINVERTTRANS(&use->cu_transform, &tinv);
-		GeoTransTrans(&use->cu_transform, &scx->scx_trans,
-				&newScx.scx_trans);
-		GEOTRANSRECT(&tinv, &scx->scx_area, &newScx.scx_area);
-		if ((*fp->tf_func)(&newScx, fp->tf_arg) == 1)
-		    return 1;
-		continue;
-	    }
-
-	    /*
-	     * More than a single array element;
-	     * check to see which ones overlap our search area.
-	     */
-	    DBArrayOverlap(use, &scx->scx_area, &xlo, &xhi, &ylo, &yhi);
-	    xsep = (use->cu_xlo > use->cu_xhi) ? -use->cu_xsep : use->cu_xsep;
-	    ysep = (use->cu_ylo > use->cu_yhi) ? -use->cu_ysep : use->cu_ysep;
-	    for (newScx.scx_y = ylo; newScx.scx_y <= yhi; newScx.scx_y++)
-		for (newScx.scx_x = xlo; newScx.scx_x <= xhi; newScx.scx_x++)
-		{
-		    if (SigInterruptPending) return 1;
-		    xbase = xsep * (newScx.scx_x - use->cu_xlo);
-		    ybase = ysep * (newScx.scx_y - use->cu_ylo);
-		    GeoTransTranslate(xbase, ybase, &use->cu_transform, &t);
-		    GEOINVERTTRANS(&t, &tinv);
-		    GeoTransTrans(&t, &scx->scx_trans, &newScx.scx_trans);
-		    GEOTRANSRECT(&tinv, &scx->scx_area, &newScx.scx_area);
-		    clientResult = (*fp->tf_func)(&newScx, fp->tf_arg);
-		    if (clientResult == 2) goto skipArray;
-		    else if (clientResult == 1) return 1;
-		}
+	    if (dbCellSrFunc(use, cxp) == 1)
+		return 1;
 	}
-	skipArray: continue;
     }
     return 0;
 }
-
+
 /*
  *-----------------------------------------------------------------------------
  *
  * DBCellEnum --
  *
- * Apply the supplied procedure once to each CellUse in the subcell tile
- * plane of the supplied CellDef.  This procedure is not a geometric
- * search, but rather a hierarchical enumeration.
+ * Apply the supplied procedure once to each CellUse in the cell index
+ * (or, if DBCellPlaneSearch is set, the subcell tile plane) of the
+ * supplied CellDef.  This procedure is not a geometric search, but
+ * rather a hierarchical enumeration.
  *
  * The procedure should be of the following form:
  *	int
@@ -1210,29 +1278,33 @@ DBCellEnum(cellDef, func, cdarg)
     ClientData cdarg;	/* Argument to pass to function */
 {
     TreeFilter filter;
-    int dbEnumFunc();
+    int dbCellPlaneEnumFunc();
 
-    filter.tf_func = func;
-    filter.tf_arg = cdarg;
     if ((cellDef->cd_flags & CDAVAILABLE) == 0)
 	if (!DBCellRead(cellDef, (char *) NULL, TRUE, NULL)) return 0;
-    if (TiSrArea((Tile *) NULL, cellDef->cd_planes[PL_CELL],
-		&TiPlaneRect, dbEnumFunc, (ClientData) &filter))
-	return 1;
-    else return 0;
+    if (DBCellPlaneSearch)
+    {
+	filter.tf_func = func;
+	filter.tf_arg = cdarg;
+	if (TiSrArea((Tile *) NULL, cellDef->cd_planes[PL_CELL],
+		&TiPlaneRect, dbCellPlaneEnumFunc, (ClientData) &filter))
+	    return 1;
+	else return 0;
+    }
+    return dbCellIndexSearch(cellDef, (Rect *) NULL, func, cdarg);
 }
-
+
 /*
  *-----------------------------------------------------------------------------
  *
- * dbEnumFunc --
+ * dbCellPlaneEnumFunc --
  *
- * Filter procedure for DBCellEnum.  Applies the procedure given
- * to DBCellEnum to any of the CellUses in the tile that are
- * enumerable.
+ * Filter procedure for DBCellEnum when DBCellPlaneSearch is set.
+ * Applies the procedure given to DBCellEnum to any of the CellUses
+ * in the tile that are enumerable.
  *
  * The scheme used for handling overlapping subcells is the same
- * as used in DBCellSrArea above.
+ * as used in dbCellPlaneSrFunc above.
  *
  * Results:
  *	0 normally, 1 if abort occurred.
@@ -1245,7 +1317,7 @@ DBCellEnum(cellDef, func, cdarg)
  */
 
 int
-dbEnumFunc(tile, fp)
+dbCellPlaneEnumFunc(tile, fp)
     Tile *tile;
     TreeFilter *fp;
 {
@@ -1258,7 +1330,7 @@ dbEnumFunc(tile, fp)
 	    body = body->ctb_next)
     {
 	use = body->ctb_use;
-	ASSERT(use != (CellUse *) NULL, "dbCellSrFunc");
+	ASSERT(use != (CellUse *) NULL, "dbCellPlaneEnumFunc");
 
 	bbox = &use->cu_bbox;
 	if ((BOTTOM(tile) <= bbox->r_ybot) && (RIGHT(tile) >= bbox->r_xtop))
@@ -1266,7 +1338,7 @@ dbEnumFunc(tile, fp)
     }
     return 0;
 }
-
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -1393,8 +1465,10 @@ DBScaleValue(v, n, d)
 	/* Hopefully we do not reach this error.  If we do, there's	*/
 	/* not much we can do about it except to increase Magic's	*/
 	/* internal Point structure to hold 8-byte integer values.	*/
+	/* Workers scaling paint keep quiet:  the paint lies inside	*/
+	/* the cell's bounding box, whose scaling reports it anyway.	*/
 
-	if ((dlong)(*v) != llv)
+	if ((dlong)(*v) != llv && !WorkerInside())
 	    TxError("ERROR: ARITHMETIC OVERFLOW in DBScaleValue()!\n");
     }
     return (((*v) % d) != 0);
@@ -1455,9 +1529,12 @@ DBScaleEverything(scalen, scaled)
 {
     void ToolScaleBox();
     void DBWScaleCrosshair();
+    void dbScaleCellList();
 
     int dbCellDefEnumFunc();
     LinkedCellDef *lhead, *lcd;
+    CellDef **defList;
+    int nDefs;
 
     // DBUpdateStamps();
 
@@ -1466,13 +1543,19 @@ DBScaleEverything(scalen, scaled)
     lhead = NULL;
     (void) DBCellSrDefs(0, dbCellDefEnumFunc, (ClientData) &lhead);    
 
-    /* Apply scaling function to each CellDef */
+    /* Apply scaling function to all of the CellDefs at once */
 
-    lcd = lhead;
-    while (lcd != NULL)
+    nDefs = 0;
+    for (lcd = lhead; lcd != NULL; lcd = lcd->cd_next)
+	nDefs++;
+    if (nDefs > 0)
     {
-	dbScaleCell(lcd->cellDef, scalen, scaled);
-	lcd = lcd->cd_next;
+	defList = (CellDef **) mallocMagic((unsigned) (nDefs * sizeof (CellDef *)));
+	nDefs = 0;
+	for (lcd = lhead; lcd != NULL; lcd = lcd->cd_next)
+	    defList[nDefs++] = lcd->cellDef;
+	dbScaleCellList(defList, nDefs, scalen, scaled);
+	freeMagic((char *) defList);
     }
 
     /* Free the linked CellDef list */
@@ -1505,6 +1588,11 @@ struct scaleArg {
    Plane *ptarget;
    bool doCIF;
    bool modified;
+   TileBuilder *builder;	/* Non-NULL while building ptarget from scratch */
+   int nsplit;		/* Split tiles left over for a painting pass */
+   int *zero;		/* Count of tiles scaled to zero area, or NULL
+			 * to report each one as it is removed.
+			 */
 };
 
 /*
@@ -1524,6 +1612,39 @@ dbScalePlane(oldplane, newplane, pnum, scalen, scaled, doCIF)
     int pnum;
     int scalen, scaled;
     bool doCIF;
+{
+    bool dbScalePlaneCount();
+
+    return dbScalePlaneCount(oldplane, newplane, pnum, scalen, scaled,
+		doCIF, (int *) NULL);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbScalePlaneCount --
+ *
+ *   Same as dbScalePlane(), but if "zero" is non-NULL, tiles that have
+ *   zero area after scaling are counted in *zero rather than reported
+ *   one by one.  This is the form used by the worker pool, which must
+ *   not print.
+ *
+ * Results:
+ *	TRUE if some paint did not scale exactly, FALSE otherwise.
+ *
+ * Side effects:
+ *	Paints into newplane.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+dbScalePlaneCount(oldplane, newplane, pnum, scalen, scaled, doCIF, zero)
+    Plane *oldplane, *newplane;
+    int pnum;
+    int scalen, scaled;
+    bool doCIF;
+    int *zero;		/* Where to count vanished tiles, or NULL */
 {
     int dbTileScaleFunc();		/* forward declaration */
     struct scaleArg arg;
@@ -1534,9 +1655,28 @@ dbScalePlane(oldplane, newplane, pnum, scalen, scaled, doCIF)
     arg.pnum = pnum;
     arg.doCIF = doCIF;
     arg.modified = FALSE;
+    arg.nsplit = 0;
+    arg.zero = zero;
+
+    /*
+     * The new plane is normally empty, in which case the Manhattan
+     * tiles can be handed to the plane builder instead of being
+     * painted one at a time.  Split tiles are set aside and painted
+     * once the plane has been built.
+     */
+    arg.builder = TiBuildStart(newplane);
     (void) DBSrPaintArea((Tile *) NULL, oldplane, &TiPlaneRect,
 		&DBAllButSpaceBits, dbTileScaleFunc, (ClientData) &arg);
 
+    if (arg.builder != NULL)
+    {
+	TiBuildFinish(arg.builder);
+	arg.builder = NULL;
+	if (arg.nsplit > 0)
+	    (void) DBSrPaintArea((Tile *) NULL, oldplane, &TiPlaneRect,
+			&DBAllButSpaceBits, dbTileScaleFunc, (ClientData) &arg);
+    }
+
     return arg.modified;
 }
 
@@ -1560,6 +1700,16 @@ dbTileScaleFunc(tile, scvals)
     TileType type;
     Rect targetRect;
     TileType exact;
+    PaintResultType *ptable;
+
+    /* Split tiles wait for the pass after the plane is built */
+    if (scvals->builder != NULL && IsSplit(tile))
+    {
+	scvals->nsplit++;
+	return 0;
+    }
+    else if (scvals->builder == NULL && scvals->nsplit > 0 && !IsSplit(tile))
+	return 0;
 
     TiToRect(tile, &targetRect);
 
@@ -1572,8 +1722,11 @@ dbTileScaleFunc(tile, scvals)
     if ((targetRect.r_xtop - targetRect.r_xbot == 0) ||
 		(targetRect.r_ytop - targetRect.r_ybot == 0))
     {
-	TxPrintf("Tile 0x%x at (%d, %d) has zero area after scaling:  Removed.\n",
-		tile, targetRect.r_xbot, targetRect.r_ybot);
+	if (scvals->zero != NULL)
+	    (*scvals->zero)++;
+	else
+	    TxPrintf("Tile 0x%x at (%d, %d) has zero area after scaling:  "
+			"Removed.\n", tile, targetRect.r_xbot, targetRect.r_ybot);
 	return 0;
     }
 
@@ -1581,9 +1734,14 @@ dbTileScaleFunc(tile, scvals)
     exact = type;
     if (IsSplit(tile))
 	type = (SplitSide(tile)) ? SplitRightType(tile) : SplitLeftType(tile);
-    DBNMPaintPlane(scvals->ptarget, exact, &targetRect,
-		((scvals->doCIF) ? CIFPaintTable :
-		DBStdPaintTbl(type, scvals->pnum)),
+    ptable = (scvals->doCIF) ? CIFPaintTable : DBStdPaintTbl(type, scvals->pnum);
+
+    /* Painting "type" over the space of an empty plane yields ptable[space] */
+    if (scvals->builder != NULL)
+	TiBuildRect(scvals->builder, &targetRect,
+		(ClientData)(spointertype) ptable[TT_SPACE]);
+    else
+	DBNMPaintPlane(scvals->ptarget, exact, &targetRect, ptable,
 		(PaintUndoInfo *)NULL);
     return 0;
 }
@@ -1644,6 +1802,9 @@ DBSrCellUses(cellDef, func, arg)
 	lu = lu->cu_next;
     }
 
+    /* The uses have moved, so their bins in the cell index are stale */
+    dbCellIndexRebuild(cellDef);
+
     /* Free this linked cellUse structure */
     lu = luhead;
     while (lu != NULL)
@@ -1654,6 +1815,157 @@ DBSrCellUses(cellDef, func, arg)
     return retval;
 }
 
+/*
+ * Work list for dbScaleCellList().  One entry per paint plane of each
+ * cell being scaled.
+ */
+
+typedef struct
+{
+    CellDef	*st_def;	/* Cell owning the plane */
+    int		 st_pNum;	/* Plane to be scaled */
+    Plane	*st_new;	/* Plane built from the scaled paint, or NULL
+				 * if the plane is scaled where it is.
+				 */
+    int		 st_scalen;	/* Scale numerator */
+    int		 st_scaled;	/* Scale denominator */
+    bool	 st_modified;	/* TRUE if some paint did not scale exactly */
+    int		 st_zero;	/* Number of tiles scaled to zero area */
+} ScaleTask;
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbScalePlaneDirect --
+ *
+ *   Scale a paint plane where it is, by moving the lower left corner of
+ *   each of its tiles.  This is only valid when scalen >= scaled:  then
+ *   rounding down keeps every pair of distinct coordinates distinct and
+ *   in the same order, so that no tile can vanish, and the stitches and
+ *   the maximal horizontal strips of the plane stay exactly as they are.
+ *   Nothing is painted or allocated in the plane.
+ *
+ * Results:
+ *	TRUE if some paint did not scale exactly, FALSE otherwise.
+ *
+ * Side effects:
+ *	Changes the coordinates of every tile in the plane.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+struct scaleDirect
+{
+    Tile **sd_tiles;		/* Tiles of the plane */
+    int sd_num;			/* Number of entries used in sd_tiles */
+    int sd_max;			/* Number of entries allocated */
+    int sd_scalen, sd_scaled;	/* Scale factor */
+    bool sd_modified;		/* Set if some paint does not scale exactly */
+};
+
+bool
+dbScalePlaneDirect(plane, scalen, scaled)
+    Plane *plane;
+    int scalen, scaled;
+{
+    int dbTileDirectFunc();
+    struct scaleDirect sd;
+    int i;
+
+    sd.sd_max = 256;
+    sd.sd_num = 0;
+    sd.sd_tiles = (Tile **) mallocMagic((unsigned) (sd.sd_max * sizeof (Tile *)));
+    sd.sd_scalen = scalen;
+    sd.sd_scaled = scaled;
+    sd.sd_modified = FALSE;
+
+    /*
+     * The upper right corner of a tile is taken from its neighbors,
+     * so no tile may be moved until all of them have been found.
+     */
+    (void) TiSrArea((Tile *) NULL, plane, &TiPlaneRect,
+		dbTileDirectFunc, (ClientData) &sd);
+    for (i = 0; i < sd.sd_num; i++)
+	(void) DBScalePoint(&sd.sd_tiles[i]->ti_ll, scalen, scaled);
+
+    freeMagic((char *) sd.sd_tiles);
+    return sd.sd_modified;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbTileDirectFunc --
+ *
+ *   Called by TiSrArea() on behalf of dbScalePlaneDirect() for each tile
+ *   of the plane.  Adds the tile to the list of tiles to be moved, and
+ *   checks whether paint tiles scale exactly, as dbTileScaleFunc() does.
+ *
+ * Results:
+ *	Always returns 0.
+ *
+ * Side effects:
+ *	May grow the list of tiles.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbTileDirectFunc(tile, sd)
+    Tile *tile;
+    struct scaleDirect *sd;
+{
+    Tile **newTiles;
+    Rect r;
+
+    if (sd->sd_num == sd->sd_max)
+    {
+	newTiles = (Tile **) mallocMagic((unsigned)
+		(2 * sd->sd_max * sizeof (Tile *)));
+	bcopy((char *) sd->sd_tiles, (char *) newTiles,
+		sd->sd_max * sizeof (Tile *));
+	freeMagic((char *) sd->sd_tiles);
+	sd->sd_tiles = newTiles;
+	sd->sd_max *= 2;
+    }
+    sd->sd_tiles[sd->sd_num++] = tile;
+
+    if (!sd->sd_modified && TiGetTypeExact(tile) != TT_SPACE)
+    {
+	TiToRect(tile, &r);
+	if (DBScalePoint(&r.r_ll, sd->sd_scalen, sd->sd_scaled))
+	    sd->sd_modified = TRUE;
+	if (DBScalePoint(&r.r_ur, sd->sd_scalen, sd->sd_scaled))
+	    sd->sd_modified = TRUE;
+    }
+    return 0;
+}
+
+/*
+ * dbScalePlaneTask --
+ *
+ * Called by WorkerRun() on behalf of dbScaleCellList() for each plane.
+ * Always returns 0.
+ */
+
+int
+dbScalePlaneTask(task, worker, cdata)
+    int task;
+    int worker;
+    ClientData cdata;	/* Array of ScaleTask */
+{
+    ScaleTask *st = &((ScaleTask *) cdata)[task];
+    Plane *plane = st->st_def->cd_planes[st->st_pNum];
+
+    if (st->st_new == NULL)
+	st->st_modified = dbScalePlaneDirect(plane, st->st_scalen,
+		st->st_scaled);
+    else
+	st->st_modified = dbScalePlaneCount(plane, st->st_new, st->st_pNum,
+		st->st_scalen, st->st_scaled, FALSE, &st->st_zero);
+    return 0;
+}
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -1670,13 +1982,146 @@ dbScaleCell(cellDef, scalen, scaled)
 			 * be an internal buffer; if so, we ignore it.
 			 */
     int scalen, scaled; /* scale numerator and denominator. */
+{
+    void dbScaleCellList();
+
+    dbScaleCellList(&cellDef, 1, scalen, scaled);
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbScaleCellList --
+ *
+ *   Scale a number of cells at once, as dbScaleCell() would one at a
+ *   time.  Nearly all of the work is in the paint planes, which are
+ *   independent of each other, so they are scaled in parallel on the
+ *   worker pool (see utils/workers.c).  When the scale factor is at
+ *   least 1, each plane is scaled where it is by dbScalePlaneDirect();
+ *   otherwise tiles may vanish or merge, and a new plane is built by
+ *   dbScalePlaneCount().  Then everything else is committed serially:
+ *   new planes replace the old ones, and the uses, labels, and bounding
+ *   boxes of each cell are scaled.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	See dbScaleCell().
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbScaleCellList(defList, nDefs, scalen, scaled)
+    CellDef **defList;	/* Cells to be scaled */
+    int nDefs;		/* Number of entries in defList */
+    int scalen, scaled; /* scale numerator and denominator. */
+{
+    void dbScaleCellOther();
+    ScaleTask *tasks, *st;
+    CellDef *cellDef;
+    Plane *oldplane;
+    int i, t, nTasks, pNum;
+
+    tasks = (ScaleTask *) mallocMagic((unsigned) (nDefs * DBNumPlanes
+		* sizeof (ScaleTask)));
+    nTasks = 0;
+    for (i = 0; i < nDefs; i++)
+    {
+	cellDef = defList[i];
+
+	/* DBCellEnum() attempts to read unavailable celldefs.  We don't */
+	/* want to do that here, so check CDAVAILABLE flag first.	 */
+
+	if ((cellDef->cd_flags & CDAVAILABLE) == 0) continue;
+
+	for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
+	{
+	    if (cellDef->cd_planes[pNum] == NULL) continue;
+	    st = &tasks[nTasks++];
+	    st->st_def = cellDef;
+	    st->st_pNum = pNum;
+	    st->st_new = NULL;
+	    if (scalen < scaled)
+	    {
+		/* Planes share their boundary tiles, so make them here */
+		st->st_new = DBNewPlane((ClientData) TT_SPACE);
+		DBClearPaintPlane(st->st_new);
+	    }
+	    else
+	    {
+		/* Tiles shared by two planes must not be moved twice */
+		TiPlaneModify(cellDef->cd_planes[pNum]);
+	    }
+	    st->st_scalen = scalen;
+	    st->st_scaled = scaled;
+	    st->st_modified = FALSE;
+	    st->st_zero = 0;
+	}
+    }
+
+    (void) WorkerRun(nTasks, dbScalePlaneTask, (ClientData) tasks);
+
+    /* Commit the new planes, then scale the rest of each cell */
+
+    t = 0;
+    for (i = 0; i < nDefs; i++)
+    {
+	cellDef = defList[i];
+	for ( ; t < nTasks && tasks[t].st_def == cellDef; t++)
+	{
+	    st = &tasks[t];
+	    if (st->st_new != NULL)
+	    {
+		oldplane = cellDef->cd_planes[st->st_pNum];
+		DBFreePaintPlane(oldplane);
+		TiFreePlane(oldplane);
+		cellDef->cd_planes[st->st_pNum] = st->st_new;
+	    }
+	    if (st->st_modified)
+		cellDef->cd_flags |= (CDMODIFIED | CDGETNEWSTAMP);
+	    if (st->st_zero > 0)
+		TxPrintf("%d tile%s of %s in cell %s had zero area after "
+			"scaling:  Removed.\n", st->st_zero,
+			(st->st_zero == 1) ? "" : "s",
+			DBPlaneLongNameTbl[st->st_pNum], cellDef->cd_name);
+	}
+	dbScaleCellOther(cellDef, scalen, scaled);
+    }
+
+    freeMagic((char *) tasks);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbScaleCellOther --
+ *
+ *   Scale everything in a cell except for its paint, which is done by
+ *   dbScaleCellList().
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Scales the cell uses, the subcell plane, the labels, and the
+ *	bounding box of the cell.  Throws away the connectivity index of
+ *	the cell, and rebuilds its subcell index.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbScaleCellOther(cellDef, scalen, scaled)
+    CellDef *cellDef;	/* Cell being scaled */
+    int scalen, scaled; /* scale numerator and denominator. */
 {
     int dbCellTileEnumFunc(), dbCellUseEnumFunc();
     Label *lab;
-    int pNum;
     LinkedTile *lhead, *lt;
     LinkedCellUse *luhead, *lu;
-    Plane *newplane;
 
     /* DBCellEnum() attempts to read unavailable celldefs.  We don't	*/
     /* want to do that here, so check CDAVAILABLE flag first.	  	*/
@@ -1686,6 +2131,9 @@ dbScaleCell(cellDef, scalen, scaled)
     else
 	cellDef->cd_flags |= CDBOXESCHANGED;
 
+    /* The paint has moved, so an index of its connectivity is stale */
+    DBConnIndexFree(cellDef);
+
     /* Enumerate all unique cell uses, and scale their position,	*/
     /* transform, and array information.				*/
 
@@ -1731,6 +2179,9 @@ dbScaleCell(cellDef, scalen, scaled)
 	lu = lu->cu_next;
     }
 
+    /* The uses have moved, so their bins in the cell index are stale */
+    dbCellIndexRebuild(cellDef);
+
     /* Scale the position of all subcell uses.  Count all of the tiles in the	*/
     /* subcell plane, and scale those without reference to the actual cells (so	*/
     /* we don't count the cells multiple times).				*/
@@ -1757,28 +2208,13 @@ dbScaleCell(cellDef, scalen, scaled)
 	lt = lt->t_next;
     }
 
-    /* Scale all of the paint tiles in this cell by creating a new plane */
-    /* and copying all tiles into the new plane at scaled dimensions.	 */
-
-    for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
-    {
-	if (cellDef->cd_planes[pNum] == NULL) continue;
-	newplane = DBNewPlane((ClientData) TT_SPACE);
-	DBClearPaintPlane(newplane);
-	if (dbScalePlane(cellDef->cd_planes[pNum], newplane, pNum,
-		scalen, scaled, FALSE))
-	    cellDef->cd_flags |= (CDMODIFIED | CDGETNEWSTAMP);
-        DBFreePaintPlane(cellDef->cd_planes[pNum]);
-	TiFreePlane(cellDef->cd_planes[pNum]);
-        cellDef->cd_planes[pNum] = newplane;
-    }
-
     /* Check consistency of several global pointers	*/
     /* WARNING:  This list may not be complete!		*/
 
     /* Also scale the position of all labels. */
     /* If labels are the rendered-font type, scale the size as well */
 
+    DBLabelIndexFree(cellDef);
     if (cellDef->cd_labels)
     {
 	int i;
@@ -1809,8 +2245,6 @@ donecell:
     DBScalePoint(&cellDef->cd_bbox.r_ur, scalen, scaled);
     DBScalePoint(&cellDef->cd_extended.r_ll, scalen, scaled);
     DBScalePoint(&cellDef->cd_extended.r_ur, scalen, scaled);
-
-    return 0;
 }
 
 /*
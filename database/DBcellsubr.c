@@ -125,6 +125,9 @@ DBCellCopyDefBody(sourceDef, destDef)
     destDef->cd_idHash = sourceDef->cd_idHash;
     for (i = 0; i < MAXPLANES; i++)
 	destDef->cd_planes[i] = sourceDef->cd_planes[i];
+    destDef->cd_cellIndex = sourceDef->cd_cellIndex;
+    destDef->cd_connIndex = sourceDef->cd_connIndex;
+    destDef->cd_labelIndex = sourceDef->cd_labelIndex;
     
     /* Be careful to update parent pointers in the children of dest.
      * Don't allow interrupts to wreck this.
@@ -198,6 +201,8 @@ DBCellClearDef(cellDef)
     {
 	DBClearCellPlane(plane);
     }
+    dbCellIndexFree(cellDef);
+    DBConnIndexFree(cellDef);
 
     /* Reduce clutter by reinitializing the id hash table */
     HashKill(&cellDef->cd_idHash);
@@ -217,6 +222,7 @@ DBCellClearDef(cellDef)
     cellDef->cd_bbox.r_xtop = cellDef->cd_bbox.r_ytop = 1;
     cellDef->cd_extended.r_xbot = cellDef->cd_extended.r_ybot = 0;
     cellDef->cd_extended.r_xtop = cellDef->cd_extended.r_ytop = 1;
+    DBLabelIndexFree(cellDef);
     for (lab = cellDef->cd_labels; lab; lab = lab->lab_next)
 	freeMagic((char *) lab);
     cellDef->cd_labels = (Label *) NULL;
@@ -253,7 +259,7 @@ DBClearCellPlane(plane)
     DBFreeCellPlane(plane);
 
     /* Allocate a new central space tile with a NULL body */
-    newCenterTile = TiAlloc();
+    newCenterTile = TiPlaneAlloc(plane);
     plane->pl_hint = newCenterTile;
     TiSetBody(newCenterTile, NULL);
     dbSetPlaneTile(plane, newCenterTile);
@@ -287,7 +293,7 @@ DBClearPaintPlane(plane)
     DBFreePaintPlane(plane);
 
     /* Allocate a new central space tile */
-    newCenterTile = TiAlloc();
+    newCenterTile = TiPlaneAlloc(plane);
     plane->pl_hint = newCenterTile;
     TiSetBody(newCenterTile, TT_SPACE);
     dbSetPlaneTile(plane, newCenterTile);
@@ -319,20 +325,20 @@ dbSetPlaneTile(plane, newCenterTile)
      * to point to the four boundaries of the plane.
      */
 
-    RT(newCenterTile) = plane->pl_top;
-    TR(newCenterTile) = plane->pl_right;
-    LB(newCenterTile) = plane->pl_bottom;
-    BL(newCenterTile) = plane->pl_left;
+    TiSetRT(newCenterTile, plane->pl_top);
+    TiSetTR(newCenterTile, plane->pl_right);
+    TiSetLB(newCenterTile, plane->pl_bottom);
+    TiSetBL(newCenterTile, plane->pl_left);
 
     /*
      * Set the stitches for the four boundaries of the plane
      * all to point to the newly created center tile.
      */
 
-    RT(plane->pl_bottom) = newCenterTile;
-    LB(plane->pl_top) = newCenterTile;
-    TR(plane->pl_left) = newCenterTile;
-    BL(plane->pl_right) = newCenterTile;
+    TiSetRT(plane->pl_bottom, newCenterTile);
+    TiSetLB(plane->pl_top, newCenterTile);
+    TiSetTR(plane->pl_left, newCenterTile);
+    TiSetBL(plane->pl_right, newCenterTile);
 
     LEFT(newCenterTile) = TiPlaneRect.r_xbot;
     BOTTOM(newCenterTile) = TiPlaneRect.r_ybot;
@@ -261,8 +261,21 @@ DBSrConnect(def, startArea, mask, connect, bounds, func, clientData)
     }
     if (startTile == NULL) return 0;
     /* The following lets us call DBSrConnect recursively */
-    else if (startTile->ti_client == (ClientData)1) return 0;
+    else if (TiGetClient(startTile) == (ClientData)1) return 0;
    
+    /* If the caller has built a connectivity index for this def (see
+     * DBconnindex.c), the neighbors of each tile are taken from it
+     * instead of being searched for.  The index ignores the bounds,
+     * so searches with bounds smaller than the plane still flood.
+     */
+
+    if (def->cd_connIndex != NULL && GEO_SURROUND(bounds, &TiPlaneRect))
+    {
+	result = dbConnIndexSearch(def, startTile, connect, func,
+		clientData, TRUE);
+	if (result >= 0) return result;
+	result = 0;
+    }
 
     /* Pass 1.  During this pass the client function gets called. */
 
@@ -352,8 +365,17 @@ DBSrConnectOnePass(def, startArea, mask, connect, bounds, func, clientData)
     }
     if (startTile == NULL) return 0;
     /* The following lets us call DBSrConnect recursively */
-    else if (startTile->ti_client == (ClientData)1) return 0;
+    else if (TiGetClient(startTile) == (ClientData)1) return 0;
    
+    /* Use the connectivity index, if there is one (see above) */
+
+    if (def->cd_connIndex != NULL && GEO_SURROUND(bounds, &TiPlaneRect))
+    {
+	result = dbConnIndexSearch(def, startTile, connect, func,
+		clientData, FALSE);
+	if (result >= 0) return result;
+	result = 0;
+    }
 
     /* Pass 1.  During this pass the client function gets called. */
 
@@ -421,13 +443,13 @@ dbSrConnectFunc(tile, csa)
 
     if (csa->csa_clear)
     {
-	if (tile->ti_client == (ClientData) CLIENTDEFAULT) return 0;
-	tile->ti_client = (ClientData) CLIENTDEFAULT;
+	if (TiGetClient(tile) == (ClientData) CLIENTDEFAULT) return 0;
+	TiSetClient(tile, (ClientData) CLIENTDEFAULT);
     }
     else
     {
-	if (tile->ti_client != (ClientData) CLIENTDEFAULT) return 0;
-	tile->ti_client = (ClientData) 1;
+	if (TiGetClient(tile) != (ClientData) CLIENTDEFAULT) return 0;
+	TiSetClient(tile, (ClientData) 1);
     }
 
     /* Call the client function, if there is one. */
@@ -470,9 +492,9 @@ dbSrConnectFunc(tile, csa)
 	{
 	    if (csa->csa_clear)
 	    {
-		if (t2->ti_client == (ClientData) CLIENTDEFAULT) continue;
+		if (TiGetClient(t2) == (ClientData) CLIENTDEFAULT) continue;
 	    }
-	    else if (t2->ti_client != (ClientData) CLIENTDEFAULT) continue;
+	    else if (TiGetClient(t2) != (ClientData) CLIENTDEFAULT) continue;
 	    if (IsSplit(t2))
 		TiSetBody(t2, (ClientData)(t2->ti_body | TT_SIDE)); /* bit set */
 	    if (dbSrConnectFunc(t2, csa) != 0) return 1;
@@ -497,9 +519,9 @@ bottomside:
 	{
 	    if (csa->csa_clear)
 	    {
-		if (t2->ti_client == (ClientData) CLIENTDEFAULT) continue;
+		if (TiGetClient(t2) == (ClientData) CLIENTDEFAULT) continue;
 	    }
-	    else if (t2->ti_client != (ClientData) CLIENTDEFAULT) continue;
+	    else if (TiGetClient(t2) != (ClientData) CLIENTDEFAULT) continue;
 	    if (IsSplit(t2))
 	    {
 		if (SplitDirection(t2))
@@ -528,9 +550,9 @@ rightside:
 	{
 	    if (csa->csa_clear)
 	    {
-		if (t2->ti_client == (ClientData) CLIENTDEFAULT) goto nextRight;
+		if (TiGetClient(t2) == (ClientData) CLIENTDEFAULT) goto nextRight;
 	    }
-	    else if (t2->ti_client != (ClientData) CLIENTDEFAULT) goto nextRight;
+	    else if (TiGetClient(t2) != (ClientData) CLIENTDEFAULT) goto nextRight;
 	    if (IsSplit(t2))
 		TiSetBody(t2, (ClientData)(t2->ti_body & ~TT_SIDE)); /* bit clear */
 	    if (dbSrConnectFunc(t2, csa) != 0) return 1;
@@ -555,9 +577,9 @@ topside:
 	{
 	    if (csa->csa_clear)
 	    {
-		if (t2->ti_client == (ClientData) CLIENTDEFAULT) goto nextTop;
+		if (TiGetClient(t2) == (ClientData) CLIENTDEFAULT) goto nextTop;
 	    }
-	    else if (t2->ti_client != (ClientData) CLIENTDEFAULT) goto nextTop;
+	    else if (TiGetClient(t2) != (ClientData) CLIENTDEFAULT) goto nextTop;
 	    if (IsSplit(t2))
 	    {
 		if (SplitDirection(t2))
@@ -0,0 +1,605 @@
+/*
+ * DBconnindex.c --
+ *
+ * Connectivity index of the paint of a CellDef.
+ *
+ * DBSrConnect() finds a net by flooding outward from a starting tile,
+ * marking every tile it reaches and then flooding a second time to
+ * clear the marks again.  Most of the work is finding the neighbors
+ * of each tile:  walking its four sides and, for contacts, searching
+ * the contact's area on each of its other planes.  Code that asks
+ * for many nets of the same cell (writing the nets of a DEF file, or
+ * verifying a netlist) can build an index first, in which each paint
+ * tile of the def has a node holding the list of tiles the flood
+ * would go to from it, in the order it would go to them.  While the
+ * index exists, DBSrConnect() walks these lists instead of the tile
+ * planes.  It visits and marks the same tiles in the same order as
+ * the flood, so clients see no difference, and the marks are cleared
+ * from a list of the tiles visited rather than by a second flood.
+ *
+ * The index holds tile pointers, so it records the pl_generation of
+ * each plane when it is built.  Every change to the tiles of a plane
+ * advances its generation (see TiPlaneModify()), so once any plane of
+ * the def has changed, however it was changed, the index is no longer
+ * used and DBSrConnect() floods.  A stale index is freed by the next
+ * DBConnIndexBuild() or DBConnIndexFree(), or when the def is cleared
+ * or deleted.  Building the index costs about as much as flooding
+ * every net of the def once, so it is not built by DBSrConnect()
+ * itself:  callers build it just before a batch of queries, such as
+ * one command, and free it just after.
+ *
+ * Only manhattan paint is indexed.  The side of a split tile that the
+ * flood looks at depends on the direction it came from, so if the def
+ * contains split tiles no index is built and DBSrConnect() floods.
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/magic.h"
+#include "utils/geometry.h"
+#include "utils/malloc.h"
+#include "tiles/tile.h"
+#include "utils/hash.h"
+#include "database/database.h"
+#include "database/databaseInt.h"
+#include "utils/signals.h"
+
+typedef struct connindex
+{
+    TileTypeBitMask *cx_connect;	/* Connect table used to build it */
+    Plane	*cx_planes[MAXPLANES];	/* Planes of the def at that time */
+    unsigned int cx_generation[MAXPLANES]; /* Their pl_generation then */
+    HashTable	 cx_nodes;		/* Maps each tile to its node + 1 */
+    int		 cx_nNodes;		/* Number of tiles indexed */
+    Tile	**cx_tile;		/* Tile of each node */
+    unsigned char *cx_plane;		/* Plane of each node */
+    int		*cx_first;		/* Index in cx_adj of the first
+					 * neighbor of each node;  one extra
+					 * entry marks the end of the last.
+					 */
+    int		*cx_adj;		/* Neighbor lists of all the nodes */
+    int		 cx_nAdj;		/* Number of entries in cx_adj */
+    int		 cx_adjSize;		/* Space allocated for cx_adj */
+} ConnIndex;
+
+/* Working state while an index is being built */
+
+typedef struct
+{
+    ConnIndex	*cb_index;	/* Index being built */
+    int		 cb_size;	/* Space allocated for nodes */
+    int		 cb_pNum;	/* Plane being scanned */
+} ConnBuild;
+
+/* One level of the depth-first walk done by dbConnIndexSearch() */
+
+typedef struct
+{
+    int		cs_node;	/* Node being visited */
+    int		cs_next;	/* Next entry in cx_adj to look at */
+} ConnStack;
+
+#define	CX_INITNODES	1024
+
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbConnIndexNode --
+ *
+ * Find the node of a tile in the index.
+ *
+ * Results:
+ *	The node number, or -1 if the tile is not in the index.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbConnIndexNode(cx, tile)
+    ConnIndex *cx;
+    Tile *tile;
+{
+    HashEntry *he;
+
+    he = HashLookOnly(&cx->cx_nodes, (char *) tile);
+    if (he == NULL)
+	return -1;
+    return (int)(spointertype) HashGetValue(he) - 1;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbConnIndexCurrent --
+ *
+ * Check that the paint of a def is still what its connectivity index
+ * was built from:  the def has the same planes, and none of them has
+ * been changed since.
+ *
+ * Results:
+ *	TRUE if the index can be used, FALSE if it is stale.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+dbConnIndexCurrent(def, cx)
+    CellDef *def;
+    ConnIndex *cx;
+{
+    int pNum;
+
+    for (pNum = PL_TECHDEPBASE; pNum < DBNumPlanes; pNum++)
+	if (cx->cx_planes[pNum] != def->cd_planes[pNum]
+		|| cx->cx_generation[pNum]
+			!= def->cd_planes[pNum]->pl_generation)
+	    return FALSE;
+    return TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbConnIndexAddFunc --
+ *
+ * Called by DBSrPaintArea() for each paint tile of the def while an
+ * index is being built, to give the tile a node.  Until the build is
+ * finished, the node number is also kept in the tile's ti_client, so
+ * that neighbors can be looked up quickly.
+ *
+ * Results:
+ *	1 (abort the build) if the tile is split or already marked,
+ *	otherwise 0.
+ *
+ * Side effects:
+ *	Adds the tile to the index, growing the node arrays as needed.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbConnIndexAddFunc(tile, cb)
+    Tile *tile;
+    ConnBuild *cb;
+{
+    ConnIndex *cx = cb->cb_index;
+    HashEntry *he;
+    int n;
+
+    if (IsSplit(tile) || TiGetClient(tile) != (ClientData) CLIENTDEFAULT)
+	return 1;
+
+    n = cx->cx_nNodes++;
+    if (n >= cb->cb_size)
+    {
+	Tile **newTile;
+	unsigned char *newPlane;
+	int newSize = cb->cb_size * 2;
+
+	newTile = (Tile **) mallocMagic(newSize * sizeof (Tile *));
+	newPlane = (unsigned char *) mallocMagic(newSize);
+	bcopy((char *) cx->cx_tile, (char *) newTile, n * sizeof (Tile *));
+	bcopy((char *) cx->cx_plane, (char *) newPlane, n);
+	freeMagic((char *) cx->cx_tile);
+	freeMagic((char *) cx->cx_plane);
+	cx->cx_tile = newTile;
+	cx->cx_plane = newPlane;
+	cb->cb_size = newSize;
+    }
+    cx->cx_tile[n] = tile;
+    cx->cx_plane[n] = (unsigned char) cb->cb_pNum;
+    TiSetClient(tile, (ClientData)(spointertype) n);
+
+    he = HashFind(&cx->cx_nodes, (char *) tile);
+    HashSetValue(he, (ClientData)(spointertype)(n + 1));
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbConnIndexAdj --
+ *
+ * Append a tile to the neighbor list of the node being built.  Also
+ * called by DBSrPaintArea() for the tiles a contact connects to on
+ * its other planes.
+ *
+ * Results:
+ *	1 (abort the build) if the tile has no node, otherwise 0.
+ *
+ * Side effects:
+ *	Adds an entry to cx_adj, growing it as needed.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbConnIndexAdj(tile, cx)
+    Tile *tile;
+    ConnIndex *cx;
+{
+    int n;
+
+    if (TiGetClient(tile) == (ClientData) CLIENTDEFAULT)
+	return 1;
+    n = (int)(spointertype) TiGetClient(tile);
+
+    if (cx->cx_nAdj >= cx->cx_adjSize)
+    {
+	int *newAdj;
+
+	newAdj = (int *) mallocMagic(2 * cx->cx_adjSize * sizeof (int));
+	bcopy((char *) cx->cx_adj, (char *) newAdj, cx->cx_nAdj * sizeof (int));
+	freeMagic((char *) cx->cx_adj);
+	cx->cx_adj = newAdj;
+	cx->cx_adjSize *= 2;
+    }
+    cx->cx_adj[cx->cx_nAdj++] = n;
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbConnIndexLink --
+ *
+ * Build the neighbor list of one node:  the tiles that
+ * dbSrConnectFunc() would go to from its tile, in the same order.
+ * These are the connected tiles along the left, bottom, right, and
+ * top sides, and for a contact, the connected tiles touching it on
+ * each of its other planes.
+ *
+ * Results:
+ *	0 normally, 1 if the index can't be built.
+ *
+ * Side effects:
+ *	Fills in cx_first[node] and appends to cx_adj.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbConnIndexLink(def, cx, node)
+    CellDef *def;
+    ConnIndex *cx;
+    int node;
+{
+    Tile *tile = cx->cx_tile[node], *t2;
+    TileTypeBitMask *connectMask;
+    TileType type = TiGetType(tile);
+    PlaneMask planes;
+    Rect area;
+    int pNum;
+
+    cx->cx_first[node] = cx->cx_nAdj;
+    connectMask = &cx->cx_connect[type];
+
+    /* Left side */
+    for (t2 = BL(tile); BOTTOM(t2) < TOP(tile); t2 = RT(t2))
+	if (TTMaskHasType(connectMask, TiGetTypeExact(t2)))
+	    if (dbConnIndexAdj(t2, cx)) return 1;
+
+    /* Bottom side */
+    for (t2 = LB(tile); LEFT(t2) < RIGHT(tile); t2 = TR(t2))
+	if (TTMaskHasType(connectMask, TiGetTypeExact(t2)))
+	    if (dbConnIndexAdj(t2, cx)) return 1;
+
+    /* Right side */
+    for (t2 = TR(tile); ; t2 = LB(t2))
+    {
+	if (TTMaskHasType(connectMask, TiGetTypeExact(t2)))
+	    if (dbConnIndexAdj(t2, cx)) return 1;
+	if (BOTTOM(t2) <= BOTTOM(tile)) break;
+    }
+
+    /* Top side */
+    for (t2 = RT(tile); ; t2 = BL(t2))
+    {
+	if (TTMaskHasType(connectMask, TiGetTypeExact(t2)))
+	    if (dbConnIndexAdj(t2, cx)) return 1;
+	if (LEFT(t2) <= LEFT(tile)) break;
+    }
+
+    /* Other planes, for contacts */
+    planes = DBConnPlanes[type] & ~PlaneNumToMaskBit(cx->cx_plane[node]);
+    if (planes == 0)
+	return 0;
+
+    TiToRect(tile, &area);
+    GEO_EXPAND(&area, 1, &area);
+    for (pNum = PL_TECHDEPBASE; pNum < DBNumPlanes; pNum++)
+    {
+	if (!PlaneMaskHasPlane(planes, pNum)) continue;
+	if (DBSrPaintArea((Tile *) NULL, def->cd_planes[pNum], &area,
+		connectMask, dbConnIndexAdj, (ClientData) cx))
+	    return 1;
+    }
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbConnIndexUnmark --
+ *
+ * Clear the node numbers left in ti_client by dbConnIndexAddFunc().
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Resets ti_client of every indexed tile to CLIENTDEFAULT.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbConnIndexUnmark(cx)
+    ConnIndex *cx;
+{
+    int n;
+
+    for (n = 0; n < cx->cx_nNodes; n++)
+	TiSetClient(cx->cx_tile[n], (ClientData) CLIENTDEFAULT);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBConnIndexBuild --
+ *
+ * Build the connectivity index of a def for the given connect table,
+ * unless an index for that table is already there.  Later calls to
+ * DBSrConnect() on the def with this table and unlimited bounds will
+ * use it.  The caller should free the index with DBConnIndexFree()
+ * when it has finished its queries.
+ *
+ * Results:
+ *	TRUE if the def has an index, FALSE if none could be built
+ *	(split tiles, tiles left marked by a search in progress, or
+ *	an interrupt).
+ *
+ * Side effects:
+ *	Allocates the index and stores it in def->cd_connIndex.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+DBConnIndexBuild(def, connect)
+    CellDef *def;		/* Def whose paint is indexed */
+    TileTypeBitMask *connect;	/* Connect table, as for DBSrConnect() */
+{
+    ConnIndex *cx;
+    ConnBuild cb;
+    int pNum, n;
+
+    if ((cx = def->cd_connIndex) != NULL)
+    {
+	if (cx->cx_connect == connect && dbConnIndexCurrent(def, cx))
+	    return TRUE;
+	DBConnIndexFree(def);
+    }
+
+    cx = (ConnIndex *) mallocMagic(sizeof (ConnIndex));
+    bzero((char *) cx, sizeof (ConnIndex));
+    cx->cx_connect = connect;
+    HashInit(&cx->cx_nodes, CX_INITNODES, HT_WORDKEYS);
+    cb.cb_index = cx;
+    cb.cb_size = CX_INITNODES;
+    cx->cx_tile = (Tile **) mallocMagic(cb.cb_size * sizeof (Tile *));
+    cx->cx_plane = (unsigned char *) mallocMagic(cb.cb_size);
+    def->cd_connIndex = cx;
+
+    /* Give every paint tile a node */
+    for (pNum = PL_TECHDEPBASE; pNum < DBNumPlanes; pNum++)
+    {
+	cx->cx_planes[pNum] = def->cd_planes[pNum];
+	cx->cx_generation[pNum] = def->cd_planes[pNum]->pl_generation;
+	cb.cb_pNum = pNum;
+	if (DBSrPaintArea((Tile *) NULL, def->cd_planes[pNum], &TiPlaneRect,
+		&DBAllButSpaceAndDRCBits, dbConnIndexAddFunc, (ClientData) &cb))
+	    goto fail;
+    }
+
+    /* Record the neighbors of each node */
+    cx->cx_first = (int *) mallocMagic((cx->cx_nNodes + 1) * sizeof (int));
+    cx->cx_adjSize = 4 * cx->cx_nNodes + 1;
+    cx->cx_adj = (int *) mallocMagic(cx->cx_adjSize * sizeof (int));
+    for (n = 0; n < cx->cx_nNodes; n++)
+    {
+	if (SigInterruptPending) goto fail;
+	if (dbConnIndexLink(def, cx, n)) goto fail;
+    }
+    cx->cx_first[cx->cx_nNodes] = cx->cx_nAdj;
+    dbConnIndexUnmark(cx);
+    return TRUE;
+
+fail:
+    dbConnIndexUnmark(cx);
+    DBConnIndexFree(def);
+    return FALSE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBConnIndexFree --
+ *
+ * Throw away the connectivity index of a def, if it has one.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Frees the index, and sets def->cd_connIndex to NULL.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+DBConnIndexFree(def)
+    CellDef *def;
+{
+    ConnIndex *cx = def->cd_connIndex;
+
+    if (cx == NULL)
+	return;
+    HashKill(&cx->cx_nodes);
+    freeMagic((char *) cx->cx_tile);
+    freeMagic((char *) cx->cx_plane);
+    if (cx->cx_first != NULL) freeMagic((char *) cx->cx_first);
+    if (cx->cx_adj != NULL) freeMagic((char *) cx->cx_adj);
+    freeMagic((char *) cx);
+    def->cd_connIndex = (ConnIndex *) NULL;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbConnIndexSearch --
+ *
+ * Do the work of DBSrConnect() or DBSrConnectOnePass() from the
+ * starting tile, using the connectivity index of the def.  This is
+ * the depth-first walk of dbSrConnectFunc(), with the neighbors of
+ * each tile taken from the index:  tiles are marked in ti_client
+ * and passed to the client procedure in the same order, and a tile
+ * already marked when it is reached is skipped in the same way.
+ *
+ * Results:
+ *	-1 if the index can't answer the query:  there is none, it
+ *	was built for another connect table, or the paint has changed
+ *	since it was built.  Otherwise
+ *	0 if the search finished normally, and 1 if the client procedure
+ *	aborted it.
+ *
+ * Side effects:
+ *	Calls the client procedure on each tile of the net, as
+ *	(*func)(tile, plane, clientData).  If "clear" is TRUE the
+ *	marks are removed again afterwards, as by DBSrConnect();
+ *	otherwise they are left for the caller, as by
+ *	DBSrConnectOnePass().
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbConnIndexSearch(def, startTile, connect, func, clientData, clear)
+    CellDef *def;		/* Def being searched */
+    Tile *startTile;		/* Tile found in the starting area */
+    TileTypeBitMask *connect;	/* Connect table */
+    int (*func)();		/* Client procedure */
+    ClientData clientData;	/* Passed to func */
+    bool clear;			/* TRUE means clear the marks afterwards */
+{
+    ConnIndex *cx = def->cd_connIndex;
+    ConnStack *stack;
+    int *visited;
+    int node, next, depth, nVisited, size, result;
+    Tile *tile;
+
+    if (cx == NULL || cx->cx_connect != connect
+	    || !dbConnIndexCurrent(def, cx))
+	return -1;
+    if ((node = dbConnIndexNode(cx, startTile)) < 0)
+	return -1;
+    if (TiGetClient(startTile) != (ClientData) CLIENTDEFAULT)
+	return 0;
+
+    /*
+     * Neither the stack nor the list of visited nodes can hold more
+     * than one entry per node.  Allocate for small nets first.
+     */
+    size = (cx->cx_nNodes < 64) ? cx->cx_nNodes : 64;
+    stack = (ConnStack *) mallocMagic(size * sizeof (ConnStack));
+    visited = (int *) mallocMagic(size * sizeof (int));
+
+    result = 0;
+    depth = nVisited = 0;
+    while (TRUE)
+    {
+	/* Visit "node":  mark it and call the client */
+	tile = cx->cx_tile[node];
+	TiSetClient(tile, (ClientData) 1);
+	if (nVisited >= size)
+	{
+	    ConnStack *newStack;
+	    int *newVisited;
+
+	    newStack = (ConnStack *) mallocMagic(2 * size * sizeof (ConnStack));
+	    newVisited = (int *) mallocMagic(2 * size * sizeof (int));
+	    bcopy((char *) stack, (char *) newStack, depth * sizeof (ConnStack));
+	    bcopy((char *) visited, (char *) newVisited, nVisited * sizeof (int));
+	    freeMagic((char *) stack);
+	    freeMagic((char *) visited);
+	    stack = newStack;
+	    visited = newVisited;
+	    size *= 2;
+	}
+	visited[nVisited++] = node;
+	if ((*func)(tile, (int) cx->cx_plane[node], clientData))
+	{
+	    result = 1;
+	    break;
+	}
+	stack[depth].cs_node = node;
+	stack[depth].cs_next = cx->cx_first[node];
+	depth++;
+
+	/* Find the next unmarked neighbor, backing up as needed */
+	node = -1;
+	while (depth > 0)
+	{
+	    ConnStack *cs = &stack[depth - 1];
+
+	    while (cs->cs_next < cx->cx_first[cs->cs_node + 1])
+	    {
+		next = cx->cx_adj[cs->cs_next++];
+		if (TiGetClient(cx->cx_tile[next]) == (ClientData) CLIENTDEFAULT)
+		{
+		    node = next;
+		    break;
+		}
+	    }
+	    if (node >= 0) break;
+	    depth--;
+	}
+	if (node < 0) break;
+    }
+
+    if (clear)
+    {
+	SigDisableInterrupts();
+	while (nVisited > 0)
+	{
+	    nVisited--;
+	    TiSetClient(cx->cx_tile[visited[nVisited]], CLIENTDEFAULT);
+	}
+	SigEnableInterrupts();
+    }
+
+    freeMagic((char *) stack);
+    freeMagic((char *) visited);
+    return result;
+}
@@ -21,6 +21,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #endif  /* not lint */
 
 #include <stdio.h>
+#include <string.h>
 #include "utils/magic.h"
 #include "utils/geometry.h"
 #include "tiles/tile.h"
@@ -30,6 +31,8 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "textio/textio.h"
 #include "utils/utils.h"
 #include "utils/stack.h"
+#include "utils/malloc.h"
+#include "utils/workers.h"
 
     /*
      * Argument passed down to search functions when searching for
@@ -43,6 +46,23 @@ struct expandArg
 				 */
     ClientData	ea_arg;		/* Argument to pass to func. */
 };
+
+    /*
+     * Argument passed down to search functions when looking for
+     * cells that haven't been read in yet (see dbReadAhead()).
+     */
+struct readAheadArg
+{
+    bool	ra_expand;	/* TRUE if searching as dbExpandFunc() does,
+				 * FALSE if as dbReadAreaFunc() does.
+				 */
+    HashTable	ra_seen;	/* Cells found so far, by address */
+    CellDef   **ra_defs;	/* Cells found by the current search */
+    int		ra_nDefs;	/* Number of entries in ra_defs */
+    int		ra_maxDefs;	/* Size of ra_defs */
+};
+
+void dbReadAhead();
 
 /*
  * ----------------------------------------------------------------------------
@@ -159,7 +179,10 @@ DBExpandAll(rootUse, rootRect, expandMask, expandFlag, func, cdarg)
     scontext.scx_trans = GeoIdentityTransform;
     scontext.scx_area = *rootRect;
     if (expandFlag)
+    {
+	dbReadAhead(&scontext, TRUE);
 	DBCellSrArea(&scontext, dbExpandFunc, (ClientData) &arg);
+    }
     else
 	DBCellSrArea(&scontext, dbUnexpandFunc, (ClientData) &arg);
 }
@@ -265,7 +288,9 @@ dbUnexpandFunc(scx, arg)
  * DBCellReadArea --
  *
  * Recursively read all cells which intersect or are contained within
- * the given rectangle.
+ * the given rectangle.  When worker threads are available, the cells
+ * are read in parallel, one level of the hierarchy at a time (see
+ * dbReadAhead() below).
  *
  * Results:
  *	None.
@@ -288,6 +313,11 @@ DBCellReadArea(rootUse, rootRect)
     scontext.scx_use = rootUse;
     scontext.scx_trans = GeoIdentityTransform;
     scontext.scx_area = *rootRect;
+
+    if ((rootUse->cu_def->cd_flags & CDAVAILABLE) == 0)
+	(void) DBCellRead(rootUse->cu_def, (char *) NULL, TRUE, NULL);
+    dbReadAhead(&scontext, FALSE);
+
     (void) dbReadAreaFunc(&scontext);
 }
 
@@ -322,3 +352,105 @@ dbReadAreaFunc(scx)
 	return 2;
     return 0;
 }
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbReadAhead --
+ *
+ * Read in, ahead of a search by dbExpandFunc() or dbReadAreaFunc(),
+ * all of the cells that the search would read in, so that they can
+ * be read in parallel by dbCellReadList().  The children of a cell
+ * are only known once the cell has been read, so this is done one
+ * level of the hierarchy at a time:  each pass searches the whole
+ * area for cells not yet read, and reads them all at once.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Reads in cells.  Does nothing unless more than one worker
+ *	thread is available.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbReadAhead(scx, expand)
+    SearchContext *scx;	/* Area to search, in the root use's def */
+    bool expand;	/* TRUE for dbExpandFunc(), FALSE for
+			 * dbReadAreaFunc().
+			 */
+{
+    int dbReadAheadFunc();
+    struct readAheadArg arg;
+
+    if (WorkerGetCount() < 2)
+	return;
+
+    arg.ra_expand = expand;
+    HashInit(&arg.ra_seen, 32, HT_WORDKEYS);
+    arg.ra_defs = NULL;
+    arg.ra_maxDefs = 0;
+
+    while (TRUE)
+    {
+	arg.ra_nDefs = 0;
+	(void) DBCellSrArea(scx, dbReadAheadFunc, (ClientData) &arg);
+	if (arg.ra_nDefs == 0) break;
+	dbCellReadList(arg.ra_defs, arg.ra_nDefs);
+    }
+
+    if (arg.ra_defs != NULL)
+	freeMagic((char *) arg.ra_defs);
+    HashKill(&arg.ra_seen);
+}
+
+/*
+ * dbReadAheadFunc --
+ *
+ * Filter function called by DBCellSrArea on behalf of dbReadAhead
+ * above.  Cells already read are searched in the same way as by
+ * dbExpandFunc() or dbReadAreaFunc();  cells not yet read, and not
+ * seen before, are added to the list.
+ */
+
+int
+dbReadAheadFunc(scx, arg)
+    SearchContext *scx;
+    struct readAheadArg *arg;
+{
+    CellDef *def = scx->scx_use->cu_def;
+    CellDef **newDefs;
+    HashEntry *he;
+
+    if ((def->cd_flags & CDAVAILABLE) == 0)
+    {
+	he = HashFind(&arg->ra_seen, (char *) def);
+	if (HashGetValue(he) == NULL)
+	{
+	    HashSetValue(he, (ClientData) def);
+	    if (arg->ra_nDefs == arg->ra_maxDefs)
+	    {
+		arg->ra_maxDefs = (arg->ra_maxDefs == 0) ? 32
+			: arg->ra_maxDefs * 2;
+		newDefs = (CellDef **) mallocMagic((unsigned)
+			(arg->ra_maxDefs * sizeof (CellDef *)));
+		if (arg->ra_nDefs > 0)
+		    memcpy(newDefs, arg->ra_defs,
+				arg->ra_nDefs * sizeof (CellDef *));
+		if (arg->ra_defs != NULL)
+		    freeMagic((char *) arg->ra_defs);
+		arg->ra_defs = newDefs;
+	    }
+	    arg->ra_defs[arg->ra_nDefs++] = def;
+	}
+	return 2;
+    }
+
+    if (DBCellSrArea(scx, dbReadAheadFunc, (ClientData) arg))
+	return 1;
+    if (arg->ra_expand || GEO_SURROUND(&scx->scx_area, &def->cd_bbox))
+	return 2;
+    return 0;
+}
@@ -41,6 +41,10 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include <time.h>
 #include <sys/time.h>
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
 #ifdef HAVE_PATHS_H
 #include <paths.h>
 #endif
@@ -61,6 +65,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "utils/undo.h"
 #include "utils/malloc.h"
 #include "utils/signals.h"
+#include "utils/workers.h"
 
 #ifndef _PATH_TMP
 #define _PATH_TMP "/tmp"
@@ -88,6 +93,7 @@ bool dbReadLabels();
 bool dbReadElements();
 bool dbReadProperties();
 bool dbReadUse();
+bool dbWriteBackup();
 
 /*
  * ----------------------------------------------------------------------------
@@ -134,6 +140,184 @@ file_is_not_writeable(name)
     return(0);
 }
 
+#ifdef HAVE_SYS_MMAN_H
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbReadMapInt --
+ *
+ * Parse a decimal integer, with optional leading minus sign, from
+ * a memory-mapped file.  This is the same syntax accepted by
+ * GetRect(), except that at least one digit is required.
+ *
+ * Results:
+ *	Pointer to the first character after the number, or NULL
+ *	if there was no number at cp.
+ *
+ * Side effects:
+ *	Stores the value in *pval.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static char *
+dbReadMapInt(cp, end, pval)
+    char *cp, *end;	/* Text to parse, and end of the mapped file */
+    int *pval;		/* Value is returned here */
+{
+    bool isNegative;
+    int n;
+
+    if (isNegative = (cp < end && *cp == '-')) cp++;
+    if (cp >= end || !isdigit(*cp)) return NULL;
+    for (n = 0; cp < end && isdigit(*cp); cp++)
+	n = n * 10 + *cp - '0';
+    *pval = isNegative ? -n : n;
+    return cp;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbReadMappedRects --
+ *
+ * Fast path for the body of a "<< layer >>" section of a .mag file.
+ * Starting at the current position of f, parse as many consecutive
+ * "rect" lines as possible directly out of the memory-mapped image
+ * of the file, instead of going through getc() and GetRect() one
+ * character at a time.
+ *
+ * Anything that is not a plain "rect" line (triangles, comments,
+ * the next section header, or a line this routine doesn't like the
+ * look of) stops the scan;  the file is left positioned at the start
+ * of that line so that the caller's getc() loop can deal with it in
+ * the usual way.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Paints the rectangles into cellDef, advances f past them,
+ *	and updates *pCount.  The paint is the same as DBPaint()
+ *	would produce.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static void
+dbReadMappedRects(cellDef, f, map, mapSize, rmask, scalen, scaled, pCount,
+	manhattan)
+    CellDef *cellDef;		/* Cell being read */
+    FILE *f;			/* File being read, positioned at a line start */
+    char *map;			/* Memory-mapped image of f */
+    off_t mapSize;		/* Size of the image */
+    TileTypeBitMask *rmask;	/* Types to paint each rectangle with */
+    int scalen, scaled;		/* Scale factors, as for GetRect() */
+    int *pCount;		/* Running count of rectangles read */
+    bool manhattan;		/* If TRUE, cellDef has no split tiles */
+{
+    long pos;
+    char *cp, *end, *lp;
+    TileType rtype;
+    Rect r;
+
+    pos = ftell(f);
+    if (pos < 0 || pos >= mapSize) return;
+    end = map + mapSize;
+
+    for (cp = map + pos; end - cp > 5 && !strncmp(cp, "rect ", 5); cp = lp)
+    {
+	lp = cp + 5;
+	if ((lp = dbReadMapInt(lp, end, &r.r_xbot)) == NULL
+		|| lp >= end || *lp++ != ' ') break;
+	if ((lp = dbReadMapInt(lp, end, &r.r_ybot)) == NULL
+		|| lp >= end || *lp++ != ' ') break;
+	if ((lp = dbReadMapInt(lp, end, &r.r_xtop)) == NULL
+		|| lp >= end || *lp++ != ' ') break;
+	if ((lp = dbReadMapInt(lp, end, &r.r_ytop)) == NULL) break;
+
+	/* Ignore the rest of the line, as GetRect() does.  A	*/
+	/* last line with no newline is left to the slow path.	*/
+	while (lp < end && *lp != '\n') lp++;
+	if (lp >= end) break;
+	lp++;
+
+	if (scalen > 1)
+	{
+	    r.r_xbot *= scalen;
+	    r.r_ybot *= scalen;
+	    r.r_xtop *= scalen;
+	    r.r_ytop *= scalen;
+	}
+	if (scaled > 1)
+	{
+	    r.r_xbot /= scaled;
+	    r.r_ybot /= scaled;
+	    r.r_xtop /= scaled;
+	    r.r_ytop /= scaled;
+	}
+
+	if ((++(*pCount) % 10000 == 0) && DBVerbose && !WorkerInside())
+	{
+	    TxPrintf("%s: %d rects\n", cellDef->cd_name, *pCount);
+	    fflush(stdout);
+	}
+
+	if (!GEO_RECTNULL(&r))
+	    for (rtype = TT_SPACE + 1; rtype < DBNumUserLayers; rtype++)
+		if (TTMaskHasType(rmask, rtype))
+		{
+		    if (manhattan)
+			DBPaintManhattan(cellDef, &r, rtype);
+		    else
+			DBPaint(cellDef, &r, rtype);
+		}
+    }
+    if (cp != map + pos)
+	(void) fseek(f, (long) (cp - map), SEEK_SET);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbSkipMappedRects --
+ *
+ * Skip over the "rect" and "tri" lines at the current position of f,
+ * using the memory-mapped image of the file.  Used when the paint of
+ * the cell has already been read from its binary file (see DBbinio.c).
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Advances f to the start of the first line that is neither.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static void
+dbSkipMappedRects(f, map, mapSize)
+    FILE *f;			/* File being read, positioned at a line start */
+    char *map;			/* Memory-mapped image of f */
+    off_t mapSize;		/* Size of the image */
+{
+    long pos;
+    char *cp, *end, *lp;
+
+    pos = ftell(f);
+    if (pos < 0 || pos >= mapSize) return;
+    end = map + mapSize;
+
+    for (cp = map + pos; cp < end && (*cp == 'r' || *cp == 't'); cp = lp + 1)
+	if ((lp = memchr(cp, '\n', end - cp)) == NULL)
+	    break;
+    if (cp != map + pos)
+	(void) fseek(f, (long) (cp - map), SEEK_SET);
+}
+
+#endif	/* HAVE_SYS_MMAN_H */
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -251,7 +435,7 @@ file_is_not_writeable(name)
  */
 
 bool
-dbCellReadDef(f, cellDef, name, ignoreTech)
+dbCellReadDef(f, cellDef, name, ignoreTech, havePaint)
     FILE *f;		/* The file, already opened by the caller */
     CellDef *cellDef;	/* Pointer to definition of cell to be read in */
     char *name;		/* Name of file from which to read definition.
@@ -266,18 +450,27 @@ dbCellReadDef(f, cellDef, name, ignoreTech)
 			 * names do not match, but an attempt will be
 			 * made to read the file anyway.
 			 */
+    bool havePaint;	/* If TRUE, the paint of the cell has already
+			 * been read (see dbCellReadList()), and the
+			 * rectangles in the file are skipped over.
+			 */
 {
     int cellStamp = 0, rectCount = 0, rectReport = 10000;
     char line[2048], tech[50], layername[50];
     PaintResultType *ptable;
-    bool result = TRUE, scaleLimit = FALSE;
+    bool result = TRUE, scaleLimit = FALSE, manhattan, skipPaint;
     Rect *rp;
     int c;
     TileType type, rtype, loctype;
     TileTypeBitMask *rmask, typemask;
     Plane *plane;
     Rect r;
-    int n = 1, d = 1;
+    int n = 1, d = 1, pNum;
+#ifdef HAVE_SYS_MMAN_H
+    struct stat sbuf;
+    char *map = NULL;
+    off_t mapSize = 0;
+#endif
 
     /*
      * It's very important to disable interrupts during the body of
@@ -415,6 +608,44 @@ dbCellReadDef(f, cellDef, name, ignoreTech)
      */
     rp = &r;
     UndoDisable();
+
+    /*
+     * As long as the cell holds no split tiles, Manhattan paint
+     * can skip the merging of non-Manhattan tiles done by DBPaint().
+     * Cells are normally empty when read, and stay Manhattan until
+     * the first triangle is read.
+     */
+    manhattan = TRUE;
+    for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
+	if (DBBoundPlane(cellDef->cd_planes[pNum], &r))
+	    manhattan = FALSE;
+
+#ifdef HAVE_SYS_MMAN_H
+    /*
+     * Map the file into memory so that runs of rectangles can be
+     * parsed without going through stdio (see dbReadMappedRects()).
+     * If the file can't be mapped, everything is read with getc().
+     */
+    if ((fstat(fileno(f), &sbuf) == 0) && S_ISREG(sbuf.st_mode)
+		&& (sbuf.st_size > 0))
+    {
+	map = (char *) mmap(NULL, (size_t) sbuf.st_size, PROT_READ,
+		MAP_PRIVATE, fileno(f), (off_t) 0);
+	if (map == (char *) MAP_FAILED)
+	    map = NULL;
+	else
+	    mapSize = sbuf.st_size;
+    }
+#endif
+
+    /*
+     * If the paint can be taken from the binary copy kept next to
+     * the file, the rectangles in the file are just skipped over.
+     */
+    skipPaint = havePaint;
+    if (!skipPaint && DBBinaryCache && manhattan && (n == 1) && (d == 1))
+	skipPaint = dbBinRead(cellDef, f, cellStamp);
+
     while (TRUE)
     {
 	/*
@@ -491,10 +722,27 @@ dbCellReadDef(f, cellDef, name, ignoreTech)
 	 * in the file beginning with 'r'.
 	 */
 nextrect:
+#ifdef HAVE_SYS_MMAN_H
+	if (map != NULL)
+	{
+	    if (skipPaint)
+		dbSkipMappedRects(f, map, mapSize);
+	    else
+		dbReadMappedRects(cellDef, f, map, mapSize, rmask, n, d,
+			&rectCount, manhattan);
+	}
+#endif
 	while (((c = getc(f)) == 'r') || (c == 't'))
 	{
 	    TileType dinfo;
 	    int dir;
+
+	    if (skipPaint)
+	    {
+		(void) fgets(line, sizeof line, f);
+		continue;
+	    }
+
 	    /*
 	     * GetRect actually reads the rest of the line up to
 	     * a trailing newline or EOF.
@@ -546,7 +794,12 @@ nextrect:
 			loctype = rtype;
 			if (dinfo & TT_SIDE) loctype <<= 14;
 			loctype |= dinfo;
-			DBPaint(cellDef, rp, loctype);
+			if (dinfo != 0)
+			    manhattan = FALSE;
+			if (manhattan)
+			    DBPaintManhattan(cellDef, rp, loctype);
+			else
+			    DBPaint(cellDef, rp, loctype);
 		    }
 		}
 	    }
@@ -573,6 +826,13 @@ nextrect:
     }
 
 done:
+#ifdef HAVE_SYS_MMAN_H
+    if (map != NULL)
+    {
+	munmap(map, (size_t) mapSize);
+	map = NULL;
+    }
+#endif
 
     cellDef->cd_flags &= ~(CDMODIFIED|CDBOXESCHANGED|CDGETNEWSTAMP);
 
@@ -650,6 +910,7 @@ badfile:
 void
 DBRemoveBackup()
 {
+    DBBackupWait();
     if (DBbackupFile != (char *)NULL)
     {
 	unlink(DBbackupFile);
@@ -691,6 +952,7 @@ DBFileRecovery(filename)
     char *prompt;
     int action;
 
+    DBBackupWait();
     if (DBbackupFile != NULL)
     {
 	TxError("Error:  Backup file in use for current session.\n");
@@ -848,7 +1110,7 @@ DBReadBackup(name)
 	    cellDef->cd_flags &= ~CDNOTFOUND;
 	    cellDef->cd_flags |= CDAVAILABLE;
 
-	    if (dbCellReadDef(f, cellDef, filename, TRUE) == FALSE)
+	    if (dbCellReadDef(f, cellDef, filename, TRUE, FALSE) == FALSE)
 		return FALSE;
 
 	    if (dbFgets(line, sizeof(line), f) == NULL)
@@ -885,6 +1147,15 @@ DBReadBackup(name)
  * preparation for allowing certain cell definitions to be in-lined into the
  * output file (such as polygonXXXXX cells generated by the gds read-in).
  *
+ * Cells are read lazily, one whole cell at a time:  a def that appears
+ * in a "use" of its parent is not read until something needs what is
+ * inside it, and until then its bounding box is the one recorded in
+ * the parent's file (see dbReadUse()).  Once a cell is read, all of its
+ * planes are built.  They are not built plane by plane on first search,
+ * because the planes of a def are used through cd_planes[] directly all
+ * over the code, so reading a cell is made fast instead (see
+ * dbReadMappedRects()).
+ *
  * Results:
  *	TRUE if the cell could be read successfully, FALSE
  *	otherwise.  If the cell is already read in, TRUE is
@@ -933,7 +1204,7 @@ DBCellRead(cellDef, name, ignoreTech, errptr)
 
     else
     {
-	result = (dbCellReadDef(f, cellDef, name, ignoreTech));
+	result = (dbCellReadDef(f, cellDef, name, ignoreTech, FALSE));
 
 #ifdef FILE_LOCKS
 	/* Close files that were locked by another user */
@@ -950,150 +1221,455 @@ DBCellRead(cellDef, name, ignoreTech, errptr)
 /*
  * ----------------------------------------------------------------------------
  *
- * dbReadOpen --
- *
- * Open the file containing the cell we are going to read.
- * If a filename for the cell is specified ('name' is non-NULL),
- * we try to open it somewhere in the search path.  Otherwise,
- * we try the filename already associated with the cell, or the
- * name of the cell itself as the name of the file containing
- * the definition of the cell.
+ * dbReadPaint --
  *
- * If 'setFileName' is TRUE, then cellDef->cd_file will be updated
- * to point to the name of the file from which the cell was loaded.
+ * Read just the paint of a cell from its file, on behalf of
+ * dbCellReadList() below.  This may run in a pool thread, so it
+ * prints nothing and changes nothing but the cell's own planes and
+ * types.  Anything out of the ordinary (another technology, a scale
+ * other than the current one, an unknown layer, a format error)
+ * makes it give up, leaving the cell to be read by dbCellReadDef()
+ * in the usual way.  Cell uses, labels, elements, and properties are
+ * skipped over;  they are read later by dbCellReadDef().
  *
  * Results:
- *	Returns an open FILE * if successful, or NULL on error.
+ *	TRUE if all of the paint of the cell was read, FALSE otherwise.
  *
  * Side effects:
- *	Opens a FILE.  Leaves cellDef->cd_flags marked as
- *	CDAVAILABLE, with the CDNOTFOUND bit clear, if we
- *	were successful.
+ *	Paints into cellDef, whose paint planes must be empty.
+ *	Leaves f positioned anywhere.
  *
  * ----------------------------------------------------------------------------
  */
 
-FILE *
-dbReadOpen(cellDef, name, setFileName, errptr)
-    CellDef *cellDef;	/* Def being read */
-    char *name;		/* Name if specified, or NULL */
-    bool setFileName;	/* If TRUE then cellDef->cd_file should be updated
-			 * to point to the name of the file from which the
-			 * cell was loaded.
-			 */
-    int *errptr;	/* Pointer to int to hold error value */
+static bool
+dbReadPaint(f, cellDef)
+    FILE *f;		/* The file, already opened by the caller */
+    CellDef *cellDef;	/* Cell whose paint is to be read */
 {
-    FILE *f = NULL;
-    char *filename, *realname;
-    bool is_locked;
-
-#ifdef FILE_LOCKS
-    if (cellDef->cd_fd != -1)
-    {
-	close(cellDef->cd_fd);
-	cellDef->cd_fd = -1;
-    }
+    char line[2048], tech[50], layername[50];
+    int cellStamp = 0, rectCount = 0, n = 1, d = 1, c, dir;
+    bool result = FALSE, manhattan = TRUE;
+    TileType type, rtype, loctype, dinfo;
+    TileTypeBitMask typemask, *rmask;
+    Rect r;
+#ifdef HAVE_SYS_MMAN_H
+    struct stat sbuf;
+    char *map = NULL;
+    off_t mapSize = 0;
 #endif
 
-    if (errptr != NULL) *errptr = 0;	// No error, by default
+    /* Header:  see dbCellReadDef() */
+    if (dbFgets(line, sizeof line, f) == NULL) return FALSE;
+    if (strncmp(line, "magic", 5) != 0) return FALSE;
+    if (dbFgets(line, sizeof line, f) == NULL) return FALSE;
 
-    if (name != (char *) NULL)
+    if ((line[0] != '<') && (line[0] != '\0'))
     {
-	f = PaLockOpen(name, "r", DBSuffix, Path,
-			CellLibPath, &filename, &is_locked);
-	if (errptr != NULL) *errptr = errno;
+	if (sscanf(line, "tech %49s", tech) != 1) return FALSE;
+	if (strcmp(DBTechName, tech) != 0) return FALSE;
+	if (dbFgets(line, sizeof line, f) == NULL) return FALSE;
+	if (line[0] == 'm')
+	{
+	    if (sscanf(line, "magscale %d %d", &n, &d) != 2) return FALSE;
+	    if (dbFgets(line, sizeof line, f) == NULL) return FALSE;
+	}
+	if (line[0] == 't')
+	{
+	    if (sscanf(line, "timestamp %d", &cellStamp) != 1) return FALSE;
+	    if (dbFgets(line, sizeof line, f) == NULL) return FALSE;
+	}
     }
-    else if (cellDef->cd_file != (char *) NULL)
-    {
-	/* Do not send a name with a file extension to PaLockOpen(),
-	 * otherwise that routine must handle it and then cannot
-	 * distinguish between, say, cell.mag and cell.mag.mag.
-	 */
-	char *pptr, *sptr;
-
-	sptr = strrchr(cellDef->cd_file, '/');
-	if (sptr == NULL)
-	    sptr = cellDef->cd_file;
-	else
-	    sptr++;
-
-	pptr = strrchr(sptr, '.');
-	if (pptr != NULL)
-	    if (strcmp(pptr, DBSuffix)) pptr = NULL;
-	else
-	    *pptr = '\0';
-
-	f = PaLockOpen(cellDef->cd_file, "r", DBSuffix, ".",
-			(char *) NULL, &filename, &is_locked);
 
-	/* Fall back on the original method of using search paths. */
-
-	if (f == NULL)
-	{
-	    f = PaLockOpen(cellDef->cd_name, "r", DBSuffix, Path,
-			CellLibPath, &filename, &is_locked);
+    /* Changing the scale of the database is left to dbCellReadDef() */
+    n *= DBLambda[1];
+    d *= DBLambda[0];
+    ReduceFraction(&n, &d);
+    if ((n != 1) || (d != 1)) return FALSE;
 
-	    if (f != NULL)
-	    {
-		if (pptr != NULL) *pptr = '.';
-		TxError("Warning:  Parent cell lists instance of \"%s\" at bad file "
-			"path %s.\n", cellDef->cd_name, cellDef->cd_file);
-		TxError("The cell exists in the search paths at %s.\n", filename);
-		TxError("The discovered version will be used.\n");
-	    }
-	}
+    if (DBBinaryCache && dbBinRead(cellDef, f, cellStamp))
+	return TRUE;
 
-	if (errptr != NULL) *errptr = errno;
-	if (pptr != NULL) *pptr = '.';	// Put it back where you found it!
-    }
-    else
+#ifdef HAVE_SYS_MMAN_H
+    if ((fstat(fileno(f), &sbuf) == 0) && S_ISREG(sbuf.st_mode)
+		&& (sbuf.st_size > 0))
     {
-	f = PaLockOpen(cellDef->cd_name, "r", DBSuffix, Path,
-			CellLibPath, &filename, &is_locked);
-	if (errptr != NULL) *errptr = errno;
+	map = (char *) mmap(NULL, (size_t) sbuf.st_size, PROT_READ,
+		MAP_PRIVATE, fileno(f), (off_t) 0);
+	if (map == (char *) MAP_FAILED)
+	    map = NULL;
+	else
+	    mapSize = sbuf.st_size;
     }
+#endif
 
-    if (f == NULL)
+    while (TRUE)
     {
-	/* Don't print another message if we've already tried to read it */
-	if (cellDef->cd_flags & CDNOTFOUND)
-	    return ((FILE *) NULL);
-
-	if (name != (char *) NULL)
-	    TxError("File %s%s couldn't be read\n", name, DBSuffix);
-	else if (cellDef->cd_file != (char *) NULL)
-	    TxError("File %s couldn't be read\n", cellDef->cd_file);
-	else {
-	    TxError("Cell %s couldn't be read\n", cellDef->cd_name);
-	    realname = (char *) mallocMagic((unsigned) (strlen(cellDef->cd_name)
-			+ strlen(DBSuffix) + 1));
-	    (void) sprintf(realname, "%s%s", cellDef->cd_name, DBSuffix);
-	    cellDef->cd_file = StrDup(&cellDef->cd_file, realname);
+	/* Skip cell uses */
+	if (sscanf(line, "<< %49s >>", layername) != 1)
+	{
+	    if (dbFgets(line, sizeof line, f) == NULL) goto done;
+	    continue;
 	}
-	if (errptr) TxError("%s\n", strerror(*errptr));
 
-	cellDef->cd_flags |= CDNOTFOUND;
-	return ((FILE *) NULL);
-    }
+	if (!strcmp(layername, "end"))
+	{
+	    result = TRUE;
+	    goto done;
+	}
 
-#ifdef FILE_LOCKS
-    else
-    {
-	if (file_is_not_writeable(filename) || (is_locked == TRUE))
+	TTMaskZero(&typemask);
+	rmask = &typemask;
+	type = DBTechNameType(layername);
+	if (type < 0)
 	{
-	    cellDef->cd_flags |= CDNOEDIT;
-	    if ((is_locked == FALSE) && DBVerbose)
-		TxPrintf("Warning: cell <%s> from file %s is not writeable\n",
-			cellDef->cd_name, filename);
+	    /* Skip sections other than paint */
+	    if (strcmp(layername, "labels") && strcmp(layername, "elements")
+			&& strcmp(layername, "properties"))
+		goto done;
+	    do
+		if (dbFgets(line, sizeof line, f) == NULL) goto done;
+	    while (strncmp(line, "<<", 2) != 0);
+	    continue;
 	}
-	else
-	    cellDef->cd_flags &= ~CDNOEDIT;
 
-	if (is_locked == FALSE)
-	    cellDef->cd_fd = fileno(f);
-	cellDef->cd_flags &= ~CDNOTFOUND;
-    }
-#else
+	if (DBPlane(type) > 0)
+	{
+	    if (type < DBNumUserLayers)
+	    {
+		TTMaskSetType(&cellDef->cd_types, type);
+		TTMaskSetType(rmask, type);
+	    }
+	    else
+	    {
+	        rmask = DBResidueMask(type);
+		for (rtype = TT_SPACE + 1; rtype < DBNumUserLayers; rtype++)
+		    if (TTMaskHasType(rmask, rtype))
+			TTMaskSetType(&cellDef->cd_types, type);
+	    }
+	}
+
+nextrect:
+#ifdef HAVE_SYS_MMAN_H
+	if (map != NULL)
+	    dbReadMappedRects(cellDef, f, map, mapSize, rmask, n, d,
+			&rectCount, manhattan);
+#endif
+	while (((c = getc(f)) == 'r') || (c == 't'))
+	{
+	    if (c == 't')
+	    {
+		if ((dir = GetRect(f, 3, &r, n, d)) == 0) goto done;
+		dir >>= 1;
+		dinfo = TT_DIAGONAL | ((dir & 0x2) ? TT_SIDE : 0) |
+			((((dir & 0x2) >> 1) ^ (dir & 0x1)) ?
+			TT_DIRECTION : 0);
+	    }
+	    else
+	    {
+		dinfo = 0;
+		if (!GetRect(f, 4, &r, n, d)) goto done;
+	    }
+
+	    if (GEO_RECTNULL(&r)) continue;
+	    for (rtype = TT_SPACE + 1; rtype < DBNumUserLayers; rtype++)
+		if (TTMaskHasType(rmask, rtype))
+		{
+		    loctype = rtype;
+		    if (dinfo & TT_SIDE) loctype <<= 14;
+		    loctype |= dinfo;
+		    if (dinfo != 0)
+			manhattan = FALSE;
+		    if (manhattan)
+			DBPaintManhattan(cellDef, &r, loctype);
+		    else
+			DBPaint(cellDef, &r, loctype);
+		}
+	}
+
+	if (c == '#')
+	{
+	    (void) fgets(line, sizeof line, f);
+	    goto nextrect;
+	}
+	if (c == EOF) goto done;
+	line[0] = c;
+	if (dbFgets(&line[1], sizeof line - 1, f) == NULL) goto done;
+    }
+
+done:
+#ifdef HAVE_SYS_MMAN_H
+    if (map != NULL)
+	munmap(map, (size_t) mapSize);
+#endif
+    return result;
+}
+
+/*
+ * Work list for dbCellReadList().  One entry per cell.
+ */
+
+typedef struct
+{
+    CellDef	*rt_def;	/* Cell being read */
+    FILE	*rt_file;	/* Its file, as opened by dbReadOpen() */
+    bool	 rt_paint;	/* TRUE if dbReadPaint() read all its paint */
+} ReadTask;
+
+/*
+ * dbReadPaintTask --
+ *
+ * Called by WorkerRun() on behalf of dbCellReadList() for each cell.
+ * Always returns 0.
+ */
+
+int
+dbReadPaintTask(task, worker, cdata)
+    int task;
+    int worker;
+    ClientData cdata;	/* Array of ReadTask */
+{
+    ReadTask *rt = &((ReadTask *) cdata)[task];
+
+    rt->rt_paint = dbReadPaint(rt->rt_file, rt->rt_def);
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbCellReadList --
+ *
+ * Read in a number of cells at once, as DBCellRead() would one at a
+ * time.  Most of the work of reading a cell is in its paint, and the
+ * paint of different cells can be read independently, so this is
+ * done in parallel on the worker pool (see utils/workers.c).  Then
+ * the rest of each file (cell uses, labels, and so forth, which may
+ * link into other cells or print messages) is read serially in the
+ * order given, skipping the paint already read.  Cells whose paint
+ * couldn't be read in a worker, for instance because they need the
+ * database to be rescaled, are then read entirely in the usual way.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	See DBCellRead().  Cells that are already available are left
+ *	alone.  Errors are reported in the same way as by DBCellRead().
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbCellReadList(defList, nDefs)
+    CellDef **defList;	/* Cells to be read */
+    int nDefs;		/* Number of entries in defList */
+{
+    ReadTask *tasks, *rt;
+    CellDef *cellDef;
+    FILE *f;
+    int i, nTasks, pNum, pass;
+
+    tasks = (ReadTask *) mallocMagic((unsigned) (nDefs * sizeof (ReadTask)));
+    nTasks = 0;
+    for (i = 0; i < nDefs; i++)
+    {
+	cellDef = defList[i];
+	if (cellDef->cd_flags & CDAVAILABLE) continue;
+	if ((f = dbReadOpen(cellDef, (char *) NULL, TRUE, (int *) NULL)) == NULL)
+	    continue;
+	rt = &tasks[nTasks++];
+	rt->rt_def = cellDef;
+	rt->rt_file = f;
+	rt->rt_paint = FALSE;
+    }
+
+    /* Nothing may be undone or interrupted while the workers paint */
+    SigDisableInterrupts();
+    UndoDisable();
+    (void) WorkerRun(nTasks, dbReadPaintTask, (ClientData) tasks);
+    UndoEnable();
+    SigEnableInterrupts();
+
+    /*
+     * Cells whose paint is already in are finished first, since
+     * reading one of the others may rescale the whole database.
+     */
+    for (pass = 0; pass < 2; pass++)
+	for (i = 0; i < nTasks; i++)
+	{
+	    rt = &tasks[i];
+	    if (rt->rt_paint != (pass == 0)) continue;
+	    cellDef = rt->rt_def;
+	    f = rt->rt_file;
+
+	    if (!rt->rt_paint)
+	    {
+		/* Throw away whatever dbReadPaint() read before giving up */
+		for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
+		    DBClearPaintPlane(cellDef->cd_planes[pNum]);
+		TTMaskZero(&cellDef->cd_types);
+	    }
+	    rewind(f);
+	    (void) dbCellReadDef(f, cellDef, (char *) NULL, TRUE, rt->rt_paint);
+
+#ifdef FILE_LOCKS
+	    if (cellDef->cd_fd == -1) fclose(f);
+#else
+	    fclose(f);
+#endif
+	}
+
+    freeMagic((char *) tasks);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbReadOpen --
+ *
+ * Open the file containing the cell we are going to read.
+ * If a filename for the cell is specified ('name' is non-NULL),
+ * we try to open it somewhere in the search path.  Otherwise,
+ * we try the filename already associated with the cell, or the
+ * name of the cell itself as the name of the file containing
+ * the definition of the cell.
+ *
+ * If 'setFileName' is TRUE, then cellDef->cd_file will be updated
+ * to point to the name of the file from which the cell was loaded.
+ *
+ * Results:
+ *	Returns an open FILE * if successful, or NULL on error.
+ *
+ * Side effects:
+ *	Opens a FILE.  Leaves cellDef->cd_flags marked as
+ *	CDAVAILABLE, with the CDNOTFOUND bit clear, if we
+ *	were successful.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+FILE *
+dbReadOpen(cellDef, name, setFileName, errptr)
+    CellDef *cellDef;	/* Def being read */
+    char *name;		/* Name if specified, or NULL */
+    bool setFileName;	/* If TRUE then cellDef->cd_file should be updated
+			 * to point to the name of the file from which the
+			 * cell was loaded.
+			 */
+    int *errptr;	/* Pointer to int to hold error value */
+{
+    FILE *f = NULL;
+    char *filename, *realname;
+    bool is_locked;
+
+#ifdef FILE_LOCKS
+    if (cellDef->cd_fd != -1)
+    {
+	close(cellDef->cd_fd);
+	cellDef->cd_fd = -1;
+    }
+#endif
+
+    if (errptr != NULL) *errptr = 0;	// No error, by default
+
+    if (name != (char *) NULL)
+    {
+	f = PaLockOpen(name, "r", DBSuffix, Path,
+			CellLibPath, &filename, &is_locked);
+	if (errptr != NULL) *errptr = errno;
+    }
+    else if (cellDef->cd_file != (char *) NULL)
+    {
+	/* Do not send a name with a file extension to PaLockOpen(),
+	 * otherwise that routine must handle it and then cannot
+	 * distinguish between, say, cell.mag and cell.mag.mag.
+	 */
+	char *pptr, *sptr;
+
+	sptr = strrchr(cellDef->cd_file, '/');
+	if (sptr == NULL)
+	    sptr = cellDef->cd_file;
+	else
+	    sptr++;
+
+	pptr = strrchr(sptr, '.');
+	if (pptr != NULL)
+	    if (strcmp(pptr, DBSuffix)) pptr = NULL;
+	else
+	    *pptr = '\0';
+
+	f = PaLockOpen(cellDef->cd_file, "r", DBSuffix, ".",
+			(char *) NULL, &filename, &is_locked);
+
+	/* Fall back on the original method of using search paths. */
+
+	if (f == NULL)
+	{
+	    f = PaLockOpen(cellDef->cd_name, "r", DBSuffix, Path,
+			CellLibPath, &filename, &is_locked);
+
+	    if (f != NULL)
+	    {
+		if (pptr != NULL) *pptr = '.';
+		TxError("Warning:  Parent cell lists instance of \"%s\" at bad file "
+			"path %s.\n", cellDef->cd_name, cellDef->cd_file);
+		TxError("The cell exists in the search paths at %s.\n", filename);
+		TxError("The discovered version will be used.\n");
+	    }
+	}
+
+	if (errptr != NULL) *errptr = errno;
+	if (pptr != NULL) *pptr = '.';	// Put it back where you found it!
+    }
+    else
+    {
+	f = PaLockOpen(cellDef->cd_name, "r", DBSuffix, Path,
+			CellLibPath, &filename, &is_locked);
+	if (errptr != NULL) *errptr = errno;
+    }
+
+    if (f == NULL)
+    {
+	/* Don't print another message if we've already tried to read it */
+	if (cellDef->cd_flags & CDNOTFOUND)
+	    return ((FILE *) NULL);
+
+	if (name != (char *) NULL)
+	    TxError("File %s%s couldn't be read\n", name, DBSuffix);
+	else if (cellDef->cd_file != (char *) NULL)
+	    TxError("File %s couldn't be read\n", cellDef->cd_file);
+	else {
+	    TxError("Cell %s couldn't be read\n", cellDef->cd_name);
+	    realname = (char *) mallocMagic((unsigned) (strlen(cellDef->cd_name)
+			+ strlen(DBSuffix) + 1));
+	    (void) sprintf(realname, "%s%s", cellDef->cd_name, DBSuffix);
+	    cellDef->cd_file = StrDup(&cellDef->cd_file, realname);
+	}
+	if (errptr) TxError("%s\n", strerror(*errptr));
+
+	cellDef->cd_flags |= CDNOTFOUND;
+	return ((FILE *) NULL);
+    }
+
+#ifdef FILE_LOCKS
+    else
+    {
+	if (file_is_not_writeable(filename) || (is_locked == TRUE))
+	{
+	    cellDef->cd_flags |= CDNOEDIT;
+	    if ((is_locked == FALSE) && DBVerbose)
+		TxPrintf("Warning: cell <%s> from file %s is not writeable\n",
+			cellDef->cd_name, filename);
+	}
+	else
+	    cellDef->cd_flags &= ~CDNOEDIT;
+
+	if (is_locked == FALSE)
+	    cellDef->cd_fd = fileno(f);
+	cellDef->cd_flags &= ~CDNOTFOUND;
+    }
+#else
     if (file_is_not_writeable(filename) && DBVerbose)
 	TxPrintf("Warning: cell <%s> from file %s is not writeable\n",
 		cellDef->cd_name, filename);
@@ -2273,102 +2849,135 @@ dbFindCellGCFFunc(cellUse, ggcf)
 /*
  * ----------------------------------------------------------------------------
  *
- * DBCellWriteFile --
+ * dbWBGrow --
+ * dbWBStr --
+ * dbWBInt --
  *
- * NOTE: this routine is usually not want you want.  Use DBCellWrite().
- *
- * Write out the paint for a cell to the specified file.
- * Mark the cell as having been written out.  Before calling this
- * procedure, the caller should make sure that timestamps have been
- * updated where appropriate.
+ * Append to the text of a cell being written.  The whole text of
+ * a cell is put together in memory before any of it goes to the
+ * file, so that all of it can be handed to the operating system
+ * at once, and so that the paint of several cells can be turned
+ * into text in parallel (see DBCellWritePrepare()).  dbWBInt() is
+ * a plain decimal conversion, much cheaper than the sprintf() that
+ * it replaces for the millions of coordinates in a large cell.
  *
  * Results:
- *	TRUE if the cell could be written successfully, FALSE otherwise.
+ *	None.
  *
  * Side effects:
- *	Writes a file to disk.
- * 	Does NOT close the file 'f', but does fflush(f) before
- * 	returning.
- *
- *	If successful, clears the CDMODIFIED, CDBOXESCHANGED,
- *	and CDSTAMPSCHANGED bits in cellDef->cd_flags.
- *
- *	In the event of an error while writing out the cell,
- *	the external integer errno is set to the UNIX error
- *	encountered, and the above bits are not cleared in
- *	cellDef->cd_flags.
+ *	Grows the buffer as needed.
  *
  * ----------------------------------------------------------------------------
  */
 
-bool
-DBCellWriteFile(cellDef, f)
-    CellDef *cellDef;	/* Pointer to definition of cell to be written out */
-    FILE *f;		/* The FILE to write to */
+void
+dbWBGrow(wb, n)
+    WriteBuf *wb;
+    int n;		/* Number of characters about to be added */
 {
-    int dbWritePaintFunc(), dbWriteCellFunc(), dbWritePropFunc();
-    int dbClearCellFunc();
-    Label *lab;
-    struct writeArg arg;
-    int pNum;
-    TileType type, stype;
-    TileTypeBitMask typeMask, *sMask;
-    int reducer;
-    char *estring;
-    char lstring[256];
-
-#define FPRINTF(f,s)\
-{\
-     if (fprintf(f,s) == EOF) goto ioerror;\
-     DBFileOffset += strlen(s);\
+    char *newtext;
+    int newsize;
+
+    if (wb->wb_len + n <= wb->wb_size) return;
+    newsize = (wb->wb_size == 0) ? 8192 : wb->wb_size;
+    while (newsize < wb->wb_len + n) newsize *= 2;
+    newtext = (char *) mallocMagic((unsigned) newsize);
+    if (wb->wb_len > 0)
+	memcpy(newtext, wb->wb_text, wb->wb_len);
+    if (wb->wb_text != NULL)
+	freeMagic(wb->wb_text);
+    wb->wb_text = newtext;
+    wb->wb_size = newsize;
 }
-#define FPRINTR(f,s)\
-{\
-     if (fprintf(f,s) == EOF) return 1;\
-     DBFileOffset += strlen(s);\
+
+void
+dbWBStr(wb, s)
+    WriteBuf *wb;
+    char *s;
+{
+    int n = strlen(s);
+
+    dbWBGrow(wb, n);
+    memcpy(wb->wb_text + wb->wb_len, s, n);
+    wb->wb_len += n;
 }
 
-    if (f == NULL) return FALSE;
+void
+dbWBInt(wb, value, sep)
+    WriteBuf *wb;
+    int value;
+    char sep;		/* Character to follow the number */
+{
+    char digits[16], *dp;
+    unsigned int u;
 
-    /* If interrupts are left enabled, a partial file could get written.
-     * This is not good.
-     */
+    dp = digits + sizeof digits;
+    *--dp = sep;
+    u = (value < 0) ? -(unsigned int) value : (unsigned int) value;
+    do
+    {
+	*--dp = '0' + (u % 10);
+	u /= 10;
+    }
+    while (u != 0);
+    if (value < 0) *--dp = '-';
 
-    reducer = DBCellFindScale(cellDef);
+    dbWBGrow(wb, digits + sizeof digits - dp);
+    while (dp < digits + sizeof digits)
+	wb->wb_text[wb->wb_len++] = *dp++;
+}
 
-    SigDisableInterrupts();
-    DBFileOffset = 0;
+/*
+ * Paint of cells turned into text ahead of time by DBCellWritePrepare(),
+ * indexed by CellDef.  Each entry is a WritePrep.
+ */
 
-    if (cellDef->cd_flags & CDGETNEWSTAMP)
-	TxPrintf("Magic error: writing out-of-date timestamp for %s.\n",
-	    cellDef->cd_name);
+typedef struct
+{
+    CellDef	*wp_def;	/* Cell whose paint this is */
+    int		 wp_reducer;	/* Scale factor, from DBCellFindScale() */
+    WriteBuf	 wp_paint;	/* Text of the paint section */
+} WritePrep;
 
-    {
-    	 char headerstring[256];
-	 if (DBLambda[0] == (DBLambda[1] / reducer))	/* Default scale */
-	     sprintf(headerstring,"magic\ntech %s\ntimestamp %d\n",
-	 		DBTechName,cellDef->cd_timestamp);
-	 else
-	     sprintf(headerstring,"magic\ntech %s\nmagscale %d %d\ntimestamp %d\n",
-	 		DBTechName, DBLambda[0], DBLambda[1] / reducer,
-			cellDef->cd_timestamp);
-	 FPRINTF(f, headerstring);
-    }
+static HashTable dbWritePrepTable;
+static bool dbWritePrepInit = FALSE;
 
-    /*
-     * Output the paint of the cell.
-     * Note that we only output up to the last layer appearing
-     * in the technology file (DBNumUserLayers-1).  Automatically
-     * generated stacked contact types are added to typeMask and
-     * will be decomposed into the residue appropriate for the
-     * plane being searched.
-     */
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbWritePaint --
+ *
+ * Append the paint of a cell to a buffer, in the format of a .mag file.
+ * Note that we only output up to the last layer appearing in the
+ * technology file (DBNumUserLayers-1).  Automatically generated stacked
+ * contact types are added to typeMask and will be decomposed into the
+ * residue appropriate for the plane being searched.
+ *
+ * This only reads the database, and may be run by the worker pool.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Appends to wb.
+ *
+ * ----------------------------------------------------------------------------
+ */
 
-    if (cellDef->cd_file)
-	arg.wa_name = cellDef->cd_file;
-    else
-	arg.wa_name = cellDef->cd_name;
-    arg.wa_file = f;
+void
+dbWritePaint(cellDef, reducer, wb)
+    CellDef *cellDef;	/* Cell whose paint is to be written */
+    int reducer;	/* Scale factor for all geometry */
+    WriteBuf *wb;	/* Buffer to append to */
+{
+    int dbWritePaintFunc();
+    struct writeArg arg;
+    int pNum;
+    TileType type, stype;
+    TileTypeBitMask typeMask, *sMask;
+
+    arg.wa_name = (cellDef->cd_file) ? cellDef->cd_file : cellDef->cd_name;
+    arg.wa_buf = wb;
     arg.wa_reducer = reducer;
     for (type = TT_PAINTBASE; type < DBNumUserLayers; type++)
     {
@@ -2389,14 +2998,217 @@ DBCellWriteFile(cellDef, f)
 		TTMaskSetType(&typeMask, stype);
 	}
 
-	if (DBSrPaintArea((Tile *) NULL, cellDef->cd_planes[pNum],
-		&TiPlaneRect, &typeMask, dbWritePaintFunc, (ClientData) &arg))
-	    goto ioerror;
+	(void) DBSrPaintArea((Tile *) NULL, cellDef->cd_planes[pNum],
+		&TiPlaneRect, &typeMask, dbWritePaintFunc, (ClientData) &arg);
+    }
+}
+
+/*
+ * dbWritePrepTask --
+ *
+ * Called by WorkerRun() on behalf of DBCellWritePrepare() for each cell.
+ * Always returns 0.
+ */
+
+int
+dbWritePrepTask(task, worker, cdata)
+    int task;
+    int worker;
+    ClientData cdata;	/* Array of WritePrep */
+{
+    WritePrep *wp = &((WritePrep *) cdata)[task];
+
+    wp->wp_reducer = DBCellFindScale(wp->wp_def);
+    dbWritePaint(wp->wp_def, wp->wp_reducer, &wp->wp_paint);
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBCellWritePrepare --
+ *
+ * Get ready to write out a number of cells.  The paint is by far
+ * the largest part of most cells, and the paint of different cells
+ * can be turned into text independently, so this is done for all
+ * of the cells in parallel on the worker pool (see utils/workers.c).
+ * The text is kept until the cell is written by DBCellWrite() or
+ * DBCellWriteFile(), which then only need to add the cell uses,
+ * labels, and so forth.
+ *
+ * The paint of the cells must not change until they have been
+ * written or DBCellWriteUnprepare() has been called.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Allocates memory for the text of each cell's paint.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+DBCellWritePrepare(defList, nDefs)
+    CellDef **defList;	/* Cells about to be written */
+    int nDefs;		/* Number of entries in defList */
+{
+    WritePrep *tasks, *wp;
+    HashEntry *he;
+    int i, nTasks;
+
+    if (!dbWritePrepInit)
+    {
+	HashInit(&dbWritePrepTable, 32, HT_WORDKEYS);
+	dbWritePrepInit = TRUE;
     }
 
+    tasks = (WritePrep *) mallocMagic((unsigned) (nDefs * sizeof (WritePrep)));
+    nTasks = 0;
+    for (i = 0; i < nDefs; i++)
+    {
+	if (!(defList[i]->cd_flags & CDAVAILABLE)) continue;
+	if (HashLookOnly(&dbWritePrepTable, (char *) defList[i]) != NULL)
+	    continue;
+	wp = &tasks[nTasks++];
+	wp->wp_def = defList[i];
+	wp->wp_paint.wb_text = NULL;
+	wp->wp_paint.wb_len = wp->wp_paint.wb_size = 0;
+    }
+
+    SigDisableInterrupts();
+    (void) WorkerRun(nTasks, dbWritePrepTask, (ClientData) tasks);
+    SigEnableInterrupts();
+
+    for (i = 0; i < nTasks; i++)
+    {
+	wp = (WritePrep *) mallocMagic((unsigned) sizeof (WritePrep));
+	*wp = tasks[i];
+	he = HashFind(&dbWritePrepTable, (char *) wp->wp_def);
+	HashSetValue(he, (ClientData) wp);
+    }
+    freeMagic((char *) tasks);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBCellWriteUnprepare --
+ *
+ * Throw away the text prepared by DBCellWritePrepare() for any cells
+ * that were not written after all.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Frees memory.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+DBCellWriteUnprepare()
+{
+    HashSearch hs;
+    HashEntry *he;
+    WritePrep *wp;
+
+    if (!dbWritePrepInit) return;
+
+    HashStartSearch(&hs);
+    while ((he = HashNext(&dbWritePrepTable, &hs)) != NULL)
+    {
+	wp = (WritePrep *) HashGetValue(he);
+	if (wp == NULL) continue;
+	if (wp->wp_paint.wb_text != NULL)
+	    freeMagic(wp->wp_paint.wb_text);
+	freeMagic((char *) wp);
+    }
+    HashKill(&dbWritePrepTable);
+    dbWritePrepInit = FALSE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbCellWriteText --
+ *
+ * Append the complete text of a cell, as it appears in a .mag file,
+ * to a buffer.  The paint is taken from DBCellWritePrepare() if it
+ * was prepared.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Appends to wb.  Consumes any prepared text for the cell.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbCellWriteText(cellDef, wb)
+    CellDef *cellDef;	/* Cell to be written */
+    WriteBuf *wb;	/* Buffer to append to */
+{
+    int dbWriteCellFunc(), dbWritePropFunc();
+    int dbClearCellFunc();
+    Label *lab;
+    struct writeArg arg;
+    WritePrep *wp = NULL;
+    HashEntry *he;
+    int reducer;
+    char *estring;
+    char lstring[256];
+
+    if (dbWritePrepInit)
+    {
+	he = HashLookOnly(&dbWritePrepTable, (char *) cellDef);
+	if (he != NULL)
+	{
+	    wp = (WritePrep *) HashGetValue(he);
+	    HashSetValue(he, (ClientData) NULL);
+	}
+    }
+    reducer = (wp != NULL) ? wp->wp_reducer : DBCellFindScale(cellDef);
+
+    dbWBStr(wb, "magic\ntech ");
+    dbWBStr(wb, DBTechName);
+    if (DBLambda[0] != (DBLambda[1] / reducer))	/* Not default scale */
+    {
+	dbWBStr(wb, "\nmagscale ");
+	dbWBInt(wb, DBLambda[0], ' ');
+	dbWBInt(wb, DBLambda[1] / reducer, '\n');
+    }
+    else
+	dbWBStr(wb, "\n");
+    dbWBStr(wb, "timestamp ");
+    dbWBInt(wb, cellDef->cd_timestamp, '\n');
+
+    /* Output the paint of the cell */
+
+    if (wp != NULL)
+    {
+	if (wp->wp_paint.wb_len > 0)
+	{
+	    dbWBGrow(wb, wp->wp_paint.wb_len);
+	    memcpy(wb->wb_text + wb->wb_len, wp->wp_paint.wb_text,
+			wp->wp_paint.wb_len);
+	    wb->wb_len += wp->wp_paint.wb_len;
+	}
+	if (wp->wp_paint.wb_text != NULL)
+	    freeMagic(wp->wp_paint.wb_text);
+	freeMagic((char *) wp);
+    }
+    else
+	dbWritePaint(cellDef, reducer, wb);
+
     /* Now the cell uses */
-    if (DBCellEnum(cellDef, dbWriteCellFunc, (ClientData) &arg))
-	goto ioerror;
+    arg.wa_name = (cellDef->cd_file) ? cellDef->cd_file : cellDef->cd_name;
+    arg.wa_buf = wb;
+    arg.wa_reducer = reducer;
+    (void) DBCellEnum(cellDef, dbWriteCellFunc, (ClientData) &arg);
 
     /* Clear flags set in dbWriteCellFunc */
     DBCellEnum(cellDef, dbClearCellFunc, (ClientData)NULL);
@@ -2404,24 +3216,24 @@ DBCellWriteFile(cellDef, f)
     /* Now labels */
     if (cellDef->cd_labels)
     {
-	FPRINTF(f, "<< labels >>\n");
+	dbWBStr(wb, "<< labels >>\n");
 	for (lab = cellDef->cd_labels; lab; lab = lab->lab_next)
 	{
 	    if (strlen(lab->lab_text) == 0) continue;	// Shouldn't happen
 	    if (lab->lab_font < 0)
 	    {
-		sprintf(lstring, "rlabel %s %s%d %d %d %d %d %s\n",
+		sprintf(lstring, "rlabel %s %s%d %d %d %d %d ",
 			DBTypeLongName(lab->lab_type),
 			((lab->lab_flags & LABEL_STICKY) ? "s " : ""),
 			lab->lab_rect.r_xbot / reducer,
 			lab->lab_rect.r_ybot / reducer,
 			lab->lab_rect.r_xtop / reducer,
 			lab->lab_rect.r_ytop / reducer,
-			lab->lab_just, lab->lab_text);
+			lab->lab_just);
 	    }
 	    else
 	    {
-		sprintf(lstring, "flabel %s %s%d %d %d %d %d %s %d %d %d %d %s\n",
+		sprintf(lstring, "flabel %s %s%d %d %d %d %d %s %d %d %d %d ",
 			DBTypeLongName(lab->lab_type),
 			((lab->lab_flags & LABEL_STICKY) ? "s " : ""),
 			lab->lab_rect.r_xbot / reducer,
@@ -2431,9 +3243,11 @@ DBCellWriteFile(cellDef, f)
 			lab->lab_just, DBFontList[lab->lab_font]->mf_name,
 			lab->lab_size / reducer, lab->lab_rotate,
 			lab->lab_offset.p_x / reducer,
-			lab->lab_offset.p_y / reducer, lab->lab_text);
+			lab->lab_offset.p_y / reducer);
 	    }
-	    FPRINTF(f, lstring);
+	    dbWBStr(wb, lstring);
+	    dbWBStr(wb, lab->lab_text);
+	    dbWBStr(wb, "\n");
 	    if (lab->lab_flags & PORT_DIR_MASK)
 	    {
 		char ppos[5];
@@ -2493,7 +3307,7 @@ DBCellWriteFile(cellDef, f)
 		    }
 		}
 		strcat(lstring, "\n");
-		FPRINTF(f, lstring); 
+		dbWBStr(wb, lstring);
 	    }
 	}
     }
@@ -2502,16 +3316,16 @@ DBCellWriteFile(cellDef, f)
     estring = DBWPrintElements(cellDef, DBW_ELEMENT_PERSISTENT);
     if (estring != NULL)
     {
-	FPRINTF(f, "<< elements >>\n");
-	FPRINTF(f, estring);
+	dbWBStr(wb, "<< elements >>\n");
+	dbWBStr(wb, estring);
 	freeMagic(estring);
     }
 
     /* And any properties */
     if (cellDef->cd_props != (ClientData)NULL)
     {
-	FPRINTF(f, "<< properties >>\n");
-	DBPropEnum(cellDef, dbWritePropFunc, (ClientData)f);
+	dbWBStr(wb, "<< properties >>\n");
+	DBPropEnum(cellDef, dbWritePropFunc, (ClientData) wb);
     }
 
     /* Fixed bounding box goes into a special property in output file	*/
@@ -2525,21 +3339,84 @@ DBCellWriteFile(cellDef, f)
 	// write the header
 
 	if (cellDef->cd_props == (ClientData)NULL)
-	    FPRINTF(f, "<< properties >>\n");
+	    dbWBStr(wb, "<< properties >>\n");
 
-	sprintf(lstring, "string FIXED_BBOX %d %d %d %d\n",
-		cellDef->cd_bbox.r_xbot / reducer,
-		cellDef->cd_bbox.r_ybot / reducer,
-		cellDef->cd_bbox.r_xtop / reducer,
-		cellDef->cd_bbox.r_ytop / reducer);
-	FPRINTF(f, lstring);
+	dbWBStr(wb, "string FIXED_BBOX ");
+	dbWBInt(wb, cellDef->cd_bbox.r_xbot / reducer, ' ');
+	dbWBInt(wb, cellDef->cd_bbox.r_ybot / reducer, ' ');
+	dbWBInt(wb, cellDef->cd_bbox.r_xtop / reducer, ' ');
+	dbWBInt(wb, cellDef->cd_bbox.r_ytop / reducer, '\n');
     }
 
-    FPRINTF(f, "<< end >>\n");
+    dbWBStr(wb, "<< end >>\n");
+}
 
-    if (fflush(f) == EOF || ferror(f))
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBCellWriteFile --
+ *
+ * NOTE: this routine is usually not want you want.  Use DBCellWrite().
+ *
+ * Write out the paint for a cell to the specified file.
+ * Mark the cell as having been written out.  Before calling this
+ * procedure, the caller should make sure that timestamps have been
+ * updated where appropriate.
+ *
+ * Results:
+ *	TRUE if the cell could be written successfully, FALSE otherwise.
+ *
+ * Side effects:
+ *	Writes a file to disk.
+ * 	Does NOT close the file 'f', but does fflush(f) before
+ * 	returning.
+ *
+ *	If successful, clears the CDMODIFIED, CDBOXESCHANGED,
+ *	and CDSTAMPSCHANGED bits in cellDef->cd_flags.
+ *
+ *	In the event of an error while writing out the cell,
+ *	the external integer errno is set to the UNIX error
+ *	encountered, and the above bits are not cleared in
+ *	cellDef->cd_flags.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+DBCellWriteFile(cellDef, f)
+    CellDef *cellDef;	/* Pointer to definition of cell to be written out */
+    FILE *f;		/* The FILE to write to */
+{
+    WriteBuf wb;
+    bool result;
+
+    if (f == NULL) return FALSE;
+
+    /* If interrupts are left enabled, a partial file could get written.
+     * This is not good.
+     */
+
+    SigDisableInterrupts();
+    DBFileOffset = 0;
+
+    if (cellDef->cd_flags & CDGETNEWSTAMP)
+	TxPrintf("Magic error: writing out-of-date timestamp for %s.\n",
+	    cellDef->cd_name);
+
+    wb.wb_text = NULL;
+    wb.wb_len = wb.wb_size = 0;
+    dbCellWriteText(cellDef, &wb);
+
+    result = TRUE;
+    if (wb.wb_len > 0 && fwrite(wb.wb_text, wb.wb_len, 1, f) != 1)
+	result = FALSE;
+    else
+	DBFileOffset = wb.wb_len;
+    if (wb.wb_text != NULL)
+	freeMagic(wb.wb_text);
+
+    if (!result || fflush(f) == EOF || ferror(f))
     {
-ioerror:
 	TxError("Warning: I/O error in writing file\n");
 	SigEnableInterrupts();
 	return (FALSE);
@@ -2557,10 +3434,10 @@ ioerror:
  * Filter function used to write out a single cell property.
  *
  * Results:
- *	Normally returns 0; returns 1 on I/O error.
+ *	Always returns 0.
  *
  * Side effects:
- *	Writes to the disk file.
+ *	Appends to the buffer.
  *
  * Warnings:
  *	This function assumes that all property values are strings!
@@ -2578,18 +3455,17 @@ dbWritePropFunc(key, value, cdata)
     ClientData value;
     ClientData cdata;
 {
-    FILE *f = (FILE *)cdata;
-    char *lstring;
-
-    lstring = (char *)mallocMagic(10 + strlen((char *)value) + strlen(key));
-    sprintf(lstring, "string %s %s\n", key, (char *)value);
-    FPRINTR(f, lstring);
-    freeMagic(lstring);
+    WriteBuf *wb = (WriteBuf *)cdata;
 
+    dbWBStr(wb, "string ");
+    dbWBStr(wb, key);
+    dbWBStr(wb, " ");
+    dbWBStr(wb, (char *)value);
+    dbWBStr(wb, "\n");
     return 0;
 }
 
-
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -2621,6 +3497,8 @@ dbWritePropFunc(key, value, cdata)
  *	Writes a file to disk.
  *	If successful, clears the CDMODIFIED, CDBOXESCHANGED,
  *	and CDSTAMPSCHANGED bits in cellDef->cd_flags.
+ *	If DBBinaryCache is set, also writes the binary copy
+ *	of the cell's paint (see DBbinio.c).
  *
  *	In the event of an error while writing out the cell,
  *	the external integer errno is set to the UNIX error
@@ -2884,6 +3762,14 @@ DBCellWrite(cellDef, fileName)
 	realf = NULL;
     }
 
+    /* Keep the binary copy of the paint in step with the file */
+    if (DBBinaryCache && !(cellDef->cd_flags & CDMODIFIED))
+	(void) dbBinWrite(cellDef, expandname);
+
+    /* Likewise the results of checking the cell, if they are kept */
+    if (!(cellDef->cd_flags & CDMODIFIED))
+	DRCStoreWrite(cellDef, expandname);
+
 cleanup:
     SigEnableInterrupts();
     freeMagic(realname);
@@ -2903,10 +3789,10 @@ cleanup:
  * is output.
  *
  * Results:
- *	Normally returns 0; returns 1 on I/O error.
+ *	Always returns 0.
  *
  * Side effects:
- *	Writes to the disk file.
+ *	Appends to the buffer.
  *
  * ----------------------------------------------------------------------------
  */
@@ -2916,8 +3802,8 @@ dbWritePaintFunc(tile, cdarg)
     Tile *tile;
     ClientData cdarg;
 {
-    char pstring[256];
     struct writeArg *arg = (struct writeArg *) cdarg;
+    WriteBuf *wb = arg->wa_buf;
     TileType type = TiGetType(tile);
     TileTypeBitMask *lMask, *rMask;
 
@@ -2957,25 +3843,25 @@ dbWritePaintFunc(tile, cdarg)
 
     if (!arg->wa_found)
     {
-	sprintf(pstring, "<< %s >>\n", DBTypeLongName(type));
-	FPRINTR(arg->wa_file,pstring);
+	dbWBStr(wb, "<< ");
+	dbWBStr(wb, DBTypeLongName(type));
+	dbWBStr(wb, " >>\n");
 	arg->wa_found = TRUE;
     }
 
+    dbWBStr(wb, IsSplit(tile) ? "tri " : "rect ");
+    dbWBInt(wb, LEFT(tile) / arg->wa_reducer, ' ');
+    dbWBInt(wb, BOTTOM(tile) / arg->wa_reducer, ' ');
+    dbWBInt(wb, RIGHT(tile) / arg->wa_reducer, ' ');
     if (IsSplit(tile))
     {
-	static char *pos_diag[] = {"nw", "sw", "se", "ne"};
+	static char *pos_diag[] = {"nw\n", "sw\n", "se\n", "ne\n"};
 	dir |= SplitDirection(tile);
-	sprintf(pstring, "tri %d %d %d %d %s\n",
-	    	LEFT(tile) / arg->wa_reducer, BOTTOM(tile) / arg->wa_reducer,
-		RIGHT(tile) / arg->wa_reducer, TOP(tile) / arg->wa_reducer,
-		pos_diag[dir]);
+	dbWBInt(wb, TOP(tile) / arg->wa_reducer, ' ');
+	dbWBStr(wb, pos_diag[dir]);
     }
     else
-	sprintf(pstring, "rect %d %d %d %d\n",
-	    LEFT(tile) / arg->wa_reducer, BOTTOM(tile) / arg->wa_reducer,
-	    RIGHT(tile) / arg->wa_reducer, TOP(tile) / arg->wa_reducer);
-    FPRINTR(arg->wa_file,pstring);
+	dbWBInt(wb, TOP(tile) / arg->wa_reducer, '\n');
     return 0;
 }
 
@@ -3013,10 +3899,10 @@ dbClearCellFunc(cellUse, cdarg)
  * subcell tile plane for a cell.
  *
  * Results:
- *	Normally returns 0; return 1 on I/O error
+ *	Always returns 0.
  *
  * Side effects:
- *	Writes to the disk file.
+ *	Appends to the buffer.
  *
  * ----------------------------------------------------------------------------
  */
@@ -3027,6 +3913,7 @@ dbWriteCellFunc(cellUse, cdarg)
     ClientData cdarg;
 {
     struct writeArg *arg = (struct writeArg *) cdarg;
+    WriteBuf *wb = arg->wa_buf;
     Transform *t;
     Rect *b;
     char     cstring[256], *pathend, *pathstart, *parent;
@@ -3095,7 +3982,7 @@ dbWriteCellFunc(cellUse, cdarg)
 			cellUse->cu_id, pathstart);
 	}
     }
-    FPRINTR(arg->wa_file, cstring);
+    dbWBStr(wb, cstring);
 
     cellUse->cu_def->cd_flags |= CDVISITED;
     if (pathend != NULL) *pathend = '/';
@@ -3103,22 +3990,29 @@ dbWriteCellFunc(cellUse, cdarg)
     if ((cellUse->cu_xlo != cellUse->cu_xhi)
 	    || (cellUse->cu_ylo != cellUse->cu_yhi))
     {
-	sprintf(cstring, "array %d %d %d %d %d %d\n",
-		cellUse->cu_xlo, cellUse->cu_xhi, cellUse->cu_xsep / arg->wa_reducer,
-		cellUse->cu_ylo, cellUse->cu_yhi, cellUse->cu_ysep / arg->wa_reducer);
-	FPRINTR(arg->wa_file,cstring);
-    }
-
-    sprintf(cstring, "timestamp %d\n", cellUse->cu_def->cd_timestamp);
-    FPRINTR(arg->wa_file,cstring)
-    sprintf(cstring, "transform %d %d %d %d %d %d\n",
-	    t->t_a, t->t_b, t->t_c / arg->wa_reducer,
-	    t->t_d, t->t_e, t->t_f / arg->wa_reducer);
-    FPRINTR(arg->wa_file,cstring)
-    sprintf(cstring, "box %d %d %d %d\n",
-	    b->r_xbot / arg->wa_reducer, b->r_ybot / arg->wa_reducer,
-	    b->r_xtop / arg->wa_reducer, b->r_ytop / arg->wa_reducer);
-    FPRINTR(arg->wa_file,cstring)
+	dbWBStr(wb, "array ");
+	dbWBInt(wb, cellUse->cu_xlo, ' ');
+	dbWBInt(wb, cellUse->cu_xhi, ' ');
+	dbWBInt(wb, cellUse->cu_xsep / arg->wa_reducer, ' ');
+	dbWBInt(wb, cellUse->cu_ylo, ' ');
+	dbWBInt(wb, cellUse->cu_yhi, ' ');
+	dbWBInt(wb, cellUse->cu_ysep / arg->wa_reducer, '\n');
+    }
+
+    dbWBStr(wb, "timestamp ");
+    dbWBInt(wb, cellUse->cu_def->cd_timestamp, '\n');
+    dbWBStr(wb, "transform ");
+    dbWBInt(wb, t->t_a, ' ');
+    dbWBInt(wb, t->t_b, ' ');
+    dbWBInt(wb, t->t_c / arg->wa_reducer, ' ');
+    dbWBInt(wb, t->t_d, ' ');
+    dbWBInt(wb, t->t_e, ' ');
+    dbWBInt(wb, t->t_f / arg->wa_reducer, '\n');
+    dbWBStr(wb, "box ");
+    dbWBInt(wb, b->r_xbot / arg->wa_reducer, ' ');
+    dbWBInt(wb, b->r_ybot / arg->wa_reducer, ' ');
+    dbWBInt(wb, b->r_xtop / arg->wa_reducer, ' ');
+    dbWBInt(wb, b->r_ytop / arg->wa_reducer, '\n');
     return 0;
 }
 
@@ -3173,6 +4067,138 @@ ret:
     return (p);
 }
 
+/*
+ * The crash backup file is put together in memory and then written
+ * out by a background thread (see WorkerBackground()), so that a
+ * periodic backup of a large design does not hold up the user.
+ * The thread writes a temporary file next to the backup file and
+ * renames it into place, so a crash while it runs leaves the last
+ * complete backup intact.  The last backup before exiting on a
+ * signal is written by the main thread (see DBWriteBackupFinal()).
+ */
+
+typedef struct
+{
+    WriteBuf	 bj_text;	/* Contents of the backup file */
+    int		 bj_fd;		/* Temporary file, open for writing */
+    char	*bj_tmpname;	/* Name of the temporary file */
+    char	*bj_name;	/* Name of the backup file */
+    int		 bj_errno;	/* Error encountered, or 0 */
+    bool	 bj_final;	/* TRUE if written by DBWriteBackupFinal() */
+} BackupJob;
+
+static BackupJob *dbBackupJob = NULL;
+
+/* Set once DBWriteBackupFinal() has started, so that a backup still
+ * being written in the background is dropped rather than renamed over
+ * the final one.
+ */
+
+static volatile bool dbBackupFinal = FALSE;
+
+/* List of the cells to go into a backup, in the order they are saved */
+
+typedef struct
+{
+    CellDef	**bl_defs;	/* Cells */
+    int		  bl_num;	/* Number of cells in bl_defs */
+    int		  bl_max;	/* Number of entries allocated */
+} BackupList;
+
+/*
+ * dbBackupWriteFunc --
+ *
+ * Called by WorkerBackground() to write out the backup file.  Runs
+ * outside the main thread, so it uses nothing but system calls.
+ * Returns 0 on success, 1 on error (with bj_errno set).
+ */
+
+int
+dbBackupWriteFunc(cdata)
+    ClientData cdata;
+{
+    BackupJob *bj = (BackupJob *) cdata;
+    char *cp = bj->bj_text.wb_text;
+    int left = bj->bj_text.wb_len;
+    int n;
+
+    while (left > 0)
+    {
+	n = write(bj->bj_fd, cp, left);
+	if (n < 0)
+	{
+	    if (errno == EINTR) continue;
+	    bj->bj_errno = errno;
+	    break;
+	}
+	cp += n;
+	left -= n;
+    }
+    if (close(bj->bj_fd) < 0 && bj->bj_errno == 0)
+	bj->bj_errno = errno;
+    if (bj->bj_errno == 0 && !bj->bj_final && dbBackupFinal)
+    {
+	unlink(bj->bj_tmpname);
+	return 0;
+    }
+    if (bj->bj_errno == 0 && rename(bj->bj_tmpname, bj->bj_name) < 0)
+	bj->bj_errno = errno;
+    if (bj->bj_errno != 0)
+    {
+	unlink(bj->bj_tmpname);
+	return 1;
+    }
+    return 0;
+}
+
+/*
+ * dbBackupFree --
+ *
+ * Report any error met in writing a backup, and free the job.
+ */
+
+void
+dbBackupFree(bj)
+    BackupJob *bj;
+{
+    if (bj->bj_errno != 0)
+	TxError("Backup file %s could not be written: %s\n", bj->bj_name,
+		strerror(bj->bj_errno));
+    if (bj->bj_text.wb_text != NULL)
+	freeMagic(bj->bj_text.wb_text);
+    freeMagic(bj->bj_tmpname);
+    freeMagic(bj->bj_name);
+    freeMagic((char *) bj);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBBackupWait --
+ *
+ * Wait until any crash backup being written by DBWriteBackup() is
+ * complete, and report any error it ran into.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Frees the memory of the finished backup.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+DBBackupWait()
+{
+    BackupJob *bj = dbBackupJob;
+
+    if (bj == NULL) return;
+    (void) WorkerWaitBackground();
+    dbBackupJob = NULL;
+    dbBackupFree(bj);
+}
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -3186,6 +4212,9 @@ ret:
  * is set to this name, erasing any previous value.  If "filename" is
  * an empty string, then the DBbackupFile reverts to NULL.
  *
+ * The file is written in the background;  use DBBackupWait() to make
+ * sure it is complete.
+ *
  * Results:
  *	TRUE if the backup file was created, FALSE if an error was
  *	encountered.
@@ -3202,10 +4231,61 @@ bool
 DBWriteBackup(filename)
     char *filename;
 {
-    FILE *f;
-    int fd, pid;
+    /* Don't start on a new backup before the last one is out */
+    DBBackupWait();
+
+    return dbWriteBackup(filename, FALSE);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBWriteBackupFinal --
+ *
+ * Save all modified cells to the crash backup file one last time, on
+ * the way out after a SIGTERM.  The signal may have arrived while
+ * other threads were running or waited for, so unlike DBWriteBackup()
+ * this neither waits for nor starts any thread:  the cells are turned
+ * into text and the file is written by the caller.  A backup still
+ * being written in the background is abandoned in favour of this one.
+ *
+ * Results:
+ *	TRUE if the backup file was written, FALSE if an error was
+ *	encountered.
+ *
+ * Side effects:
+ *	Writes cells to disk (in a single file).
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+DBWriteBackupFinal()
+{
+    dbBackupFinal = TRUE;
+    return dbWriteBackup((char *) NULL, TRUE);
+}
+
+/*
+ * dbWriteBackup --
+ *
+ * Does the work of DBWriteBackup() and DBWriteBackupFinal().  If final
+ * is TRUE, everything is done in the calling thread, and the file has
+ * been written on return.
+ */
+
+bool
+dbWriteBackup(filename, final)
+    char *filename;
+    bool final;
+{
+    int fd, pid, i;
     char *tempdir;
     MagWindow *mw;
+    BackupJob *bj;
+    BackupList bl;
+    CellDef *def;
+    char *sp;
 
     int dbWriteBackupFunc(), dbCheckModifiedCellsFunc();
     int flags = CDMODIFIED;
@@ -3255,58 +4335,105 @@ DBWriteBackup(filename)
 	TxPrintf("Created database crash recovery file %s\n", DBbackupFile);
     }
 
-    f = fopen(filename, "w");
-    if (f == NULL)
+    bj = (BackupJob *) mallocMagic((unsigned) sizeof (BackupJob));
+    bj->bj_name = StrDup((char **) NULL, filename);
+
+    /* The temporary file is hidden, so that "crash recover" can't	*/
+    /* mistake what is left of it after a crash for a backup.		*/
+
+    bj->bj_tmpname = (char *) mallocMagic((unsigned) (strlen(filename) + 9));
+    sp = strrchr(filename, '/');
+    sp = (sp == NULL) ? filename : sp + 1;
+    sprintf(bj->bj_tmpname, "%.*s.%s.XXXXXX", (int)(sp - filename), filename, sp);
+    bj->bj_fd = mkstemp(bj->bj_tmpname);
+    if (bj->bj_fd < 0)
     {
 	TxError("Backup file %s cannot be opened for writing.\n", filename);
+	freeMagic(bj->bj_tmpname);
+	freeMagic(bj->bj_name);
+	freeMagic((char *) bj);
 	return FALSE;
     }
+    bj->bj_errno = 0;
+    bj->bj_final = final;
+    bj->bj_text.wb_text = NULL;
+    bj->bj_text.wb_len = bj->bj_text.wb_size = 0;
+
+    /* Find the cells to save and get their paint ready in parallel */
 
-    result = DBCellSrDefs(flags, dbWriteBackupFunc, (ClientData)f);
+    bl.bl_defs = NULL;
+    bl.bl_num = bl.bl_max = 0;
+    (void) DBCellSrDefs(flags, dbWriteBackupFunc, (ClientData) &bl);
+    if (!final)
+	DBCellWritePrepare(bl.bl_defs, bl.bl_num);
+
+    for (i = 0; i < bl.bl_num; i++)
+    {
+	def = bl.bl_defs[i];
+	dbWBStr(&bj->bj_text, "file ");
+	dbWBStr(&bj->bj_text, (def->cd_file != NULL) ? def->cd_file : def->cd_name);
+	dbWBStr(&bj->bj_text, "\n");
+	dbCellWriteText(def, &bj->bj_text);
+    }
+    if (bl.bl_defs != NULL)
+	freeMagic((char *) bl.bl_defs);
 
     /* End by printing the keyword "end" followed by the cell to load	*/
     /* into the first available window, so that we don't have a default	*/
     /* blank display after crash recovery.				*/
 
     mw = WindSearchWid(0);
+    dbWBStr(&bj->bj_text, "end");
     if (mw != NULL)
-	fprintf(f, "end %s\n", ((CellUse *)mw->w_surfaceID)->cu_def->cd_name);
-    else
-	fprintf(f, "end\n");
-    fclose(f);
+    {
+	dbWBStr(&bj->bj_text, " ");
+	dbWBStr(&bj->bj_text, ((CellUse *)mw->w_surfaceID)->cu_def->cd_name);
+    }
+    dbWBStr(&bj->bj_text, "\n");
+
+    if (final)
+    {
+	result = dbBackupWriteFunc((ClientData) bj);
+	dbBackupFree(bj);
+	return (result == 0);
+    }
+
+    dbBackupJob = bj;
+    WorkerBackground(dbBackupWriteFunc, (ClientData) bj);
     return TRUE;
 }
 
 /*
  * Filter function used by DBWriteBackup() above.
- * This function writes a single cell definition to the crash backup
- * file.  Only editable cells whose paint, labels, or subcells have
- * changed are considered.
+ * This function adds a single cell definition to the list of cells
+ * to be saved in the crash backup file.  Only editable cells whose
+ * paint, labels, or subcells have changed are considered.
  */
 
 int
-dbWriteBackupFunc(def, f)
+dbWriteBackupFunc(def, bl)
     CellDef *def;	/* Pointer to CellDef to be saved */
-    FILE *f;		/* File to append to */
+    BackupList *bl;	/* List to add to */
 {
-    char *name = def->cd_file;
-    int result, save_flags;
+    CellDef **newdefs;
 
     if (def->cd_flags & (CDINTERNAL | CDNOEDIT | CDNOTFOUND)) return 0;
     else if (!(def->cd_flags & CDAVAILABLE)) return 0;
 
-    if (name == NULL) name = def->cd_name;
-
-    fprintf(f, "file %s\n", name);
-    
-    /* Save/restore flags such that the crash recovery file write does	*/
-    /* *not* clear the CDMODIFIED, et al., bits				*/
-
-    save_flags = def->cd_flags;
-    def->cd_flags &= ~(CDGETNEWSTAMP);
-    result = DBCellWriteFile(def, f);
-    def->cd_flags = save_flags;
-    return (result == TRUE) ? FALSE : TRUE;
+    if (bl->bl_num == bl->bl_max)
+    {
+	bl->bl_max = (bl->bl_max == 0) ? 16 : 2 * bl->bl_max;
+	newdefs = (CellDef **) mallocMagic((unsigned) (bl->bl_max
+		* sizeof (CellDef *)));
+	if (bl->bl_num > 0)
+	{
+	    memcpy(newdefs, bl->bl_defs, bl->bl_num * sizeof (CellDef *));
+	    freeMagic((char *) bl->bl_defs);
+	}
+	bl->bl_defs = newdefs;
+    }
+    bl->bl_defs[bl->bl_num++] = def;
+    return 0;
 }
 
 /*
@@ -143,7 +143,7 @@ DBPutFontLabel(cellDef, rect, font, size, rot, offset, align, text, type, flags)
     TileType type;	/* Type of tile to be labelled */
     int flags;		/* Label flags */
 {
-    Label *lab;
+    Label *lab, *labPrev;
     int len, x1, x2, y1, y2, tmp, labx, laby;
 
     len = strlen(text) + sizeof (Label) - sizeof lab->lab_text + 1;
@@ -211,15 +211,20 @@ DBPutFontLabel(cellDef, rect, font, size, rot, offset, align, text, type, flags)
     lab->lab_rect = *rect;
     lab->lab_next = NULL;
     if (cellDef->cd_labels == NULL)
+    {
+	labPrev = NULL;
 	cellDef->cd_labels = lab;
+    }
     else
     {
 	ASSERT(cellDef->cd_lastLabel->lab_next == NULL, "DBPutLabel");
+	labPrev = cellDef->cd_lastLabel;
 	cellDef->cd_lastLabel->lab_next = lab;
     }
     cellDef->cd_lastLabel = lab;
 
     DBFontLabelSetBBox(lab);
+    dbLabelIndexAdd(cellDef, lab, labPrev);
     DBUndoPutLabel(cellDef, lab);
     cellDef->cd_flags |= CDMODIFIED|CDGETNEWSTAMP;
     return lab;
@@ -267,18 +272,18 @@ DBEraseLabel(cellDef, area, mask, areaReturn)
 				 */
     Rect *areaReturn;		/* Expand this with label bounding box */
 {
-    Label *lab, *labPrev;
+    Label *lab;
+    LabelSearch ls;
     bool erasedAny = FALSE;
     TileType newType;
 
-    labPrev = NULL;
-    lab = cellDef->cd_labels;
-    while (lab != NULL)
+    for (lab = dbLabelSrFirst(cellDef, area, &ls); lab != NULL;
+	    lab = dbLabelSrNext(&ls))
     {
-	if (!GEO_LABEL_IN_AREA(&lab->lab_rect, area)) goto nextLab;
+	if (!GEO_LABEL_IN_AREA(&lab->lab_rect, area)) continue;
 	if (!TTMaskHasType(mask, L_LABEL))
 	{
-	    if (!TTMaskHasType(mask, lab->lab_type)) goto nextLab;
+	    if (!TTMaskHasType(mask, lab->lab_type)) continue;
 
 	    /* Labels on space always get deleted at this point, since
 	     * there's no reasonable new layer to put them on.
@@ -286,28 +291,20 @@ DBEraseLabel(cellDef, area, mask, areaReturn)
 	    if (!(lab->lab_type == TT_SPACE))
 	    {
 		newType = DBPickLabelLayer(cellDef, lab, 0);
-		if (DBConnectsTo(newType, lab->lab_type)) goto nextLab;
+		if (DBConnectsTo(newType, lab->lab_type)) continue;
 	    }
 	}
 
 	DBWLabelChanged(cellDef, lab, DBW_ALLWINDOWS);
-	if (labPrev == NULL)
-	    cellDef->cd_labels = lab->lab_next;
-	else labPrev->lab_next = lab->lab_next;
-	if (cellDef->cd_lastLabel == lab)
-	    cellDef->cd_lastLabel = labPrev;
+	dbUnlinkLabel(cellDef, lab, dbLabelSrPrev(&ls));
 	DBUndoEraseLabel(cellDef, lab);
 	if ((lab->lab_font >= 0) && areaReturn)
 	    GeoInclude(&lab->lab_bbox, areaReturn);
 
 	freeMagic((char *) lab);
-	lab = lab->lab_next;
 	erasedAny = TRUE;
-	continue;
-
-	nextLab: labPrev = lab;
-	lab = lab->lab_next;
     }
+    dbLabelSrDone(&ls);
 
     if (erasedAny)
 	cellDef->cd_flags |= CDMODIFIED|CDGETNEWSTAMP;
@@ -346,38 +343,26 @@ DBEraseLabelsByContent(def, rect, type, text)
 				 * labels are deleted regardless of text.
 				 */
 {
-    Label *lab, *labPrev;
+    Label *lab;
+    LabelSearch ls;
 
 #define	RECTEQUAL(r1, r2)	  ((r1)->r_xbot == (r2)->r_xbot \
 				&& (r1)->r_ybot == (r2)->r_ybot \
 				&& (r1)->r_xtop == (r2)->r_xtop \
 				&& (r1)->r_ytop == (r2)->r_ytop)
 
-    for (labPrev = NULL, lab = def->cd_labels;
-	    lab != NULL;
-	    labPrev = lab, lab = lab->lab_next)
+    for (lab = dbLabelSrFirst(def, rect, &ls); lab != NULL;
+	    lab = dbLabelSrNext(&ls))
     {
-	nextCheck:
 	if ((rect != NULL) && !(RECTEQUAL(&lab->lab_rect, rect))) continue;
 	if ((type >= 0) && (type != lab->lab_type)) continue;
 	if ((text != NULL) && (strcmp(text, lab->lab_text) != 0)) continue;
 	DBUndoEraseLabel(def, lab);
 	DBWLabelChanged(def, lab, DBW_ALLWINDOWS);
-	if (labPrev == NULL)
-	    def->cd_labels = lab->lab_next;
-	else labPrev->lab_next = lab->lab_next;
-	if (def->cd_lastLabel == lab)
-	    def->cd_lastLabel = labPrev;
+	dbUnlinkLabel(def, lab, dbLabelSrPrev(&ls));
 	freeMagic((char *) lab);
-
-	/* Don't iterate through loop, since this will skip a label:
-	 * just go back to top.  This is tricky!
-	 */
-
-	lab = lab->lab_next;
-	if (lab == NULL) break;
-	else goto nextCheck;
     }
+    dbLabelSrDone(&ls);
 }
 
 /*
@@ -424,11 +409,7 @@ DBEraseLabelsByFunction(def, func)
 	if (!(*func)(lab)) continue;
 	DBUndoEraseLabel(def, lab);
 	DBWLabelChanged(def, lab, DBW_ALLWINDOWS);
-	if (labPrev == NULL)
-	    def->cd_labels = lab->lab_next;
-	else labPrev->lab_next = lab->lab_next;
-	if (def->cd_lastLabel == lab)
-	    def->cd_lastLabel = labPrev;
+	dbUnlinkLabel(def, lab, labPrev);
 	freeMagic((char *) lab);
 
 	/* Don't iterate through loop, since this will skip a label:
@@ -469,8 +450,10 @@ DBReOrientLabel(cellDef, area, newPos)
 				 */
 {
     Label *lab;
+    LabelSearch ls;
 
-    for (lab = cellDef->cd_labels; lab != NULL; lab = lab->lab_next)
+    for (lab = dbLabelSrFirst(cellDef, area, &ls); lab != NULL;
+	    lab = dbLabelSrNext(&ls))
     {
 	if (GEO_TOUCH(area, &lab->lab_rect))
 	{
@@ -481,6 +464,7 @@ DBReOrientLabel(cellDef, area, newPos)
 	    DBWLabelChanged(cellDef, lab, DBW_ALLWINDOWS);
 	}
     }
+    dbLabelSrDone(&ls);
 }
 
 /*
@@ -511,6 +495,7 @@ DBAdjustLabels(def, area)
     Rect *area;			/* Area where paint was modified. */
 {
     Label *lab;
+    LabelSearch ls;
     TileType newType;
     bool modified = FALSE;
 
@@ -518,7 +503,8 @@ DBAdjustLabels(def, area)
      * interested in.
      */
     
-    for (lab = def->cd_labels; lab != NULL; lab = lab->lab_next)
+    for (lab = dbLabelSrFirst(def, area, &ls); lab != NULL;
+	    lab = dbLabelSrNext(&ls))
     {
 	if (!GEO_TOUCH(&lab->lab_rect, area)) continue;
 	newType = DBPickLabelLayer(def, lab, 0);
@@ -534,6 +520,7 @@ DBAdjustLabels(def, area)
 	DBUndoPutLabel(def, lab);
 	modified = TRUE;
     }
+    dbLabelSrDone(&ls);
 
     if (modified) DBCellSetModified(def, TRUE);
 }
@@ -551,7 +538,8 @@ DBAdjustLabelsNew(def, area, noreconnect)
 			 * connect to the original type, delete instead
 			 */
 {
-    Label *lab, *labPrev;
+    Label *lab;
+    LabelSearch ls;
     TileType newType;
     bool modified = FALSE;
 
@@ -559,32 +547,25 @@ DBAdjustLabelsNew(def, area, noreconnect)
      * interested in.
      */
     
-    labPrev = NULL;
-    lab = def->cd_labels;
-    while (lab != NULL)
+    for (lab = dbLabelSrFirst(def, area, &ls); lab != NULL;
+	    lab = dbLabelSrNext(&ls))
     {
 	    if (!GEO_TOUCH(&lab->lab_rect, area)) {
-		    goto nextLab;
+		    continue;
 	    }
 	    newType = DBPickLabelLayer(def, lab, noreconnect);
 	    if (newType == lab->lab_type) {
-		    goto nextLab;
+		    continue;
 	    } 
 	    if(newType < 0 && !(lab->lab_flags & LABEL_STICKY)) {
 		    TxPrintf("Deleting ambiguous-layer label \"%s\" from %s in cell %s.\n",
 			     lab->lab_text, DBTypeLongName(lab->lab_type),
 			     def->cd_name);
 	    
-		    if (labPrev == NULL)
-			    def->cd_labels = lab->lab_next;
-		    else 
-			    labPrev->lab_next = lab->lab_next;
-		    if (def->cd_lastLabel == lab)
-			    def->cd_lastLabel = labPrev;
+		    dbUnlinkLabel(def, lab, dbLabelSrPrev(&ls));
 		    DBUndoEraseLabel(def, lab);
 		    DBWLabelChanged(def, lab, DBW_ALLWINDOWS);
 		    freeMagic((char *) lab);
-		    lab = lab->lab_next;
 		    modified = TRUE;
 		    continue;
 	    } else if (!(lab->lab_flags & LABEL_STICKY)) {
@@ -598,10 +579,8 @@ DBAdjustLabelsNew(def, area, noreconnect)
 		    DBUndoPutLabel(def, lab);
 		    modified = TRUE;
 	    }
-    nextLab: 
-	    labPrev = lab;
-	    lab = lab->lab_next;
     }
+    dbLabelSrDone(&ls);
 
     if (modified) DBCellSetModified(def, TRUE);
 }
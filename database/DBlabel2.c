@@ -59,6 +59,15 @@ typedef struct {
     ClientData labSrArg;	/* Client data of caller */
 } labSrStruct;
 
+/* Arguments of DBSrLabelLoc passed down to dbSrLabelLocFunc */
+
+typedef struct {
+    SearchContext *lls_scx;	/* Use containing the labels */
+    char *lls_name;		/* Full hierarchical name */
+    int (*lls_func)();		/* Function to apply to each label found */
+    ClientData lls_arg;		/* Client data of caller */
+} labLocStruct;
+
 /* Forward declarations */
 
 extern void DBTreeFindUse();
@@ -218,12 +227,11 @@ DBSrLabelLoc(rootUse, name, func, cdarg)
     int (*func)();	/* Applied to each instance of the label name */
     ClientData cdarg;	/* Data to pass through to (*func)() */
 {
-    CellDef *def;
     SearchContext scx;
+    labLocStruct lls;
     char *cp;
-    Label *lab;
     char csave;
-    Rect r;
+    int dbSrLabelLocFunc();
 
     if (cp = strrchr(name, '/'))
     {
@@ -242,16 +250,28 @@ DBSrLabelLoc(rootUse, name, func, cdarg)
 	cp = name;
     }
 
-    def = scx.scx_use->cu_def;
-    for (lab = def->cd_labels; lab; lab = lab->lab_next)
-	if (lab->lab_text[0] == *cp && strcmp(lab->lab_text, cp) == 0)
-	{
-	    GeoTransRect(&scx.scx_trans, &lab->lab_rect, &r);
-	    if ((*func)(&r, name, lab, cdarg))
-		return 1;
-	}
+    lls.lls_scx = &scx;
+    lls.lls_name = name;
+    lls.lls_func = func;
+    lls.lls_arg = cdarg;
+    return DBSrLabelName(scx.scx_use->cu_def, cp, dbSrLabelLocFunc,
+		(ClientData) &lls);
+}
 
-    return 0;
+/*
+ * Filter function called by DBSrLabelName() on behalf of DBSrLabelLoc()
+ * for each label with the name being searched for.
+ */
+
+int
+dbSrLabelLocFunc(lab, lls)
+    Label *lab;
+    labLocStruct *lls;
+{
+    Rect r;
+
+    GeoTransRect(&lls->lls_scx->scx_trans, &lab->lab_rect, &r);
+    return (*lls->lls_func)(&r, lls->lls_name, lab, lls->lls_arg);
 }
 
 /*
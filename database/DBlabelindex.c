@@ -0,0 +1,1020 @@
+/*
+ * DBlabelindex.c --
+ *
+ * Spatial and name index of the labels of a CellDef.
+ *
+ * The labels of a def are kept on a singly linked list, and every
+ * search for the labels in an area (DBTreeSrLabels(), DBEraseLabel(),
+ * DBAdjustLabels(), and through them the redisplay code) walks the
+ * whole list.  Cells read from DEF files can carry a hundred thousand
+ * pin and net labels, which makes each of these searches slow.
+ *
+ * For defs with more than a few labels an index is built the first
+ * time they are searched.  It is a uniform grid of bins over the area
+ * covered by the labels.  Each label is kept in the bin containing
+ * the lower-left corner of its area (its rectangle, plus the bounding
+ * box of the text for rendered-font labels), provided the label is no
+ * larger than a bin;  the others are kept in one extra bin that is
+ * always searched.  An area search looks at the bins within one bin
+ * size of the area, and returns the labels found in the order of the
+ * label list, so that clients see the same labels in the same order
+ * as when walking the list.  The index also remembers the label before
+ * each one on the list, so that labels can be unlinked without a walk,
+ * and it maps each label text to the labels carrying it.
+ *
+ * The index is kept up to date by the procedures in DBlabel.c.  Code
+ * that changes the area of a label in place must call
+ * DBLabelIndexUpdate(), and code that links or unlinks labels itself
+ * must call DBLabelIndexFree().  As a safeguard, the index also
+ * records the first and last labels of the list, and is thrown away
+ * when they don't match the def any more.
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/magic.h"
+#include "utils/geometry.h"
+#include "utils/malloc.h"
+#include "tiles/tile.h"
+#include "utils/hash.h"
+#include "database/database.h"
+#include "database/databaseInt.h"
+#include "utils/workers.h"
+
+/* Number of labels a def must have before it is indexed */
+#define LI_MINLABELS	64
+
+typedef struct labelnode
+{
+    Label	*ln_label;	/* The label itself */
+    Label	*ln_prev;	/* Label before it on the list, or NULL */
+    unsigned int ln_seq;	/* Increases along the label list */
+    int		 ln_bin;	/* Bin holding this node */
+    Rect	 ln_area;	/* Area of the label when it was indexed */
+} LabelNode;
+
+typedef struct
+{
+    LabelNode	**lb_nodes;	/* Nodes in this bin */
+    int		  lb_num;	/* Number of entries in lb_nodes */
+    int		  lb_max;	/* Space allocated for lb_nodes */
+} LabelBin;
+
+typedef struct
+{
+    Label	**tl_labels;	/* Labels with one text, in list order */
+    int		  tl_num;	/* Number of entries in tl_labels */
+    int		  tl_max;	/* Space allocated for tl_labels */
+} TextList;
+
+typedef struct labelindex
+{
+    Label	*li_first;	/* cd_labels as of the last change */
+    Label	*li_last;	/* cd_lastLabel as of the last change */
+    int		 li_count;	/* Number of labels indexed */
+    int		 li_dead;	/* Entries of li_where no longer used */
+    unsigned int li_nextSeq;	/* Sequence number for the next label */
+    Rect	 li_area;	/* Area covered by the grid */
+    int		 li_size;	/* Size of each bin */
+    int		 li_nx, li_ny;	/* Bins across and up */
+    LabelBin	*li_bins;	/* Grid bins row by row, then one more
+				 * bin for the labels outside the grid.
+				 */
+    HashTable	 li_where;	/* Maps each label to its LabelNode */
+    HashTable	 li_names;	/* Maps label texts to TextLists */
+} LabelIndex;
+
+/* The extra bin for labels that aren't in the grid */
+#define	LI_OTHER(li)	((li)->li_nx * (li)->li_ny)
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelArea --
+ *
+ * Compute the area of a label that searches look at:  its rectangle,
+ * plus the bounding box of its text if it is drawn in a font.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Sets *area.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbLabelArea(lab, area)
+    Label *lab;
+    Rect *area;
+{
+    *area = lab->lab_rect;
+    if (lab->lab_font >= 0)
+    {
+	if (lab->lab_bbox.r_xbot < area->r_xbot)
+	    area->r_xbot = lab->lab_bbox.r_xbot;
+	if (lab->lab_bbox.r_ybot < area->r_ybot)
+	    area->r_ybot = lab->lab_bbox.r_ybot;
+	if (lab->lab_bbox.r_xtop > area->r_xtop)
+	    area->r_xtop = lab->lab_bbox.r_xtop;
+	if (lab->lab_bbox.r_ytop > area->r_ytop)
+	    area->r_ytop = lab->lab_bbox.r_ytop;
+    }
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelBinFor --
+ *
+ * Find the bin in which a label with the given area belongs.
+ *
+ * Results:
+ *	Index of the bin in li->li_bins.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbLabelBinFor(li, area)
+    LabelIndex *li;
+    Rect *area;
+{
+    int ix, iy;
+
+    if (area->r_xbot < li->li_area.r_xbot || area->r_xbot >= li->li_area.r_xtop
+	    || area->r_ybot < li->li_area.r_ybot
+	    || area->r_ybot >= li->li_area.r_ytop
+	    || (dlong) area->r_xtop - area->r_xbot > li->li_size
+	    || (dlong) area->r_ytop - area->r_ybot > li->li_size)
+	return LI_OTHER(li);
+
+    ix = (int)(((dlong) area->r_xbot - li->li_area.r_xbot) / li->li_size);
+    iy = (int)(((dlong) area->r_ybot - li->li_area.r_ybot) / li->li_size);
+    return iy * li->li_nx + ix;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelBinAdd --
+ * dbLabelBinRemove --
+ *
+ * Add a node to, or remove it from, the bin given by its ln_bin.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Modifies the bin.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbLabelBinAdd(li, node)
+    LabelIndex *li;
+    LabelNode *node;
+{
+    LabelBin *bin = &li->li_bins[node->ln_bin];
+    LabelNode **newNodes;
+    int i;
+
+    if (bin->lb_num == bin->lb_max)
+    {
+	bin->lb_max = (bin->lb_max == 0) ? 4 : bin->lb_max * 2;
+	newNodes = (LabelNode **) mallocMagic((unsigned)
+		(bin->lb_max * sizeof (LabelNode *)));
+	for (i = 0; i < bin->lb_num; i++)
+	    newNodes[i] = bin->lb_nodes[i];
+	if (bin->lb_nodes != NULL) freeMagic((char *) bin->lb_nodes);
+	bin->lb_nodes = newNodes;
+    }
+    bin->lb_nodes[bin->lb_num++] = node;
+}
+
+void
+dbLabelBinRemove(li, node)
+    LabelIndex *li;
+    LabelNode *node;
+{
+    LabelBin *bin = &li->li_bins[node->ln_bin];
+    int i;
+
+    for (i = 0; i < bin->lb_num; i++)
+	if (bin->lb_nodes[i] == node)
+	{
+	    bin->lb_nodes[i] = bin->lb_nodes[--bin->lb_num];
+	    return;
+	}
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelNameAdd --
+ * dbLabelNameRemove --
+ *
+ * Add a label to the end of the list for its text, or remove it
+ * from that list.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Modifies li->li_names.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbLabelNameAdd(li, lab)
+    LabelIndex *li;
+    Label *lab;
+{
+    HashEntry *he;
+    TextList *tl;
+    Label **newLabels;
+    int i;
+
+    he = HashFind(&li->li_names, lab->lab_text);
+    tl = (TextList *) HashGetValue(he);
+    if (tl == NULL)
+    {
+	tl = (TextList *) mallocMagic((unsigned) sizeof (TextList));
+	tl->tl_labels = NULL;
+	tl->tl_num = tl->tl_max = 0;
+	HashSetValue(he, tl);
+    }
+    if (tl->tl_num == tl->tl_max)
+    {
+	tl->tl_max = (tl->tl_max == 0) ? 2 : tl->tl_max * 2;
+	newLabels = (Label **) mallocMagic((unsigned)
+		(tl->tl_max * sizeof (Label *)));
+	for (i = 0; i < tl->tl_num; i++)
+	    newLabels[i] = tl->tl_labels[i];
+	if (tl->tl_labels != NULL) freeMagic((char *) tl->tl_labels);
+	tl->tl_labels = newLabels;
+    }
+    tl->tl_labels[tl->tl_num++] = lab;
+}
+
+void
+dbLabelNameRemove(li, lab)
+    LabelIndex *li;
+    Label *lab;
+{
+    HashEntry *he;
+    TextList *tl;
+    int i;
+
+    he = HashLookOnly(&li->li_names, lab->lab_text);
+    if (he == NULL) return;
+    tl = (TextList *) HashGetValue(he);
+    if (tl == NULL) return;
+    for (i = 0; i < tl->tl_num; i++)
+	if (tl->tl_labels[i] == lab)
+	{
+	    for (tl->tl_num--; i < tl->tl_num; i++)
+		tl->tl_labels[i] = tl->tl_labels[i + 1];
+	    return;
+	}
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelNodeFind --
+ *
+ * Find the node of a label.
+ *
+ * Results:
+ *	Pointer to the LabelNode, or NULL if the label isn't indexed.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+LabelNode *
+dbLabelNodeFind(li, lab)
+    LabelIndex *li;
+    Label *lab;
+{
+    HashEntry *he;
+
+    he = HashLookOnly(&li->li_where, (char *) lab);
+    if (he == NULL) return (LabelNode *) NULL;
+    return (LabelNode *) HashGetValue(he);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelNodeAdd --
+ *
+ * Index a label.  Prev is the label before it on the list.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Adds a node to the index.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbLabelNodeAdd(li, lab, prev)
+    LabelIndex *li;
+    Label *lab;
+    Label *prev;
+{
+    LabelNode *node;
+    HashEntry *he;
+
+    node = (LabelNode *) mallocMagic((unsigned) sizeof (LabelNode));
+    node->ln_label = lab;
+    node->ln_prev = prev;
+    node->ln_seq = li->li_nextSeq++;
+    dbLabelArea(lab, &node->ln_area);
+    node->ln_bin = dbLabelBinFor(li, &node->ln_area);
+    dbLabelBinAdd(li, node);
+
+    he = HashFind(&li->li_where, (char *) lab);
+    if (HashGetValue(he) == NULL && li->li_dead > 0)
+	li->li_dead--;
+    HashSetValue(he, node);
+    dbLabelNameAdd(li, lab);
+    li->li_count++;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelIndexBuild --
+ *
+ * Build the index for the labels of a def.
+ *
+ * Results:
+ *	Pointer to the new index.
+ *
+ * Side effects:
+ *	Sets def->cd_labelIndex.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbLabelSizeCmp(p1, p2)
+    int *p1, *p2;
+{
+    return (*p1 < *p2) ? -1 : (*p1 > *p2) ? 1 : 0;
+}
+
+LabelIndex *
+dbLabelIndexBuild(def, nLabels)
+    CellDef *def;
+    int nLabels;	/* Number of labels on def's list */
+{
+    LabelIndex *li;
+    Label *lab, *prev;
+    Rect area;
+    int *sizes, i, nBins;
+    dlong width, height, size;
+
+    li = (LabelIndex *) mallocMagic((unsigned) sizeof (LabelIndex));
+    li->li_count = 0;
+    li->li_dead = 0;
+    li->li_nextSeq = 0;
+    HashInit(&li->li_where, nLabels, HT_WORDKEYS);
+    HashInit(&li->li_names, nLabels, HT_STRINGKEYS);
+
+    /*
+     * Start with a bin size that holds most labels within single bins,
+     * and double it until there are only a few labels per bin.
+     */
+
+    sizes = (int *) mallocMagic((unsigned) (nLabels * sizeof (int)));
+    i = 0;
+    for (lab = def->cd_labels; lab && i < nLabels; lab = lab->lab_next)
+    {
+	dbLabelArea(lab, &area);
+	if (i == 0) li->li_area = area;
+	else GeoIncludeAll(&area, &li->li_area);
+	width = (dlong) area.r_xtop - area.r_xbot;
+	height = (dlong) area.r_ytop - area.r_ybot;
+	sizes[i++] = (int) MIN(MAX(width, height), INFINITY);
+    }
+    qsort((char *) sizes, i, sizeof (int), dbLabelSizeCmp);
+    size = MAX(sizes[(i * 7) / 8], 1);
+    freeMagic((char *) sizes);
+
+    width = (dlong) li->li_area.r_xtop - li->li_area.r_xbot + 1;
+    height = (dlong) li->li_area.r_ytop - li->li_area.r_ybot + 1;
+    while ((width / size + 1) * (height / size + 1) > (dlong) nLabels / 2
+	    && size < INFINITY)
+	size *= 2;
+
+    li->li_size = (int) MIN(size, INFINITY);
+    li->li_nx = (int)(width / li->li_size + 1);
+    li->li_ny = (int)(height / li->li_size + 1);
+    li->li_area.r_xtop = (int) MIN((dlong) li->li_area.r_xbot
+		+ (dlong) li->li_nx * li->li_size, (dlong) INFINITY);
+    li->li_area.r_ytop = (int) MIN((dlong) li->li_area.r_ybot
+		+ (dlong) li->li_ny * li->li_size, (dlong) INFINITY);
+
+    nBins = li->li_nx * li->li_ny + 1;
+    li->li_bins = (LabelBin *) mallocMagic((unsigned) (nBins * sizeof (LabelBin)));
+    for (i = 0; i < nBins; i++)
+    {
+	li->li_bins[i].lb_nodes = NULL;
+	li->li_bins[i].lb_num = li->li_bins[i].lb_max = 0;
+    }
+
+    prev = NULL;
+    for (lab = def->cd_labels; lab; prev = lab, lab = lab->lab_next)
+	dbLabelNodeAdd(li, lab, prev);
+
+    li->li_first = def->cd_labels;
+    li->li_last = def->cd_lastLabel;
+    def->cd_labelIndex = li;
+    return li;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBLabelIndexFree --
+ *
+ * Throw away the label index of a def, if it has one.  This must be
+ * called by code that adds labels to or removes them from cd_labels
+ * without going through the procedures of DBlabel.c.  The labels
+ * themselves are never touched, so it is safe to call after they
+ * have been freed.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Frees the index and sets def->cd_labelIndex to NULL.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+DBLabelIndexFree(def)
+    CellDef *def;
+{
+    LabelIndex *li = def->cd_labelIndex;
+    HashSearch hs;
+    HashEntry *he;
+    TextList *tl;
+    int i, nBins;
+
+    if (li == NULL) return;
+
+    nBins = li->li_nx * li->li_ny + 1;
+    for (i = 0; i < nBins; i++)
+    {
+	LabelBin *bin = &li->li_bins[i];
+	int j;
+
+	for (j = 0; j < bin->lb_num; j++)
+	    freeMagic((char *) bin->lb_nodes[j]);
+	if (bin->lb_nodes != NULL)
+	    freeMagic((char *) bin->lb_nodes);
+    }
+    freeMagic((char *) li->li_bins);
+
+    HashStartSearch(&hs);
+    while ((he = HashNext(&li->li_names, &hs)) != NULL)
+    {
+	tl = (TextList *) HashGetValue(he);
+	if (tl == NULL) continue;
+	if (tl->tl_labels != NULL) freeMagic((char *) tl->tl_labels);
+	freeMagic((char *) tl);
+    }
+    HashKill(&li->li_names);
+    HashKill(&li->li_where);
+
+    freeMagic((char *) li);
+    def->cd_labelIndex = (LabelIndex *) NULL;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelIndexValid --
+ *
+ * Check that the index of a def still matches its label list.
+ *
+ * Results:
+ *	TRUE if the def has an index that can be used.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+dbLabelIndexValid(def)
+    CellDef *def;
+{
+    LabelIndex *li = def->cd_labelIndex;
+
+    return (li != NULL && li->li_first == def->cd_labels
+		&& li->li_last == def->cd_lastLabel);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelIndexGet --
+ *
+ * Return the index of a def, building it (or building it again) if
+ * necessary.  Indices are only built or freed outside of the worker
+ * pool;  a search running in a pool task just walks the list if the
+ * def doesn't have a usable index.
+ *
+ * Results:
+ *	Pointer to the index, or NULL if the def has too few labels
+ *	to be worth indexing.
+ *
+ * Side effects:
+ *	May build or free the index.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+LabelIndex *
+dbLabelIndexGet(def)
+    CellDef *def;
+{
+    LabelIndex *li = def->cd_labelIndex;
+    Label *lab;
+    int nLabels;
+
+    if (WorkerInside())
+	return dbLabelIndexValid(def) ? li : (LabelIndex *) NULL;
+
+    if (li != NULL)
+    {
+	/*
+	 * Rebuild the grid when many labels have been added outside
+	 * of it, or when the tables have filled up with dead entries.
+	 */
+	if (!dbLabelIndexValid(def)
+		|| li->li_bins[LI_OTHER(li)].lb_num > li->li_count / 4 + LI_MINLABELS
+		|| li->li_dead > li->li_count + LI_MINLABELS
+		|| li->li_nextSeq > (unsigned int) 0x7fffffff)
+	    DBLabelIndexFree(def);
+	else
+	    return li;
+    }
+
+    nLabels = 0;
+    for (lab = def->cd_labels; lab; lab = lab->lab_next)
+	nLabels++;
+    if (nLabels < LI_MINLABELS) return (LabelIndex *) NULL;
+
+    return dbLabelIndexBuild(def, nLabels);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelIndexAdd --
+ *
+ * Called by DBPutFontLabel() after it has appended a label to the
+ * list of a def.  Prev is the label before it (the old last label).
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Adds the label to the def's index, if there is one.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbLabelIndexAdd(def, lab, prev)
+    CellDef *def;
+    Label *lab;
+    Label *prev;
+{
+    LabelIndex *li = def->cd_labelIndex;
+
+    if (li == NULL) return;
+    if (li->li_last != prev
+	    || li->li_first != ((prev == NULL) ? (Label *) NULL : def->cd_labels))
+    {
+	DBLabelIndexFree(def);
+	return;
+    }
+    dbLabelNodeAdd(li, lab, prev);
+    li->li_first = def->cd_labels;
+    li->li_last = def->cd_lastLabel;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelPrev --
+ *
+ * Find the label before a given one on the list of a def.
+ *
+ * Results:
+ *	The previous label, or NULL if lab is the first one.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+Label *
+dbLabelPrev(def, lab)
+    CellDef *def;
+    Label *lab;
+{
+    LabelNode *node;
+    Label *prev;
+
+    if (dbLabelIndexValid(def))
+    {
+	node = dbLabelNodeFind(def->cd_labelIndex, lab);
+	if (node != NULL) return node->ln_prev;
+    }
+
+    if (def->cd_labels == lab) return (Label *) NULL;
+    for (prev = def->cd_labels; prev; prev = prev->lab_next)
+	if (prev->lab_next == lab)
+	    break;
+    return prev;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbUnlinkLabel --
+ *
+ * Remove a label from the list of a def.  The label isn't freed.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Modifies the label list of def and its index.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbUnlinkLabel(def, lab, labPrev)
+    CellDef *def;
+    Label *lab;
+    Label *labPrev;	/* Label before lab, or NULL if lab is first */
+{
+    LabelIndex *li = def->cd_labelIndex;
+    LabelNode *node, *nextNode;
+    HashEntry *he;
+
+    if (li != NULL)
+    {
+	node = dbLabelIndexValid(def) ? dbLabelNodeFind(li, lab) : NULL;
+	if (node == NULL || node->ln_prev != labPrev)
+	{
+	    DBLabelIndexFree(def);
+	    li = NULL;
+	}
+	else
+	{
+	    if (lab->lab_next != NULL)
+	    {
+		nextNode = dbLabelNodeFind(li, lab->lab_next);
+		if (nextNode != NULL) nextNode->ln_prev = labPrev;
+	    }
+	    dbLabelBinRemove(li, node);
+	    dbLabelNameRemove(li, lab);
+	    he = HashLookOnly(&li->li_where, (char *) lab);
+	    HashSetValue(he, NULL);
+	    li->li_dead++;
+	    li->li_count--;
+	    freeMagic((char *) node);
+	}
+    }
+
+    if (labPrev == NULL)
+	def->cd_labels = lab->lab_next;
+    else labPrev->lab_next = lab->lab_next;
+    if (def->cd_lastLabel == lab)
+	def->cd_lastLabel = labPrev;
+
+    if (li != NULL)
+    {
+	li->li_first = def->cd_labels;
+	li->li_last = def->cd_lastLabel;
+    }
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBLabelIndexUpdate --
+ *
+ * Must be called after the rectangle or the text bounding box of a
+ * label has been changed in place.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Moves the label to its new bin in the def's index.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+DBLabelIndexUpdate(def, lab)
+    CellDef *def;
+    Label *lab;
+{
+    LabelIndex *li = def->cd_labelIndex;
+    LabelNode *node;
+
+    if (li == NULL) return;
+    node = dbLabelIndexValid(def) ? dbLabelNodeFind(li, lab) : NULL;
+    if (node == NULL)
+    {
+	DBLabelIndexFree(def);
+	return;
+    }
+    dbLabelBinRemove(li, node);
+    dbLabelArea(lab, &node->ln_area);
+    node->ln_bin = dbLabelBinFor(li, &node->ln_area);
+    dbLabelBinAdd(li, node);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbLabelSrFirst --
+ * dbLabelSrNext --
+ * dbLabelSrPrev --
+ * dbLabelSrDone --
+ *
+ * Enumerate the labels of a def that may touch an area, in the order
+ * of the label list:
+ *
+ *	for (lab = dbLabelSrFirst(def, area, &ls); lab; lab = dbLabelSrNext(&ls))
+ *	    ...
+ *	dbLabelSrDone(&ls);
+ *
+ * The labels returned are a superset of those touching the area, so
+ * the caller must still check each one.  If area is NULL, or the def
+ * has no index, or the area covers much of the def, every label is
+ * returned.  The current label may be unlinked and freed inside the
+ * loop, but no others;  dbLabelSrPrev() gives the label before it on
+ * the list, to pass to dbUnlinkLabel().  Labels added during the loop
+ * may or may not be returned.
+ *
+ * Results:
+ *	dbLabelSrFirst() and dbLabelSrNext() return the next label, or
+ *	NULL when there are no more.  dbLabelSrPrev() returns the label
+ *	before the current one, or NULL if it is the first.
+ *
+ * Side effects:
+ *	dbLabelSrFirst() may build the index of def.  dbLabelSrDone()
+ *	frees any memory used by the enumeration.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+dbLabelSeqCmp(p1, p2)
+    LabelNode **p1, **p2;
+{
+    return ((*p1)->ln_seq < (*p2)->ln_seq) ? -1 :
+		((*p1)->ln_seq > (*p2)->ln_seq) ? 1 : 0;
+}
+
+/* Append the nodes of a bin that touch area to (*pNodes)[n...] */
+
+int
+dbLabelBinSearch(bin, area, pNodes, n, pMax, nodeBuf)
+    LabelBin *bin;
+    Rect *area;
+    LabelNode ***pNodes;
+    int n, *pMax;
+    LabelNode **nodeBuf;	/* Initial buffer, not to be freed */
+{
+    LabelNode *node, **newNodes;
+    int i;
+
+    for (i = 0; i < bin->lb_num; i++)
+    {
+	node = bin->lb_nodes[i];
+	if (!GEO_TOUCH(&node->ln_area, area)) continue;
+	if (n == *pMax)
+	{
+	    *pMax *= 2;
+	    newNodes = (LabelNode **) mallocMagic((unsigned)
+			(*pMax * sizeof (LabelNode *)));
+	    memcpy((char *) newNodes, (char *) *pNodes,
+			n * sizeof (LabelNode *));
+	    if (*pNodes != nodeBuf) freeMagic((char *) *pNodes);
+	    *pNodes = newNodes;
+	}
+	(*pNodes)[n++] = node;
+    }
+    return n;
+}
+
+Label *
+dbLabelSrFirst(def, area, ls)
+    CellDef *def;
+    Rect *area;
+    LabelSearch *ls;
+{
+    LabelIndex *li;
+    LabelNode *nodeBuf[LS_BUFSIZE], **nodes;
+    int ixlo, ixhi, iylo, iyhi, ix, iy, i, n, max;
+
+    ls->ls_def = def;
+    ls->ls_labels = (Label **) NULL;
+    ls->ls_num = ls->ls_cur = 0;
+    ls->ls_next = def->cd_labels;
+    ls->ls_last = ls->ls_prev = (Label *) NULL;
+
+    if (area == NULL) return dbLabelSrNext(ls);
+    li = dbLabelIndexGet(def);
+    if (li == NULL) return dbLabelSrNext(ls);
+
+    /* Range of bins that can hold labels touching the area */
+
+    ixlo = (int) MAX(((dlong) area->r_xbot - li->li_size - li->li_area.r_xbot)
+		/ li->li_size, (dlong) 0);
+    ixhi = (int) MIN(((dlong) area->r_xtop - li->li_area.r_xbot)
+		/ li->li_size, (dlong) li->li_nx - 1);
+    iylo = (int) MAX(((dlong) area->r_ybot - li->li_size - li->li_area.r_ybot)
+		/ li->li_size, (dlong) 0);
+    iyhi = (int) MIN(((dlong) area->r_ytop - li->li_area.r_ybot)
+		/ li->li_size, (dlong) li->li_ny - 1);
+    if (area->r_xtop < li->li_area.r_xbot || area->r_ytop < li->li_area.r_ybot)
+	ixhi = -1;
+
+    /* If the area covers much of the grid, walking the list is faster */
+
+    if (ixhi >= ixlo && iyhi >= iylo
+	    && (dlong)(ixhi - ixlo + 1) * (iyhi - iylo + 1)
+		> (dlong) li->li_nx * li->li_ny / 4)
+	return dbLabelSrNext(ls);
+
+    nodes = nodeBuf;
+    max = LS_BUFSIZE;
+    n = 0;
+    for (iy = iylo; iy <= iyhi; iy++)
+	for (ix = ixlo; ix <= ixhi; ix++)
+	    n = dbLabelBinSearch(&li->li_bins[iy * li->li_nx + ix], area,
+			&nodes, n, &max, nodeBuf);
+    n = dbLabelBinSearch(&li->li_bins[LI_OTHER(li)], area,
+			&nodes, n, &max, nodeBuf);
+
+    if (n > 1)
+	qsort((char *) nodes, n, sizeof (LabelNode *), dbLabelSeqCmp);
+
+    ls->ls_labels = (n <= LS_BUFSIZE) ? ls->ls_buf
+		: (Label **) mallocMagic((unsigned) (n * sizeof (Label *)));
+    for (i = 0; i < n; i++)
+	ls->ls_labels[i] = nodes[i]->ln_label;
+    ls->ls_num = n;
+    if (nodes != nodeBuf) freeMagic((char *) nodes);
+
+    return dbLabelSrNext(ls);
+}
+
+Label *
+dbLabelSrNext(ls)
+    LabelSearch *ls;
+{
+    Label *lab;
+
+    if (ls->ls_labels != NULL)
+    {
+	if (ls->ls_cur >= ls->ls_num) return (Label *) NULL;
+	return ls->ls_labels[ls->ls_cur++];
+    }
+
+    /* The last label returned is still on the list unless it was unlinked */
+    if (ls->ls_last != NULL)
+    {
+	lab = (ls->ls_prev == NULL) ? ls->ls_def->cd_labels
+		: ls->ls_prev->lab_next;
+	if (lab == ls->ls_last) ls->ls_prev = ls->ls_last;
+    }
+
+    lab = ls->ls_next;
+    if (lab != NULL) ls->ls_next = lab->lab_next;
+    ls->ls_last = lab;
+    return lab;
+}
+
+Label *
+dbLabelSrPrev(ls)
+    LabelSearch *ls;
+{
+    if (ls->ls_labels != NULL)
+	return dbLabelPrev(ls->ls_def, ls->ls_labels[ls->ls_cur - 1]);
+    return ls->ls_prev;
+}
+
+void
+dbLabelSrDone(ls)
+    LabelSearch *ls;
+{
+    if (ls->ls_labels != NULL && ls->ls_labels != ls->ls_buf)
+	freeMagic((char *) ls->ls_labels);
+    ls->ls_labels = (Label **) NULL;
+    ls->ls_next = (Label *) NULL;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBSrLabelName --
+ *
+ * Apply a procedure to each label of a def whose text is exactly the
+ * given string, in the order of the label list.  The procedure has
+ * the form:
+ *
+ *	int
+ *	func(lab, cdarg)
+ *	    Label *lab;
+ *	    ClientData cdarg;
+ *
+ * It should normally return 0;  if it returns 1 the search is aborted.
+ * It must not add or remove labels of the def.
+ *
+ * Results:
+ *	1 if the search was aborted, 0 otherwise.
+ *
+ * Side effects:
+ *	Whatever func does.  May build the index of def.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+DBSrLabelName(def, text, func, cdarg)
+    CellDef *def;
+    char *text;
+    int (*func)();
+    ClientData cdarg;
+{
+    LabelIndex *li;
+    HashEntry *he;
+    TextList *tl;
+    Label *lab;
+    int i;
+
+    li = dbLabelIndexGet(def);
+    if (li == NULL)
+    {
+	for (lab = def->cd_labels; lab; lab = lab->lab_next)
+	    if (lab->lab_text[0] == text[0] && strcmp(lab->lab_text, text) == 0)
+		if ((*func)(lab, cdarg))
+		    return 1;
+	return 0;
+    }
+
+    he = HashLookOnly(&li->li_names, text);
+    if (he == NULL) return 0;
+    tl = (TextList *) HashGetValue(he);
+    if (tl == NULL) return 0;
+    for (i = 0; i < tl->tl_num; i++)
+	if ((*func)(tl->tl_labels[i], cdarg))
+	    return 1;
+    return 0;
+}
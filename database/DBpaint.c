@@ -27,6 +27,8 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 
 #include <sys/types.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "utils/magic.h"
 #include "utils/malloc.h"
@@ -55,6 +57,7 @@ Tile *dbPaintMergeVert();
 
 bool TiNMSplitX();
 bool TiNMSplitY();
+bool dbPaintUndoExtend();
 Tile *TiNMMergeRight();
 Tile *TiNMMergeLeft();
 
@@ -99,23 +102,23 @@ int dbPaintDebug = 0;
 	Tile *xtile = otile, *xxnew, *xp; \
 	int x = xcoord; \
  \
-	xxnew = (Tile *) TiAlloc(); \
-	xxnew->ti_client = (ClientData) CLIENTDEFAULT; \
+	xxnew = (Tile *) TiAllocNear(xtile); \
+	TiSetClient(xxnew, (ClientData) CLIENTDEFAULT); \
  \
 	LEFT(xxnew) = x, BOTTOM(xxnew) = BOTTOM(xtile); \
-	BL(xxnew) = xtile, TR(xxnew) = TR(xtile), RT(xxnew) = RT(xtile); \
+	TiSetBL(xxnew, xtile), TiSetTR(xxnew, TR(xtile)), TiSetRT(xxnew, RT(xtile)); \
  \
 	/* Left edge */ \
-	for (xp = TR(xtile); BL(xp) == xtile; xp = LB(xp)) BL(xp) = xxnew; \
-	TR(xtile) = xxnew; \
+	for (xp = TR(xtile); BL(xp) == xtile; xp = LB(xp)) TiSetBL(xp, xxnew); \
+	TiSetTR(xtile, xxnew); \
  \
 	/* Top edge */ \
-	for (xp = RT(xtile); LEFT(xp) >= x; xp = BL(xp)) LB(xp) = xxnew; \
-	RT(xtile) = xp; \
+	for (xp = RT(xtile); LEFT(xp) >= x; xp = BL(xp)) TiSetLB(xp, xxnew); \
+	TiSetRT(xtile, xp); \
  \
 	/* Bottom edge */ \
 	for (xp = LB(xtile); RIGHT(xp) <= x; xp = TR(xp)) /* nothing */; \
-	for (LB(xxnew) = xp; RT(xp) == xtile; RT(xp) = xxnew, xp = TR(xp)); \
+	for (TiSetLB(xxnew, xp); RT(xp) == xtile; TiSetRT(xp, xxnew), xp = TR(xp)); \
 	res = xxnew; \
     }
 
@@ -123,7 +126,9 @@ int dbPaintDebug = 0;
 // #undef TISPLITX
 // #define TISPLITX(a, b, c) a = TiSplitX(b, c)
 
-/* Record undo information */
+/* Record undo information.  A tile that extends the rectangle of the	*/
+/* previous paint record of the same command (same plane and types,	*/
+/* neither one split) into a larger rectangle is folded into it.	*/
 
 #define	DBPAINTUNDO(tile, newType, undo) \
     { \
@@ -131,7 +136,11 @@ int dbPaintDebug = 0;
 \
 	if (undo->pu_def != dbUndoLastCell) dbUndoEdit(undo->pu_def); \
 \
-	xxpup = (paintUE *) UndoNewEvent(dbUndoIDPaint, sizeof(paintUE)); \
+	xxpup = (paintUE *) UndoLastEvent(dbUndoIDPaint); \
+	if (xxpup && dbPaintUndoExtend(xxpup, tile, newType, undo->pu_pNum)) \
+	    xxpup = NULL; \
+	else \
+	    xxpup = (paintUE *) UndoNewEvent(dbUndoIDPaint, sizeof(paintUE)); \
 	if (xxpup) \
 	{ \
 	    xxpup->pue_rect.r_xbot = LEFT(tile); \
@@ -146,6 +155,64 @@ int dbPaintDebug = 0;
 
 
 
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbPaintUndoExtend --
+ *
+ * Try to fold the undo record for painting newType over a tile into
+ * the previous paint record "pup".  This is possible when both record
+ * the same change on the same plane and the tile abuts the record's
+ * rectangle along a whole side, so that the two make up one rectangle.
+ * Playing paint records back or forward is done point by point, so
+ * the merged record has the same effect as the two separate ones.
+ *
+ * Results:
+ *	TRUE if the record was extended, FALSE if a new record is needed.
+ *
+ * Side effects:
+ *	May enlarge pup->pue_rect.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+dbPaintUndoExtend(pup, tile, newType, pNum)
+    paintUE *pup;
+    Tile *tile;
+    TileType newType;
+    int pNum;
+{
+    Rect *r = &pup->pue_rect;
+
+    if (pup->pue_plane != pNum || pup->pue_newtype != newType
+	    || pup->pue_oldtype != TiGetTypeExact(tile)
+	    || (newType & TT_DIAGONAL) || IsSplit(tile))
+	return FALSE;
+
+    if (r->r_ybot == BOTTOM(tile) && r->r_ytop == TOP(tile))
+    {
+	if (r->r_xtop == LEFT(tile))
+	    r->r_xtop = RIGHT(tile);
+	else if (r->r_xbot == RIGHT(tile))
+	    r->r_xbot = LEFT(tile);
+	else
+	    return FALSE;
+	return TRUE;
+    }
+    if (r->r_xbot == LEFT(tile) && r->r_xtop == RIGHT(tile))
+    {
+	if (r->r_ytop == BOTTOM(tile))
+	    r->r_ytop = TOP(tile);
+	else if (r->r_ybot == TOP(tile))
+	    r->r_ybot = BOTTOM(tile);
+	else
+	    return FALSE;
+	return TRUE;
+    }
+    return FALSE;
+}
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -264,6 +331,8 @@ DBPaintPlane0(plane, area, resultTbl, undo, method)
     if (area->r_xtop <= area->r_xbot || area->r_ytop <= area->r_ybot)
 	return;
 
+    TiPlaneModify(plane);
+
     /*
      * The following is a modified version of the area enumeration
      * algorithm.  It expects the in-line paint code below to leave
@@ -292,7 +361,7 @@ enumerate:
 
 	/* Skip processed tiles, if the "method" option was PAINT_MARK */
 	if (method == (unsigned char)PAINT_MARK)
-	    if (tile->ti_client != (ClientData) CLIENTDEFAULT)
+	    if (TiGetClient(tile) != (ClientData) CLIENTDEFAULT)
 		goto paintdone;
 
 	oldType = TiGetTypeExact(tile);
@@ -569,7 +638,7 @@ clipdone:
 		DBPAINTUNDO(tile, newType, undo);
 
 	TiSetBody(tile, newType);
-	if (method == (unsigned char)PAINT_MARK) tile->ti_client = (ClientData)1;
+	if (method == (unsigned char)PAINT_MARK) TiSetClient(tile, (ClientData)1);
 
 #ifdef	PAINTDEBUG
 	if (dbPaintDebug)
@@ -657,7 +726,7 @@ enum2:
 	    clipTop = TOP(tile);
 	    if (clipTop > area->r_ytop) clipTop = area->r_ytop;
 
-	    tile->ti_client = (ClientData)CLIENTDEFAULT;
+	    TiSetClient(tile, (ClientData)CLIENTDEFAULT);
 
 	    /* Move right if possible */
 	    tpnew = TR(tile);
@@ -686,19 +755,250 @@ enum2:
 		    tile = tpnew;
 		    goto enum2;
 		}
-	        tile->ti_client = (ClientData)CLIENTDEFAULT;
+	        TiSetClient(tile, (ClientData)CLIENTDEFAULT);
 	    }
 	    /* At left edge -- walk down to next tile along the left edge */
 	    for (tile = LB(tile); RIGHT(tile) <= area->r_xbot; tile = TR(tile))
-	        tile->ti_client = (ClientData)CLIENTDEFAULT;
+	        TiSetClient(tile, (ClientData)CLIENTDEFAULT);
 	}
-	tile->ti_client = (ClientData)CLIENTDEFAULT;
+	TiSetClient(tile, (ClientData)CLIENTDEFAULT);
     }
 
 done2:
     plane->pl_hint = tile;
 }
 
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DBPaintPlaneBatch --
+ *
+ * Paint a whole array of rectangles into a single tile plane, with the
+ * same result table for all of them.  This is meant for importers (GDS,
+ * CIF, LEF, DEF) that would otherwise call DBPaintPlane() once for each
+ * of thousands of small, overlapping or abutting rectangles, and so
+ * split and re-merge the same tiles over and over.
+ *
+ * The rectangles are first swept in scanline order, top to bottom, and
+ * their union is cut into maximal horizontal strips, the same form
+ * that the plane itself takes.  Only these strips are then painted,
+ * in scanline order, so that each paint starts next to where the last
+ * one ended.  Since only the union is painted, the result table must
+ * give the same result for painting an area twice as for painting it
+ * once;  this is true of all the standard paint tables.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Modifies the plane, as DBPaintPlane() would for each rectangle.
+ *	The contents of the array are not changed.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+typedef struct
+{
+    int	ds_xbot, ds_xtop;	/* Horizontal extent of the strip */
+    int	ds_ytop;		/* Top of the strip */
+} dbStrip;
+
+typedef struct
+{
+    Rect *db_rects;		/* Strips to be painted */
+    int   db_count;		/* Number of strips in db_rects */
+    int   db_size;		/* Number of entries allocated */
+} dbBatchOut;
+
+/* Add the strip (xbot, xtop, ytop) ending at ybot to the output */
+
+void
+dbBatchEmit(bo, strip, ybot)
+    dbBatchOut *bo;
+    dbStrip *strip;
+    int ybot;
+{
+    Rect *r;
+
+    if (bo->db_count == bo->db_size)
+    {
+	Rect *newrects;
+
+	bo->db_size *= 2;
+	newrects = (Rect *) mallocMagic(bo->db_size * sizeof (Rect));
+	memcpy(newrects, bo->db_rects, bo->db_count * sizeof (Rect));
+	freeMagic((char *) bo->db_rects);
+	bo->db_rects = newrects;
+    }
+    r = &bo->db_rects[bo->db_count++];
+    r->r_xbot = strip->ds_xbot;
+    r->r_xtop = strip->ds_xtop;
+    r->r_ytop = strip->ds_ytop;
+    r->r_ybot = ybot;
+}
+
+int
+dbBatchCmpTop(r1, r2)
+    Rect **r1, **r2;
+{
+    /* Decreasing top, then increasing left */
+    if ((*r1)->r_ytop != (*r2)->r_ytop)
+	return ((*r1)->r_ytop > (*r2)->r_ytop) ? -1 : 1;
+    if ((*r1)->r_xbot != (*r2)->r_xbot)
+	return ((*r1)->r_xbot < (*r2)->r_xbot) ? -1 : 1;
+    return 0;
+}
+
+int
+dbBatchCmpY(y1, y2)
+    int *y1, *y2;
+{
+    /* Decreasing y */
+    if (*y1 == *y2) return 0;
+    return (*y1 > *y2) ? -1 : 1;
+}
+
+int
+dbBatchCmpRect(r1, r2)
+    Rect *r1, *r2;
+{
+    return dbBatchCmpTop(&r1, &r2);
+}
+
+void
+DBPaintPlaneBatch(plane, rects, nRects, resultTbl, undo)
+    Plane *plane;		/* Plane whose paint is to be modified */
+    Rect *rects;		/* Array of areas to be painted */
+    int nRects;			/* Number of entries in rects */
+    PaintResultType *resultTbl;	/* Paint table, as for DBPaintPlane() */
+    PaintUndoInfo *undo;	/* Undo record, or NULL, as for DBPaintPlane() */
+{
+    Rect **byTop, **active, *rp;
+    int *ys, nYs, nValid, nActive, nNext, nOpen, nNew, i, j, k;
+    int ytop, ybot, xbot, xtop;
+    dbStrip *open, *next, *swap;
+    dbBatchOut bo;
+
+    TiPlaneModify(plane);
+
+    /* Small batches are not worth sorting */
+    if (nRects < 3)
+    {
+	for (i = 0; i < nRects; i++)
+	    DBPaintPlane(plane, &rects[i], resultTbl, undo);
+	return;
+    }
+
+    byTop = (Rect **) mallocMagic(nRects * sizeof (Rect *));
+    active = (Rect **) mallocMagic(nRects * sizeof (Rect *));
+    ys = (int *) mallocMagic(2 * nRects * sizeof (int));
+    open = (dbStrip *) mallocMagic(nRects * sizeof (dbStrip));
+    next = (dbStrip *) mallocMagic(nRects * sizeof (dbStrip));
+    bo.db_size = nRects;
+    bo.db_count = 0;
+    bo.db_rects = (Rect *) mallocMagic(bo.db_size * sizeof (Rect));
+
+    /* Collect the non-degenerate rectangles and their y coordinates */
+    nYs = nValid = 0;
+    for (i = 0; i < nRects; i++)
+    {
+	rp = &rects[i];
+	if (rp->r_xtop <= rp->r_xbot || rp->r_ytop <= rp->r_ybot) continue;
+	byTop[nValid++] = rp;
+	ys[nYs++] = rp->r_ytop;
+	ys[nYs++] = rp->r_ybot;
+    }
+    qsort(byTop, nValid, sizeof (Rect *), dbBatchCmpTop);
+    qsort(ys, nYs, sizeof (int), dbBatchCmpY);
+    for (i = j = 0; i < nYs; i++)
+	if (j == 0 || ys[i] != ys[j - 1])
+	    ys[j++] = ys[i];
+    nYs = j;
+
+    /*
+     * Sweep down through the bands between successive y coordinates.
+     * "active" holds the rectangles crossing the current band, sorted
+     * by left edge;  "open" holds the strips begun in bands above that
+     * may still continue downward, also sorted by left edge.  A strip
+     * continues only if the band has an interval with exactly the same
+     * left and right edges;  otherwise it is closed off at the band top.
+     */
+
+    nActive = nNext = nOpen = 0;
+    for (i = 0; i + 1 < nYs; i++)
+    {
+	ytop = ys[i];
+	ybot = ys[i + 1];
+
+	/* Drop rectangles that ended above this band */
+	for (j = k = 0; j < nActive; j++)
+	    if (active[j]->r_ybot < ytop)
+		active[k++] = active[j];
+	nActive = k;
+
+	/* Add rectangles that begin at the top of this band */
+	for ( ; nNext < nValid; nNext++)
+	{
+	    rp = byTop[nNext];
+	    if (rp->r_ytop < ytop) break;
+	    for (j = nActive; j > 0 && active[j - 1]->r_xbot > rp->r_xbot; j--)
+		active[j] = active[j - 1];
+	    active[j] = rp;
+	    nActive++;
+	}
+
+	/* Merge the band's intervals against the open strips */
+	nNew = 0;
+	k = 0;
+	for (j = 0; j < nActive; )
+	{
+	    xbot = active[j]->r_xbot;
+	    xtop = active[j]->r_xtop;
+	    for (j++; j < nActive && active[j]->r_xbot <= xtop; j++)
+		if (active[j]->r_xtop > xtop)
+		    xtop = active[j]->r_xtop;
+
+	    /* Close open strips lying entirely to the left */
+	    while (k < nOpen && open[k].ds_xbot < xbot)
+		dbBatchEmit(&bo, &open[k++], ytop);
+	    next[nNew].ds_xbot = xbot;
+	    next[nNew].ds_xtop = xtop;
+	    if (k < nOpen && open[k].ds_xbot == xbot
+			&& open[k].ds_xtop == xtop)
+		next[nNew].ds_ytop = open[k++].ds_ytop;
+	    else
+		next[nNew].ds_ytop = ytop;
+	    nNew++;
+	}
+	for ( ; k < nOpen; k++)
+	    dbBatchEmit(&bo, &open[k], ytop);
+
+	swap = open;
+	open = next;
+	next = swap;
+	nOpen = nNew;
+    }
+
+    /* Close whatever is still open at the bottom of the last band */
+    for (k = 0; k < nOpen; k++)
+	dbBatchEmit(&bo, &open[k], ys[nYs - 1]);
+
+    /* Paint the strips in scanline order */
+    qsort(bo.db_rects, bo.db_count, sizeof (Rect), dbBatchCmpRect);
+    for (i = 0; i < bo.db_count; i++)
+    {
+	if (SigInterruptPending) break;
+	DBPaintPlane(plane, &bo.db_rects[i], resultTbl, undo);
+    }
+
+    freeMagic((char *) byTop);
+    freeMagic((char *) active);
+    freeMagic((char *) ys);
+    freeMagic((char *) open);
+    freeMagic((char *) next);
+    freeMagic((char *) bo.db_rects);
+}
+
 /*
  * ----------------------------------------------------------------------------
  * DBSplitTile --
@@ -718,6 +1018,8 @@ DBSplitTile(plane, point, splitx)
     int splitx;
 {
     Tile *tile, *newtile, *tp;
+
+    TiPlaneModify(plane);
     tile = plane->pl_hint;
     GOTOPOINT(tile, point);
 
@@ -783,6 +1085,8 @@ DBFracturePlane(plane, area, resultTbl, undo)
     if (area->r_xtop <= area->r_xbot || area->r_ytop <= area->r_ybot)
 	return;
 
+    TiPlaneModify(plane);
+
     /*
      * The following is a modified version of the area enumeration
      * algorithm.  It expects the in-line paint code below to leave
@@ -1033,6 +1337,8 @@ DBMergeNMTiles0(plane, area, undo, mergeOnce)
     int aspecta, aspectb;
     TileType ttype, ltype, rtype;
 
+    TiPlaneModify(plane);
+
     start.p_x = area->r_xbot;
     start.p_y = area->r_ytop - 1;
     tile = plane->pl_hint;
@@ -1479,6 +1785,8 @@ DBNMPaintPlane0(plane, exacttype, area, resultTbl, undo, method)
     dlong xref, yref;		/* xref, yref can easily exceed 32 bits */
     int resstate;
 
+    TiPlaneModify(plane);
+
     if (exacttype & TT_DIAGONAL)
     {
 	int dbNMEnumFunc();	/* Forward reference */
@@ -1830,9 +2138,9 @@ dbMarkClient(tile, clip)
 		RIGHT(tile) > clip->r_xbot &&
 		BOTTOM(tile) < clip->r_ytop &&
 		TOP(tile) > clip->r_ybot)
-	tile->ti_client = (ClientData)1;
+	TiSetClient(tile, (ClientData)1);
     else
-	tile->ti_client = (ClientData)CLIENTDEFAULT;
+	TiSetClient(tile, (ClientData)CLIENTDEFAULT);
 }
 
 
@@ -2083,6 +2391,8 @@ DBPaintType(plane, area, resultTbl, client, undo, tileMask)
     if (area->r_xtop <= area->r_xbot || area->r_ytop <= area->r_ybot)
 	return;
 
+    TiPlaneModify(plane);
+
     /*
      * The following is a modified version of the area enumeration
      * algorithm.  It expects the in-line paint code below to leave
@@ -2232,7 +2542,7 @@ enumerate:
 	if (mergeFlags & MRG_LEFT)
 	{
 	    for (tp = BL(tile); BOTTOM(tp) < TOP(tile); tp = RT(tp))
-		if ( (TiGetTypeExact(tp) == newType) && (tp->ti_client == client) )
+		if ( (TiGetTypeExact(tp) == newType) && (TiGetClient(tp) == client) )
 		{
 		    tile = dbMergeType(tile, newType, plane, mergeFlags, undo, client);
 		    goto paintdone;
@@ -2242,7 +2552,7 @@ enumerate:
 	if (mergeFlags & MRG_RIGHT)
 	{
 	    for (tp = TR(tile); TOP(tp) > BOTTOM(tile); tp = LB(tp))
-		if ( (TiGetTypeExact(tp) == newType) && (tp->ti_client == client) )
+		if ( (TiGetTypeExact(tp) == newType) && (TiGetClient(tp) == client) )
 		{
 		    tile = dbMergeType(tile, newType, plane, mergeFlags, undo, client);
 		    goto paintdone;
@@ -2271,7 +2581,7 @@ enumerate:
 	if (mergeFlags & MRG_TOP)
 	{
 	    tp = RT(tile);
-	    if (CANMERGE_Y(tile, tp) && (tp->ti_client == client))
+	    if (CANMERGE_Y(tile, tp) && (TiGetClient(tp) == client))
 		TiJoinY(tile, tp, plane);
 #ifdef	PAINTDEBUG
 	    if (dbPaintDebug)
@@ -2281,7 +2591,7 @@ enumerate:
 	if (mergeFlags & MRG_BOTTOM)
 	{
 	    tp = LB(tile);
-	    if (CANMERGE_Y(tile, tp) && (tp->ti_client == client))
+	    if (CANMERGE_Y(tile, tp) && (TiGetClient(tp) == client))
 		TiJoinY(tile, tp, plane);
 #ifdef	PAINTDEBUG
 	    if (dbPaintDebug)
@@ -2391,7 +2701,7 @@ dbMergeType(tile, newType, plane, mergeFlags, undo, client)
 	 * the LHS that is of type 'newType'.
 	 */
 	for (tpLast = NULL, tp = BL(tile); BOTTOM(tp) < TOP(tile); tp = RT(tp))
-	    if ((TiGetTypeExact(tp) == newType) && (tp->ti_client == client) )
+	    if ((TiGetTypeExact(tp) == newType) && (TiGetClient(tp) == client) )
 		tpLast = tp;
 
 	/* If the topmost LHS tile is not of type 'newType', we don't merge */
@@ -2414,7 +2724,7 @@ dbMergeType(tile, newType, plane, mergeFlags, undo, client)
 	 * the RHS that is of type 'newType'.
 	 */
 	tp = TR(tile);
-	if ((TiGetTypeExact(tp) == newType) && (tp->ti_client == client))
+	if ((TiGetTypeExact(tp) == newType) && (TiGetClient(tp) == client))
 	{
 	    if (BOTTOM(tp) > ysplit) ysplit = BOTTOM(tp);
 	}
@@ -2502,7 +2812,7 @@ dbMergeType(tile, newType, plane, mergeFlags, undo, client)
     if (mergeFlags&MRG_TOP)
     {
 	tp = RT(tile);
-	if (CANMERGE_Y(tp, tile) && (tp->ti_client == client)) TiJoinY(tile, tp, plane);
+	if (CANMERGE_Y(tp, tile) && (TiGetClient(tp) == client)) TiJoinY(tile, tp, plane);
 #ifdef	PAINTDEBUG
 	if (dbPaintDebug)
 	    dbPaintShowTile(tile, undo, "(DBMERGE) merged up");
@@ -2511,7 +2821,7 @@ dbMergeType(tile, newType, plane, mergeFlags, undo, client)
     if (mergeFlags&MRG_BOTTOM)
     {
 	tp = LB(tile);
-	if (CANMERGE_Y(tp, tile) && (tp->ti_client == client)) TiJoinY(tile, tp, plane);
+	if (CANMERGE_Y(tp, tile) && (TiGetClient(tp) == client)) TiJoinY(tile, tp, plane);
 #ifdef	PAINTDEBUG
 	if (dbPaintDebug)
 	    dbPaintShowTile(tile, undo, "(DBMERGE) merged down");
@@ -2570,6 +2880,8 @@ DBPaintPlaneVert(plane, area, resultTbl, undo)
     if (area->r_xtop <= area->r_xbot || area->r_ytop <= area->r_ybot)
 	return;
 
+    TiPlaneModify(plane);
+
     /*
      * The following is a modified version of the area enumeration
      * algorithm.  It expects the in-line paint code below to leave
@@ -29,6 +29,8 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "utils/hash.h"
 #include "database/database.h"
 #include "database/databaseInt.h"
+
+void dbPaintImages();	/* Forward declaration */
 
 /*
  * ----------------------------------------------------------------------------
@@ -78,6 +80,74 @@ DBPaint (cellDef, rect, type)
     /* different planes, as well as relaxing the constraints on	*/
     /* the "compose" section of the technology file.		*/
 
+    dbPaintImages(cellDef, rect, type, loctype);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ * DBPaintManhattan --
+ *
+ * Same as DBPaint(), for a Manhattan type in a cell whose planes are
+ * known to hold no split (non-Manhattan) tiles, such as a cell being
+ * read in from a file that has no triangles.  Since no split tiles
+ * exist, there is nothing for DBMergeNMTiles() to do, and the search
+ * it would make around each rectangle is skipped.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Modifies potentially all paint tile planes in cellDef.
+ * ----------------------------------------------------------------------------
+ */
+
+void
+DBPaintManhattan(cellDef, rect, type)
+    CellDef  * cellDef;		/* CellDef to modify */
+    Rect     * rect;		/* Area to paint */
+    TileType   type;		/* Type of tile to be painted */
+{
+    int pNum;
+    PaintUndoInfo ui;
+
+    cellDef->cd_flags |= CDMODIFIED|CDGETNEWSTAMP;
+    ui.pu_def = cellDef;
+    for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
+	if (DBPaintOnPlane(type, pNum))
+	{
+	    ui.pu_pNum = pNum;
+	    DBPaintPlane(cellDef->cd_planes[pNum], rect,
+			DBStdPaintTbl(type, pNum), &ui);
+	}
+
+    dbPaintImages(cellDef, rect, type, type);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ * dbPaintImages --
+ *
+ * After painting "type" over "rect", find any stacked types on other
+ * planes whose residues include the painted type, and make sure that
+ * all of their images are present (see dbResolveImages() below).
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	May paint into other planes of cellDef.
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbPaintImages(cellDef, rect, type, loctype)
+    CellDef  * cellDef;		/* CellDef that was painted */
+    Rect     * rect;		/* Area that was painted */
+    TileType   type;		/* Type painted, with diagonal bits */
+    TileType   loctype;		/* Type painted, without diagonal bits */
+{
+    int pNum;
+
     if (loctype < DBNumUserLayers)
     {
 	TileTypeBitMask *rMask, tMask;
@@ -108,6 +178,63 @@ DBPaint (cellDef, rect, type)
     }
 }
 
+/*
+ * ----------------------------------------------------------------------------
+ * DBPaintBatch --
+ *
+ * Paint an array of rectangles, all with the same (Manhattan) tile
+ * type, as if DBPaint() had been called for each of them in turn.
+ * On each plane the rectangles are painted together with
+ * DBPaintPlaneBatch(), which avoids most of the splitting and
+ * merging of tiles that painting them one at a time would cause.
+ * Non-Manhattan types are simply passed to DBPaint() one by one.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Modifies potentially all paint tile planes in cellDef.
+ * ----------------------------------------------------------------------------
+ */
+
+void
+DBPaintBatch(cellDef, rects, nRects, type)
+    CellDef  * cellDef;		/* CellDef to modify */
+    Rect     * rects;		/* Areas to paint */
+    int        nRects;		/* Number of entries in rects */
+    TileType   type;		/* Type of tile to be painted */
+{
+    int pNum, i;
+    PaintUndoInfo ui;
+    Rect brect;
+
+    if ((type & TT_DIAGONAL) || (nRects < 2))
+    {
+	for (i = 0; i < nRects; i++)
+	    DBPaint(cellDef, &rects[i], type);
+	return;
+    }
+
+    brect = rects[0];
+    for (i = 1; i < nRects; i++)
+	GeoInclude(&rects[i], &brect);
+    GEO_EXPAND(&brect, 1, &brect);
+
+    cellDef->cd_flags |= CDMODIFIED|CDGETNEWSTAMP;
+    ui.pu_def = cellDef;
+    for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
+	if (DBPaintOnPlane(type, pNum))
+	{
+	    ui.pu_pNum = pNum;
+	    DBPaintPlaneBatch(cellDef->cd_planes[pNum], rects, nRects,
+			DBStdPaintTbl(type, pNum), &ui);
+	    DBMergeNMTiles(cellDef->cd_planes[pNum], &brect, &ui);
+	}
+
+    for (i = 0; i < nRects; i++)
+	dbPaintImages(cellDef, &rects[i], type, type);
+}
+
 /*
  * dbResolveImages ---
  *
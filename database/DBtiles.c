@@ -32,6 +32,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "database/database.h"
 #include "database/databaseInt.h"
 #include "utils/malloc.h"
+#include "utils/workers.h"
 
 /* Used by DBCheckMaxHStrips() and DBCheckMaxVStrips() */
 struct dbCheck
@@ -42,6 +43,7 @@ struct dbCheck
 };
 
 int dbCheckMaxHFunc(), dbCheckMaxVFunc();
+int dbSrPaintCursor();
 
 /*
  * --------------------------------------------------------------------
@@ -473,6 +475,498 @@ enumerate:
     return (0);
 }
 
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * DBSrPaintAreaCursor --
+ *
+ * Reentrant form of DBSrPaintArea() and DBSrPaintClient().  Find all
+ * tiles overlapping a given area whose types are contained in the
+ * mask supplied, and apply the given procedure to each.  Instead of
+ * the plane's hint, the search starts from and updates the hint in
+ * a caller-owned cursor;  instead of ti_client, tiles may be
+ * filtered by a caller-owned table of marks (see DBMarkGet()).
+ * Nothing in the plane or its tiles is written, so several threads
+ * may search one plane at once, each with its own cursor and marks.
+ *
+ * Because split tiles are not modified either, the side of a split
+ * tile being visited is passed to the procedure separately:
+ *
+ *	int
+ *	func(tile, dinfo, cdata)
+ *	    Tile *tile;
+ *	    TileType dinfo;
+ *	    ClientData cdata;
+ *	{
+ *	}
+ *
+ * "dinfo" is the tile's exact type (TiGetTypeExact()), with TT_SIDE
+ * set as DBSrPaintArea() would have set it in the tile body.  The
+ * macro DBInfoType(dinfo) gives the type of the side visited.
+ *
+ * Func normally should return 0.  If it returns 1 then the search
+ * will be aborted.  Func must not modify the plane being searched,
+ * and if other threads may be searching it, must not write to any
+ * of the tiles it is passed.
+ *
+ * Results:
+ *	0 is returned if the search completed normally.  1 is returned
+ *	if it aborted.
+ *
+ * Side effects:
+ *	Updates the cursor's hint.  Otherwise, whatever side effects
+ *	result from application of the supplied procedure.
+ *
+ * --------------------------------------------------------------------
+ */
+
+int
+DBSrPaintAreaCursor(cursor, rect, mask, marks, client, func, arg)
+    TileCursor *cursor;		/* Plane to search and hint at which to
+				 * begin;  the hint is updated to the last
+				 * tile visited.
+				 */
+    Rect *rect;			/* Area to search.  This area should not be
+				 * degenerate.  Tiles must OVERLAP the area.
+				 */
+    TileTypeBitMask *mask;	/* Mask of those paint tiles to be passed to
+				 * func.
+				 */
+    HashTable *marks;		/* If not NULL, only tiles whose mark in this
+				 * table matches "client" are passed to func.
+				 */
+    ClientData client;		/* Mark to match, if marks is not NULL */
+    int (*func)();		/* Function to apply at each tile */
+    ClientData arg;		/* Additional argument to pass to (*func)() */
+{
+    return dbSrPaintCursor(cursor, rect, rect, mask, marks, client, func, arg);
+}
+
+/*
+ * dbSrPaintCursor --
+ *
+ * Body of DBSrPaintAreaCursor().  The tiles enumerated are those
+ * overlapping "rect", but the sides of split tiles are tested for
+ * overlap against "area", which contains "rect".  The parallel
+ * search uses this to cut an area into bands without changing
+ * which sides of a split tile are visited.
+ */
+
+int
+dbSrPaintCursor(cursor, rect, area, mask, marks, client, func, arg)
+    TileCursor *cursor;
+    Rect *rect, *area;
+    TileTypeBitMask *mask;
+    HashTable *marks;
+    ClientData client;
+    int (*func)();
+    ClientData arg;
+{
+    Point start;
+    Tile *tp, *tpnew;
+    TileType dinfo;
+
+    start.p_x = rect->r_xbot;
+    start.p_y = rect->r_ytop - 1;
+    tp = cursor->tc_hint;
+    GOTOPOINT(tp, &start);
+
+    /* Each iteration visits another tile on the LHS of the search area */
+    while (TOP(tp) > rect->r_ybot)
+    {
+	/* Each iteration enumerates another tile */
+enumerate:
+	cursor->tc_hint = tp;
+	if (SigInterruptPending)
+	    return (1);
+
+	if (marks != NULL && DBMarkGet(marks, tp) != client)
+	    goto next;
+
+	/* See DBSrPaintArea() for the treatment of split tiles */
+	if (IsSplit(tp))
+	{
+	    int theight, twidth;
+	    dlong f1, f2, f3, f4;
+
+	    theight = TOP(tp) - BOTTOM(tp);
+	    twidth = RIGHT(tp) - LEFT(tp);
+	    f1 = (area->r_ybot > MINFINITY + 2) ?
+		(dlong)(TOP(tp) - area->r_ybot) * twidth : DLONG_MAX;
+	    f2 = (area->r_ytop < INFINITY - 2) ?
+		(dlong)(area->r_ytop - BOTTOM(tp)) * twidth : DLONG_MAX;
+
+	    if (TTMaskHasType(mask, SplitLeftType(tp)))
+	    {
+		/* !Outside-of-triangle check */
+		f4 = (area->r_xbot > MINFINITY + 2) ?
+			(dlong)(area->r_xbot - LEFT(tp)) * theight : DLONG_MIN;
+		if (SplitDirection(tp) ? (f1 > f4) : (f2 > f4))
+		{
+		    dinfo = TiGetTypeExact(tp) & ~TT_SIDE;
+		    if ((*func)(tp, dinfo, arg)) return (1);
+		}
+	    }
+
+	    if (TTMaskHasType(mask, SplitRightType(tp)))
+	    {
+		/* !Outside-of-triangle check */
+		f3 = (area->r_xtop < INFINITY - 2) ?
+			(dlong)(RIGHT(tp) - area->r_xtop) * theight : DLONG_MIN;
+		if (SplitDirection(tp) ? (f2 > f3) : (f1 > f3))
+		{
+		    dinfo = TiGetTypeExact(tp) | TT_SIDE;
+		    if ((*func)(tp, dinfo, arg)) return (1);
+		}
+	    }
+	}
+	else
+	    if (TTMaskHasType(mask, TiGetType(tp))
+			&& (*func)(tp, TiGetTypeExact(tp), arg))
+		return (1);
+
+next:
+	tpnew = TR(tp);
+	if (LEFT(tpnew) < rect->r_xtop)
+	{
+	    while (BOTTOM(tpnew) >= rect->r_ytop) tpnew = LB(tpnew);
+	    if (BOTTOM(tpnew) >= BOTTOM(tp) || BOTTOM(tp) <= rect->r_ybot)
+	    {
+		tp = tpnew;
+		goto enumerate;
+	    }
+	} 
+
+	/* Each iteration returns one tile further to the left */
+	while (LEFT(tp) > rect->r_xbot)
+	{
+	    if (BOTTOM(tp) <= rect->r_ybot) 
+		return (0);
+	    tpnew = LB(tp);
+	    tp = BL(tp);
+	    if (BOTTOM(tpnew) >= BOTTOM(tp) || BOTTOM(tp) <= rect->r_ybot)
+	    {
+		tp = tpnew;
+		goto enumerate;
+	    }
+	}
+
+	/* At left edge -- walk down to next tile along the left edge */
+	for (tp = LB(tp); RIGHT(tp) <= rect->r_xbot; tp = TR(tp))
+	    /* Nothing */;
+    }
+    return (0);
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * DBMarkGet, DBMarkSet --
+ *
+ * Read and write the mark kept for a tile in a caller-owned table,
+ * for use by searches that may not write ti_client because other
+ * threads are reading the same plane.  The table is an ordinary
+ * HashTable, set up with HashInit(marks, size, HT_WORDKEYS) and
+ * freed with HashKill(marks), and is private to one thread.
+ *
+ * Results:
+ *	DBMarkGet() returns the mark last set for the tile, or
+ *	CLIENTDEFAULT (the initial value of ti_client) if none.
+ *	DBMarkSet() returns nothing.
+ *
+ * Side effects:
+ *	DBMarkSet() records "value" as the tile's mark in the table.
+ *
+ * --------------------------------------------------------------------
+ */
+
+ClientData
+DBMarkGet(marks, tile)
+    HashTable *marks;
+    Tile *tile;
+{
+    HashEntry *he;
+
+    he = HashLookOnly(marks, (char *) tile);
+    if (he == NULL) return (ClientData) CLIENTDEFAULT;
+    return (ClientData) HashGetValue(he);
+}
+
+void
+DBMarkSet(marks, tile, value)
+    HashTable *marks;
+    Tile *tile;
+    ClientData value;
+{
+    HashEntry *he;
+
+    he = HashFind(marks, (char *) tile);
+    HashSetValue(he, value);
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * DBSrPaintAreaParallel --
+ *
+ * Search the paint planes of a cell for tiles overlapping a given
+ * area whose types are contained in the mask supplied, using the
+ * worker pool (see utils/workers.c).  This is the parallel
+ * counterpart of calling DBSrPaintNMArea() on each plane of "def"
+ * in turn.
+ *
+ * The search is cut into tasks, each described by a DBSearchTask:
+ * one per plane, and for manhattan searches, one per horizontal
+ * band of the area within each plane, so that a single plane can
+ * be searched by several threads at once with DBSrPaintAreaCursor().
+ * Each tile is passed to exactly one task, the one whose band holds
+ * the bottom of the part of the tile inside "rect".  The tile
+ * procedure is applied to each tile found, in whichever worker
+ * thread is running the task:
+ *
+ *	int
+ *	tileFunc(tile, dinfo, task)
+ *	    Tile *tile;
+ *	    TileType dinfo;
+ *	    DBSearchTask *task;
+ *	{
+ *	}
+ *
+ * "dinfo" is as for DBSrPaintAreaCursor();  the tile body is not
+ * modified, so use DBInfoType(dinfo), not TiGetType(tile), to get
+ * the type of a split tile's side.  tileFunc must not modify the
+ * database or print anything;  it should keep whatever it finds in
+ * task->dst_result (NULL to start with), and may read the caller's
+ * task->dst_cdata.  Once every task has finished, the merge
+ * procedure is called in the calling thread once per task, in
+ * increasing order of plane number and then of band from bottom
+ * to top, so that the combined result does not depend on thread
+ * scheduling:
+ *
+ *	int
+ *	mergeFunc(task, cdata)
+ *	    DBSearchTask *task;
+ *	    ClientData cdata;
+ *	{
+ *	}
+ *
+ * If tileFunc returns 1 the search is aborted:  no more tiles are
+ * passed to tileFunc in any thread.  The merge procedure is still
+ * called for every task, so that it can release task->dst_result.
+ * If mergeFunc returns 1, no further tasks are merged.  mergeFunc
+ * may be NULL.
+ *
+ * Results:
+ *	0 is returned if the search completed normally.  1 is returned
+ *	if it was aborted, either by tileFunc, mergeFunc, or an
+ *	interrupt.
+ *
+ * Side effects:
+ *	Whatever side effects result from application of the
+ *	supplied procedures.  A non-manhattan search (ttype != 0)
+ *	goes through DBSrPaintNMArea(), one task per plane, and so
+ *	updates the hint and the split-tile side bits of each plane.
+ *
+ * --------------------------------------------------------------------
+ */
+
+/* Most bands a plane is cut into, and fewest units of height per band */
+#define DB_PAR_MAXBANDS		16
+#define DB_PAR_MINHEIGHT	64
+
+typedef struct dbparsearch
+{
+    struct dbpartask *dps_tasks; /* One entry per plane and band */
+    Rect	   dps_area;	/* Whole area being searched */
+    TileType	   dps_ttype;	/* Diagonal search area, or 0 */
+    TileTypeBitMask *dps_mask;	/* Types to pass to dps_func */
+    int		 (*dps_func)();	/* Tile procedure */
+    int		   dps_abort;	/* Set once any task has aborted */
+} dbParSearch;
+
+typedef struct dbpartask
+{
+    DBSearchTask   dpt_task;	/* Public part, passed to the procedures */
+    Plane	  *dpt_plane;	/* Plane to search */
+    bool	   dpt_first;	/* TRUE for the bottom band of a plane */
+    dbParSearch	  *dpt_search;	/* Search this task belongs to */
+} dbParTask;
+
+int dbParTaskFunc(), dbParTileFunc(), dbParNMTileFunc();
+
+int
+DBSrPaintAreaParallel(def, planeMask, ttype, rect, mask, tileFunc, mergeFunc,
+		cdata)
+    CellDef *def;		/* Cell whose paint is to be searched */
+    PlaneMask planeMask;	/* Planes to search */
+    TileType ttype;		/* Non-manhattan search area, as passed to
+				 * DBSrPaintNMArea();  zero if manhattan.
+				 */
+    Rect *rect;			/* Area to search.  Tiles must OVERLAP it */
+    TileTypeBitMask *mask;	/* Mask of those paint tiles to be passed to
+				 * tileFunc.
+				 */
+    int (*tileFunc)();		/* Applied to each tile, in a worker thread */
+    int (*mergeFunc)();		/* Applied to each task, in this thread */
+    ClientData cdata;		/* Passed to both procedures */
+{
+    dbParTask *tasks, *pt;
+    dbParSearch search;
+    int pNum, nPlanes, nBands, nTasks, band, i, result;
+    int lo, hi;
+
+    planeMask &= DBTechTypesToPlanes(mask);
+    nPlanes = 0;
+    for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
+	if (PlaneMaskHasPlane(planeMask, pNum))
+	    nPlanes++;
+    if (nPlanes == 0) return 0;
+
+    /*
+     * Cut the area into enough bands to keep every thread busy.
+     * The cuts are spread over the part of the area covered by
+     * the cell, since there is only space outside of it;  the
+     * bottom and top bands stretch out to the edges of "rect".
+     */
+
+    nBands = 1;
+    lo = MAX(rect->r_ybot, def->cd_bbox.r_ybot);
+    hi = MIN(rect->r_ytop, def->cd_bbox.r_ytop);
+    if (ttype == 0 && hi > lo)
+    {
+	nBands = (2 * WorkerGetCount() + nPlanes - 1) / nPlanes;
+	nBands = MIN(nBands, DB_PAR_MAXBANDS);
+	nBands = MIN(nBands, (hi - lo) / DB_PAR_MINHEIGHT);
+	if (nBands < 1) nBands = 1;
+    }
+
+    tasks = (dbParTask *) mallocMagic(nPlanes * nBands * sizeof (dbParTask));
+    search.dps_tasks = tasks;
+    search.dps_area = *rect;
+    search.dps_ttype = ttype;
+    search.dps_mask = mask;
+    search.dps_func = tileFunc;
+    search.dps_abort = 0;
+
+    nTasks = 0;
+    for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
+    {
+	if (!PlaneMaskHasPlane(planeMask, pNum)) continue;
+	for (band = 0; band < nBands; band++)
+	{
+	    pt = &tasks[nTasks++];
+	    pt->dpt_plane = def->cd_planes[pNum];
+	    pt->dpt_first = (band == 0);
+	    pt->dpt_search = &search;
+	    pt->dpt_task.dst_pNum = pNum;
+	    pt->dpt_task.dst_area = *rect;
+	    if (band > 0)
+		pt->dpt_task.dst_area.r_ybot = lo +
+			(int)((dlong)(hi - lo) * band / nBands);
+	    if (band < nBands - 1)
+		pt->dpt_task.dst_area.r_ytop = lo +
+			(int)((dlong)(hi - lo) * (band + 1) / nBands);
+	    pt->dpt_task.dst_worker = 0;
+	    pt->dpt_task.dst_cdata = cdata;
+	    pt->dpt_task.dst_result = (ClientData) NULL;
+	}
+    }
+
+    result = WorkerRun(nTasks, dbParTaskFunc, (ClientData) &search);
+    if (search.dps_abort) result = 1;
+
+    if (mergeFunc != NULL)
+    {
+	for (i = 0; i < nTasks; i++)
+	    if ((*mergeFunc)(&tasks[i].dpt_task, cdata))
+	    {
+		result = 1;
+		break;
+	    }
+    }
+
+    freeMagic((char *) tasks);
+    return result;
+}
+
+/*
+ * dbParTaskFunc --
+ *
+ * Called by WorkerRun() to search one band of one plane on behalf
+ * of DBSrPaintAreaParallel().
+ */
+
+int
+dbParTaskFunc(task, worker, cdata)
+    int task, worker;
+    ClientData cdata;
+{
+    dbParSearch *search = (dbParSearch *) cdata;
+    dbParTask *pt = &search->dps_tasks[task];
+    TileCursor cursor;
+    int result;
+
+    pt->dpt_task.dst_worker = worker;
+    if (search->dps_ttype != 0)
+	result = DBSrPaintNMArea((Tile *) NULL, pt->dpt_plane,
+		search->dps_ttype, &pt->dpt_task.dst_area, search->dps_mask,
+		dbParNMTileFunc, (ClientData) pt);
+    else
+    {
+	TiCursorInit(&cursor, pt->dpt_plane);
+	result = dbSrPaintCursor(&cursor, &pt->dpt_task.dst_area,
+		&search->dps_area, search->dps_mask, (HashTable *) NULL,
+		(ClientData) NULL, dbParTileFunc, (ClientData) pt);
+    }
+    if (result)
+    {
+	search->dps_abort = 1;
+	return 1;
+    }
+    return 0;
+}
+
+/*
+ * dbParTileFunc --
+ *
+ * Pass one tile found by dbSrPaintCursor() on to the caller's tile
+ * procedure, unless it belongs to a lower band or another task has
+ * already aborted the search.
+ */
+
+int
+dbParTileFunc(tile, dinfo, pt)
+    Tile *tile;
+    TileType dinfo;
+    dbParTask *pt;
+{
+    dbParSearch *search = pt->dpt_search;
+
+    if (search->dps_abort) return 1;
+    if (!pt->dpt_first && BOTTOM(tile) < pt->dpt_task.dst_area.r_ybot)
+	return 0;
+    return (*search->dps_func)(tile, dinfo, &pt->dpt_task);
+}
+
+/*
+ * dbParNMTileFunc --
+ *
+ * The same, for tiles found by DBSrPaintNMArea(), which has set
+ * the side of any split tile in the tile itself.
+ */
+
+int
+dbParNMTileFunc(tile, pt)
+    Tile *tile;
+    dbParTask *pt;
+{
+    dbParSearch *search = pt->dpt_search;
+
+    if (search->dps_abort) return 1;
+    return (*search->dps_func)(tile, TiGetTypeExact(tile), &pt->dpt_task);
+}
+
 
 /*
  * --------------------------------------------------------------------
@@ -580,7 +1074,7 @@ enumerate:
 		{
 		    TiSetBody(tp, (ClientData)((TileType)TiGetBody(tp)
 				& ~TT_SIDE));  /* bit clear */
-		    if ((tp->ti_client == client) && (*func)(tp, arg))
+		    if ((TiGetClient(tp) == client) && (*func)(tp, arg))
 			return (1);
 		}
 	    }
@@ -594,13 +1088,13 @@ enumerate:
 		{
 		    TiSetBody(tp, (ClientData)((TileType)TiGetBody(tp)
 				| TT_SIDE));      /* bit set */
-		    if ((tp->ti_client == client) && (*func)(tp, arg))
+		    if ((TiGetClient(tp) == client) && (*func)(tp, arg))
 			return (1);
 		}
 	    }
 	}
 	else
-	    if (TTMaskHasType(mask, TiGetType(tp)) && tp->ti_client == client
+	    if (TTMaskHasType(mask, TiGetType(tp)) && TiGetClient(tp) == client
 				&& (*func)(tp, arg))
 		return (1);
 
@@ -669,7 +1163,7 @@ DBResetTilePlane(plane, cdata)
     {
 	/* Each iteration frees another tile */
 enumerate:
-	tp->ti_client = cdata;
+	TiSetClient(tp, cdata);
 
 	/* Move along to the next tile */
 	tpnew = TR(tp);
@@ -714,6 +1208,8 @@ enumerate:
  * This is a procedure internal to the database.  The only reason
  * it lives in DBtiles.c rather than DBcellsubr.c is that it requires
  * intimate knowledge of the contents of paint tiles and tile planes.
+ * Paint tiles have no allocated bodies, so all the work is done by
+ * TiClearPlane(), which releases the plane's tile arena in one step.
  *
  * Results:
  *	None.
@@ -721,14 +1217,6 @@ enumerate:
  * Side effects:
  *	Deallocates a lot of memory.  
  *
- *			*** WARNING ***
- *
- * This procedure uses a carfully constructed non-recursive area 
- * enumeration algorithm.  Care is taken to not access a tile that has
- * been deallocated.  The only exception is for a tile that has just been
- * passed to free(), but no more calls to free() or malloc() have been made.  
- * Magic's malloc allows this.
- *
  * --------------------------------------------------------------------
  */
 
@@ -736,53 +1224,9 @@ void
 DBFreePaintPlane(plane)
     Plane *plane;	/* Plane whose storage is to be freed */
 {
-    Tile *tp, *tpnew;
-    Rect *rect = &TiPlaneRect;
-
-    /* Start with the bottom-right non-infinity tile in the plane */
-    tp = BL(plane->pl_right);
-
-    /* Each iteration visits another tile on the RHS of the search area */
-    while (BOTTOM(tp) < rect->r_ytop)
-    {
-enumerate:
-
-#define	CLIP_TOP(t)	(MIN(TOP(t),rect->r_ytop))
-
-	/* Move along to the next tile to the left */
-	if (LEFT(tp) > rect->r_xbot)
-	{
-	    tpnew = BL(tp);
-	    while (TOP(tpnew) <= rect->r_ybot) tpnew = RT(tpnew);
-	    if (CLIP_TOP(tpnew) <= CLIP_TOP(tp))
-	    {
-		tp = tpnew;
-		goto enumerate;
-	    }
-	}
-
-	/* Each iteration returns one tile further to the right */
-	while (RIGHT(tp) < rect->r_xtop)
-	{
-	    TiFree(tp); 
-	    tpnew = RT(tp);
-	    tp = TR(tp);
-	    if (CLIP_TOP(tpnew) <= CLIP_TOP(tp) && BOTTOM(tpnew) < rect->r_ytop)
-	    {
-		tp = tpnew;
-		goto enumerate;
-	    }
-	}
-
-	TiFree(tp); 
-	/* At right edge -- walk up to next tile along the right edge */
-	tp = RT(tp);
-	if (BOTTOM(tp) < rect->r_ytop) {
-	    while(LEFT(tp) >= rect->r_xtop) tp = BL(tp);
-	}
-    }
+    TiClearPlane(plane);
 }
-
+
 /*
  * --------------------------------------------------------------------
  *
@@ -26,6 +26,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 
 #include "utils/magic.h"
 #include "utils/geometry.h"
+#include "utils/malloc.h"
 #include "utils/utils.h"
 #include "tiles/tile.h"
 #include "utils/hash.h"
@@ -35,8 +36,8 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "textio/textio.h"
 
     /* Painting and erasing tables */
-PaintResultType DBPaintResultTbl[NP][NT][NT];
-PaintResultType DBEraseResultTbl[NP][NT][NT];
+PaintResultType *DBPaintResultTbl[NP][NT];
+PaintResultType *DBEraseResultTbl[NP][NT];
 PaintResultType DBWriteResultTbl[NT][NT];
 PaintResultType DBSpecialResultTbl[NT];
 
@@ -45,6 +46,10 @@ PlaneMask DBTypeErasePlanesTbl[NT];
 
 /* ----------------- Data local to tech file processing --------------- */
 
+/* Full painting and erasing tables (see databaseInt.h) */
+PaintResultType *dbPaintBuildTbl = NULL;
+PaintResultType *dbEraseBuildTbl = NULL;
+
 /*
  * Tables telling which rules are default, and which have come
  * from user-specified rules.  The bit is CLEAR if the type is
@@ -58,6 +63,13 @@ TileTypeBitMask dbNotDefaultPaintTbl[NT];
 int dbNumSavedRules = 0;
 Rule dbSavedRules[NT];
 
+/* Row of results for painting or erasing that changes nothing */
+static PaintResultType dbIdentityRow[NT];
+
+/* Storage for the distinct rows of DBPaintResultTbl and DBEraseResultTbl */
+static PaintResultType *dbPaintRowStore = NULL;
+static PaintResultType *dbEraseRowStore = NULL;
+
 /* Forward declarations */
 
 extern void dbTechBitTypeInit();
@@ -80,7 +92,9 @@ bool dbTechSaveCompose();
  *	None.
  *
  * Side effects:
- *	Modifies the paint and erase tables.
+ *	Reallocates and fills in the full paint and erase tables.
+ *	Until dbTechCompactPaint() is called, DBPaintResultTbl and
+ *	DBEraseResultTbl leave everything unchanged.
  *
  * ----------------------------------------------------------------------------
  */
@@ -90,6 +104,7 @@ DBTechInitCompose()
 {
     TileType s, t, r;
     int ps;
+    size_t size;
     PaintResultType *stype, *dtype;
     TileTypeBitMask *ttype;
 
@@ -103,34 +118,51 @@ DBTechInitCompose()
 
     /* Painting and erasing are no-ops for undefined tile types */
 
-    /* The following code is the FAST version using memcpy().	*/
-    /* See below for the actual slow loops.			*/
+    for (s = 0; s < TT_MAXTYPES; s++)
+	dbIdentityRow[s] = (PaintResultType) s;
+    for (ps = 0; ps < PL_MAXTYPES; ps++)
+	for (t = 0; t < TT_MAXTYPES; t++)
+	{
+	    DBPaintResultTbl[ps][t] = dbIdentityRow;
+	    DBEraseResultTbl[ps][t] = dbIdentityRow;
+	}
+
+    /*
+     * The full tables only cover the types and planes defined by
+     * the technology.  Fill the first row, then copy it to all of
+     * the others, which is much faster than setting each entry.
+     */
 
-    stype = dtype = &(DBEraseResultTbl[0][0][0]);
-    for (ps = 0; ps < TT_MAXTYPES; ps++)
+    if (dbPaintBuildTbl != NULL) freeMagic((char *) dbPaintBuildTbl);
+    if (dbEraseBuildTbl != NULL) freeMagic((char *) dbEraseBuildTbl);
+    size = (size_t) DBNumPlanes * DBNumTypes * DBNumTypes
+		* sizeof (PaintResultType);
+    dbPaintBuildTbl = (PaintResultType *) mallocMagic((unsigned) size);
+    dbEraseBuildTbl = (PaintResultType *) mallocMagic((unsigned) size);
+
+    stype = dtype = dbEraseBuildTbl;
+    for (ps = 0; ps < DBNumTypes; ps++)
 	*dtype++ = (PaintResultType)ps; 
-    for (ps = 1; ps < PL_MAXTYPES * TT_MAXTYPES; ps++)
+    for (ps = 1; ps < DBNumPlanes * DBNumTypes; ps++)
     {
-	memcpy((void *)dtype, (void *)stype, (size_t)TT_MAXTYPES
+	memcpy((void *)dtype, (void *)stype, (size_t)DBNumTypes
 		* sizeof(PaintResultType));
-	dtype += TT_MAXTYPES;
+	dtype += DBNumTypes;
     }
 
     /* Fast copy the entire erase table to the paint table memory */
-    dtype = &(DBPaintResultTbl[0][0][0]);
-    memcpy((void *)dtype, (void *)stype, (size_t)(TT_MAXTYPES
-		* TT_MAXTYPES * PL_MAXTYPES * sizeof(PaintResultType)));
+    memcpy((void *)dbPaintBuildTbl, (void *)stype, size);
 
     /* The following code is dreadfully slow, but I'm leaving it */
     /* in as a comment because it's easier to read.  The code	 */
     /* above uses memory copying tricks to speed up the process. */
     /*
 
-    for (pNum = 0; pNum < PL_MAXTYPES; pNum++)
+    for (pNum = 0; pNum < DBNumPlanes; pNum++)
     {
-	for (s = 0; s < TT_MAXTYPES; s++)
+	for (s = 0; s < DBNumTypes; s++)
 	{
-	    for (t = 0; t < TT_MAXTYPES; t++)
+	    for (t = 0; t < DBNumTypes; t++)
 	    {
 		/- Paint and erase are no-ops -/
 		dbSetEraseEntry(s, t, pNum, s);
@@ -712,7 +744,7 @@ dbTechCheckPaint(where)
     {
 	for (t = TT_TECHDEPBASE; t < DBNumTypes; t++)
 	{
-	    result = DBStdPaintEntry(have, t, DBPlane(have));
+	    result = dbPaintEntry(have, t, DBPlane(have));
 	    if (result != TT_SPACE && DBPlane(result) != DBPlane(have))
 	    {
 		if (!printedHeader && where)
@@ -721,7 +753,7 @@ dbTechCheckPaint(where)
 			DBTypeShortName(have), DBTypeShortName(t),
 			DBTypeShortName(result));
 	    }
-	    result = DBStdEraseEntry(have, t, DBPlane(have));
+	    result = dbEraseEntry(have, t, DBPlane(have));
 	    if (result != TT_SPACE && DBPlane(result) != DBPlane(have))
 	    {
 		if (!printedHeader && where)
@@ -782,7 +814,7 @@ dbTechPrintPaint(where, doPaint, contactsOnly)
 		    if (!PlaneMaskHasPlane(lp->l_pmask, plane))
 			continue;
 
-		    result = DBStdPaintEntry(have, paint, plane);
+		    result = dbPaintEntry(have, paint, plane);
 		    if (result != have)
 		    {
 		        TxPrintf("%s ",
@@ -813,7 +845,7 @@ dbTechPrintPaint(where, doPaint, contactsOnly)
 		    if (!PlaneMaskHasPlane(lp->l_pmask, plane))
 			continue;
 
-		    result = DBStdEraseEntry(have, erase, plane);
+		    result = dbEraseEntry(have, erase, plane);
 		    if (result != have)
 		    {
 		        TxPrintf("%s ",
@@ -830,3 +862,122 @@ dbTechPrintPaint(where, doPaint, contactsOnly)
 	}
     }
 }
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbTechCompactPaint --
+ *
+ * Build DBPaintResultTbl and DBEraseResultTbl from the full paint and
+ * erase tables.  Must be called whenever the full tables change after
+ * the "compose" section has been read.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Replaces all of the rows of DBPaintResultTbl and DBEraseResultTbl.
+ *	Pointers to the old rows become invalid.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbTechCompactPaint()
+{
+    void dbTechCompactTable();
+
+    dbTechCompactTable(dbPaintBuildTbl, DBPaintResultTbl, &dbPaintRowStore);
+    dbTechCompactTable(dbEraseBuildTbl, DBEraseResultTbl, &dbEraseRowStore);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * dbTechCompactTable --
+ *
+ * Build the rows of one compact table from a full table.  Each row
+ * gives the results of painting (or erasing) one type on one plane,
+ * indexed by the type already there.  Most types don't change most
+ * planes, and their rows are all replaced by dbIdentityRow.  Only one
+ * copy is kept of rows that are identical.  So the rows in use fit in
+ * the cache even when there are many types.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Fills in all of rowTbl.  Allocates new storage for the rows in
+ *	*pStore and frees the old storage.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+dbTechCompactTable(buildTbl, rowTbl, pStore)
+    PaintResultType *buildTbl;		/* Full table */
+    PaintResultType *rowTbl[NP][NT];	/* Compact table to fill in */
+    PaintResultType **pStore;		/* Storage for rows of rowTbl */
+{
+    HashTable ht;
+    HashEntry *he;
+    PaintResultType *row, *store;
+    unsigned *key;
+    int *rowIndex;
+    int nWords, nRows, pNum, i;
+    size_t rowSize;
+    TileType s, t;
+
+    /* Rows are hashed as whole words, padded with zeroes */
+    rowSize = DBNumTypes * sizeof (PaintResultType);
+    nWords = (rowSize + sizeof (unsigned) - 1) / sizeof (unsigned);
+    if (nWords < HT_STRUCTKEYS) nWords = HT_STRUCTKEYS;
+    key = (unsigned *) mallocMagic((unsigned) (nWords * sizeof (unsigned)));
+    bzero((char *) key, nWords * sizeof (unsigned));
+    HashInit(&ht, 64, nWords);
+
+    /* Number the distinct rows that aren't identity rows */
+    rowIndex = (int *) mallocMagic((unsigned) (DBNumPlanes * DBNumTypes
+		* sizeof (int)));
+    nRows = 0;
+    for (i = 0; i < DBNumPlanes * DBNumTypes; i++)
+    {
+	row = &buildTbl[i * DBNumTypes];
+	for (s = 0; s < DBNumTypes; s++)
+	    if (row[s] != s)
+		break;
+	if (s == DBNumTypes)
+	{
+	    rowIndex[i] = -1;
+	    continue;
+	}
+	memcpy((void *) key, (void *) row, rowSize);
+	he = HashFind(&ht, (char *) key);
+	if (HashGetValue(he) == NULL)
+	    HashSetValue(he, (ClientData)(spointertype) ++nRows);
+	rowIndex[i] = (int)(spointertype) HashGetValue(he) - 1;
+    }
+    HashKill(&ht);
+    freeMagic((char *) key);
+
+    /* Copy the distinct rows to contiguous storage */
+    store = (nRows == 0) ? (PaintResultType *) NULL
+		: (PaintResultType *) mallocMagic((unsigned) (nRows * rowSize));
+    for (pNum = 0; pNum < PL_MAXTYPES; pNum++)
+	for (t = 0; t < TT_MAXTYPES; t++)
+	    rowTbl[pNum][t] = dbIdentityRow;
+    i = 0;
+    for (pNum = 0; pNum < DBNumPlanes; pNum++)
+	for (t = 0; t < DBNumTypes; t++, i++)
+	{
+	    if (rowIndex[i] < 0) continue;
+	    row = &store[rowIndex[i] * DBNumTypes];
+	    memcpy((void *) row, (void *) &buildTbl[i * DBNumTypes], rowSize);
+	    rowTbl[pNum][t] = row;
+	}
+    freeMagic((char *) rowIndex);
+
+    if (*pStore != NULL)
+	freeMagic((char *) *pStore);
+    *pStore = store;
+}
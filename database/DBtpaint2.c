@@ -119,6 +119,9 @@ DBTechFinalCompose()
 	}
     }
 
+    /* Build the tables used for painting */
+    dbTechCompactPaint();
+
     /* Diagnostic */
     /* dbTechPrintPaint("DBTechFinalCompose", TRUE, FALSE); */
     /* dbTechPrintPaint("DBTechFinalCompose", FALSE, FALSE); */
@@ -161,9 +164,9 @@ dbTechPaintErasePlanes()
 	for (pNum = PL_PAINTBASE; pNum < DBNumPlanes; pNum++)
 	    for (s = 0; s < DBNumTypes; s++)
 	    {
-		if (DBStdPaintEntry(s, t, pNum) != s)
+		if (dbPaintEntry(s, t, pNum) != s)
 		    DBTypePaintPlanesTbl[t] |= PlaneNumToMaskBit(pNum);
-		if (DBStdEraseEntry(s, t, pNum) != s)
+		if (dbEraseEntry(s, t, pNum) != s)
 		    DBTypeErasePlanesTbl[t] |= PlaneNumToMaskBit(pNum);
 	    }
     }
@@ -330,8 +333,8 @@ dbComposeContacts()
 		for (ttype = TT_TECHDEPBASE; ttype < DBNumUserLayers; ttype++)
 		    if (TTMaskHasType(rmask, ttype))
 		    {
-			presult = DBStdPaintEntry(presult, ttype, pNum);
-			eresult = DBStdEraseEntry(eresult, ttype, pNum);
+			presult = dbPaintEntry(presult, ttype, pNum);
+			eresult = dbEraseEntry(eresult, ttype, pNum);
 		    }
 		SETPAINT(itype, n, pNum, presult);
 		SETERASE(itype, n, pNum, eresult);
@@ -762,6 +765,7 @@ DBLockContact(ctype)
 	    if (PlaneMaskHasPlane(lpPaint->l_pmask, pNum))
 		SETERASE(ctype, n, pNum, ctype);
     }
+    dbTechCompactPaint();
 }
 
 /*
@@ -790,6 +794,7 @@ DBUnlockContact(ctype)
 	    lpPaint = &dbLayerInfo[n];
 	    dbComposeEraseContact(lpImage, lpPaint);
     }
+    dbTechCompactPaint();
 
     /* To be done (maybe):  revert rules for stacked contact types */
 }
@@ -27,16 +27,42 @@
 
 /* ----------- Argument to area search when writing out cell ---------- */
 
+/* Text of a cell file, put together in memory before it is written */
+typedef struct
+{
+    char       *wb_text;	/* Text so far (not null-terminated) */
+    int		wb_len;		/* Number of characters in wb_text */
+    int		wb_size;	/* Number of characters allocated */
+} WriteBuf;
+
 struct writeArg
 {
     char       *wa_name;	/* Filename of output file */
-    FILE       *wa_file;	/* File to which to output */
+    WriteBuf   *wa_buf;		/* Buffer to which to output */
     TileType	wa_type;	/* Type of tile being searched for */
     bool	wa_found;	/* Have any tiles been found yet? */
     int		wa_reducer;	/* Scale factor for all geometry */
     int		wa_plane;	/* Current plane being searched */
 };
 
+/* -------------- State of a search of the labels of a def ------------- */
+
+#define	LS_BUFSIZE	32
+
+typedef struct
+{
+    CellDef    *ls_def;		/* Def being searched */
+    Label      *ls_next;	/* Next label when walking the list */
+    Label      *ls_last;	/* Last label returned when walking */
+    Label      *ls_prev;	/* Label before ls_last on the list */
+    Label     **ls_labels;	/* Labels found in the index, or NULL
+				 * when walking the list.
+				 */
+    int		ls_num;		/* Number of entries in ls_labels */
+    int		ls_cur;		/* Next entry of ls_labels to return */
+    Label      *ls_buf[LS_BUFSIZE];	/* Space for a few labels */
+} LabelSearch;
+
 /* --------------------- Undo info for painting ----------------------- */
 
 /* The following is the structure of the undo info saved for each tile */
@@ -202,6 +228,22 @@ extern void DBStampMismatch();
 extern void DBTechAddNameToType();
 
 extern void dbComputeBbox();
+extern bool dbBinRead();
+extern bool dbBinWrite();
+extern void dbCellReadList();
+extern void dbCellIndexInsert();
+extern void dbCellIndexDelete();
+extern void dbCellIndexFree();
+extern void dbCellIndexRebuild();
+extern int dbCellIndexSearch();
+extern int dbConnIndexSearch();
+extern void dbLabelIndexAdd();
+extern Label *dbLabelPrev();
+extern void dbUnlinkLabel();
+extern Label *dbLabelSrFirst();
+extern Label *dbLabelSrNext();
+extern Label *dbLabelSrPrev();
+extern void dbLabelSrDone();
 extern void dbFreeCellPlane();
 extern void dbFreePaintPlane();
 extern bool dbTechAddPaint();
@@ -211,19 +253,39 @@ ClientData dbTechNameLookupExact();
 
 /* --------------- Internal database technology variables ------------- */
 
+/*
+ * While the technology file is read, the paint and erase rules are
+ * assembled in full tables with DBNumTypes x DBNumTypes entries for
+ * each plane, which dbTechCompactPaint() then turns into the shared
+ * rows of DBPaintResultTbl and DBEraseResultTbl.  The full tables
+ * are kept, so that the rules can be changed later on (see
+ * DBLockContact()), but nothing else should need them.
+ */
+extern PaintResultType *dbPaintBuildTbl;
+extern PaintResultType *dbEraseBuildTbl;
+extern void dbTechCompactPaint();
+
+#define	dbBuildIndex(h,t,p)	((((p) * DBNumTypes) + (t)) * DBNumTypes + (h))
+
 /*
  * Macros to set the paint result tables.
  * The argument order is different from the index order in
- * the tables, for historical reasons.
+ * the tables, for historical reasons.  The paint and erase
+ * rules are set in the full tables, and can be read back
+ * from there before they have been compacted.
  *
  * Usage:
  *	dbSetPaintEntry(oldType, paintType, planeNum, resultType)
  *	dbSetEraseEntry(oldType, paintType, planeNum, resultType)
  *	dbSetWriteEntry(oldType, paintType, resultType)
+ *	resultType = dbPaintEntry(oldType, paintType, planeNum)
+ *	resultType = dbEraseEntry(oldType, paintType, planeNum)
  */
-#define	dbSetPaintEntry(h,t,p,r) 	(DBPaintResultTbl[p][t][h] = r)
-#define	dbSetEraseEntry(h,t,p,r)	(DBEraseResultTbl[p][t][h] = r)
+#define	dbSetPaintEntry(h,t,p,r) 	(dbPaintBuildTbl[dbBuildIndex(h,t,p)] = r)
+#define	dbSetEraseEntry(h,t,p,r)	(dbEraseBuildTbl[dbBuildIndex(h,t,p)] = r)
 #define	dbSetWriteEntry(h,t,r)		(DBWriteResultTbl[t][h] = r)
+#define	dbPaintEntry(h,t,p)		(dbPaintBuildTbl[dbBuildIndex(h,t,p)])
+#define	dbEraseEntry(h,t,p)		(dbEraseBuildTbl[dbBuildIndex(h,t,p)])
 
 extern TileTypeBitMask dbNotDefaultEraseTbl[];
 extern TileTypeBitMask dbNotDefaultPaintTbl[];
@@ -237,8 +299,8 @@ extern TileTypeBitMask dbNotDefaultPaintTbl[];
  * TT_SPACE has no specific home plane and is handled specially.
  */
 #define	PAINTAFFECTS(t, s) \
-	((t) != TT_SPACE && DBStdPaintEntry((t), (s), DBPlane(t)) != (t))
+	((t) != TT_SPACE && dbPaintEntry((t), (s), DBPlane(t)) != (t))
 #define	ERASEAFFECTS(t, s) \
-	((t) != TT_SPACE && DBStdEraseEntry((t), (s), DBPlane(t)) != (t))
+	((t) != TT_SPACE && dbEraseEntry((t), (s), DBPlane(t)) != (t))
 
 #endif /* _DATABASEINT_H */
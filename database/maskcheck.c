@@ -0,0 +1,115 @@
+/*
+ * maskcheck.c --
+ *
+ * Standalone check of the multi-word TileTypeBitMask macros generated
+ * by scripts/makedbh.  Depending on the compiler flags, database.h
+ * defines these with AVX2 or SSE2 vector operations, or word by word.
+ * This program applies each of them to a series of pseudo-random masks
+ * and prints a checksum of the results;  "make check" in this directory
+ * builds it once for each form and checks that the checksums agree.
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ */
+
+#include <stdio.h>
+
+#include "utils/magic.h"
+#include "utils/geometry.h"
+#include "tiles/tile.h"
+#include "utils/hash.h"
+#include "database/database.h"
+
+#define	MC_ROUNDS	100000
+
+static unsigned int mcSeed = 1;
+static unsigned int mcSum = 0;
+
+/* Next number from a simple linear congruential generator */
+
+unsigned int
+mcRandom()
+{
+    mcSeed = mcSeed * 1103515245 + 12345;
+    return (mcSeed >> 16) & 0x7fff;
+}
+
+/*
+ * Fill a mask with random bits.  Most masks are sparse or empty in
+ * some words, as real type masks are, so that the tests for zero
+ * and for intersection come out both ways.
+ */
+
+void
+mcFill(m)
+    TileTypeBitMask *m;
+{
+    int i, kind = mcRandom() % 4;
+
+    for (i = 0; i < TT_MASKWORDS; i++)
+    {
+	switch (kind)
+	{
+	    case 0: m->tt_words[i] = 0; break;
+	    case 1: m->tt_words[i] = 1 << (mcRandom() % 32); break;
+	    case 2: m->tt_words[i] = (mcRandom() % 8 == 0)
+			? (mcRandom() << 17) ^ mcRandom() : 0;
+		    break;
+	    default: m->tt_words[i] = (mcRandom() << 17) ^ mcRandom(); break;
+	}
+    }
+}
+
+/* Fold a mask, or a truth value, into the checksum */
+
+void
+mcAdd(m)
+    TileTypeBitMask *m;
+{
+    int i;
+
+    for (i = 0; i < TT_MASKWORDS; i++)
+	mcSum = (mcSum * 31 + m->tt_words[i]) ^ (mcSum >> 27);
+}
+
+#define	mcAddBool(b)	(mcSum = mcSum * 31 + ((b) ? 1 : 2))
+
+int
+main()
+{
+    TileTypeBitMask a, b, c, r;
+    int n;
+
+    for (n = 0; n < MC_ROUNDS; n++)
+    {
+	mcFill(&a);
+	mcFill(&b);
+	mcFill(&c);
+	if (mcRandom() % 8 == 0) b = a;
+
+	mcAddBool(TTMaskIsZero(&a));
+	mcAddBool(TTMaskEqual(&a, &b));
+	mcAddBool(TTMaskIntersect(&a, &b));
+
+	r = a; TTMaskZero(&r); mcAdd(&r);
+	r = a; TTMaskCom(&r); mcAdd(&r);
+	r = c; TTMaskCom2(&r, &a); mcAdd(&r);
+	r = a; TTMaskSetMask(&r, &b); mcAdd(&r);
+	r = c; TTMaskSetMask3(&r, &a, &b); mcAdd(&r);
+	r = a; TTMaskAndMask(&r, &b); mcAdd(&r);
+	r = c; TTMaskAndMask3(&r, &a, &b); mcAdd(&r);
+	r = a; TTMaskClearMask(&r, &b); mcAdd(&r);
+	r = c; TTMaskClearMask3(&r, &a, &b); mcAdd(&r);
+    }
+    printf("%08x\n", mcSum);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#
+# parsearch.tcl --
+#
+#	Run by "make check" in this directory.  Paints a few thousand
+#	random rectangles into a cell and uses the "*parsearch" wizard
+#	command to check that DBSrPaintAreaParallel() finds the same
+#	tiles as DBSrPaintArea(), with one thread and with several, over
+#	the whole cell and over part of it.
+#
+
+load ../magic/tclmagic[info sharedlibextension]
+
+magic::initialize -dnull -noconsole -nowrapper -T ../scmos/scmos
+magic::startup
+magic::openwindow
+
+magic::drc off
+magic::load parsearch
+expr {srand(1)}
+set layers {ndiff pdiff poly m1 m2 m3 ndc pdc pc via}
+for {set i 0} {$i < 4000} {incr i} {
+    set x [expr {int(rand() * 4000)}]
+    set y [expr {int(rand() * 4000)}]
+    magic::box $x $y [expr {$x + 4 + int(rand() * 60)}] \
+	    [expr {$y + 4 + int(rand() * 60)}]
+    magic::paint [lindex $layers [expr {int(rand() * [llength $layers])}]]
+}
+
+set status 0
+foreach n {1 2 8} {
+    magic::threads $n
+    foreach area {{-10 -10 4100 4100} {1000 1500 2500 2100}} {
+	foreach types {* m1 poly,m2,via} {
+	    magic::box {*}$area
+	    lassign [magic::*parsearch $types] tiles total same
+	    if {!$same || $tiles == 0} {
+		puts stderr "parsearch: $n thread(s), $types in $area:\
+			$tiles tile(s), the searches differ"
+		set status 1
+	    }
+	}
+    }
+}
+if {$status == 0} {
+    puts "parsearch: same tiles with 1, 2 and 8 threads"
+}
+magic::threads default
+exit $status
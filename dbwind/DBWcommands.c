@@ -38,7 +38,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
  * Standard DBWind command set
  */
 
-extern void CmdAddPath(), CmdArray();
+extern void CmdAddPath(), CmdArray(), CmdBincache();
 extern void CmdBox(), CmdCellname(), CmdClockwise();
 extern void CmdContact(), CmdCopy(), CmdCorner();
 extern void CmdCrash(), CmdCrosshair();
@@ -53,7 +53,7 @@ extern void CmdSave(), CmdScaleGrid(), CmdSee();
 extern void CmdSelect(), CmdSetLabel(), CmdSideways();
 extern void CmdShell(), CmdSnap();
 extern void CmdStretch(), CmdStraighten();
-extern void CmdTech(), CmdTool(), CmdUnexpand();
+extern void CmdTech(), CmdThreads(), CmdTool(), CmdUnexpand();
 extern void CmdUpsidedown(), CmdWhat(), CmdWire(), CmdWriteall();
 extern void CmdGoto(), CmdFlatten(), CmdXload(), CmdXor();
 
@@ -71,6 +71,7 @@ extern void CmdSplitErase();
 extern void CmdCoord();
 extern void CmdExtractTest();
 extern void CmdExtResis();
+extern void CmdParsearch();
 extern void CmdPsearch();
 extern void CmdPlowTest();
 extern void CmdShowtech();
@@ -204,6 +205,10 @@ DBWInitCommands()
     WindAddCommand(DBWclientID,
 	"*plow cmd [args]	debug plowing",
 	CmdPlowTest, FALSE);
+    WindAddCommand(DBWclientID,
+	"*parsearch [layers]	compare parallel and serial area searches\n\
+			over box area",
+	CmdParsearch, FALSE);
     WindAddCommand(DBWclientID,
 	"*psearch plane count	invoke point search over box area",
 	CmdPsearch, FALSE);
@@ -227,6 +232,10 @@ DBWInitCommands()
 	"array xlo xhi ylo yhi\n"
 	"			array everything in selection",
 	CmdArray, FALSE);
+    WindAddCommand(DBWclientID,
+	"bincache [yes|no]	keep binary copies of cell paint (.magb files)\n"
+	"			for faster loading",
+	CmdBincache, FALSE);
     WindAddCommand(DBWclientID,
 	"box [dir [amount]]	move box dist units in direction or (with\n"
 	"			no arguments) show box size",
@@ -438,6 +447,10 @@ DBWInitCommands()
 	"tech option	technology handling; type \"techinfo help\"\n\
 			for information on options",
 	CmdTech, FALSE);
+    WindAddCommand(DBWclientID,
+	"threads [count|default]	set the number of threads used by parallel\n\
+			operations",
+	CmdThreads, FALSE);
 #ifndef MAGIC_WRAPPER
     WindAddCommand(DBWclientID,
 	"tool [name|info]	change layout tool or print info about what\n\
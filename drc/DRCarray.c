@@ -25,6 +25,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 
 #include <sys/types.h>
 #include <stdio.h>
+#include <string.h>
 #include "utils/magic.h"
 #include "utils/geometry.h"
 #include "tiles/tile.h"
@@ -33,10 +34,13 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "drc/drc.h"
 #include "windows/windows.h"
 #include "commands/commands.h"
+#include "utils/signals.h"
+#include "utils/malloc.h"
 
 /* Forward references: */
 
 extern int drcArrayYankFunc(), drcArrayOverlapFunc();
+extern int drcCifValid;
 
 /* Dummy DRC cookie used to pass the error message to DRC error
  * routines.
@@ -59,6 +63,416 @@ static void (*drcArrayErrorFunc)();	/* Function to call on violations. */
 static ClientData drcArrayClientData;	/* Extra parameter to pass to func. */
 
 
+/*
+ * The errors found in one square of an array's lattice (see
+ * drcArrayFunc), relative to the lower-left corner of the square.
+ */
+
+typedef struct
+{
+    Rect	 ae_rect;
+    DRCCookie	*ae_cptr;
+} ArrayError;
+
+typedef struct
+{
+    int		 ar_nErrors;
+    int		 ar_size;	/* Number of entries allocated */
+    ArrayError	*ar_errors;
+    Point	 ar_origin;	/* Lower-left corner of the square */
+} ArrayRep;
+
+/* A run of squares along one axis of the lattice, all of which look
+ * the same as the square ra_rep.
+ */
+
+typedef struct
+{
+    int		ra_lo, ra_hi;
+    int		ra_rep;
+} ArrayRun;
+
+/* Squares are remembered from one call of DRCArrayCheck to the next,
+ * since the continuous checker looks at a big array a piece at a time.
+ * They are found by the contents of the element cell and by the
+ * transform, size, and spacing of the array.
+ */
+
+typedef struct
+{
+    DRCHash	ak_sig;		/* Signature of the element cell */
+    Transform	ak_trans;
+    int		ak_xlo, ak_xhi, ak_ylo, ak_yhi;
+    int		ak_xsep, ak_ysep;
+    int		ak_p, ak_q;	/* Indices of square in lattice */
+} ArrayKey;
+
+#define	DRC_ARRAY_SQUARES	4096
+
+/* Arrays with fewer elements than this are cheap to check afresh, so
+ * their squares are not worth a signature of the element cell or a
+ * place in drcArrayTable.
+ */
+
+#define	DRC_ARRAY_MINSIZE	64
+
+static HashTable drcArrayTable;		/* ArrayKey -> ArrayRep */
+static bool drcArrayInit = FALSE;
+
+/* The layout of an array in its parent.  Index 0 is for x, 1 for y. */
+
+typedef struct
+{
+    CellUse	*aa_use;
+    Rect	 aa_bbox;	/* Area of the whole array */
+    int		 aa_sep[2];	/* Distance between elements */
+    int		 aa_size[2];	/* Size of each element */
+    int		 aa_n[2];	/* Number of elements */
+    int		 aa_squares[2];	/* Number of squares in the lattice */
+    bool	 aa_bands[2];	/* TRUE if neighbours can interact */
+} ArrayLayout;
+
+/* Floor of a / b, for b > 0 */
+
+#define	FLOORDIV(a, b)	(((a) >= 0) ? ((a) / (b)) : -((-(a) + (b) - 1) / (b)))
+
+#define	AXLO(r, axis)	((axis) ? (r)->r_ybot : (r)->r_xbot)
+#define	AXHI(r, axis)	((axis) ? (r)->r_ytop : (r)->r_xtop)
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcArrayKill --
+ *
+ *	Free all the squares in a table, and the table itself.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory free'd.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcArrayKill(table)
+    HashTable *table;
+{
+    HashSearch hs;
+    HashEntry *he;
+    ArrayRep *rep;
+
+    HashStartSearch(&hs);
+    while ((he = HashNext(table, &hs)) != NULL)
+    {
+	rep = (ArrayRep *) HashGetValue(he);
+	if (rep->ar_errors != NULL) freeMagic((char *) rep->ar_errors);
+	freeMagic((char *) rep);
+    }
+    HashKill(table);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcArrayFlush --
+ *
+ *	Forget the squares of arrays checked so far.  Called from
+ *	drcCacheFlush when the rules change.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory free'd.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcArrayFlush()
+{
+    if (drcArrayInit) drcArrayKill(&drcArrayTable);
+    HashInit(&drcArrayTable, 64, HashSize(sizeof (ArrayKey)));
+    drcArrayInit = TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcArrayRuns --
+ *
+ *	Divide the squares lo through hi along one axis of an array's
+ *	lattice into runs that look the same.  A square is far enough
+ *	from both ends of the array if every element and every gap
+ *	between elements that comes within the halo of the square is
+ *	really there;  all such squares look the same, apart from
+ *	their position.  Every other square is a run by itself.
+ *
+ * Results:
+ *	Returns the number of runs, and sets *runsp to point to them.
+ *	The caller must free the runs.
+ *
+ * Side effects:
+ *	Memory is allocated.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+drcArrayRuns(aa, axis, lo, hi, runsp)
+    ArrayLayout *aa;
+    int axis;
+    int lo, hi;		/* Range of squares to divide up */
+    ArrayRun **runsp;
+{
+    ArrayRun *runs;
+    int sep = aa->aa_sep[axis];
+    int first, last, p, n;
+
+    /* Squares first through last are the ones far from the ends */
+
+    first = (aa->aa_size[axis] + DRCTechHalo) / sep + 1;
+    last = aa->aa_n[axis] - 4 - DRCTechHalo / sep;
+    if (first > last || last < lo || first > hi)
+	first = last = hi + 1;
+
+    runs = (ArrayRun *) mallocMagic((unsigned) ((hi - lo + 1
+		- MAX(MIN(last, hi) - MAX(first, lo), 0)) * sizeof (ArrayRun)));
+    n = 0;
+    for (p = lo; p <= hi; p++)
+    {
+	runs[n].ra_lo = runs[n].ra_rep = p;
+	if (p >= first && p <= last)
+	{
+	    runs[n].ra_rep = first;
+	    p = MIN(last, hi);
+	}
+	runs[n++].ra_hi = p;
+    }
+    *runsp = runs;
+    return n;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcArrayBands --
+ *
+ *	Find where the bands in which neighbouring elements of an array
+ *	interact cross the range lo to hi along one axis.  The band
+ *	between elements i and i + 1 runs from the halo before the start
+ *	of element i + 1 to the halo past the end of element i.
+ *
+ * Results:
+ *	The number of separate pieces of bands, which are left in
+ *	ivlo[] and ivhi[] in order.  There are never more than
+ *	DRC_ARRAY_BANDS of them.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+#define	DRC_ARRAY_BANDS	4
+
+int
+drcArrayBands(aa, axis, lo, hi, ivlo, ivhi)
+    ArrayLayout *aa;
+    int axis;
+    int lo, hi;
+    int ivlo[], ivhi[];
+{
+    int sep = aa->aa_sep[axis];
+    int base = AXLO(&aa->aa_bbox, axis);
+    int i, ilast, blo, bhi, n;
+
+    if (!aa->aa_bands[axis] || lo >= hi) return 0;
+
+    n = 0;
+    i = MAX(0, FLOORDIV(lo - base - aa->aa_size[axis] - DRCTechHalo, sep));
+    ilast = MIN(aa->aa_n[axis] - 2, FLOORDIV(hi - base + DRCTechHalo, sep));
+    for (; i <= ilast; i++)
+    {
+	blo = MAX(lo, base + i * sep + sep - DRCTechHalo);
+	bhi = MIN(hi, base + i * sep + aa->aa_size[axis] + DRCTechHalo);
+	if (blo >= bhi) continue;
+	if (n > 0 && blo <= ivhi[n - 1])
+	    ivhi[n - 1] = MAX(ivhi[n - 1], bhi);
+	else if (n == DRC_ARRAY_BANDS)
+	    ivhi[n - 1] = bhi;
+	else
+	{
+	    ivlo[n] = blo;
+	    ivhi[n++] = bhi;
+	}
+    }
+    return n;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcArrayRecord --
+ *
+ *	Called for each error found while checking a square of an
+ *	array's lattice.  Saves the error, relative to the square.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Adds to the errors in rep.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcArrayRecord(def, rect, cptr, rep)
+    CellDef *def;
+    Rect *rect;
+    DRCCookie *cptr;
+    ArrayRep *rep;
+{
+    ArrayError *ae;
+
+    if (rep->ar_nErrors == rep->ar_size)
+    {
+	ArrayError *newErrors;
+
+	rep->ar_size = (rep->ar_size == 0) ? 8 : 2 * rep->ar_size;
+	newErrors = (ArrayError *) mallocMagic((unsigned) (rep->ar_size
+		* sizeof (ArrayError)));
+	if (rep->ar_nErrors > 0)
+	{
+	    memcpy(newErrors, rep->ar_errors, rep->ar_nErrors
+			* sizeof (ArrayError));
+	    freeMagic((char *) rep->ar_errors);
+	}
+	rep->ar_errors = newErrors;
+    }
+    ae = &rep->ar_errors[rep->ar_nErrors++];
+    ae->ae_cptr = cptr;
+    ae->ae_rect.r_xbot = rect->r_xbot - rep->ar_origin.p_x;
+    ae->ae_rect.r_xtop = rect->r_xtop - rep->ar_origin.p_x;
+    ae->ae_rect.r_ybot = rect->r_ybot - rep->ar_origin.p_y;
+    ae->ae_rect.r_ytop = rect->r_ytop - rep->ar_origin.p_y;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcArrayPiece --
+ *
+ *	Check one piece of the area where elements of an array interact:
+ *	yank the elements around it into DRCdef, run the basic checker,
+ *	and look for illegal partial overlaps between elements.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The errors found are added to rep.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcArrayPiece(aa, piece, rep)
+    ArrayLayout *aa;
+    Rect *piece;		/* Errors are found in this area */
+    ArrayRep *rep;
+{
+    Rect yankArea;
+    struct drcClientData arg;
+    int count = 0;
+
+    GEO_EXPAND(piece, DRCTechHalo, &yankArea);
+    DBCellClearDef(DRCdef);
+    (void) DBArraySr(aa->aa_use, &yankArea, drcArrayYankFunc,
+		(ClientData) &yankArea);
+    (void) drcCachedCheck(&yankArea, piece, drcArrayRecord, (ClientData) rep);
+
+    arg.dCD_celldef = DRCdef;
+    arg.dCD_errors = &count;
+    arg.dCD_clip = piece;
+    arg.dCD_cptr = &drcArrayCookie;
+    arg.dCD_function = drcArrayRecord;
+    arg.dCD_clientData = (ClientData) rep;
+    (void) DBArraySr(aa->aa_use, piece, drcArrayOverlapFunc,
+		(ClientData) &arg);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcArraySquare --
+ *
+ *	Find all the errors in one square of an array's lattice.  The
+ *	part of the square covered by bands between rows of elements is
+ *	checked in one piece (or two), and the part covered by bands
+ *	between columns that is left over in up to three more.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Fills in rep.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcArraySquare(aa, p, q, rep)
+    ArrayLayout *aa;
+    int p, q;			/* Indices of square in lattice */
+    ArrayRep *rep;
+{
+    int rowlo[DRC_ARRAY_BANDS], rowhi[DRC_ARRAY_BANDS];
+    int collo[DRC_ARRAY_BANDS], colhi[DRC_ARRAY_BANDS];
+    int nRows, nCols, i, j, y;
+    Rect square, piece;
+
+    rep->ar_nErrors = rep->ar_size = 0;
+    rep->ar_errors = NULL;
+    rep->ar_origin.p_x = aa->aa_bbox.r_xbot + p * aa->aa_sep[0];
+    rep->ar_origin.p_y = aa->aa_bbox.r_ybot + q * aa->aa_sep[1];
+
+    square.r_ll = rep->ar_origin;
+    square.r_xtop = square.r_xbot + aa->aa_sep[0];
+    square.r_ytop = square.r_ybot + aa->aa_sep[1];
+    GeoClip(&square, &aa->aa_bbox);
+    if (GEO_RECTNULL(&square)) return;
+
+    nRows = drcArrayBands(aa, 1, square.r_ybot, square.r_ytop, rowlo, rowhi);
+    nCols = drcArrayBands(aa, 0, square.r_xbot, square.r_xtop, collo, colhi);
+
+    piece.r_xbot = square.r_xbot;
+    piece.r_xtop = square.r_xtop;
+    for (i = 0; i < nRows; i++)
+    {
+	piece.r_ybot = rowlo[i];
+	piece.r_ytop = rowhi[i];
+	drcArrayPiece(aa, &piece, rep);
+    }
+    for (j = 0; j < nCols; j++)
+    {
+	piece.r_xbot = collo[j];
+	piece.r_xtop = colhi[j];
+	y = square.r_ybot;
+	for (i = 0; i <= nRows; i++)
+	{
+	    piece.r_ybot = y;
+	    piece.r_ytop = (i < nRows) ? rowlo[i] : square.r_ytop;
+	    if (piece.r_ybot < piece.r_ytop)
+		drcArrayPiece(aa, &piece, rep);
+	    if (i < nRows) y = rowhi[i];
+	}
+    }
+}
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -74,33 +488,40 @@ static ClientData drcArrayClientData;	/* Extra parameter to pass to func. */
  *
  * Side effects:
  *	Design rules are checked for the subcell, if it is an array,
- *	and the count of errors is added into drcSubCount.
+ *	and the count of errors is added into drcArrayCount.
  *
  * Design:
- *	To verify that an array is correct, we only have to check
- *	four interaction areas, shaded as A, B, C, and D in the diagram
- *	below.  The exact size of the interaction areas depends on
+ *	Elements of an array can only interact in bands along the
+ *	boundaries between neighbouring rows and columns, like A and B
+ *	in the diagram below.  The exact size of the bands depends on
  *	how much overlap there is.  In the extreme cases, there may be
- *	no areas to check at all (instances widely separated), or there
- *	may even be areas with more than four instances overlapping
- *	(spacing less than half the size of the instance).
- *
- * 	--------------DDDDD------------------------------
- *	|             DDDDD             |               |
- *	|               |               |               |
- *	|               |               |               |
- *	|               |               |               |
+ *	no bands at all (instances widely separated), or the bands
+ *	may cover the whole array (spacing less than half the size of
+ *	the instance).
+ *
  * 	-------------------------------------------------
- *	|               |               |               |
- *	|               |               |               |
- *	|               |               |               |
- *	AAAAAAAAAAAAAAAAAAA             |             CCC
- * 	AAAAAAAAAAAAAAAAAAA---------------------------CCC
- *	AAAAAAAAAAAAAAAAAAA             |             CCC
- *	|             BBBBB             |               |
- *	|             BBBBB             |               |
- *	|             BBBBB             |               |
- * 	--------------BBBBB------------------------------
+ *	|             BBBBB             BBBBB           |
+ *	|             BBBBB             BBBBB           |
+ *	|             BBBBB             BBBBB           |
+ *	AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA
+ * 	AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA
+ *	AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA
+ *	|             BBBBB             BBBBB           |
+ *	|             BBBBB             BBBBB           |
+ *	|             BBBBB             BBBBB           |
+ * 	--------------BBBBB---------------BBBBB----------
+ *
+ *	The array is divided into a lattice of squares, one array pitch
+ *	on a side.  Away from the edges of the array, every square
+ *	contains the same elements, bands, and crossings of bands, in
+ *	the same places;  so only one such square is checked, and its
+ *	errors are repeated in all the others.  Only the few squares
+ *	near the edges, where neighbours are missing, are checked on
+ *	their own, so the work done doesn't depend on the size of the
+ *	array.  Errors are reported in every square that overlaps the
+ *	area being checked, so that a big array with a bad element
+ *	spacing shows errors all over, as the same cells placed one at
+ *	a time would.
  *
  * ----------------------------------------------------------------------------
  */
@@ -112,28 +533,23 @@ drcArrayFunc(scx, area)
 				 * regenerated.
 				 */
 {
-    int xsep, ysep;
-    int xsize, ysize;
-    Rect errorArea, yankArea, tmp, tmp2;
+    ArrayLayout aa;
+    ArrayKey key;
+    ArrayRun *xruns, *yruns;
+    ArrayRep *rep;
+    ArrayError *ae;
+    HashTable reps, *table;
+    HashEntry *he;
+    Rect tmp, tmp2, r;
     CellUse *use = scx->scx_use;
-    struct drcClientData arg;
+    int nx, ny, ix, iy, p, q, i, ox, oy, axis, lo[2], hi[2];
+    bool savedBatch;
 
     if ((use->cu_xlo == use->cu_xhi) && (use->cu_ylo == use->cu_yhi))
 	return 2;
-    
-    /* Set up the client data that will be passed down during
-     * checks for exact overlaps.
-     */
-    
-    arg.dCD_celldef = DRCdef;
-    arg.dCD_errors = &drcArrayCount;
-    arg.dCD_clip = &errorArea;
-    arg.dCD_cptr = &drcArrayCookie;
-    arg.dCD_function = drcArrayErrorFunc;
-    arg.dCD_clientData = drcArrayClientData;
 
     /* Compute the sizes and separations of elements, in coordinates
-     * of the parend.  If the array is 1-dimensional, we set the
+     * of the parent.  If the array is 1-dimensional, we set the
      * corresponding spacing to an impossibly large distance.
      */
     
@@ -148,99 +564,130 @@ drcArrayFunc(scx, area)
 	    - use->cu_def->cd_bbox.r_ybot;
     else tmp.r_ytop = use->cu_ysep;
     GeoTransRect(&use->cu_transform, &tmp, &tmp2);
-    xsep = tmp2.r_xtop - tmp2.r_xbot;
-    ysep = tmp2.r_ytop - tmp2.r_ybot;
+    aa.aa_sep[0] = tmp2.r_xtop - tmp2.r_xbot;
+    aa.aa_sep[1] = tmp2.r_ytop - tmp2.r_ybot;
     GeoTransRect(&use->cu_transform, &use->cu_def->cd_bbox, &tmp2);
-    xsize = tmp2.r_xtop - tmp2.r_xbot;
-    ysize = tmp2.r_ytop - tmp2.r_ybot;
-
-    /* Check each of the four areas A, B, C, and D.  Remember that
-     * absolutely arbitrary overlaps between cells are allowed.
-     * Skip some or all of the areas if the cell isn't arrayed in
-     * that direction or if the instances are widely spaced.
+    aa.aa_size[0] = tmp2.r_xtop - tmp2.r_xbot;
+    aa.aa_size[1] = tmp2.r_ytop - tmp2.r_ybot;
+    aa.aa_use = use;
+    aa.aa_bbox = use->cu_bbox;
+
+    /* Work out which squares of the lattice overlap the area.  Skip
+     * the array if neighbouring elements are too far apart to interact,
+     * or if elements are stacked on top of each other.
      */
-    
-    if (ysep < ysize + DRCTechHalo)
+
+    for (axis = 0; axis < 2; axis++)
     {
-	/* A */
-
-	errorArea.r_xbot = use->cu_bbox.r_xbot;
-	errorArea.r_xtop = use->cu_bbox.r_xbot + xsize + DRCTechHalo;
-	errorArea.r_ybot = use->cu_bbox.r_ybot + ysep - DRCTechHalo;
-	errorArea.r_ytop = use->cu_bbox.r_ybot + ysize + DRCTechHalo;
-	GeoClip(&errorArea, area);
-	if (!GEO_RECTNULL(&errorArea))
-	{
-	    GEO_EXPAND(&errorArea, DRCTechHalo, &yankArea);
-	    DBCellClearDef(DRCdef);
-	    (void) DBArraySr(use, &yankArea, drcArrayYankFunc,
-		(ClientData) &yankArea);
-	    drcArrayCount += DRCBasicCheck(DRCdef, &yankArea, &errorArea,
-		drcArrayErrorFunc, drcArrayClientData);
-	    (void) DBArraySr(use, &errorArea, drcArrayOverlapFunc,
-		(ClientData) &arg);
-	}
+	int sep = aa.aa_sep[axis];
+	int base = AXLO(&aa.aa_bbox, axis);
+	int length = AXHI(&aa.aa_bbox, axis) - base;
+
+	if (sep <= 0) return 2;
+	aa.aa_n[axis] = (length - aa.aa_size[axis]) / sep + 1;
+	aa.aa_squares[axis] = (length + sep - 1) / sep;
+	aa.aa_bands[axis] = (aa.aa_n[axis] > 1)
+		&& (sep < aa.aa_size[axis] + DRCTechHalo);
+	lo[axis] = MAX(0, FLOORDIV(AXLO(area, axis) - base, sep));
+	hi[axis] = MIN(aa.aa_squares[axis] - 1,
+		FLOORDIV(AXHI(area, axis) - 1 - base, sep));
+    }
+    if (!aa.aa_bands[0] && !aa.aa_bands[1]) return 2;
+    if (lo[0] > hi[0] || lo[1] > hi[1]) return 2;
 
-	/* C */
+    /* The squares are checked here and now, even by the batch checker,
+     * since their errors have to be repeated.
+     */
 
-	errorArea.r_xtop = use->cu_bbox.r_xtop;
-	errorArea.r_xbot = use->cu_bbox.r_xtop - DRCTechHalo;
-	GeoClip(&errorArea, area);
-	if (!GEO_RECTNULL(&errorArea))
-	{
-	    GEO_EXPAND(&errorArea, DRCTechHalo, &yankArea);
-	    DBCellClearDef(DRCdef);
-	    (void) DBArraySr(use, &yankArea, drcArrayYankFunc,
-		(ClientData) &yankArea);
-	    drcArrayCount += DRCBasicCheck(DRCdef, &yankArea, &errorArea,
-		drcArrayErrorFunc, drcArrayClientData);
-	    (void) DBArraySr(use, &errorArea, drcArrayOverlapFunc,
-		(ClientData) &arg);
-	}
-    }
+    savedBatch = drcBatchActive;
+    drcBatchActive = FALSE;
+
+    /* Squares are kept from call to call unless the array is small,
+     * or the element cell can't be identified (or CIF rules are being
+     * checked).
+     */
 
-    if (xsep < xsize + DRCTechHalo)
+    memset(&key, 0, sizeof key);
+    if (aa.aa_n[0] * aa.aa_n[1] >= DRC_ARRAY_MINSIZE && !drcCifValid
+	    && DRCCellSignature(use->cu_def, &key.ak_sig))
+    {
+	if (!drcArrayInit) drcArrayFlush();
+	table = &drcArrayTable;
+    }
+    else
     {
-	/* B */
-
-	errorArea.r_xbot = use->cu_bbox.r_xbot + xsep - DRCTechHalo;
-	errorArea.r_xtop = use->cu_bbox.r_xbot + xsize + DRCTechHalo;
-	errorArea.r_ybot = use->cu_bbox.r_ybot;
-	errorArea.r_ytop = errorArea.r_ybot + ysep - DRCTechHalo;
-	GeoClip(&errorArea, area);
-	if (!GEO_RECTNULL(&errorArea))
+	HashInit(&reps, 16, HashSize(sizeof (ArrayKey)));
+	table = &reps;
+    }
+    key.ak_trans = use->cu_transform;
+    key.ak_xlo = use->cu_xlo;
+    key.ak_xhi = use->cu_xhi;
+    key.ak_ylo = use->cu_ylo;
+    key.ak_yhi = use->cu_yhi;
+    key.ak_xsep = use->cu_xsep;
+    key.ak_ysep = use->cu_ysep;
+
+    nx = drcArrayRuns(&aa, 0, lo[0], hi[0], &xruns);
+    ny = drcArrayRuns(&aa, 1, lo[1], hi[1], &yruns);
+
+    for (ix = 0; ix < nx; ix++)
+	for (iy = 0; iy < ny; iy++)
 	{
-	    GEO_EXPAND(&errorArea, DRCTechHalo, &yankArea);
-	    DBCellClearDef(DRCdef);
-	    (void) DBArraySr(use, &yankArea, drcArrayYankFunc,
-		(ClientData) &yankArea);
-	    drcArrayCount += DRCBasicCheck(DRCdef, &yankArea, &errorArea,
-		drcArrayErrorFunc, drcArrayClientData);
-	    (void) DBArraySr(use, &errorArea, drcArrayOverlapFunc,
-		(ClientData) &arg);
+	    if (SigInterruptPending) goto done;
+
+	    key.ak_p = xruns[ix].ra_rep;
+	    key.ak_q = yruns[iy].ra_rep;
+	    he = HashLookOnly(table, (char *) &key);
+	    if (he != NULL)
+		rep = (ArrayRep *) HashGetValue(he);
+	    else
+	    {
+		rep = (ArrayRep *) mallocMagic(sizeof (ArrayRep));
+		drcArraySquare(&aa, key.ak_p, key.ak_q, rep);
+		if (SigInterruptPending)
+		{
+		    if (rep->ar_errors != NULL)
+			freeMagic((char *) rep->ar_errors);
+		    freeMagic((char *) rep);
+		    goto done;
+		}
+		if (table == &drcArrayTable && HashGetNumEntries(table)
+			>= DRC_ARRAY_SQUARES)
+		    drcArrayFlush();
+		HashSetValue(HashFind(table, (char *) &key), rep);
+	    }
+	    if (rep->ar_nErrors == 0) continue;
+
+	    for (p = xruns[ix].ra_lo; p <= xruns[ix].ra_hi; p++)
+		for (q = yruns[iy].ra_lo; q <= yruns[iy].ra_hi; q++)
+		{
+		    ox = aa.aa_bbox.r_xbot + p * aa.aa_sep[0];
+		    oy = aa.aa_bbox.r_ybot + q * aa.aa_sep[1];
+		    for (i = 0, ae = rep->ar_errors; i < rep->ar_nErrors;
+			    i++, ae++)
+		    {
+			r = ae->ae_rect;
+			r.r_xbot += ox;
+			r.r_xtop += ox;
+			r.r_ybot += oy;
+			r.r_ytop += oy;
+			GeoClip(&r, area);
+			if (GEO_RECTNULL(&r)) continue;
+			(*drcArrayErrorFunc)(DRCdef, &r, ae->ae_cptr,
+				drcArrayClientData);
+			drcArrayCount++;
+		    }
+		}
 	}
 
-	/* D */
-
-	errorArea.r_ytop = use->cu_bbox.r_ytop;
-	errorArea.r_ybot = use->cu_bbox.r_ytop - DRCTechHalo;
-	GeoClip(&errorArea, area);
-	if (!GEO_RECTNULL(&errorArea))
-	{
-	    GEO_EXPAND(&errorArea, DRCTechHalo, &yankArea);
-	    DBCellClearDef(DRCdef);
-	    (void) DBArraySr(use, &yankArea, drcArrayYankFunc,
-		(ClientData) &yankArea);
-	    drcArrayCount += DRCBasicCheck(DRCdef, &yankArea, &errorArea,
-		drcArrayErrorFunc, drcArrayClientData);
-	    (void) DBArraySr(use, &errorArea, drcArrayOverlapFunc,
-		(ClientData) &arg);
-	}
-    }
-    
+done:
+    if (table == &reps) drcArrayKill(&reps);
+    freeMagic((char *) xruns);
+    freeMagic((char *) yruns);
+    drcBatchActive = savedBatch;
     return 2;
 }
-
+
 /*
  * ----------------------------------------------------------------------------
  * DRCArrayCheck --
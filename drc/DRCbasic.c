@@ -55,6 +55,7 @@ static DRCCookie drcOverlapCookie = {
 
 extern int areaCheck();
 extern int drcTile();
+extern void drcBasicPlanes();
 extern MaxRectsData *drcCanonicalMaxwidth();
 
 /*
@@ -303,6 +304,10 @@ areaCheck(tile, arg)
  *	the basic will be aborted immediately.  This means the check
  *	may be incomplete.
  *
+ *	While the batch checker is collecting work (see DRCbatch.c),
+ *	the paint is only copied away here, and its errors are found
+ *	later.  The count returned then covers only the CIF layers.
+ *
  * ----------------------------------------------------------------------------
  */
 
@@ -318,7 +323,6 @@ DRCBasicCheck (celldef, checkRect, clipRect, function, cdata)
 {
     struct drcClientData arg;
     int	errors;
-    int planeNum;
 
     if (DRCCurStyle == NULL) return 0;	/* No DRC, no errors */
 
@@ -339,16 +343,99 @@ DRCBasicCheck (celldef, checkRect, clipRect, function, cdata)
     arg.dCD_rlist = NULL;
     arg.dCD_entries = 0;
 
+    /* The batch checker does the paint later, in parallel */
+    if (!drcBatchActive || !drcBatchDefer(celldef, checkRect, clipRect))
+	drcBasicPlanes(&arg);
+    drcCifCheck(&arg);
+    if (arg.dCD_rlist != NULL) freeMagic(arg.dCD_rlist);
+    return (errors);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcCheckPaint --
+ *
+ * Same as DRCBasicCheck(), but without the checks on CIF layers.
+ * This is what the batch checker (DRCbatch.c) runs in the pool
+ * threads, on paint that has been copied into a cell of its own.
+ *
+ * Results:
+ *	Number of errors found.
+ *
+ * Side effects:
+ *	Calls function for each error, as DRCBasicCheck() does.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+drcCheckPaint(celldef, checkRect, clipRect, function, cdata)
+    CellDef *celldef;	/* CellDef being checked */
+    Rect *checkRect;	/* Check rules in this area */
+    Rect *clipRect;	/* Clip error tiles against this area. */
+    void (*function)();	/* Function to apply for each error found. */
+    ClientData cdata;	/* Passed to function as argument. */
+{
+    struct drcClientData arg;
+    int	errors;
+
+    if (DRCCurStyle == NULL) return 0;
+    if ((checkRect->r_xbot >= checkRect->r_xtop)
+	    || (checkRect->r_ybot >= checkRect->r_ytop))
+	 return (0);
+
+    errors = 0;
+
+    arg.dCD_celldef = celldef;
+    arg.dCD_rect = checkRect;
+    arg.dCD_errors = &errors;
+    arg.dCD_function = function;
+    arg.dCD_clip = clipRect;
+    arg.dCD_clientData = cdata;
+    arg.dCD_rlist = NULL;
+    arg.dCD_entries = 0;
+
+    drcBasicPlanes(&arg);
+    if (arg.dCD_rlist != NULL) freeMagic(arg.dCD_rlist);
+    return (errors);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcBasicPlanes --
+ *
+ * Check the rules on each paint plane of arg->dCD_celldef over
+ * the area arg->dCD_rect.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Calls the client's error function for each error found.
+ *	Sets the client fields of all tiles of the planes.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcBasicPlanes(arg)
+    struct drcClientData *arg;
+{
+    CellDef *celldef = arg->dCD_celldef;
+    int planeNum;
+
+    /* No edge rules until the style has been compiled */
+    if (DRCCurStyle->DRCRules == NULL) return;
+
     for (planeNum = PL_TECHDEPBASE; planeNum < DBNumPlanes; planeNum++)
     {
-        arg.dCD_plane = planeNum;
+        arg->dCD_plane = planeNum;
 	DBResetTilePlane(celldef->cd_planes[planeNum], DRC_UNPROCESSED);
         (void) DBSrPaintArea ((Tile *) NULL, celldef->cd_planes[planeNum],
-		checkRect, &DBAllTypeBits, drcTile, (ClientData) &arg);
+		arg->dCD_rect, &DBAllTypeBits, drcTile, (ClientData) arg);
     }
-    drcCifCheck(&arg);
-    if (arg.dCD_rlist != NULL) freeMagic(arg.dCD_rlist);
-    return (errors);
 }
 
 /*
@@ -378,6 +465,8 @@ drcTile (tile, arg)
     struct drcClientData *arg;
 {
     DRCCookie *cptr;	/* Current design rule on list */
+    DRCCookie *cend;	/* End of the rules for the edge */
+    int *start;		/* Start of the rules for each edge */
     Rect *rect = arg->dCD_rect;	/* Area being checked */
     Rect errRect;		/* Area checked for an individual rule */
     MaxRectsData *mrd;		/* Used by widespacing rule */
@@ -416,24 +505,16 @@ drcTile (tile, arg)
 	TileType tt = TiGetLeftType(tile);
 	if (tt != TT_SPACE)
 	{
-	    for (cptr = DRCCurStyle->DRCRulesTbl[TT_SPACE][tt];
-			cptr != (DRCCookie *) NULL; cptr = cptr->drcc_next)
-		if (cptr->drcc_flags & DRC_ANGLES)
-		{
-		    drcCheckAngles(tile, arg, cptr);
-		    break;
-		}
+	    cptr = DRCCurStyle->DRCAngleRules[tt];
+	    if (cptr != (DRCCookie *) NULL)
+		drcCheckAngles(tile, arg, cptr);
 	}
 	tt = TiGetRightType(tile);
 	if (tt != TT_SPACE)
 	{
-	    for (cptr = DRCCurStyle->DRCRulesTbl[TT_SPACE][tt];
-			cptr != (DRCCookie *) NULL; cptr = cptr->drcc_next)
-		if (cptr->drcc_flags & DRC_ANGLES)
-		{
-		    drcCheckAngles(tile, arg, cptr);
-		    break;
-		}
+	    cptr = DRCCurStyle->DRCAngleRules[tt];
+	    if (cptr != (DRCCookie *) NULL)
+		drcCheckAngles(tile, arg, cptr);
 	}
 
         /* This drc is only for the left edge of the tile */
@@ -511,8 +592,10 @@ drcTile (tile, arg)
 		continue;
 
 	    triggered = 0;
-	    for (cptr = DRCCurStyle->DRCRulesTbl[to][tt]; cptr != (DRCCookie *) NULL;
-			cptr = cptr->drcc_next)
+	    start = DRCCurStyle->DRCRuleStart[DRC_VERTICAL]
+			+ to * DRCCurStyle->DRCRuleTypes + tt;
+	    cend = DRCCurStyle->DRCRules + start[1];
+	    for (cptr = DRCCurStyle->DRCRules + start[0]; cptr < cend; cptr++)
 	    {
 		if (cptr->drcc_flags & DRC_ANGLES) continue;
 
@@ -526,7 +609,7 @@ drcTile (tile, arg)
 
 		if (arg->dCD_plane != cptr->drcc_edgeplane)
 		{
-		    if (trigpending) cptr = cptr->drcc_next;
+		    if (trigpending) cptr++;
 		    continue;
 		}
 
@@ -546,7 +629,9 @@ drcTile (tile, arg)
 		    Rect *lr;
 		    int i;
 
-		    if (!trigpending) cptr->drcc_dist++;
+		    /* Unless this is a trigger, the distance of the	*/
+		    /* packed rule is one more than the rule's own (see	*/
+		    /* drcPackRules).					*/
 
 		    if (cptr->drcc_flags & DRC_REVERSE)
 			mrd = drcCanonicalMaxwidth(tpleft, GEO_WEST, arg, cptr);
@@ -554,13 +639,12 @@ drcTile (tile, arg)
 			mrd = drcCanonicalMaxwidth(tile, GEO_EAST, arg, cptr);
 		    else
 			mrd = NULL;
-		    if (!trigpending) cptr->drcc_dist--;
 		    if (trigpending)
 		    {
 			if (mrd)
 			    triggered = mrd->entries;
 			else
-			    cptr = cptr->drcc_next;
+			    cptr++;
 		    }
 		    else if (mrd)
 		    {
@@ -790,7 +874,7 @@ drcTile (tile, arg)
 		    /* do the next rule.  Otherwise, skip it.		*/
 
 		    if (trigpending)
-			cptr = cptr->drcc_next;
+			cptr++;
 		}
 		else
 		    triggered = arg->dCD_entries;
@@ -873,8 +957,10 @@ checkbottom:
 		continue;
 
 	    triggered = 0;
-	    for (cptr = DRCCurStyle->DRCRulesTbl[to][tt]; cptr != (DRCCookie *) NULL;
-				cptr = cptr->drcc_next)
+	    start = DRCCurStyle->DRCRuleStart[DRC_HORIZONTAL]
+			+ to * DRCCurStyle->DRCRuleTypes + tt;
+	    cend = DRCCurStyle->DRCRules + start[1];
+	    for (cptr = DRCCurStyle->DRCRules + start[0]; cptr < cend; cptr++)
 	    {
 		if (cptr->drcc_flags & DRC_ANGLES) continue;
 
@@ -888,7 +974,7 @@ checkbottom:
 
 		if (arg->dCD_plane != cptr->drcc_edgeplane)
 		{
-		    if (trigpending) cptr = cptr->drcc_next;
+		    if (trigpending) cptr++;
 		    continue;
 		}
 
@@ -903,7 +989,9 @@ checkbottom:
 		    Rect *lr;
 		    int i;
 
-		    if (!trigpending) cptr->drcc_dist++;
+		    /* Unless this is a trigger, the distance of the	*/
+		    /* packed rule is one more than the rule's own (see	*/
+		    /* drcPackRules).					*/
 
 		    if (cptr->drcc_flags & DRC_REVERSE)
 			mrd = drcCanonicalMaxwidth(tpbot, GEO_SOUTH, arg, cptr);
@@ -911,13 +999,12 @@ checkbottom:
 			mrd = drcCanonicalMaxwidth(tile, GEO_NORTH, arg, cptr);
 		    else
 			mrd = NULL;
-		    if (!trigpending) cptr->drcc_dist--;
 		    if (trigpending)
 		    {
 			if (mrd)
 			    triggered = mrd->entries;
 			else
-			    cptr = cptr->drcc_next;
+			    cptr++;
 		    }
 		    else if (mrd)
 		    {
@@ -939,7 +1026,7 @@ checkbottom:
 				| DRC_MAXWIDTH))
 		{
 		    /* only have to do these checks in one direction */
-		    if (trigpending) cptr = cptr->drcc_next;
+		    if (trigpending) cptr++;
 		    continue;
 		}
 		else if (!triggered) mrd = NULL;
@@ -1095,7 +1182,7 @@ checkbottom:
 		    /* do the next rule.  Otherwise, skip it.	*/
 
 		    if (trigpending)
-			cptr = cptr->drcc_next;
+			cptr++;
 		}
 		else
 		    triggered = arg->dCD_entries;
@@ -0,0 +1,545 @@
+/*
+ * DRCbatch.c --
+ *
+ * Batch design-rule checker.  The continuous checker (DRCcontin.c)
+ * takes one square of the DRCStepSize checkerboard at a time, which
+ * keeps the layout editable while it runs.  When the whole of the
+ * pending work is wanted at once ("drc catchup", as in a full-chip
+ * check), the squares can instead be checked on the pool of worker
+ * threads (see utils/workers.c).
+ *
+ * The squares with check tiles in them are visited in order, and each
+ * is handled as drcCheckTile() would, except that every call to
+ * DRCBasicCheck() only copies the paint it would check into a yank
+ * cell of its own, along with the areas to check and to clip errors
+ * to.  The paint of the cell being checked is copied with the halo
+ * around the check area, while the paint that the interaction and
+ * array checks have just yanked into DRCdef is taken over whole.
+ * Once a number of squares have been collected, the copies are checked
+ * in parallel, each thread painting errors into a plane belonging to
+ * the copy.  Then the errors of each square are merged into the cell's
+ * error plane in the same way that drcCheckTile() does, in the order
+ * that the squares were visited.  Everything apart from the basic
+ * checks, including the search for interactions and the checks on CIF
+ * layers, still runs in the calling thread.  So does the basic check
+ * of a cell's own paint when the style has rules that look at whole
+ * shapes, which a copy of the paint around one square would cut short.
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "utils/magic.h"
+#include "utils/geometry.h"
+#include "tiles/tile.h"
+#include "utils/hash.h"
+#include "database/database.h"
+#include "drc/drc.h"
+#include "utils/signals.h"
+#include "utils/undo.h"
+#include "utils/malloc.h"
+#include "utils/workers.h"
+
+/* Number of squares collected per thread before they are checked */
+#define	DRC_BATCH_SQUARES	8
+
+/*
+ * A copy of some paint to be checked by DRCBasicCheck(), and the
+ * results of checking it.
+ */
+
+typedef struct
+{
+    CellDef	*bc_def;	/* Yank cell holding the paint */
+    CellUse	*bc_use;	/* Use of bc_def, to copy paint into */
+    Plane	*bc_errors;	/* Error tiles found in bc_def */
+    Rect	 bc_area;	/* Area to check */
+    Rect	 bc_clip;	/* Area to clip errors to */
+    TileType	 bc_type;	/* Type of error tiles to paint */
+    int		 bc_count;	/* Number of errors found */
+    int		 bc_tiles;	/* Statistics gathered while checking */
+    int		 bc_edges;
+    int		 bc_rules;
+    int		 bc_slow;
+} BatchCheck;
+
+/*
+ * One square of the checkerboard.
+ */
+
+typedef struct
+{
+    Rect	 bs_square;	/* The square itself */
+    Rect	 bs_erase;	/* Area of the check tiles in the square */
+    Rect	 bs_check;	/* bs_erase plus the halo, within the square */
+    Plane	*bs_errors;	/* Errors found in the calling thread */
+    int		 bs_first;	/* Index of the first BatchCheck for */
+    int		 bs_last;	/* this square, and one past its last. */
+} BatchSquare;
+
+/* TRUE while DRCBasicCheck() is to call drcBatchDefer() */
+global bool drcBatchActive = FALSE;
+
+/*
+ * The BatchChecks are kept from one run to the next, so that their
+ * yank cells needn't be made again.  drcBatchNumChecks of them are
+ * in use.
+ */
+
+static BatchCheck **drcBatchChecks = NULL;
+static int drcBatchNumChecks = 0;
+static int drcBatchMaxChecks = 0;
+
+/* Use through which the paint of the cell being checked is copied */
+static CellUse *drcBatchUse = NULL;
+
+/* Erases all check tiles (TT_SPACE is zero) */
+static PaintResultType drcBatchEraseTbl[TT_MAXTYPES];
+
+extern CellDef *DRCErrorDef;
+extern TileType DRCErrorType;
+extern int DRCErrorCount;
+extern int drcBatchPutFunc();
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcBatchNewCheck --
+ *
+ * Find the next free BatchCheck, making it if need be.
+ *
+ * Results:
+ *	Pointer to the BatchCheck, whose yank cell and error plane
+ *	are empty.
+ *
+ * Side effects:
+ *	May make a new yank cell.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+BatchCheck *
+drcBatchNewCheck()
+{
+    BatchCheck *bc, **newChecks;
+    char name[32];
+    int i;
+
+    if (drcBatchNumChecks == drcBatchMaxChecks)
+    {
+	i = (drcBatchMaxChecks == 0) ? 64 : 2 * drcBatchMaxChecks;
+	newChecks = (BatchCheck **) mallocMagic((unsigned) (i
+		* sizeof (BatchCheck *)));
+	if (drcBatchMaxChecks > 0)
+	{
+	    memcpy(newChecks, drcBatchChecks,
+			drcBatchMaxChecks * sizeof (BatchCheck *));
+	    freeMagic((char *) drcBatchChecks);
+	}
+	while (drcBatchMaxChecks < i)
+	    newChecks[drcBatchMaxChecks++] = (BatchCheck *) NULL;
+	drcBatchChecks = newChecks;
+    }
+
+    bc = drcBatchChecks[drcBatchNumChecks];
+    if (bc == (BatchCheck *) NULL)
+    {
+	bc = (BatchCheck *) mallocMagic(sizeof (BatchCheck));
+	(void) sprintf(name, "__DRCBATCH%d__", drcBatchNumChecks);
+	bc->bc_def = DBCellLookDef(name);
+	if (bc->bc_def == (CellDef *) NULL)
+	{
+	    bc->bc_def = DBCellNewDef(name, (char *) NULL);
+	    DBCellSetAvail(bc->bc_def);
+	    bc->bc_def->cd_flags |= CDINTERNAL;
+	}
+	bc->bc_use = DBCellNewUse(bc->bc_def, (char *) NULL);
+	DBSetTrans(bc->bc_use, &GeoIdentityTransform);
+	bc->bc_errors = DBNewPlane((ClientData) TT_SPACE);
+	drcBatchChecks[drcBatchNumChecks] = bc;
+    }
+    drcBatchNumChecks++;
+    return bc;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcBatchDefer --
+ *
+ * Called by DRCBasicCheck() while drcBatchActive is set, to put off
+ * checking the paint of celldef until drcBatchRun().
+ *
+ * Only the paint around checkRect is copied from a real cell, so a
+ * rule that measures whole shapes (the area of a region, say) would
+ * see them cut off at the edge of the copy.  If the style has such
+ * rules, the paint of real cells is checked in place by the caller.
+ * DRCdef is always taken, since it holds no more than the area being
+ * checked anyway.
+ *
+ * Results:
+ *	TRUE, meaning that the paint has been taken care of, or FALSE
+ *	if the caller must check it now.
+ *
+ * Side effects:
+ *	Copies the paint around checkRect, or all of DRCdef, into the
+ *	yank cell of a new BatchCheck.  The current DRCErrorType is
+ *	the type of the errors that will be painted.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+drcBatchDefer(celldef, checkRect, clipRect)
+    CellDef *celldef;	/* Cell whose paint is to be checked */
+    Rect *checkRect;	/* Area to check */
+    Rect *clipRect;	/* Area to clip errors to */
+{
+    BatchCheck *bc;
+    SearchContext scx;
+    int pNum;
+
+    if (celldef != DRCdef && DRCCurStyle->DRCWholeShapes)
+	return FALSE;
+
+    bc = drcBatchNewCheck();
+    bc->bc_area = *checkRect;
+    bc->bc_clip = *clipRect;
+    bc->bc_type = DRCErrorType;
+
+    if (celldef == DRCdef)
+    {
+	/*
+	 * DRCdef is cleared before it is filled again, which leaves
+	 * the tiles with the yank cell that shares them.
+	 */
+	for (pNum = PL_TECHDEPBASE; pNum < DBNumPlanes; pNum++)
+	    TiSharePlane(bc->bc_def->cd_planes[pNum], DRCdef->cd_planes[pNum]);
+    }
+    else
+    {
+	drcBatchUse->cu_def = celldef;
+	scx.scx_use = drcBatchUse;
+	scx.scx_trans = GeoIdentityTransform;
+	GEO_EXPAND(checkRect, DRCTechHalo, &scx.scx_area);
+	DBCellCopyPaint(&scx, &DBAllButSpaceAndDRCBits, 0, bc->bc_use);
+    }
+    return TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcBatchError --
+ *
+ * Error function for the basic checks run by drcBatchTask().
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Paints an error tile into the error plane of the BatchCheck.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcBatchError(celldef, rect, cptr, bc)
+    CellDef *celldef;		/* Yank cell being checked -- not used */
+    Rect *rect;			/* Area of error */
+    DRCCookie *cptr;		/* Design rule violated -- not used */
+    BatchCheck *bc;
+{
+    DBPaintPlane(bc->bc_errors, rect, DBStdPaintTbl(bc->bc_type,
+	PL_DRC_ERROR), (PaintUndoInfo *) NULL);
+}
+
+/*
+ * drcBatchTask --
+ *
+ * Called by WorkerRun() on behalf of drcBatchRun() for each BatchCheck.
+ * The statistics counted in this thread are handed back to be added up
+ * by drcBatchRun().  Always returns 0.
+ */
+
+int
+drcBatchTask(task, worker, cdata)
+    int task;
+    int worker;
+    ClientData cdata;	/* Not used */
+{
+    BatchCheck *bc = drcBatchChecks[task];
+    int tiles = DRCstatTiles, edges = DRCstatEdges;
+    int rules = DRCstatRules, slow = DRCstatSlow;
+
+    bc->bc_count = drcCheckPaint(bc->bc_def, &bc->bc_area, &bc->bc_clip,
+		drcBatchError, (ClientData) bc);
+
+    bc->bc_tiles = DRCstatTiles - tiles;
+    bc->bc_edges = DRCstatEdges - edges;
+    bc->bc_rules = DRCstatRules - rules;
+    bc->bc_slow = DRCstatSlow - slow;
+    DRCstatTiles = tiles;
+    DRCstatEdges = edges;
+    DRCstatRules = rules;
+    DRCstatSlow = slow;
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcBatchRun --
+ *
+ * Run the basic checks collected for a number of squares of celldef,
+ * and record the results.
+ *
+ * Results:
+ *	TRUE if the squares were checked, FALSE if there was an
+ *	interrupt.
+ *
+ * Side effects:
+ *	Unless there was an interrupt, the check tiles of the squares
+ *	are erased and their errors are regenerated, as by drcCheckTile().
+ *	All the BatchChecks are freed up.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+drcBatchRun(celldef, squares, nSquares)
+    CellDef *celldef;		/* Cell being checked */
+    BatchSquare *squares;	/* Squares collected */
+    int nSquares;		/* Number of entries in squares */
+{
+    BatchCheck *bc;
+    BatchSquare *bs;
+    bool done;
+    int i, pNum;
+
+    if (nSquares == 0) return TRUE;
+
+    /*
+     * Let go of the last yank, so that no two threads can see the
+     * same tiles.  Planes that would still be shared (for example
+     * if DRCdef had nothing on them) are given copies of their own.
+     */
+    DBCellClearDef(DRCdef);
+    for (i = 0; i < drcBatchNumChecks; i++)
+	for (pNum = PL_TECHDEPBASE; pNum < DBNumPlanes; pNum++)
+	    TiUnsharePlane(drcBatchChecks[i]->bc_def->cd_planes[pNum]);
+
+    if (!SigInterruptPending)
+	(void) WorkerRun(drcBatchNumChecks, drcBatchTask, (ClientData) NULL);
+    done = !SigInterruptPending;
+
+    for (bs = squares; bs < squares + nSquares; bs++)
+    {
+	for (i = bs->bs_first; i < bs->bs_last; i++)
+	{
+	    bc = drcBatchChecks[i];
+	    if (done)
+	    {
+		(void) DBSrPaintArea((Tile *) NULL, bc->bc_errors,
+			&TiPlaneRect, &DBAllButSpaceBits, drcBatchPutFunc,
+			(ClientData) bs->bs_errors);
+		DRCErrorCount += bc->bc_count;
+		DRCstatTiles += bc->bc_tiles;
+		DRCstatEdges += bc->bc_edges;
+		DRCstatRules += bc->bc_rules;
+		DRCstatSlow += bc->bc_slow;
+	    }
+	    DBCellClearDef(bc->bc_def);
+	    DBClearPaintPlane(bc->bc_errors);
+	}
+	if (done)
+	{
+	    DRCstatSquares += 1;
+	    drcSquareDone(celldef, drcBatchEraseTbl, &bs->bs_square,
+			&bs->bs_erase, &bs->bs_check, bs->bs_errors);
+	}
+	DBClearPaintPlane(bs->bs_errors);
+    }
+    drcBatchNumChecks = 0;
+    return done;
+}
+
+/*
+ * drcBatchPutFunc --
+ *
+ * Called for each error tile of a BatchCheck, to paint it into the
+ * error plane of its square.  Always returns 0.
+ */
+
+int
+drcBatchPutFunc(tile, plane)
+    Tile *tile;
+    Plane *plane;
+{
+    Rect area;
+
+    TiToRect(tile, &area);
+    DBPaintPlane(plane, &area, DBStdPaintTbl(TiGetType(tile), PL_DRC_ERROR),
+	(PaintUndoInfo *) NULL);
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcBatchCell --
+ *
+ * Check all the squares of celldef that have check tiles in them.
+ *
+ * Results:
+ *	TRUE if all went well, FALSE if there was an interrupt.
+ *
+ * Side effects:
+ *	Modifies both DRC planes of celldef.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+drcBatchCell(celldef, squares, maxSquares)
+    CellDef *celldef;		/* Cell to check */
+    BatchSquare *squares;	/* Room for collecting squares */
+    int maxSquares;		/* Number of entries in squares */
+{
+    BatchSquare *bs;
+    Rect bbox, square, erasebox;
+    int xlo, ylo, nSquares;
+    extern int DRCInteractionCheck(), DRCArrayCheck();
+
+    if (!DBBoundPlane(celldef->cd_planes[PL_DRC_CHECK], &bbox))
+	return TRUE;
+
+    /* Squares are aligned as in drcCheckTile() */
+
+    xlo = (bbox.r_xbot / DRCStepSize) * DRCStepSize;
+    if (xlo > bbox.r_xbot) xlo -= DRCStepSize;
+    ylo = (bbox.r_ybot / DRCStepSize) * DRCStepSize;
+    if (ylo > bbox.r_ybot) ylo -= DRCStepSize;
+
+    DRCErrorDef = celldef;
+    nSquares = 0;
+    for (square.r_ybot = ylo; square.r_ybot < bbox.r_ytop;
+		square.r_ybot += DRCStepSize)
+	for (square.r_xbot = xlo; square.r_xbot < bbox.r_xtop;
+		square.r_xbot += DRCStepSize)
+	{
+	    square.r_xtop = square.r_xbot + DRCStepSize;
+	    square.r_ytop = square.r_ybot + DRCStepSize;
+	    erasebox = GeoNullRect;
+	    (void) DBSrPaintArea((Tile *) NULL,
+		celldef->cd_planes[PL_DRC_CHECK], &square,
+		&DBAllButSpaceBits, drcIncludeArea, (ClientData) &erasebox);
+	    GeoClip(&erasebox, &square);
+	    if (GEO_RECTNULL(&erasebox)) continue;
+
+	    bs = &squares[nSquares];
+	    bs->bs_square = square;
+	    bs->bs_erase = erasebox;
+	    GEO_EXPAND(&erasebox, DRCTechHalo, &bs->bs_check);
+	    GeoClip(&bs->bs_check, &square);
+	    bs->bs_first = drcBatchNumChecks;
+
+	    /* The same checks as made by drcCheckTile() */
+
+	    drcBatchActive = TRUE;
+	    DRCErrorType = TT_ERROR_S;
+	    (void) DRCInteractionCheck(celldef, &bs->bs_square, &bs->bs_erase,
+			drcPaintError, (ClientData) bs->bs_errors);
+	    DRCErrorType = TT_ERROR_P;
+	    (void) DRCArrayCheck(celldef, &bs->bs_erase, drcPaintError,
+			(ClientData) bs->bs_errors);
+	    drcBatchActive = FALSE;
+
+	    bs->bs_last = drcBatchNumChecks;
+	    if (++nSquares == maxSquares || SigInterruptPending)
+	    {
+		if (!drcBatchRun(celldef, squares, nSquares))
+		    return FALSE;
+		nSquares = 0;
+	    }
+	}
+
+    return drcBatchRun(celldef, squares, nSquares);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DRCBatchCheck --
+ *
+ * Check all the squares waiting for the continuous checker, using
+ * the worker threads.  The cells stay on the DRCPending list, for
+ * DRCContinuous() to take off.
+ *
+ * Results:
+ *	TRUE if everything was checked.  FALSE if there was an interrupt,
+ *	or if the batch checker wasn't used because there are no worker
+ *	threads to make it worthwhile or the continuous checker is in
+ *	the middle of a square.
+ *
+ * Side effects:
+ *	Modifies both DRC planes of the cells on the DRCPending list.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+DRCBatchCheck()
+{
+    DRCPendingCookie *dpc;
+    BatchSquare *squares;
+    int i, maxSquares;
+    bool done;
+
+    if (DRCPendingRoot == (DRCPendingCookie *) NULL) return TRUE;
+    if (DRCCurStyle == NULL || DRCStepSize <= 0) return FALSE;
+    if (WorkerGetCount() < 2) return FALSE;
+#ifdef MAGIC_WRAPPER
+    if (DRCStatus != DRC_NOT_RUNNING) return FALSE;
+#endif
+
+    if (drcBatchUse == (CellUse *) NULL)
+    {
+	drcBatchUse = DBCellNewUse(DRCdef, (char *) NULL);
+	DBSetTrans(drcBatchUse, &GeoIdentityTransform);
+    }
+
+    maxSquares = DRC_BATCH_SQUARES * WorkerGetCount();
+    squares = (BatchSquare *) mallocMagic((unsigned) (maxSquares
+		* sizeof (BatchSquare)));
+    for (i = 0; i < maxSquares; i++)
+	squares[i].bs_errors = DBNewPlane((ClientData) TT_SPACE);
+
+    UndoDisable();
+    drcCacheFlushSigs();
+    done = TRUE;
+    for (dpc = DRCPendingRoot; dpc != NULL && done; dpc = dpc->dpc_next)
+	if (!drcCacheSkip(dpc->dpc_def))
+	    done = drcBatchCell(dpc->dpc_def, squares, maxSquares);
+    UndoEnable();
+
+    for (i = 0; i < maxSquares; i++)
+    {
+	DBFreePaintPlane(squares[i].bs_errors);
+	TiFreePlane(squares[i].bs_errors);
+    }
+    freeMagic((char *) squares);
+    return done;
+}
@@ -0,0 +1,873 @@
+/*
+ * DRCcache.c --
+ *
+ * Caches that let the design-rule checker avoid repeating work whose
+ * outcome is already known.
+ *
+ * Cells:  when every bit of a cell has been marked for checking (as
+ * "drc check" does), the cell is checked from scratch.  Once that is
+ * done, a signature of the cell's contents is kept along with one of
+ * the errors that were found.  The signature covers the paint of the
+ * cell, and the placement and signature of each of its subcells, so
+ * it changes whenever anything that the checker looks at changes.  If
+ * the whole cell is marked again later and neither signature has
+ * changed, the errors are known to be right already and the check
+ * tiles are simply erased.
+ *
+ * Interactions:  the subcell interaction check copies everything in
+ * an area of the hierarchy into DRCdef and runs the basic checker
+ * over the copy.  A design that places the same cells next to each
+ * other in the same way over and over produces the same copy over and
+ * over, up to a translation.  The errors found in each copy are kept,
+ * keyed by a signature of the copy, and replayed in place of the basic
+ * check when the same copy turns up again.
+ *
+ * Signatures are 128-bit hashes.  The signatures of cells are worked
+ * out when they are first needed and kept until something is changed,
+ * so a cell used in many places is only looked at once.
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "utils/magic.h"
+#include "utils/geometry.h"
+#include "tiles/tile.h"
+#include "utils/hash.h"
+#include "database/database.h"
+#include "windows/windows.h"
+#include "dbwind/dbwind.h"
+#include "drc/drc.h"
+#include "cif/cif.h"
+#include "cif/CIFint.h"
+#include "utils/signals.h"
+#include "utils/malloc.h"
+
+/* Largest number of interaction areas remembered at once.  When
+ * there are more, all of them are forgotten and the cache starts
+ * over.
+ */
+#define	DRC_CACHE_AREAS		4096
+
+/* What is known about the checking of one cell */
+
+typedef struct
+{
+    DRCHash	dcc_paint;	/* Signature of the cell when last checked */
+    DRCHash	dcc_errors;	/* Signature of the errors found then */
+    DRCHash	dcc_style;	/* Signature of the DRC style used */
+    bool	dcc_valid;	/* TRUE if the fields above are set */
+    bool	dcc_full;	/* TRUE if the whole cell is being checked */
+} DRCCellCache;
+
+/* Signature of a cell, as worked out by DRCCellSignature() */
+
+typedef struct
+{
+    DRCHash	dcs_hash;
+    bool	dcs_ok;		/* FALSE if no signature could be made */
+} DRCCellSig;
+
+/* An error found in an interaction area, relative to the area */
+
+typedef struct
+{
+    Rect	 dce_rect;
+    DRCCookie	*dce_cptr;
+} DRCCacheError;
+
+/* The errors found in one interaction area */
+
+typedef struct
+{
+    int		  dca_count;	/* Value returned by DRCBasicCheck() */
+    int		  dca_nErrors;	/* Number of entries in dca_errors */
+    DRCCacheError dca_errors[1];	/* Actually dca_nErrors long */
+} DRCCacheArea;
+
+/* Used to record the errors in an interaction area while checking it */
+
+typedef struct
+{
+    void	 (*dcr_func)();	/* Client's function, and its argument */
+    ClientData	  dcr_cdarg;
+    Point	  dcr_origin;	/* Lower-left corner of the area */
+    DRCCacheError *dcr_errors;
+    int		  dcr_nErrors;
+    int		  dcr_size;	/* Number of entries allocated */
+} DRCCacheRecording;
+
+/* Used to hash the paint of a plane */
+
+typedef struct
+{
+    DRCHash	*dhs_hash;
+    Rect	*dhs_clip;	/* Clip tiles to this area, or NULL */
+    Point	 dhs_origin;	/* Coordinates are taken relative to this */
+} DRCHashState;
+
+static HashTable drcCellTable;	/* CellDef -> DRCCellCache */
+static HashTable drcSigTable;	/* CellDef -> DRCCellSig */
+static HashTable drcAreaTable;	/* Signature -> DRCCacheArea */
+static HashTable drcWhyTable;	/* Why string -> DRCHash, while hashing rules */
+static bool drcCacheInit = FALSE;
+
+int DRCstatCacheCells = 0;	/* Number of cells found unchanged */
+int DRCstatCacheAreas = 0;	/* Number of interaction areas reused */
+
+extern int drcAlwaysOne();
+extern int DRCBasicCheck();
+extern bool DRCDisplayCheckTiles;
+extern TileTypeBitMask DRCLayers;
+extern int drcCifValid;
+extern DRCCookie *drcCifRules[MAXCIFLAYERS][2];
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcHashWord --
+ *
+ *	Mix one 64-bit value into a signature.  The two halves of the
+ *	signature are made with different functions (both from the
+ *	SplitMix64 generator), so that they are independent.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Updates *dh.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcHashWord(dh, w)
+    DRCHash *dh;
+    uint64_t w;
+{
+    uint64_t z;
+
+    z = dh->dh_a ^ w;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    dh->dh_a = z ^ (z >> 31);
+
+    z = dh->dh_b + (w + 0x9e3779b97f4a7c15ULL) * 0xd6e8feb86659fd93ULL;
+    z = (z ^ (z >> 32)) * 0xd6e8feb86659fd93ULL;
+    dh->dh_b = z ^ (z >> 32);
+}
+
+/* Mix two coordinates into a signature as one word */
+
+#define	drcHashPoint(dh, x, y) \
+    drcHashWord((dh), ((uint64_t) (unsigned) (x) << 32) | (unsigned) (y))
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcHashString --
+ *
+ *	Mix a string (which may be NULL) into a signature.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Updates *dh.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcHashString(dh, s)
+    DRCHash *dh;
+    char *s;
+{
+    uint64_t w;
+    int n;
+
+    if (s == NULL)
+    {
+	drcHashWord(dh, (uint64_t) 0);
+	return;
+    }
+    w = 1;
+    for (n = 1; *s != '\0'; s++, n++)
+    {
+	w = (w << 8) | (unsigned char) *s;
+	if ((n & 7) == 0)
+	{
+	    drcHashWord(dh, w);
+	    w = 1;
+	}
+    }
+    drcHashWord(dh, w);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcHashRules --
+ *
+ *	Mix a list of rules into a signature.  Only the mask words that
+ *	can hold a tile type are looked at.  The rules made from one line
+ *	of the technology file share a "why" string, so each string is
+ *	hashed once (in drcWhyTable, which the caller must set up) and its
+ *	hash is mixed in thereafter.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Updates *dh.  Adds to drcWhyTable.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcHashRules(dh, dp)
+    DRCHash *dh;
+    DRCCookie *dp;
+{
+    HashEntry *he;
+    DRCHash *wh;
+    int i, nWords = (DBNumTypes + TT_BPW - 1) / TT_BPW;
+
+    for (; dp != NULL; dp = dp->drcc_next)
+    {
+	drcHashPoint(dh, dp->drcc_dist, dp->drcc_cdist);
+	drcHashPoint(dh, (dp->drcc_mod << 16) | dp->drcc_cmod, dp->drcc_flags);
+	drcHashPoint(dh, dp->drcc_edgeplane, dp->drcc_plane);
+	for (i = 0; i < nWords; i++)
+	    drcHashPoint(dh, dp->drcc_mask.tt_words[i],
+			dp->drcc_corner.tt_words[i]);
+
+	he = HashFind(&drcWhyTable, (char *) dp->drcc_why);
+	wh = (DRCHash *) HashGetValue(he);
+	if (wh == NULL)
+	{
+	    wh = (DRCHash *) mallocMagic(sizeof (DRCHash));
+	    wh->dh_a = wh->dh_b = 0;
+	    drcHashString(wh, dp->drcc_why);
+	    HashSetValue(he, wh);
+	}
+	drcHashWord(dh, wh->dh_a);
+    }
+    drcHashWord(dh, (uint64_t) 0);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DRCStyleSignature --
+ *
+ *	Find the signature of the current DRC style:  its rules (including
+ *	those on CIF layers), the halo and step size, the paint table
+ *	used to flatten the hierarchy, and the distance metric.  Two styles with the same signature
+ *	find the same errors in everything.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Sets *dh.  The signature is kept in the style, until its rules are
+ *	compiled again.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+DRCStyleSignature(dh)
+    DRCHash *dh;
+{
+    DRCStyle *style = DRCCurStyle;
+    TileType i, j;
+    int p, n;
+
+    dh->dh_a = dh->dh_b = 0;
+    if (style == NULL) return;
+
+    /* Why strings are only known by their addresses for the length of
+     * one call, since the strings of an old style may have been freed.
+     */
+    HashInit(&drcWhyTable, 64, HT_WORDKEYS);
+
+    if (!style->DRCSigValid)
+    {
+	DRCHash *sh = &style->DRCSignature;
+
+	sh->dh_a = sh->dh_b = 0;
+	drcHashString(sh, style->ds_name);
+	drcHashPoint(sh, style->DRCTechHalo, style->DRCStepSize);
+	drcHashPoint(sh, style->DRCScaleFactorN, style->DRCScaleFactorD);
+	drcHashPoint(sh, DBNumTypes, DBNumPlanes);
+	for (n = 0; n < TT_MASKWORDS; n++)
+	    drcHashWord(sh, (uint64_t) style->DRCExactOverlapTypes.tt_words[n]);
+	for (i = 0; i < DBNumTypes; i++)
+	    for (j = 0; j < DBNumTypes; j++)
+		drcHashRules(sh, style->DRCRulesTbl[i][j]);
+	for (p = 0; p < DBNumPlanes; p++)
+	    for (i = 0; i < DBNumTypes; i++)
+		for (j = 0; j < DBNumTypes; j += 2)
+		    drcHashPoint(sh, style->DRCPaintTable[p][i][j],
+			    (j + 1 < DBNumTypes)
+			    ? style->DRCPaintTable[p][i][j + 1] : 0);
+	style->DRCSigValid = TRUE;
+    }
+    *dh = style->DRCSignature;
+    drcHashWord(dh, (uint64_t) DRCEuclidean);
+
+    /* The rules on CIF layers belong to the DRC style, but are kept
+     * apart from it, and the layers depend on the CIF output style.
+     */
+
+    if (drcCifValid)
+    {
+	drcHashString(dh, (CIFCurStyle == NULL) ? NULL : CIFCurStyle->cs_name);
+	for (n = 0; n < MAXCIFLAYERS; n++)
+	{
+	    drcHashRules(dh, drcCifRules[n][0]);
+	    drcHashRules(dh, drcCifRules[n][1]);
+	}
+    }
+    HashFreeKill(&drcWhyTable);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcHashTileFunc --
+ *
+ *	Called by DBSrPaintArea() for each tile of a plane being hashed.
+ *
+ * Results:
+ *	Always 0, to keep the search going.
+ *
+ * Side effects:
+ *	Mixes the type and area of the tile into the signature.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+drcHashTileFunc(tile, dhs)
+    Tile *tile;
+    DRCHashState *dhs;
+{
+    Rect r;
+
+    TiToRect(tile, &r);
+    if (dhs->dhs_clip != NULL) GeoClip(&r, dhs->dhs_clip);
+    drcHashWord(dhs->dhs_hash, (uint64_t) TiGetTypeExact(tile));
+    drcHashPoint(dhs->dhs_hash, r.r_xbot - dhs->dhs_origin.p_x,
+		r.r_ybot - dhs->dhs_origin.p_y);
+    drcHashPoint(dhs->dhs_hash, r.r_xtop - dhs->dhs_origin.p_x,
+		r.r_ytop - dhs->dhs_origin.p_y);
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcHashPlanes --
+ *
+ *	Mix the paint of planes pNum through pLast of a cell into a
+ *	signature.  Only the paint in area is looked at, and coordinates
+ *	are taken relative to the lower-left corner of the area.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Updates *dh.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcHashPlanes(dh, def, pNum, pLast, area)
+    DRCHash *dh;
+    CellDef *def;
+    int pNum, pLast;
+    Rect *area;
+{
+    DRCHashState dhs;
+
+    dhs.dhs_hash = dh;
+    dhs.dhs_clip = (area == &TiPlaneRect) ? (Rect *) NULL : area;
+    dhs.dhs_origin = (area == &TiPlaneRect) ? GeoOrigin : area->r_ll;
+    for (; pNum <= pLast; pNum++)
+    {
+	drcHashWord(dh, (uint64_t) pNum);
+	(void) DBSrPaintArea((Tile *) NULL, def->cd_planes[pNum], area,
+		&DBAllButSpaceBits, drcHashTileFunc, (ClientData) &dhs);
+    }
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DRCCellSignature --
+ *
+ *	Find the signature of everything in a cell that the design-rule
+ *	checker looks at:  the paint in the cell, and the transform,
+ *	array layout and signature of each subcell.  The uses are
+ *	combined so that their order doesn't matter.
+ *
+ *	Signatures are remembered until drcCacheFlushSigs() is called,
+ *	which must happen whenever anything in a cell changes.
+ *
+ * Results:
+ *	TRUE if a signature was made.  FALSE if some cell in the
+ *	hierarchy hasn't been read in yet.
+ *
+ * Side effects:
+ *	Sets *dh.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+DRCCellSignature(def, dh)
+    CellDef *def;
+    DRCHash *dh;
+{
+    HashEntry *he;
+    DRCCellSig *sig;
+    extern int drcSigUseFunc();
+
+    if (!drcCacheInit) drcCacheFlush();
+    he = HashFind(&drcSigTable, (char *) def);
+    sig = (DRCCellSig *) HashGetValue(he);
+    if (sig == NULL)
+    {
+	DRCHash uses;
+
+	sig = (DRCCellSig *) mallocMagic(sizeof (DRCCellSig));
+	sig->dcs_hash.dh_a = sig->dcs_hash.dh_b = 0;
+	sig->dcs_ok = (def->cd_flags & CDAVAILABLE) ? TRUE : FALSE;
+	if (sig->dcs_ok)
+	{
+	    drcHashWord(&sig->dcs_hash, (uint64_t) (def->cd_flags
+			& (CDVENDORGDS | CDNOEDIT | CDINTERNAL)));
+	    drcHashPlanes(&sig->dcs_hash, def, PL_TECHDEPBASE,
+			DBNumPlanes - 1, &TiPlaneRect);
+	    uses.dh_a = uses.dh_b = 0;
+	    if (DBCellEnum(def, drcSigUseFunc, (ClientData) &uses))
+		sig->dcs_ok = FALSE;
+	    drcHashWord(&sig->dcs_hash, uses.dh_a);
+	    drcHashWord(&sig->dcs_hash, uses.dh_b);
+	}
+	HashSetValue(he, sig);
+    }
+    *dh = sig->dcs_hash;
+    return sig->dcs_ok;
+}
+
+/*
+ * Called by DBCellEnum() for each use in a cell whose signature is
+ * being made.  The signature of each use is added into *uses.
+ * Returns 1 to stop the search if the child has no signature.
+ */
+
+int
+drcSigUseFunc(use, uses)
+    CellUse *use;
+    DRCHash *uses;
+{
+    DRCHash dh;
+    Transform *t = &use->cu_transform;
+
+    if (!DRCCellSignature(use->cu_def, &dh)) return 1;
+    drcHashPoint(&dh, t->t_a, t->t_b);
+    drcHashPoint(&dh, t->t_c, t->t_d);
+    drcHashPoint(&dh, t->t_e, t->t_f);
+    drcHashPoint(&dh, use->cu_xlo, use->cu_xhi);
+    drcHashPoint(&dh, use->cu_ylo, use->cu_yhi);
+    drcHashPoint(&dh, use->cu_xsep, use->cu_ysep);
+    uses->dh_a += dh.dh_a;
+    uses->dh_b += dh.dh_b;
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcCacheFlushSigs --
+ *
+ *	Forget the signatures of all cells.  Called whenever something
+ *	in some cell may have changed.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory free'd.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcCacheFlushSigs()
+{
+    if (!drcCacheInit)
+	drcCacheFlush();
+    else if (HashGetNumEntries(&drcSigTable) > 0)
+    {
+	HashFreeKill(&drcSigTable);
+	HashInit(&drcSigTable, 32, HT_WORDKEYS);
+    }
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcCacheFlush --
+ *
+ *	Forget everything in the caches.  Called when the rules change.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory free'd.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcCacheFlush()
+{
+    if (drcCacheInit)
+    {
+	HashFreeKill(&drcCellTable);
+	HashFreeKill(&drcSigTable);
+	HashFreeKill(&drcAreaTable);
+    }
+    HashInit(&drcCellTable, 32, HT_WORDKEYS);
+    HashInit(&drcSigTable, 32, HT_WORDKEYS);
+    HashInit(&drcAreaTable, 256, HashSize(sizeof (DRCHash)));
+    drcCacheInit = TRUE;
+    drcArrayFlush();
+    drcStoreFlush();
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcCacheForget --
+ *
+ *	Forget what is known about a cell, because it is being deleted.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory free'd.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcCacheForget(def)
+    CellDef *def;
+{
+    HashEntry *he;
+    DRCCellCache *dcc;
+
+    if (!drcCacheInit) return;
+    he = HashLookOnly(&drcCellTable, (char *) def);
+    if (he != NULL && (dcc = (DRCCellCache *) HashGetValue(he)) != NULL)
+	dcc->dcc_valid = dcc->dcc_full = FALSE;
+    drcCacheFlushSigs();
+    drcStoreForget(def);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcCacheSkip --
+ *
+ *	Called before the check tiles of a cell are processed.  If all
+ *	of the cell is to be checked, and it hasn't changed since it was
+ *	last checked all over, the errors already in the cell are what
+ *	checking it would find, so the checks aren't made.
+ *
+ * Results:
+ *	TRUE if the cell was skipped.
+ *
+ * Side effects:
+ *	If the cell is skipped, its check tiles are erased.  Otherwise,
+ *	if all of the cell is to be checked, the signatures of the cell
+ *	are noted by drcCacheRecord() when the checks are done.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+drcCacheSkip(def)
+    CellDef *def;
+{
+    HashEntry *he;
+    DRCCellCache *dcc;
+    DRCHash paint, errors, style;
+
+    if (DRCCurStyle == NULL) return FALSE;
+    if (DBSrPaintArea((Tile *) NULL, def->cd_planes[PL_DRC_CHECK],
+		&def->cd_bbox, &DBSpaceBits, drcAlwaysOne, (ClientData) NULL))
+	return FALSE;
+    if (!drcCacheInit) drcCacheFlush();
+
+    he = HashFind(&drcCellTable, (char *) def);
+    dcc = (DRCCellCache *) HashGetValue(he);
+    if (dcc == NULL)
+    {
+	dcc = (DRCCellCache *) mallocMagic(sizeof (DRCCellCache));
+	dcc->dcc_valid = dcc->dcc_full = FALSE;
+	HashSetValue(he, dcc);
+    }
+
+    /* Nothing is known about the cell yet, but the results of checking
+     * it may have been saved along with it (see DRCstore.c).  They can
+     * only be compared with the cell once its subcells are read in.
+     */
+    if (!dcc->dcc_valid && DRCStoreFiles) drcStoreLoad(def);
+    if (!DRCCellSignature(def, &paint)) return FALSE;
+
+    DRCStyleSignature(&style);
+    if (!dcc->dcc_valid && DRCStoreFiles && drcStoreRead(def, &paint, &style))
+    {
+	dcc->dcc_paint = paint;
+	dcc->dcc_style = style;
+	dcc->dcc_errors.dh_a = dcc->dcc_errors.dh_b = 0;
+	drcHashPlanes(&dcc->dcc_errors, def, PL_DRC_ERROR, PL_DRC_ERROR,
+		&TiPlaneRect);
+	dcc->dcc_valid = TRUE;
+    }
+
+    if (dcc->dcc_valid && DRC_HASH_EQUAL(&dcc->dcc_paint, &paint)
+		&& DRC_HASH_EQUAL(&dcc->dcc_style, &style))
+    {
+	errors.dh_a = errors.dh_b = 0;
+	drcHashPlanes(&errors, def, PL_DRC_ERROR, PL_DRC_ERROR, &TiPlaneRect);
+	if (DRC_HASH_EQUAL(&dcc->dcc_errors, &errors))
+	{
+	    SigDisableInterrupts();
+	    DBClearPaintPlane(def->cd_planes[PL_DRC_CHECK]);
+	    if (DRCDisplayCheckTiles)
+		DBWAreaChanged(def, &def->cd_bbox, DBW_ALLWINDOWS, &DRCLayers);
+	    DBCellSetModified(def, TRUE);
+	    SigEnableInterrupts();
+	    dcc->dcc_full = FALSE;
+	    DRCstatCacheCells++;
+	    return TRUE;
+	}
+    }
+    dcc->dcc_full = TRUE;
+    return FALSE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcCacheRecord --
+ *
+ *	Called when all of the check tiles of a cell have been processed.
+ *	If the checks covered all of the cell, note the signatures of the
+ *	cell and of the errors found, for drcCacheSkip().
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Updates the cache entry for the cell.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcCacheRecord(def)
+    CellDef *def;
+{
+    HashEntry *he;
+    DRCCellCache *dcc;
+
+    if (!drcCacheInit || DRCCurStyle == NULL) return;
+    he = HashLookOnly(&drcCellTable, (char *) def);
+    if (he == NULL) return;
+    dcc = (DRCCellCache *) HashGetValue(he);
+    if (dcc == NULL || !dcc->dcc_full) return;
+
+    dcc->dcc_full = FALSE;
+    dcc->dcc_valid = DRCCellSignature(def, &dcc->dcc_paint);
+    DRCStyleSignature(&dcc->dcc_style);
+    dcc->dcc_errors.dh_a = dcc->dcc_errors.dh_b = 0;
+    drcHashPlanes(&dcc->dcc_errors, def, PL_DRC_ERROR, PL_DRC_ERROR,
+		&TiPlaneRect);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcCacheRecordError --
+ *
+ *	Called by DRCBasicCheck() for each error found in an interaction
+ *	area that is being recorded.  Saves the error, then passes it on
+ *	to the client's function.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Whatever the client's function does.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcCacheRecordError(def, rect, cptr, dcr)
+    CellDef *def;
+    Rect *rect;
+    DRCCookie *cptr;
+    DRCCacheRecording *dcr;
+{
+    DRCCacheError *dce;
+
+    if (dcr->dcr_nErrors == dcr->dcr_size)
+    {
+	DRCCacheError *newErrors;
+
+	dcr->dcr_size = (dcr->dcr_size == 0) ? 16 : 2 * dcr->dcr_size;
+	newErrors = (DRCCacheError *) mallocMagic((unsigned) (dcr->dcr_size
+		* sizeof (DRCCacheError)));
+	if (dcr->dcr_nErrors > 0)
+	{
+	    memcpy(newErrors, dcr->dcr_errors, dcr->dcr_nErrors
+			* sizeof (DRCCacheError));
+	    freeMagic((char *) dcr->dcr_errors);
+	}
+	dcr->dcr_errors = newErrors;
+    }
+    dce = &dcr->dcr_errors[dcr->dcr_nErrors++];
+    dce->dce_cptr = cptr;
+    dce->dce_rect = *rect;
+    dce->dce_rect.r_xbot -= dcr->dcr_origin.p_x;
+    dce->dce_rect.r_xtop -= dcr->dcr_origin.p_x;
+    dce->dce_rect.r_ybot -= dcr->dcr_origin.p_y;
+    dce->dce_rect.r_ytop -= dcr->dcr_origin.p_y;
+
+    (*dcr->dcr_func)(def, rect, cptr, dcr->dcr_cdarg);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcCachedCheck --
+ *
+ *	Run the basic checker over an interaction area that has just been
+ *	copied into DRCdef, as DRCBasicCheck(DRCdef, ...) would, but look
+ *	first for the same copy among those checked before.  If it is
+ *	found, the errors found in it then are passed to func again,
+ *	moved to where the area is now.
+ *
+ *	The cache isn't used while the batch checker is running (it puts
+ *	off the basic checks), or when there are rules on CIF layers,
+ *	which are generated on a grid that doesn't move with the area.
+ *
+ * Results:
+ *	The value DRCBasicCheck() returns.
+ *
+ * Side effects:
+ *	Calls func for each error, as DRCBasicCheck() does.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+drcCachedCheck(checkRect, clipRect, func, cdarg)
+    Rect *checkRect;	/* Area copied into DRCdef */
+    Rect *clipRect;	/* Clip errors to this area */
+    void (*func)();	/* Function to call for each error */
+    ClientData cdarg;	/* Passed to func */
+{
+    DRCHash key;
+    DRCCacheRecording dcr;
+    DRCCacheArea *dca;
+    DRCCacheError *dce;
+    HashEntry *he;
+    Point *origin = &checkRect->r_ll;
+    Rect r;
+    int count, n;
+
+    if (drcBatchActive || drcCifValid || DRCCurStyle == NULL)
+	return DRCBasicCheck(DRCdef, checkRect, clipRect, func, cdarg);
+    if (!drcCacheInit) drcCacheFlush();
+
+    DRCStyleSignature(&key);
+    drcHashPoint(&key, checkRect->r_xtop - origin->p_x,
+		checkRect->r_ytop - origin->p_y);
+    drcHashPoint(&key, clipRect->r_xbot - origin->p_x,
+		clipRect->r_ybot - origin->p_y);
+    drcHashPoint(&key, clipRect->r_xtop - origin->p_x,
+		clipRect->r_ytop - origin->p_y);
+    drcHashPlanes(&key, DRCdef, PL_TECHDEPBASE, DBNumPlanes - 1, checkRect);
+
+    he = HashLookOnly(&drcAreaTable, (char *) &key);
+    if (he != NULL)
+    {
+	dca = (DRCCacheArea *) HashGetValue(he);
+	DRCstatCacheAreas++;
+	for (n = 0, dce = dca->dca_errors; n < dca->dca_nErrors; n++, dce++)
+	{
+	    r = dce->dce_rect;
+	    r.r_xbot += origin->p_x;
+	    r.r_xtop += origin->p_x;
+	    r.r_ybot += origin->p_y;
+	    r.r_ytop += origin->p_y;
+	    (*func)(DRCdef, &r, dce->dce_cptr, cdarg);
+	}
+	return dca->dca_count;
+    }
+
+    dcr.dcr_func = func;
+    dcr.dcr_cdarg = cdarg;
+    dcr.dcr_origin = *origin;
+    dcr.dcr_errors = NULL;
+    dcr.dcr_nErrors = dcr.dcr_size = 0;
+    count = DRCBasicCheck(DRCdef, checkRect, clipRect, drcCacheRecordError,
+		(ClientData) &dcr);
+
+    /* An interrupted check may have missed errors */
+
+    if (!SigInterruptPending)
+    {
+	if (HashGetNumEntries(&drcAreaTable) >= DRC_CACHE_AREAS)
+	{
+	    HashFreeKill(&drcAreaTable);
+	    HashInit(&drcAreaTable, 256, HashSize(sizeof (DRCHash)));
+	}
+	he = HashFind(&drcAreaTable, (char *) &key);
+	dca = (DRCCacheArea *) mallocMagic((unsigned) (sizeof (DRCCacheArea)
+		+ MAX(dcr.dcr_nErrors - 1, 0) * sizeof (DRCCacheError)));
+	dca->dca_count = count;
+	dca->dca_nErrors = dcr.dcr_nErrors;
+	if (dcr.dcr_nErrors > 0)
+	    memcpy(dca->dca_errors, dcr.dcr_errors, dcr.dcr_nErrors
+			* sizeof (DRCCacheError));
+	HashSetValue(he, dca);
+    }
+    if (dcr.dcr_errors != NULL) freeMagic((char *) dcr.dcr_errors);
+    return count;
+}
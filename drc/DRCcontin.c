@@ -202,6 +202,12 @@ DRCCheckThis (celldef, operation, area)
 
     if (celldef->cd_flags & (CDVENDORGDS | CDNOEDIT | CDINTERNAL)) return;
 
+    /* Something changed, so the signatures of cells are out of date,	*/
+    /* and the errors of this one are no longer final.			*/
+
+    drcCacheFlushSigs();
+    drcStoreForget(celldef);
+
     /* Insert celldef into list of Defs waiting to be checked, unless	*/
     /* it is already there.						*/
 
@@ -292,6 +298,8 @@ DRCRemovePending(def)
 {
     DRCPendingCookie *p, *plast;
 
+    drcCacheForget(def);
+
     p = DRCPendingRoot;
     plast = NULL;
 
@@ -452,6 +460,7 @@ DRCContinuous()
 #ifndef MAGIC_WRAPPER
     Rect drc_orig_bbox;			/* Area of DRC def that changed. */
 #endif
+    CellDef *def;			/* Cell at the front of the list. */
 
     if (DRCHasWork == FALSE)
     {
@@ -472,14 +481,23 @@ DRCContinuous()
 
     UndoDisable();			/* Don't want to undo error info. */
     drc_orig_bbox = DRCdef->cd_bbox;
+    drcCacheFlushSigs();
 
     while (DRCPendingRoot != (DRCPendingCookie *) NULL)
     {
+	/* A cell that is to be checked all over needn't be, if it
+	 * hasn't changed since the last time.
+	 */
+
+	def = DRCPendingRoot->dpc_def;
+	(void) drcCacheSkip(def);
+
 				/*  DBSrPaintArea() returns 1 if drcCheckTile()
 				 *  returns 1, meaning that a CHECK tile
 				 *  was found and processed.
 				 */
 	while ((DRCPendingRoot != (DRCPendingCookie *)NULL) &&
+	    (DRCPendingRoot->dpc_def == def) &&
 	    DBSrPaintArea ((Tile *) NULL,
 	    DRCPendingRoot->dpc_def->cd_planes[PL_DRC_CHECK],
 	    &TiPlaneRect, &DBAllButSpaceBits, drcCheckTile, (ClientData) NULL))
@@ -511,9 +529,18 @@ DRCContinuous()
 #endif
 	}
 
+	/* A cell read in while checking this one, or changed by a	*/
+	/* command, has been put in front of it.  Start over with that	*/
+	/* one, so that it gets the same chance to be skipped.		*/
+
+	if ((DRCPendingRoot != (DRCPendingCookie *)NULL) &&
+		(DRCPendingRoot->dpc_def != def))
+	    continue;
+
 	/* No check tiles were found, so knock this cell off the list. */
 
 	if (DRCPendingRoot != (DRCPendingCookie *)NULL) {
+	    drcCacheRecord(DRCPendingRoot->dpc_def);
 	    DBReComputeBbox(DRCPendingRoot->dpc_def);
 	    freeMagic((char *) DRCPendingRoot);
 	    DRCPendingRoot = DRCPendingRoot->dpc_next;
@@ -617,9 +644,6 @@ drcCheckTile(tile, arg)
 				 */
     Rect checkbox;
     CellDef * celldef;		/* First CellDef on DRCPending list. */
-    Rect redisplayArea;		/* Area to be redisplayed. */
-    extern int drcXorFunc();	/* Forward declarations. */
-    extern int drcPutBackFunc();
 
     celldef = DRCPendingRoot->dpc_def;
     DRCErrorDef = celldef;
@@ -651,14 +675,6 @@ drcCheckTile(tile, arg)
     GEO_EXPAND(&erasebox, DRCTechHalo, &checkbox);
     GeoClip(&checkbox, &square);
 
-    /* Use drcDisplayPlane to save all the current errors in the
-     * area we're about to recheck.
-     */
-
-    DBClearPaintPlane(drcDisplayPlane);
-    (void) DBSrPaintArea((Tile *) NULL, celldef->cd_planes[PL_DRC_ERROR],
-	&square, &DBAllButSpaceBits, drcXorFunc, (ClientData) NULL);
-    
     /* Check #1:  recheck the paint of the cell, ignoring subcells. */
 
     DRCErrorType = TT_ERROR_P;
@@ -697,6 +713,50 @@ drcCheckTile(tile, arg)
 
     if (SigInterruptPending) return 1;
 
+    drcSquareDone(celldef, DBStdEraseTbl(TiGetType(tile), PL_DRC_CHECK),
+		&square, &erasebox, &checkbox, drcTempPlane);
+
+    return (1);		/* stop the area search: we modified the database! */
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ * drcSquareDone --
+ *
+ *	Record the results of rechecking one square of the checkerboard
+ *	(see drcCheckTile() above):  erase the check tiles and the old
+ *	error tiles there, and paint in the errors just found.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Modifies both DRC planes of celldef, and redisplays the error
+ *	tiles that changed.
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcSquareDone(celldef, checkErase, square, erasebox, checkbox, errors)
+    CellDef *celldef;		/* Cell that was checked */
+    PaintResultType *checkErase; /* Erase table for the check tiles */
+    Rect *square;		/* Square of the checkerboard */
+    Rect *erasebox;		/* Check tiles are erased in this area */
+    Rect *checkbox;		/* Old errors are erased in this area */
+    Plane *errors;		/* New error tiles */
+{
+    Rect redisplayArea;		/* Area to be redisplayed. */
+    extern int drcXorFunc();	/* Forward declarations. */
+    extern int drcPutBackFunc();
+
+    /* Use drcDisplayPlane to save all the current errors in the
+     * area that was rechecked.
+     */
+
+    DBClearPaintPlane(drcDisplayPlane);
+    (void) DBSrPaintArea((Tile *) NULL, celldef->cd_planes[PL_DRC_ERROR],
+	square, &DBAllButSpaceBits, drcXorFunc, (ClientData) NULL);
+
     /* Erase the check tile from the check plane, erase the pre-existing
      * error tiles, and paint back in the new error tiles.  Do this all
      * with interrupts disabled to be sure that it won't be aborted.
@@ -704,16 +764,15 @@ drcCheckTile(tile, arg)
 
     SigDisableInterrupts();
 
-    DBPaintPlane(celldef->cd_planes[PL_DRC_CHECK], &erasebox,
-	DBStdEraseTbl(TiGetType(tile), PL_DRC_CHECK),
+    DBPaintPlane(celldef->cd_planes[PL_DRC_CHECK], erasebox, checkErase,
 	(PaintUndoInfo *) NULL);
-    DBPaintPlane(celldef->cd_planes[PL_DRC_ERROR], &checkbox,
+    DBPaintPlane(celldef->cd_planes[PL_DRC_ERROR], checkbox,
 	DBStdEraseTbl(TT_ERROR_P, PL_DRC_ERROR),
 	(PaintUndoInfo *) NULL);
-    DBPaintPlane(celldef->cd_planes[PL_DRC_ERROR], &checkbox,
+    DBPaintPlane(celldef->cd_planes[PL_DRC_ERROR], checkbox,
 	DBStdEraseTbl(TT_ERROR_S, PL_DRC_ERROR),
 	(PaintUndoInfo *) NULL);
-    (void) DBSrPaintArea((Tile *) NULL, drcTempPlane, &TiPlaneRect,
+    (void) DBSrPaintArea((Tile *) NULL, errors, &TiPlaneRect,
 	&DBAllButSpaceBits, drcPutBackFunc, (ClientData) celldef);
 
     /* XOR the new errors in the tile with the old errors we
@@ -723,20 +782,18 @@ drcCheckTile(tile, arg)
      */
     
     (void) DBSrPaintArea((Tile *) NULL, celldef->cd_planes[PL_DRC_ERROR],
-	&square, &DBAllButSpaceBits, drcXorFunc, (ClientData) NULL);
+	square, &DBAllButSpaceBits, drcXorFunc, (ClientData) NULL);
     if (DBBoundPlane(drcDisplayPlane, &redisplayArea))
     {
-	GeoClip(&redisplayArea, &square);
+	GeoClip(&redisplayArea, square);
 	if (!GEO_RECTNULL(&redisplayArea))
 	    DBWAreaChanged (celldef, &redisplayArea, DBW_ALLWINDOWS,
 		&DRCLayers);
     }
     if (DRCDisplayCheckTiles)
-	DBWAreaChanged(celldef, &square, DBW_ALLWINDOWS, &DRCLayers);
+	DBWAreaChanged(celldef, square, DBW_ALLWINDOWS, &DRCLayers);
     DBCellSetModified (celldef, TRUE);
     SigEnableInterrupts();
-
-    return (1);		/* stop the area search: we modified the database! */
 }
 
 /* The utility function below gets called for each error tile in a
@@ -21,11 +21,12 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "utils/stack.h"
 #include "utils/maxrect.h"
 
-Stack *DRCstack = (Stack *)NULL;
+/* Stack used for the searches over regions, one per thread */
+DRC_LOCAL Stack *DRCstack = (Stack *)NULL;
 
 #define PUSHTILE(tp) \
-    if ((tp)->ti_client == (ClientData) DRC_UNPROCESSED) { \
-        (tp)->ti_client = (ClientData)  DRC_PENDING; \
+    if (TiGetClient((tp)) == (ClientData) DRC_UNPROCESSED) { \
+        TiSetClient((tp), (ClientData)  DRC_PENDING); \
         STACKPUSH((ClientData) (tp), DRCstack); \
     }
 
@@ -108,9 +109,9 @@ drcCheckArea(starttile,arg,cptr)
     while (!StackEmpty(DRCstack))
     {
 	tile = (Tile *) STACKPOP(DRCstack);
-	if (tile->ti_client != (ClientData)DRC_PENDING) continue;
+	if (TiGetClient(tile) != (ClientData)DRC_PENDING) continue;
 	area += (long)(RIGHT(tile)-LEFT(tile))*(TOP(tile)-BOTTOM(tile));
-	tile->ti_client = (ClientData)DRC_PROCESSED;
+	TiSetClient(tile, (ClientData)DRC_PROCESSED);
 	/* are we at the clip boundary? If so, skip to the end */
 	if (RIGHT(tile) == cliprect->r_xtop ||
 	    LEFT(tile) == cliprect->r_xbot ||
@@ -156,7 +157,7 @@ forgetit:
      while (!StackEmpty(DRCstack)) tile = (Tile *) STACKPOP(DRCstack);
 
      /* reset the tiles */
-     starttile->ti_client = (ClientData)DRC_UNPROCESSED;
+     TiSetClient(starttile, (ClientData)DRC_UNPROCESSED);
      STACKPUSH(starttile, DRCstack);
      while (!StackEmpty(DRCstack))
      {
@@ -164,33 +165,33 @@ forgetit:
 
 	/* Top */
 	for (tp = RT(tile); RIGHT(tp) > LEFT(tile); tp = BL(tp))
-	    if (tp->ti_client != (ClientData)DRC_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)DRC_UNPROCESSED)
 	    {
-	    	 tp->ti_client = (ClientData)DRC_UNPROCESSED;
+	    	 TiSetClient(tp, (ClientData)DRC_UNPROCESSED);
 		 STACKPUSH(tp,DRCstack);
 	    }
 
 	/* Left */
 	for (tp = BL(tile); BOTTOM(tp) < TOP(tile); tp = RT(tp))
-	    if (tp->ti_client != (ClientData)DRC_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)DRC_UNPROCESSED)
 	    {
-	    	 tp->ti_client = (ClientData)DRC_UNPROCESSED;
+	    	 TiSetClient(tp, (ClientData)DRC_UNPROCESSED);
 		 STACKPUSH(tp,DRCstack);
 	    }
 
 	/* Bottom */
 	for (tp = LB(tile); LEFT(tp) < RIGHT(tile); tp = TR(tp))
-	    if (tp->ti_client != (ClientData)DRC_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)DRC_UNPROCESSED)
 	    {
-	    	 tp->ti_client = (ClientData)DRC_UNPROCESSED;
+	    	 TiSetClient(tp, (ClientData)DRC_UNPROCESSED);
 		 STACKPUSH(tp,DRCstack);
 	    }
 
 	/* Right */
 	for (tp = TR(tile); TOP(tp) > BOTTOM(tile); tp = LB(tp))
-	    if (tp->ti_client != (ClientData)DRC_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)DRC_UNPROCESSED)
 	    {
-	    	 tp->ti_client = (ClientData)DRC_UNPROCESSED;
+	    	 TiSetClient(tp, (ClientData)DRC_UNPROCESSED);
 		 STACKPUSH(tp,DRCstack);
 	    }
 
@@ -242,8 +243,8 @@ drcCheckMaxwidth(starttile,arg,cptr)
     while (!StackEmpty(DRCstack))
     {
 	tile = (Tile *) STACKPOP(DRCstack);
-	if (tile->ti_client != (ClientData)DRC_PENDING) continue;
-	tile->ti_client = (ClientData)DRC_PROCESSED;
+	if (TiGetClient(tile) != (ClientData)DRC_PENDING) continue;
+	TiSetClient(tile, (ClientData)DRC_PROCESSED);
 	
 	if (boundrect.r_xbot > LEFT(tile)) boundrect.r_xbot = LEFT(tile);
 	if (boundrect.r_xtop < RIGHT(tile)) boundrect.r_xtop = RIGHT(tile);
@@ -290,7 +291,7 @@ drcCheckMaxwidth(starttile,arg,cptr)
     }
 
     /* reset the tiles */
-    starttile->ti_client = (ClientData)DRC_UNPROCESSED;
+    TiSetClient(starttile, (ClientData)DRC_UNPROCESSED);
     STACKPUSH(starttile, DRCstack);
     while (!StackEmpty(DRCstack))
     {
@@ -298,33 +299,33 @@ drcCheckMaxwidth(starttile,arg,cptr)
 
 	/* Top */
 	for (tp = RT(tile); RIGHT(tp) > LEFT(tile); tp = BL(tp))
-	    if (tp->ti_client != (ClientData)DRC_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)DRC_UNPROCESSED)
 	    {
-	    	 tp->ti_client = (ClientData)DRC_UNPROCESSED;
+	    	 TiSetClient(tp, (ClientData)DRC_UNPROCESSED);
 		 STACKPUSH(tp,DRCstack);
 	    }
 
 	/* Left */
 	for (tp = BL(tile); BOTTOM(tp) < TOP(tile); tp = RT(tp))
-	    if (tp->ti_client != (ClientData)DRC_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)DRC_UNPROCESSED)
 	    {
-	    	 tp->ti_client = (ClientData)DRC_UNPROCESSED;
+	    	 TiSetClient(tp, (ClientData)DRC_UNPROCESSED);
 		 STACKPUSH(tp,DRCstack);
 	    }
 
 	/* Bottom */
 	for (tp = LB(tile); LEFT(tp) < RIGHT(tile); tp = TR(tp))
-	    if (tp->ti_client != (ClientData)DRC_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)DRC_UNPROCESSED)
 	    {
-	    	 tp->ti_client = (ClientData)DRC_UNPROCESSED;
+	    	 TiSetClient(tp, (ClientData)DRC_UNPROCESSED);
 		 STACKPUSH(tp,DRCstack);
 	    }
 
 	/* Right */
 	for (tp = TR(tile); TOP(tp) > BOTTOM(tile); tp = LB(tp))
-	    if (tp->ti_client != (ClientData)DRC_UNPROCESSED)
+	    if (TiGetClient(tp) != (ClientData)DRC_UNPROCESSED)
 	    {
-	    	 tp->ti_client = (ClientData)DRC_UNPROCESSED;
+	    	 TiSetClient(tp, (ClientData)DRC_UNPROCESSED);
 		 STACKPUSH(tp,DRCstack);
 	    }
 
@@ -447,7 +448,7 @@ drcCanonicalMaxwidth(starttile, dir, arg, cptr)
     int		    s, edgelimit;
     Tile	    *tile,*tp;
     TileTypeBitMask wrongtypes;
-    static MaxRectsData *mrd = (MaxRectsData *)NULL;
+    static DRC_LOCAL MaxRectsData *mrd = (MaxRectsData *)NULL;
     Rect	    *boundrect, boundorig;
 
     /* Generate an initial array size of 8 for rlist and swap. */
@@ -75,22 +75,24 @@ HashTable DRCErrorTable;	/* Hash table used to eliminate duplicate
 /* Global variables used by all DRC modules to record statistics.
  * For each statistic we keep two values, the count since stats
  * were last printed (in DRCstatXXX), and the total count (in
- * drcTotalXXX).
+ * drcTotalXXX).  The counts made by the basic checker itself are
+ * kept per thread (DRC_LOCAL);  the batch checker adds in those of
+ * its threads when it merges their results.
  */
 
 int DRCstatSquares = 0;		/* Number of DRCStepSize-by-DRCStepSize
 				 * squares processed by continuous checker.
 				 */
-int DRCstatTiles = 0;		/* Number of tiles processed by basic
+DRC_LOCAL int DRCstatTiles = 0;		/* Number of tiles processed by basic
 				 * checker.
 				 */
-int DRCstatEdges = 0;		/* Number of "atomic" edges processed
+DRC_LOCAL int DRCstatEdges = 0;		/* Number of "atomic" edges processed
 				 * by basic checker.
 				 */
-int DRCstatRules = 0;		/* Number of rules processed by basic checker
+DRC_LOCAL int DRCstatRules = 0;		/* Number of rules processed by basic checker
 				 * (rule = one constraint for one edge).
 				 */
-int DRCstatSlow = 0;		/* Number of places where constraint doesn't
+DRC_LOCAL int DRCstatSlow = 0;		/* Number of places where constraint doesn't
 				 * all fall in a single tile.
 				 */
 int DRCstatInteractions = 0;	/* Number of times drcInt is called to check
@@ -119,6 +121,8 @@ static int drcTotalSlow = 0;
 static int drcTotalInteractions = 0;
 static int drcTotalIntTiles = 0;
 static int drcTotalArrayTiles = 0;
+static int drcTotalCacheCells = 0;
+static int drcTotalCacheAreas = 0;
 
 #ifdef	DRCRULESHISTO
 static int drcTotalVRulesHisto[DRC_MAXRULESHISTO];
@@ -338,6 +342,14 @@ DRCPrintStats()
     TxPrintf("    Tiles processed for arrays: %d/%d\n",
 	DRCstatArrayTiles, drcTotalArrayTiles);
     DRCstatArrayTiles = 0;
+    drcTotalCacheCells += DRCstatCacheCells;
+    TxPrintf("    Unchanged cells skipped: %d/%d\n",
+	DRCstatCacheCells, drcTotalCacheCells);
+    DRCstatCacheCells = 0;
+    drcTotalCacheAreas += DRCstatCacheAreas;
+    TxPrintf("    Interaction areas reused: %d/%d\n",
+	DRCstatCacheAreas, drcTotalCacheAreas);
+    DRCstatCacheAreas = 0;
 
 #ifdef	DRCRULESHISTO
     TxPrintf("    Number of rules applied per edge:\n");
@@ -528,17 +540,22 @@ drcWhyFunc(scx, cdarg)
     CellDef *def = scx->scx_use->cu_def;
     bool dolist = (bool)((pointertype)cdarg);
 
-    /* Check paint and interactions in this subcell. */
+    /* Check paint and interactions in this subcell, unless its	*/
+    /* errors are already known.					*/
     
 //  (void) DRCBasicCheck(def, &haloArea, &scx->scx_area,
 //		(dolist) ? drcListError : drcPrintError,
 //		(ClientData) scx);
-    (void) DRCInteractionCheck(def, &scx->scx_area, &scx->scx_area,
+    if (!DRCStoreWhy(def, &scx->scx_area,
+		(dolist) ? drcListError : drcPrintError, (ClientData) scx))
+    {
+	(void) DRCInteractionCheck(def, &scx->scx_area, &scx->scx_area,
 		(dolist) ? drcListError : drcPrintError,
 		(ClientData) scx);
-    (void) DRCArrayCheck(def, &scx->scx_area,
+	(void) DRCArrayCheck(def, &scx->scx_area,
 		(dolist) ? drcListError : drcPrintError,
 		(ClientData) scx);
+    }
     
     /* Also search children. */
 
@@ -556,12 +573,16 @@ drcWhyAllFunc(scx, cdarg)
 {
     CellDef *def = scx->scx_use->cu_def;
 
-    /* Check paint and interactions in this subcell. */
+    /* Check paint and interactions in this subcell, unless its	*/
+    /* errors are already known.					*/
     
-    (void) DRCInteractionCheck(def, &scx->scx_area, &scx->scx_area,
+    if (!DRCStoreWhy(def, &scx->scx_area, drcListallError, (ClientData)scx))
+    {
+	(void) DRCInteractionCheck(def, &scx->scx_area, &scx->scx_area,
 		drcListallError, (ClientData)scx);
-    (void) DRCArrayCheck(def, &scx->scx_area, &scx->scx_area,
+	(void) DRCArrayCheck(def, &scx->scx_area,
 		drcListallError, (ClientData)scx);
+    }
     
     /* Also search children. */
 
@@ -738,11 +759,17 @@ drcCountFunc(scx, dupTable)
     if (HashGetValue(h) != 0) goto done;
     HashSetValue(h, 1);
 
-    /* Count errors in this cell definition by scanning the error plane. */
+    /* Count errors in this cell definition by scanning the error plane, */
+    /* unless they have been counted already.				 */
 
-    count = 0;
-    (void) DBSrPaintArea((Tile *) NULL, def->cd_planes[PL_DRC_ERROR],
-	&def->cd_bbox, &DBAllButSpaceBits, drcCountFunc2, (ClientData) &count);
+    count = DRCStoreCount(def);
+    if (count < 0)
+    {
+	count = 0;
+	(void) DBSrPaintArea((Tile *) NULL, def->cd_planes[PL_DRC_ERROR],
+		&def->cd_bbox, &DBAllButSpaceBits, drcCountFunc2,
+		(ClientData) &count);
+    }
     HashSetValue(h, (spointertype)count + 1);
 
     /* Ignore children that have not been loaded---we will only report	*/
@@ -781,6 +808,9 @@ drcCountFunc2(tile, pCount)
  *
  * 	This procedure just runs the background checker, regardless
  *	of whether it's enabled or not, and waits for it to complete.
+ *	As nothing else can happen in the meantime, the squares to be
+ *	checked are first handed to the batch checker (DRCbatch.c),
+ *	which checks them in parallel.
  *
  * Results:
  *	None.
@@ -798,6 +828,7 @@ DRCCatchUp()
 
     background = DRCBackGround;
     DRCBackGround = DRC_SET_ON;
+    (void) DRCBatchCheck();
     DRCContinuous();
     DRCBackGround = background;
 }
@@ -884,6 +915,7 @@ drcFindFunc(scx, finddata)
 {
     CellDef *def;
     HashEntry *h;
+    int n;
     int drcFindFunc2();
 
     def = scx->scx_use->cu_def;
@@ -893,7 +925,24 @@ drcFindFunc(scx, finddata)
 
     (void) DBCellRead(def, (char *) NULL, TRUE, NULL);
 
-    if (DBSrPaintArea((Tile *) NULL, def->cd_planes[PL_DRC_ERROR],
+    /* If the error tiles of the cell have been listed, go straight	*/
+    /* to the one wanted, or past all of them.				*/
+
+    n = DRCStoreCount(def);
+    if (n >= 0)
+    {
+	if (finddata->target > finddata->current
+		&& finddata->target <= finddata->current + n)
+	{
+	    (void) DRCStoreTile(def, finddata->target - finddata->current - 1,
+			finddata->rect);
+	    finddata->current = finddata->target;
+	    finddata->trans = scx->scx_trans;
+	    return 1;
+	}
+	finddata->current += n;
+    }
+    else if (DBSrPaintArea((Tile *) NULL, def->cd_planes[PL_DRC_ERROR],
 	    &def->cd_bbox, &DBAllButSpaceBits, drcFindFunc2,
 	    (ClientData)finddata) != 0)
     {
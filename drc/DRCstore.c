@@ -0,0 +1,1162 @@
+/*
+ * DRCstore.c --
+ *
+ * The results of checking each cell, kept so that questions about its
+ * errors can be answered without walking the error plane or running
+ * the checks again, and saved next to the cell's file so that a cell
+ * that was checked before doesn't have to be checked again.
+ *
+ * Once a cell has no check tiles left, its error plane stays as it is
+ * until something marks the cell for checking again, which always goes
+ * through DRCCheckThis().  While that is so, the error tiles of the cell
+ * are listed the first time they are counted or looked for.  The errors
+ * themselves, each with the rule that it breaks and the reason given for
+ * that, are found one DRC square at a time, the first time the errors
+ * in the square are asked for, by checking the square again if it holds
+ * any error tiles.  All of this is thrown away by DRCCheckThis(), when
+ * the cell is deleted, and when the rules change.
+ *
+ * When DRCStoreFiles is set ("drc store on"), DBCellWrite() also writes
+ * the lists of a finished cell to a file next to its .mag file, named
+ * like it but ending in ".drc".  The file carries the signature of the
+ * cell (see DRCCellSignature()) and of the DRC style.  When all of a
+ * cell is to be checked, as it is when the cell is read in before its
+ * checks were finished or after "drc check", and nothing else is known
+ * about it, the file is read.  If both signatures still match, the
+ * error tiles in the file replace those of the cell and the cell isn't
+ * checked.
+ *
+ * The file is text, one item to a line, with coordinates in internal
+ * units:
+ *
+ *	magic-drc 1
+ *	style <name>
+ *	rules <signature of the style>
+ *	cell <signature of the cell>
+ *	why <n>			then n lines, one reason each
+ *	tiles <n>		then n lines:  <type> xbot ybot xtop ytop
+ *	errors <n>		then n lines:  <rule> <why> xbot ybot xtop ytop
+ *	end
+ *
+ * Signatures are written as two hexadecimal numbers.  <rule> is the
+ * index of the rule among the packed rules of the style (DRCRules), or
+ * -1 for errors that don't come from a rule there, such as illegal
+ * overlaps of subcells.  <why> is the index of the reason in the list.
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "utils/magic.h"
+#include "utils/geometry.h"
+#include "tiles/tile.h"
+#include "utils/hash.h"
+#include "utils/utils.h"
+#include "database/database.h"
+#include "windows/windows.h"
+#include "dbwind/dbwind.h"
+#include "drc/drc.h"
+#include "utils/undo.h"
+#include "textio/textio.h"
+#include "utils/signals.h"
+#include "utils/malloc.h"
+
+/* If TRUE, DBCellWrite() saves the results of checking each cell,
+ * and they are read back in place of checking the cell again.
+ */
+bool DRCStoreFiles = FALSE;
+
+#define	DRC_STORE_VERSION	1
+#define	DRC_STORE_LINE		1024
+
+/* Number of the DRC square of the given size that holds coordinate c */
+#define	DRC_STORE_SQUARE(c, step) \
+	(((c) >= 0) ? (c) / (step) : -((-(c) + (step) - 1) / (step)))
+
+/* One error tile of a cell */
+
+typedef struct
+{
+    Rect	dt_rect;
+    TileType	dt_type;
+} DRCErrorTile;
+
+/* One error of a cell */
+
+typedef struct
+{
+    Rect	de_rect;
+    int		de_rule;	/* Index in DRCRules, or -1 */
+    int		de_why;		/* Index in ds_why */
+} DRCStoreError;
+
+/* The errors in one DRC square of a cell */
+
+typedef struct
+{
+    int		  *sq_errors;	/* Indices in ds_errors */
+    int		   sq_n;
+    int		   sq_size;	/* Entries allocated in sq_errors */
+} DRCStoreSquare;
+
+/* What is known about the errors of one cell */
+
+typedef struct
+{
+    int		   ds_nTiles;	/* -1 until the error tiles are listed */
+    DRCErrorTile  *ds_tiles;	/* In the order of DBSrPaintArea() */
+    int		   ds_tileSize;	/* Entries allocated in ds_tiles */
+    Rect	   ds_bbox;	/* Area of the cell when they were listed */
+    Rect	   ds_tileBox;	/* Bounding box of the error tiles */
+    DRCStoreError *ds_errors;	/* The errors found so far */
+    int		   ds_nErrors;
+    int		   ds_errSize;	/* Entries allocated in ds_errors */
+    HashTable	   ds_squares;	/* Square -> DRCStoreSquare, once known */
+    int		   ds_step;	/* Size of the squares */
+    bool	   ds_complete;	/* TRUE if all squares with errors are known */
+    DRCCookie	  *ds_why;	/* Reasons, in drcc_why only, for clients */
+    int		   ds_nWhy;
+    int		   ds_whySize;	/* Entries allocated in ds_why */
+    HashTable	   ds_whyTable;	/* Reason -> index in ds_why + 1 */
+    DRCStoreSquare *ds_cur;	/* Square being checked */
+    Rect	   ds_curArea;	/* Area of that square */
+} DRCStore;
+
+static HashTable drcStoreTable;		/* CellDef -> DRCStore */
+static bool drcStoreInit = FALSE;
+
+extern TileTypeBitMask DRCLayers;
+extern int drcAlwaysOne();
+extern int DRCInteractionCheck();
+extern int DRCArrayCheck();
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreGrow --
+ *
+ *	Make room for one more entry at the end of a list that is being
+ *	built.
+ *
+ * Results:
+ *	The list, which may have moved.
+ *
+ * Side effects:
+ *	*pSize is updated to the number of entries allocated.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static char *
+drcStoreGrow(list, count, pSize, elSize)
+    char *list;		/* The list, or NULL */
+    int count;		/* Entries used in the list */
+    int *pSize;		/* Entries allocated in the list */
+    int elSize;		/* Size of one entry */
+{
+    char *newList;
+
+    if (count < *pSize) return list;
+    *pSize = (*pSize == 0) ? 16 : *pSize * 2;
+    newList = (char *) mallocMagic((unsigned) (*pSize * elSize));
+    if (list != NULL)
+    {
+	memcpy(newList, list, count * elSize);
+	freeMagic(list);
+    }
+    return newList;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreFree --
+ *
+ *	Free what is known about one cell.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory free'd.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static void
+drcStoreFree(ds)
+    DRCStore *ds;
+{
+    HashSearch hs;
+    HashEntry *he;
+    DRCStoreSquare *sq;
+    int i;
+
+    HashStartSearch(&hs);
+    while ((he = HashNext(&ds->ds_squares, &hs)) != NULL)
+    {
+	sq = (DRCStoreSquare *) HashGetValue(he);
+	if (sq->sq_errors != NULL) freeMagic((char *) sq->sq_errors);
+	freeMagic((char *) sq);
+    }
+    HashKill(&ds->ds_squares);
+    HashKill(&ds->ds_whyTable);
+    if (ds->ds_tiles != NULL) freeMagic((char *) ds->ds_tiles);
+    if (ds->ds_errors != NULL) freeMagic((char *) ds->ds_errors);
+    for (i = 0; i < ds->ds_nWhy; i++)
+	freeMagic(ds->ds_why[i].drcc_why);
+    if (ds->ds_why != NULL) freeMagic((char *) ds->ds_why);
+    freeMagic((char *) ds);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreFlush --
+ *
+ *	Forget what is known about all cells.  Called when the rules
+ *	change.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory free'd.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcStoreFlush()
+{
+    HashSearch hs;
+    HashEntry *he;
+
+    if (drcStoreInit)
+    {
+	HashStartSearch(&hs);
+	while ((he = HashNext(&drcStoreTable, &hs)) != NULL)
+	    if (HashGetValue(he) != NULL)
+		drcStoreFree((DRCStore *) HashGetValue(he));
+	HashKill(&drcStoreTable);
+    }
+    HashInit(&drcStoreTable, 32, HT_WORDKEYS);
+    drcStoreInit = TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreForget --
+ *
+ *	Forget what is known about a cell, because it has been marked
+ *	to be checked again or is being deleted.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory free'd.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcStoreForget(def)
+    CellDef *def;
+{
+    HashEntry *he;
+
+    if (!drcStoreInit) return;
+    he = HashLookOnly(&drcStoreTable, (char *) def);
+    if (he == NULL || HashGetValue(he) == NULL) return;
+    drcStoreFree((DRCStore *) HashGetValue(he));
+    HashSetValue(he, NULL);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreLookup --
+ *
+ *	Find the entry for a cell, making an empty one if there is none.
+ *
+ * Results:
+ *	The entry.
+ *
+ * Side effects:
+ *	May allocate memory.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static DRCStore *
+drcStoreLookup(def)
+    CellDef *def;
+{
+    HashEntry *he;
+    DRCStore *ds;
+
+    if (!drcStoreInit) drcStoreFlush();
+    he = HashFind(&drcStoreTable, (char *) def);
+    ds = (DRCStore *) HashGetValue(he);
+    if (ds == NULL)
+    {
+	ds = (DRCStore *) mallocMagic(sizeof (DRCStore));
+	ds->ds_nTiles = -1;
+	ds->ds_tiles = NULL;
+	ds->ds_tileSize = 0;
+	ds->ds_errors = NULL;
+	ds->ds_nErrors = ds->ds_errSize = 0;
+	HashInit(&ds->ds_squares, 32, HashSize(2 * sizeof (int)));
+	ds->ds_step = (DRCStepSize > 0) ? DRCStepSize : (1 << 20);
+	ds->ds_complete = FALSE;
+	ds->ds_why = NULL;
+	ds->ds_nWhy = ds->ds_whySize = 0;
+	HashInit(&ds->ds_whyTable, 32, HT_STRINGKEYS);
+	HashSetValue(he, ds);
+    }
+    return ds;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreCurrent --
+ *
+ *	Tell whether the error plane of a cell is final, i.e. the cell
+ *	has been checked and nothing remains to be checked in it.
+ *
+ * Results:
+ *	TRUE if so.  Cells that are never checked (read-only, vendor
+ *	GDS and internal cells) are never current, since their error
+ *	planes say nothing about the rules.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static bool
+drcStoreCurrent(def)
+    CellDef *def;
+{
+    if (DRCCurStyle == NULL) return FALSE;
+    if (!(def->cd_flags & CDAVAILABLE)) return FALSE;
+    if (def->cd_flags & (CDVENDORGDS | CDNOEDIT | CDINTERNAL)) return FALSE;
+    return (DBSrPaintArea((Tile *) NULL, def->cd_planes[PL_DRC_CHECK],
+		&TiPlaneRect, &DBAllButSpaceBits, drcAlwaysOne,
+		(ClientData) NULL) == 0);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreTiles --
+ *
+ *	Get the list of error tiles of a cell, making it if need be.
+ *
+ * Results:
+ *	The entry for the cell, or NULL if its errors aren't final.
+ *
+ * Side effects:
+ *	May list the error tiles of the cell.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static DRCStore *
+drcStoreTiles(def)
+    CellDef *def;
+{
+    DRCStore *ds;
+    int drcStoreTileFunc();
+
+    if (!drcStoreCurrent(def)) return NULL;
+    ds = drcStoreLookup(def);
+
+    /* The area of the cell can still change when the checker is done
+     * with it, so the list is only good for the area it was made for.
+     */
+    if (ds->ds_nTiles >= 0
+		&& (!GEO_SAMEPOINT(ds->ds_bbox.r_ll, def->cd_bbox.r_ll)
+		|| !GEO_SAMEPOINT(ds->ds_bbox.r_ur, def->cd_bbox.r_ur)))
+	ds->ds_nTiles = -1;
+
+    if (ds->ds_nTiles < 0)
+    {
+	ds->ds_nTiles = 0;
+	ds->ds_bbox = def->cd_bbox;
+	ds->ds_tileBox = GeoNullRect;
+	(void) DBSrPaintArea((Tile *) NULL, def->cd_planes[PL_DRC_ERROR],
+		&def->cd_bbox, &DBAllButSpaceBits, drcStoreTileFunc,
+		(ClientData) ds);
+    }
+    return ds;
+}
+
+int
+drcStoreTileFunc(tile, ds)
+    Tile *tile;
+    DRCStore *ds;
+{
+    DRCErrorTile *dt;
+
+    if (TiGetType(tile) == TT_SPACE) return 0;
+    ds->ds_tiles = (DRCErrorTile *) drcStoreGrow((char *) ds->ds_tiles,
+		ds->ds_nTiles, &ds->ds_tileSize, sizeof (DRCErrorTile));
+    dt = &ds->ds_tiles[ds->ds_nTiles++];
+    TiToRect(tile, &dt->dt_rect);
+    dt->dt_type = TiGetType(tile);
+    (void) GeoInclude(&dt->dt_rect, &ds->ds_tileBox);
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DRCStoreCount --
+ *
+ *	Count the error tiles of a cell, as DRCCount() does.
+ *
+ * Results:
+ *	The number of error tiles in the cell, or -1 if its errors
+ *	aren't final yet, in which case the caller must count them
+ *	itself.
+ *
+ * Side effects:
+ *	May list the error tiles of the cell.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+DRCStoreCount(def)
+    CellDef *def;
+{
+    DRCStore *ds;
+
+    ds = drcStoreTiles(def);
+    return (ds == NULL) ? -1 : ds->ds_nTiles;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DRCStoreTile --
+ *
+ *	Find an error tile of a cell by its place in the order in which
+ *	DBSrPaintArea() visits the error plane.
+ *
+ * Results:
+ *	TRUE if the tile was found, FALSE if there is no such tile or
+ *	the errors of the cell aren't final yet.
+ *
+ * Side effects:
+ *	Fills in *rect.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+DRCStoreTile(def, indx, rect)
+    CellDef *def;
+    int indx;		/* Index of the tile, from 0 */
+    Rect *rect;		/* Filled in with the area of the tile */
+{
+    DRCStore *ds;
+
+    ds = drcStoreTiles(def);
+    if (ds == NULL || indx < 0 || indx >= ds->ds_nTiles) return FALSE;
+    *rect = ds->ds_tiles[indx].dt_rect;
+    return TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreWhyIndex --
+ *
+ *	Find a reason in the list of a cell, adding it if it is new.
+ *
+ * Results:
+ *	The index of the reason.
+ *
+ * Side effects:
+ *	May add to ds_why.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static int
+drcStoreWhyIndex(ds, why)
+    DRCStore *ds;
+    char *why;
+{
+    HashEntry *he;
+    int n;
+
+    he = HashFind(&ds->ds_whyTable, why);
+    n = (int) (spointertype) HashGetValue(he);
+    if (n != 0) return n - 1;
+
+    ds->ds_why = (DRCCookie *) drcStoreGrow((char *) ds->ds_why,
+		ds->ds_nWhy, &ds->ds_whySize, sizeof (DRCCookie));
+    n = ds->ds_nWhy++;
+    memset((char *) &ds->ds_why[n], 0, sizeof (DRCCookie));
+    ds->ds_why[n].drcc_why = StrDup((char **) NULL, why);
+    HashSetValue(he, (spointertype) (n + 1));
+    return n;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreAdd --
+ *
+ *	Add an error of a cell to the list of one of its squares.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Adds to sq_errors.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static void
+drcStoreAdd(sq, indx)
+    DRCStoreSquare *sq;
+    int indx;		/* Index of the error in ds_errors */
+{
+    sq->sq_errors = (int *) drcStoreGrow((char *) sq->sq_errors,
+		sq->sq_n, &sq->sq_size, sizeof (int));
+    sq->sq_errors[sq->sq_n++] = indx;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreErrorFunc --
+ *
+ *	Called by the checker for each error found by drcStoreSquare().
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Adds the error to the lists of the cell and of the square.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcStoreErrorFunc(def, rect, cptr, ds)
+    CellDef *def;
+    Rect *rect;
+    DRCCookie *cptr;
+    DRCStore *ds;
+{
+    DRCStoreError *de;
+    Rect r;
+    int n, nRules;
+
+    r = *rect;
+    GeoClip(&r, &ds->ds_curArea);
+    if (r.r_xbot >= r.r_xtop || r.r_ybot >= r.r_ytop) return;
+
+    ds->ds_errors = (DRCStoreError *) drcStoreGrow((char *) ds->ds_errors,
+		ds->ds_nErrors, &ds->ds_errSize, sizeof (DRCStoreError));
+    de = &ds->ds_errors[ds->ds_nErrors];
+    de->de_rect = r;
+
+    n = DRCCurStyle->DRCRuleTypes;
+    nRules = DRCCurStyle->DRCRuleStart[DRC_HORIZONTAL][n * n];
+    if (DRCCurStyle->DRCRules != NULL && cptr >= DRCCurStyle->DRCRules
+		&& cptr < DRCCurStyle->DRCRules + nRules)
+	de->de_rule = cptr - DRCCurStyle->DRCRules;
+    else
+	de->de_rule = -1;
+    de->de_why = drcStoreWhyIndex(ds,
+		(cptr->drcc_why != NULL) ? cptr->drcc_why : "");
+    drcStoreAdd(ds->ds_cur, ds->ds_nErrors++);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreSquare --
+ *
+ *	Find the errors in one DRC square of a cell whose error tiles
+ *	are final.  Squares without error tiles have no errors; the
+ *	others are checked again.
+ *
+ * Results:
+ *	TRUE if the errors are known, FALSE if the checks were
+ *	interrupted.
+ *
+ * Side effects:
+ *	Adds the square to ds_squares.  DRCdef is used.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static bool
+drcStoreSquare(def, ds, key)
+    CellDef *def;
+    DRCStore *ds;
+    int *key;		/* Numbers of the square in x and y */
+{
+    DRCStoreSquare *sq;
+    int first;
+
+    sq = (DRCStoreSquare *) mallocMagic(sizeof (DRCStoreSquare));
+    sq->sq_errors = NULL;
+    sq->sq_n = sq->sq_size = 0;
+
+    ds->ds_curArea.r_xbot = key[0] * ds->ds_step;
+    ds->ds_curArea.r_ybot = key[1] * ds->ds_step;
+    ds->ds_curArea.r_xtop = ds->ds_curArea.r_xbot + ds->ds_step;
+    ds->ds_curArea.r_ytop = ds->ds_curArea.r_ybot + ds->ds_step;
+    if (DBSrPaintArea((Tile *) NULL, def->cd_planes[PL_DRC_ERROR],
+		&ds->ds_curArea, &DBAllButSpaceBits, drcAlwaysOne,
+		(ClientData) NULL))
+    {
+	first = ds->ds_nErrors;
+	ds->ds_cur = sq;
+	UndoDisable();
+	(void) DRCInteractionCheck(def, &ds->ds_curArea, &ds->ds_curArea,
+		drcStoreErrorFunc, (ClientData) ds);
+	(void) DRCArrayCheck(def, &ds->ds_curArea, drcStoreErrorFunc,
+		(ClientData) ds);
+	UndoEnable();
+	if (SigInterruptPending)
+	{
+	    ds->ds_nErrors = first;
+	    if (sq->sq_errors != NULL) freeMagic((char *) sq->sq_errors);
+	    freeMagic((char *) sq);
+	    return FALSE;
+	}
+    }
+    HashSetValue(HashFind(&ds->ds_squares, (char *) key), sq);
+    return TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreComplete --
+ *
+ *	Find all of the errors of a cell whose error tiles are final.
+ *
+ * Results:
+ *	TRUE if the errors are known, FALSE if the checks were
+ *	interrupted.
+ *
+ * Side effects:
+ *	Fills in ds_squares.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static bool
+drcStoreComplete(def, ds)
+    CellDef *def;
+    DRCStore *ds;
+{
+    Rect *r;
+    int i, step, key[2];
+
+    if (ds->ds_complete) return TRUE;
+    step = ds->ds_step;
+    for (i = 0; i < ds->ds_nTiles; i++)
+    {
+	r = &ds->ds_tiles[i].dt_rect;
+	for (key[0] = DRC_STORE_SQUARE(r->r_xbot, step);
+		key[0] <= DRC_STORE_SQUARE(r->r_xtop - 1, step); key[0]++)
+	    for (key[1] = DRC_STORE_SQUARE(r->r_ybot, step);
+		    key[1] <= DRC_STORE_SQUARE(r->r_ytop - 1, step); key[1]++)
+		if (HashLookOnly(&ds->ds_squares, (char *) key) == NULL
+			&& !drcStoreSquare(def, ds, key))
+		    return FALSE;
+    }
+    ds->ds_complete = TRUE;
+    return TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DRCStoreWhy --
+ *
+ *	Pass each error of a cell in an area to a client function, as
+ *	DRCInteractionCheck() and DRCArrayCheck() together would, but
+ *	from the errors kept for the cell instead of by checking it.
+ *
+ * Results:
+ *	TRUE if the errors were passed on, FALSE if the errors of the
+ *	cell aren't final, or couldn't all be found, in which case the
+ *	caller must check the area itself.
+ *
+ * Side effects:
+ *	Whatever func does.  It is called as
+ *
+ *	(*func)(def, rect, cptr, cdarg)
+ *
+ *	where only the drcc_why field of *cptr is meaningful.  Squares
+ *	of the area whose errors aren't known yet are checked first.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+DRCStoreWhy(def, area, func, cdarg)
+    CellDef *def;
+    Rect *area;			/* Area of interest, in def's coordinates */
+    void (*func)();
+    ClientData cdarg;
+{
+    DRCStore *ds;
+    DRCStoreSquare *sq;
+    DRCStoreError *de;
+    HashEntry *he;
+    Rect r, search;
+    int j, step, key[2], xlo, xhi, ylo, yhi;
+
+    ds = drcStoreTiles(def);
+    if (ds == NULL) return FALSE;
+
+    /* Errors are only found where there are error tiles */
+
+    search = *area;
+    GeoClip(&search, &ds->ds_tileBox);
+    if (search.r_xbot >= search.r_xtop || search.r_ybot >= search.r_ytop)
+	return TRUE;
+    step = ds->ds_step;
+    xlo = DRC_STORE_SQUARE(search.r_xbot, step);
+    xhi = DRC_STORE_SQUARE(search.r_xtop - 1, step);
+    ylo = DRC_STORE_SQUARE(search.r_ybot, step);
+    yhi = DRC_STORE_SQUARE(search.r_ytop - 1, step);
+
+    /* Find the errors of every square first, so nothing is passed on
+     * if that is interrupted.
+     */
+
+    if (!ds->ds_complete)
+	for (key[0] = xlo; key[0] <= xhi; key[0]++)
+	    for (key[1] = ylo; key[1] <= yhi; key[1]++)
+		if (HashLookOnly(&ds->ds_squares, (char *) key) == NULL
+			&& !drcStoreSquare(def, ds, key))
+		    return FALSE;
+
+    /* An error in more than one square is passed on from the square
+     * that holds the lower left corner of its part in the area.
+     */
+
+    for (key[0] = xlo; key[0] <= xhi; key[0]++)
+	for (key[1] = ylo; key[1] <= yhi; key[1]++)
+	{
+	    he = HashLookOnly(&ds->ds_squares, (char *) key);
+	    if (he == NULL) continue;
+	    sq = (DRCStoreSquare *) HashGetValue(he);
+	    for (j = 0; j < sq->sq_n; j++)
+	    {
+		de = &ds->ds_errors[sq->sq_errors[j]];
+		if (!GEO_OVERLAP(&de->de_rect, area)) continue;
+		r = de->de_rect;
+		GeoClip(&r, area);
+		if (DRC_STORE_SQUARE(r.r_xbot, step) != key[0]
+			|| DRC_STORE_SQUARE(r.r_ybot, step) != key[1])
+		    continue;
+		(*func)(def, &r, &ds->ds_why[de->de_why], cdarg);
+	    }
+	}
+    return TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreName --
+ *
+ *	Form the name of the file that holds the results for a cell.
+ *
+ * Results:
+ *	The name, in memory allocated by mallocMagic().  The caller
+ *	must free it.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static char *
+drcStoreName(magName)
+    char *magName;	/* Name of the .mag file, with or without suffix */
+{
+    char *name;
+    int len, slen;
+
+    len = strlen(magName);
+    slen = strlen(DBSuffix);
+    if (len > slen && strcmp(magName + len - slen, DBSuffix) == 0)
+	len -= slen;
+    name = (char *) mallocMagic((unsigned) (len + 5));
+    strncpy(name, magName, len);
+    strcpy(name + len, ".drc");
+    return name;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * DRCStoreWrite --
+ *
+ *	Called by DBCellWrite() when a cell has been written.  If
+ *	DRCStoreFiles is set and the cell has been checked, write what
+ *	is known about its errors next to its file.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Writes the file.  May find the errors of the cell first.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+DRCStoreWrite(def, magName)
+    CellDef *def;
+    char *magName;	/* Name of the .mag file just written */
+{
+    DRCStore *ds;
+    DRCHash cell, style;
+    DRCErrorTile *dt;
+    DRCStoreError *de;
+    char *name;
+    FILE *f;
+    int i;
+
+    if (!DRCStoreFiles || !drcStoreCurrent(def)) return;
+    if (!DRCCellSignature(def, &cell)) return;
+    DRCStyleSignature(&style);
+    ds = drcStoreTiles(def);
+    if (!drcStoreComplete(def, ds)) return;
+
+    name = drcStoreName(magName);
+    f = fopen(name, "w");
+    if (f == NULL)
+    {
+	TxError("Warning: cannot write DRC results to %s\n", name);
+	freeMagic(name);
+	return;
+    }
+
+    fprintf(f, "magic-drc %d\n", DRC_STORE_VERSION);
+    fprintf(f, "style %s\n", DRCCurStyle->ds_name);
+    fprintf(f, "rules %016llx %016llx\n", (unsigned long long) style.dh_a,
+		(unsigned long long) style.dh_b);
+    fprintf(f, "cell %016llx %016llx\n", (unsigned long long) cell.dh_a,
+		(unsigned long long) cell.dh_b);
+    fprintf(f, "why %d\n", ds->ds_nWhy);
+    for (i = 0; i < ds->ds_nWhy; i++)
+	fprintf(f, "%s\n", ds->ds_why[i].drcc_why);
+    fprintf(f, "tiles %d\n", ds->ds_nTiles);
+    for (i = 0; i < ds->ds_nTiles; i++)
+    {
+	dt = &ds->ds_tiles[i];
+	fprintf(f, "%s %d %d %d %d\n", DBTypeLongNameTbl[dt->dt_type],
+		dt->dt_rect.r_xbot, dt->dt_rect.r_ybot,
+		dt->dt_rect.r_xtop, dt->dt_rect.r_ytop);
+    }
+    fprintf(f, "errors %d\n", ds->ds_nErrors);
+    for (i = 0; i < ds->ds_nErrors; i++)
+    {
+	de = &ds->ds_errors[i];
+	fprintf(f, "%d %d %d %d %d %d\n", de->de_rule, de->de_why,
+		de->de_rect.r_xbot, de->de_rect.r_ybot,
+		de->de_rect.r_xtop, de->de_rect.r_ytop);
+    }
+    fprintf(f, "end\n");
+    if (fclose(f) != 0)
+    {
+	TxError("Warning: I/O error in writing %s\n", name);
+	(void) unlink(name);
+    }
+    freeMagic(name);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreLine --
+ *
+ *	Read one line of a results file, without its newline.
+ *
+ * Results:
+ *	TRUE if a whole line was read.
+ *
+ * Side effects:
+ *	Fills in line.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+static bool
+drcStoreLine(f, line)
+    FILE *f;
+    char *line;		/* DRC_STORE_LINE bytes */
+{
+    int len;
+
+    if (fgets(line, DRC_STORE_LINE, f) == NULL) return FALSE;
+    len = strlen(line);
+    if (len == 0 || line[len - 1] != '\n') return FALSE;
+    line[len - 1] = '\0';
+    return TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreLoad --
+ *
+ *	Read in all of the cells used, directly or not, by a cell.  The
+ *	signature of a cell can't be worked out until they are, and
+ *	checking all of the cell would read them anyway.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Cells are read in, which puts them on the list of cells to be
+ *	checked.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcStoreLoad(def)
+    CellDef *def;
+{
+    HashTable seen;
+    int drcStoreLoadFunc();
+
+    HashInit(&seen, 32, HT_WORDKEYS);
+    (void) DBCellEnum(def, drcStoreLoadFunc, (ClientData) &seen);
+    HashKill(&seen);
+}
+
+int
+drcStoreLoadFunc(use, seen)
+    CellUse *use;
+    HashTable *seen;
+{
+    HashEntry *he;
+
+    he = HashFind(seen, (char *) use->cu_def);
+    if (HashGetValue(he) != NULL) return 0;
+    HashSetValue(he, 1);
+    (void) DBCellEnum(use->cu_def, drcStoreLoadFunc, (ClientData) seen);
+    return 0;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcStoreRead --
+ *
+ *	Called by drcCacheSkip() when all of a cell is about to be
+ *	checked and nothing is known about it.  If DRCStoreFiles is
+ *	set and the file next to the cell's holds the results of
+ *	checking the cell as it is now with the rules in use now, put
+ *	those results in place of the cell's errors.
+ *
+ * Results:
+ *	TRUE if the results were read, in which case the cell needs
+ *	no checking.
+ *
+ * Side effects:
+ *	Replaces the error plane of the cell and sets its lists.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+drcStoreRead(def, cell, style)
+    CellDef *def;
+    DRCHash *cell;		/* Signature of the cell */
+    DRCHash *style;		/* Signature of the rules */
+{
+    DRCStore *ds;
+    DRCStoreSquare *sq;
+    HashEntry *he;
+    int key[2], n;
+    DRCErrorTile *tiles = NULL;
+    DRCStoreError *errors = NULL;
+    char **why = NULL;
+    char line[DRC_STORE_LINE], tname[DRC_STORE_LINE];
+    unsigned long long a, b;
+    int version, nWhy = 0, nTiles = 0, nErrors = 0, i;
+    Rect changed, r;
+    TileType type;
+    bool ok = FALSE;
+    FILE *f;
+    char *name;
+
+    if (!DRCStoreFiles || def->cd_file == NULL) return FALSE;
+    name = drcStoreName(def->cd_file);
+    f = fopen(name, "r");
+    freeMagic(name);
+    if (f == NULL) return FALSE;
+
+    if (!drcStoreLine(f, line) || sscanf(line, "magic-drc %d", &version) != 1
+		|| version != DRC_STORE_VERSION)
+	goto done;
+    if (!drcStoreLine(f, line) || strncmp(line, "style ", 6) != 0
+		|| strcmp(line + 6, DRCCurStyle->ds_name) != 0)
+	goto done;
+    if (!drcStoreLine(f, line) || sscanf(line, "rules %llx %llx", &a, &b) != 2
+		|| a != style->dh_a || b != style->dh_b)
+	goto done;
+    if (!drcStoreLine(f, line) || sscanf(line, "cell %llx %llx", &a, &b) != 2
+		|| a != cell->dh_a || b != cell->dh_b)
+	goto done;
+
+    if (!drcStoreLine(f, line) || sscanf(line, "why %d", &nWhy) != 1
+		|| nWhy < 0)
+	goto done;
+    if (nWhy > 0)
+	why = (char **) mallocMagic((unsigned) (nWhy * sizeof (char *)));
+    for (i = 0; i < nWhy; i++) why[i] = NULL;
+    for (i = 0; i < nWhy; i++)
+    {
+	if (!drcStoreLine(f, line)) goto done;
+	why[i] = StrDup((char **) NULL, line);
+    }
+
+    if (!drcStoreLine(f, line) || sscanf(line, "tiles %d", &nTiles) != 1
+		|| nTiles < 0)
+	goto done;
+    if (nTiles > 0)
+	tiles = (DRCErrorTile *) mallocMagic((unsigned) (nTiles
+		* sizeof (DRCErrorTile)));
+    for (i = 0; i < nTiles; i++)
+    {
+	r = GeoNullRect;
+	if (!drcStoreLine(f, line) || sscanf(line, "%s %d %d %d %d", tname,
+		&r.r_xbot, &r.r_ybot, &r.r_xtop, &r.r_ytop) != 5)
+	    goto done;
+	type = DBTechNameType(tname);
+	if (type <= TT_SPACE || DBTypePlaneTbl[type] != PL_DRC_ERROR) goto done;
+	tiles[i].dt_rect = r;
+	tiles[i].dt_type = type;
+    }
+
+    if (!drcStoreLine(f, line) || sscanf(line, "errors %d", &nErrors) != 1
+		|| nErrors < 0)
+	goto done;
+    if (nErrors > 0)
+	errors = (DRCStoreError *) mallocMagic((unsigned) (nErrors
+		* sizeof (DRCStoreError)));
+    for (i = 0; i < nErrors; i++)
+    {
+	if (!drcStoreLine(f, line) || sscanf(line, "%d %d %d %d %d %d",
+		&errors[i].de_rule, &errors[i].de_why,
+		&errors[i].de_rect.r_xbot, &errors[i].de_rect.r_ybot,
+		&errors[i].de_rect.r_xtop, &errors[i].de_rect.r_ytop) != 6)
+	    goto done;
+	if (errors[i].de_why < 0 || errors[i].de_why >= nWhy) goto done;
+    }
+    if (!drcStoreLine(f, line) || strcmp(line, "end") != 0) goto done;
+    ok = TRUE;
+
+done:
+    fclose(f);
+    if (!ok)
+    {
+	for (i = 0; i < nWhy && why != NULL; i++)
+	    if (why[i] != NULL) freeMagic(why[i]);
+	if (why != NULL) freeMagic((char *) why);
+	if (tiles != NULL) freeMagic((char *) tiles);
+	if (errors != NULL) freeMagic((char *) errors);
+	return FALSE;
+    }
+
+    /* Put the saved error tiles in place of the ones the cell has */
+
+    if (!DBBoundPlane(def->cd_planes[PL_DRC_ERROR], &changed))
+	changed = GeoNullRect;
+    SigDisableInterrupts();
+    DBClearPaintPlane(def->cd_planes[PL_DRC_ERROR]);
+    for (i = 0; i < nTiles; i++)
+    {
+	DBPaintPlane(def->cd_planes[PL_DRC_ERROR], &tiles[i].dt_rect,
+		DBStdPaintTbl(tiles[i].dt_type, PL_DRC_ERROR),
+		(PaintUndoInfo *) NULL);
+	(void) GeoInclude(&tiles[i].dt_rect, &changed);
+    }
+    SigEnableInterrupts();
+    if (!GEO_RECTNULL(&changed))
+	DBWAreaChanged(def, &changed, DBW_ALLWINDOWS, &DRCLayers);
+
+    /* The errors are kept, in the squares that they overlap.  The
+     * tiles are listed again when wanted, in the order of the plane
+     * as painted here.
+     */
+
+    drcStoreForget(def);
+    ds = drcStoreLookup(def);
+    if (tiles != NULL) freeMagic((char *) tiles);
+    for (i = 0; i < nWhy; i++)
+    {
+	n = drcStoreWhyIndex(ds, why[i]);
+	freeMagic(why[i]);
+	why[i] = (char *) (spointertype) n;
+    }
+    ds->ds_errors = errors;
+    ds->ds_nErrors = ds->ds_errSize = nErrors;
+    for (i = 0; i < nErrors; i++)
+    {
+	errors[i].de_why = (int) (spointertype) why[errors[i].de_why];
+	r = errors[i].de_rect;
+	for (key[0] = DRC_STORE_SQUARE(r.r_xbot, ds->ds_step);
+		key[0] <= DRC_STORE_SQUARE(r.r_xtop - 1, ds->ds_step); key[0]++)
+	    for (key[1] = DRC_STORE_SQUARE(r.r_ybot, ds->ds_step);
+		    key[1] <= DRC_STORE_SQUARE(r.r_ytop - 1, ds->ds_step);
+		    key[1]++)
+	    {
+		he = HashFind(&ds->ds_squares, (char *) key);
+		sq = (DRCStoreSquare *) HashGetValue(he);
+		if (sq == NULL)
+		{
+		    sq = (DRCStoreSquare *) mallocMagic(sizeof (DRCStoreSquare));
+		    sq->sq_errors = NULL;
+		    sq->sq_n = sq->sq_size = 0;
+		    HashSetValue(he, sq);
+		}
+		drcStoreAdd(sq, i);
+	    }
+    }
+    ds->ds_complete = TRUE;
+    if (why != NULL) freeMagic((char *) why);
+    return TRUE;
+}
@@ -670,10 +670,11 @@ DRCInteractionCheck(def, area, erasebox, func, cdarg)
 	    (void) DBNewPaintTable(savedPaintTable);
 	    (void) DBNewPaintPlane(savedPaintPlane);
 
-	    /* Run the basic checker over the interaction area. */
+	    /* Run the basic checker over the interaction area, unless
+	     * the same interaction has been checked already.
+	     */
 
-	    count += DRCBasicCheck(DRCdef, &scx.scx_area, &intArea,
-		func, cdarg);
+	    count += drcCachedCheck(&scx.scx_area, &intArea, func, cdarg);
 	    /* TxPrintf("Interaction area: (%d, %d) (%d %d)\n",
 		intArea.r_xbot, intArea.r_ybot,
 		intArea.r_xtop, intArea.r_ytop);
@@ -76,6 +76,8 @@ void DRCTechStyleInit();
 void drcLoadStyle();
 void DRCTechFinal();
 void drcTechFinalStyle();
+void drcCompileRules();
+void drcFreeRules();
 
 /*
  * ----------------------------------------------------------------------------
@@ -287,6 +289,8 @@ drcTechFreeStyle()
 		}
 	    }
 
+	drcFreeRules(DRCCurStyle);
+
 	/* Clear the DRCWhyList */
 
 	while (DRCCurStyle->DRCWhyList != NULL)
@@ -530,7 +534,9 @@ DRCTechStyleInit()
     {
 	DRCCurStyle = (DRCStyle *) mallocMagic(sizeof(DRCStyle));
 	DRCCurStyle->ds_name = NULL;
+	DRCCurStyle->DRCRules = NULL;
     }
+    drcFreeRules(DRCCurStyle);
 
     DRCCurStyle->ds_status = TECH_NOT_LOADED;
 
@@ -3233,6 +3239,7 @@ DRCTechFinal()
 	DRCCurStyle->ds_status = TECH_LOADED;
     }
     drcTechFinalStyle(DRCCurStyle);
+    drcCompileRules(DRCCurStyle);
 }
 
 /*
@@ -3623,6 +3630,228 @@ drcTechFinalStyle(style)
     }
 }
 
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcRuleUnused --
+ *
+ *	Determine whether drcTile ever applies a rule to edges in the
+ *	given direction.  "Angles" rules are checked per tile, not per
+ *	edge, and area, rectangle size, and maxwidth (without bends)
+ *	rules are checked only along vertical edges.
+ *
+ * Results:
+ *	TRUE if the rule can be left out of the direction's packed rules.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+drcRuleUnused(dp, dir)
+    DRCCookie *dp;
+    int dir;		/* DRC_VERTICAL or DRC_HORIZONTAL */
+{
+    if (dp->drcc_flags & DRC_ANGLES) return TRUE;
+    if (dir == DRC_VERTICAL) return FALSE;
+    if ((dp->drcc_flags & (DRC_MAXWIDTH | DRC_BENDS)) ==
+		(DRC_MAXWIDTH | DRC_BENDS))
+	return FALSE;
+    return (dp->drcc_flags & (DRC_AREA | DRC_RECTSIZE | DRC_MAXWIDTH)) ?
+		TRUE : FALSE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcPackRules --
+ *
+ *	Walk the rules table in the order in which drcCompileRules lays
+ *	out the packed rules.  If "rules" is NULL, the rules are only
+ *	counted;  otherwise they are copied into "rules", and the start
+ *	indices and angle rules of the style are filled in.
+ *
+ *	A rule that drcTile would skip in a direction is left out of
+ *	that direction (along with the rule it triggers), unless it
+ *	follows a trigger rule itself.  So every trigger rule is still
+ *	followed by the rule it triggers, and the rules that remain are
+ *	visited in the same order and with the same outcome as before.
+ *
+ *	Canonical maxwidth ("widespacing") rules that are not triggers
+ *	look one unit past their distance.  drcTile used to add the unit
+ *	to the cookie for the duration of each check;  it is now folded
+ *	into the copy, so the checker never writes to the rules and any
+ *	number of threads may share them.
+ *
+ * Results:
+ *	The number of packed rules.
+ *
+ * Side effects:
+ *	See above.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+drcPackRules(style, rules)
+    DRCStyle *style;
+    DRCCookie *rules;	/* Where to copy the rules, or NULL to count */
+{
+    DRCCookie *dp, *rp;
+    TileType i, j;
+    int dir, n, count;
+    bool follower;
+
+    n = style->DRCRuleTypes;
+    count = 0;
+    for (dir = DRC_VERTICAL; dir <= DRC_HORIZONTAL; dir++)
+    {
+	for (i = 0; i < n; i++)
+	    for (j = 0; j < n; j++)
+	    {
+		if (rules != NULL)
+		    style->DRCRuleStart[dir][i * n + j] = count;
+		follower = FALSE;
+		for (dp = style->DRCRulesTbl[i][j]; dp != NULL; dp = dp->drcc_next)
+		{
+		    if (!follower && drcRuleUnused(dp, dir))
+		    {
+			if (dp->drcc_flags & DRC_TRIGGER)
+			    if ((dp = dp->drcc_next) == NULL)
+				break;
+			continue;
+		    }
+		    if (rules != NULL)
+		    {
+			rp = &rules[count];
+			*rp = *dp;
+			rp->drcc_next = NULL;
+			if (!(dp->drcc_flags & DRC_TRIGGER) &&
+				((dp->drcc_flags & (DRC_MAXWIDTH | DRC_BENDS))
+				== (DRC_MAXWIDTH | DRC_BENDS)))
+			    rp->drcc_dist++;
+		    }
+		    count++;
+		    follower = (dp->drcc_flags & DRC_TRIGGER) ? TRUE : FALSE;
+		}
+	    }
+	if (rules != NULL)
+	    style->DRCRuleStart[dir][n * n] = count;
+    }
+
+    /* drcTile looks up the first "angles" rule of a type for each	*/
+    /* split tile.							*/
+
+    for (j = 0; j < n; j++)
+    {
+	for (dp = style->DRCRulesTbl[TT_SPACE][j]; dp != NULL; dp = dp->drcc_next)
+	    if (dp->drcc_flags & DRC_ANGLES)
+		break;
+	if (dp == NULL) continue;
+	if (rules != NULL)
+	{
+	    rp = &rules[count];
+	    *rp = *dp;
+	    rp->drcc_next = NULL;
+	    style->DRCAngleRules[j] = rp;
+	}
+	count++;
+    }
+    return count;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcCompileRules --
+ *
+ *	Pack the edge rules of a style for the basic checker.  The rules
+ *	for each pair of types and each direction become one contiguous
+ *	run of DRCCookies (see drcPackRules), so drcTile steps through an
+ *	array instead of chasing drcc_next pointers, and never looks at
+ *	the rules that don't apply to the direction.
+ *
+ *	This must be called again whenever the rules in DRCRulesTbl are
+ *	changed or rescaled.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Replaces the packed rules of the style.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcCompileRules(style)
+    DRCStyle *style;
+{
+    int dir, count, n;
+
+    drcFreeRules(style);
+
+    n = style->DRCRuleTypes = DBNumTypes;
+    for (dir = DRC_VERTICAL; dir <= DRC_HORIZONTAL; dir++)
+	style->DRCRuleStart[dir] = (int *) mallocMagic((unsigned)
+		((n * n + 1) * sizeof (int)));
+
+    count = drcPackRules(style, (DRCCookie *) NULL);
+    style->DRCRules = (DRCCookie *) mallocMagic((unsigned)
+		(MAX(count, 1) * sizeof (DRCCookie)));
+    (void) drcPackRules(style, style->DRCRules);
+
+    for (n = 0; n < count; n++)
+	if (style->DRCRules[n].drcc_flags
+		& (DRC_AREA | DRC_MAXWIDTH | DRC_RECTSIZE))
+	    style->DRCWholeShapes = TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * drcFreeRules --
+ *
+ *	Free the packed rules of a style made by drcCompileRules.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory free'd.  The basic checker finds no rules until the style
+ *	is compiled again.  Everything in the DRC caches is forgotten.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+drcFreeRules(style)
+    DRCStyle *style;
+{
+    int dir;
+    TileType i;
+
+    if (style->DRCRules != NULL)
+    {
+	freeMagic((char *) style->DRCRules);
+	for (dir = DRC_VERTICAL; dir <= DRC_HORIZONTAL; dir++)
+	    freeMagic((char *) style->DRCRuleStart[dir]);
+    }
+    style->DRCRules = NULL;
+    style->DRCRuleStart[DRC_VERTICAL] = NULL;
+    style->DRCRuleStart[DRC_HORIZONTAL] = NULL;
+    style->DRCRuleTypes = 0;
+    style->DRCWholeShapes = FALSE;
+    for (i = 0; i < TT_MAXTYPES; i++)
+	style->DRCAngleRules[i] = NULL;
+
+    /* The cached results of checks refer to the packed rules */
+    style->DRCSigValid = FALSE;
+    drcCacheFlush();
+}
+
 
 /*
  * ----------------------------------------------------------------------------
@@ -3734,6 +3963,9 @@ DRCTechScale(scalen, scaled)
 
     DRCCurStyle->DRCStepSize *= scaled;
     DRCCurStyle->DRCStepSize /= scalen;
+
+    /* The packed rules hold copies of the old distances */
+    drcCompileRules(DRCCurStyle);
 }
 
 /* The following routines are used by the "tech" command (and in other places,
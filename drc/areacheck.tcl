@@ -0,0 +1,57 @@
+#
+# areacheck.tcl --
+#
+#	Run by "make check" in this directory.  Checks that the batch
+#	checker (more than one thread) finds the same area errors as the
+#	serial one.  The technology is scmos with one extra rule,
+#	"area m1 300000 4".  A 4 x 100000 wire satisfies it, but a piece of
+#	it clipped to one batch square does not; an 8 x 8 square of m1
+#	violates it in any case.
+#
+
+load ../magic/tclmagic[info sharedlibextension]
+
+set f [open ../scmos/scmos.tech]
+set tech [read $f]
+close $f
+set rule "drc\n    area m1 300000 4 \\\n \"Metal1 area must be at least 300000 (areacheck)\""
+if {![regsub -line {^drc$} $tech $rule tech]} {
+    puts stderr "areacheck: no drc section in scmos.tech"
+    exit 1
+}
+set f [open areacheck.tech w]
+puts -nonewline $f $tech
+close $f
+
+magic::initialize -dnull -noconsole -nowrapper -T areacheck
+magic::startup
+magic::openwindow
+
+set status 0
+foreach n {1 8} {
+    magic::threads $n
+    magic::drc off
+    magic::load areacheck$n
+    magic::box 0 0 100000 4
+    magic::paint m1
+    magic::box 0 100 8 108
+    magic::paint m1
+    magic::drc on
+    magic::box -10 -10 100010 200
+    magic::drc check
+    magic::drc catchup
+    set count($n) [magic::drc list count total]
+}
+if {$count(1) == 0} {
+    puts stderr "areacheck: the 8 x 8 square was not flagged"
+    set status 1
+} elseif {$count(8) != $count(1)} {
+    puts stderr "areacheck: $count(1) error tile(s) with 1 thread,\
+	    $count(8) with 8"
+    set status 1
+} else {
+    puts "areacheck: $count(1) error tile(s) with 1 thread and with 8"
+}
+magic::threads default
+file delete areacheck.tech
+exit $status
@@ -158,6 +158,20 @@ typedef struct drcwhylist
     struct drcwhylist   * dwl_next;
 } drcWhyList;      
  
+/*
+ * Signatures used by the caches in DRCcache.c to tell whether the
+ * checker has seen something before.
+ */
+
+typedef struct
+{
+    uint64_t	dh_a;
+    uint64_t	dh_b;
+} DRCHash;
+
+#define	DRC_HASH_EQUAL(h1, h2) \
+	(((h1)->dh_a == (h2)->dh_a) && ((h1)->dh_b == (h2)->dh_b))
+
 /*
  * Structure defining a DRC style
  */
@@ -174,21 +188,57 @@ typedef struct drcstyle
     int			DRCStepSize;	/* chunk size for decomposing large areas */
     drcWhyList		*DRCWhyList;
     PaintResultType	DRCPaintTable[NP][NT][NT];
+
+    /* The edge rules of DRCRulesTbl, packed by drcCompileRules() for
+     * the basic checker.  The rules for an edge with type "to" on its
+     * left (bottom) and "tt" on its right (top) are DRCRules[n] for
+     * DRCRuleStart[dir][k] <= n < DRCRuleStart[dir][k + 1], where
+     * k = to * DRCRuleTypes + tt and dir is DRC_VERTICAL or
+     * DRC_HORIZONTAL.
+     */
+    DRCCookie		*DRCRules;
+    int			*DRCRuleStart[2];
+    int			DRCRuleTypes;
+    bool		DRCWholeShapes;	/* TRUE if some rule looks at whole
+					 * shapes (area, maxwidth, rect_only),
+					 * not just at the halo around edges.
+					 */
+    DRCCookie		*DRCAngleRules[TT_MAXTYPES];
+
+    /* Signature of the rules, made by DRCStyleSignature() */
+    DRCHash		DRCSignature;
+    bool		DRCSigValid;
 } DRCStyle;
 
+#define	DRC_VERTICAL	0	/* Edges along the left side of a tile */
+#define	DRC_HORIZONTAL	1	/* Edges along the bottom of a tile */
+
 /* Things shared between DRC functions, but not used by the
  * outside world:
  */
 
-extern int  DRCstatEdges;	/* counters for statistics gathering */
-extern int  DRCstatSlow;
-extern int  DRCstatRules;
-extern int  DRCstatTiles;
+/* The batch checker (DRCbatch.c) runs the basic checker in several
+ * threads at once.  Each thread keeps its own copy of the variables
+ * declared DRC_LOCAL.
+ */
+
+#ifdef WORKER_THREADS
+#define	DRC_LOCAL	__thread
+#else
+#define	DRC_LOCAL
+#endif
+
+extern DRC_LOCAL int  DRCstatEdges;	/* counters for statistics gathering */
+extern DRC_LOCAL int  DRCstatSlow;
+extern DRC_LOCAL int  DRCstatRules;
+extern DRC_LOCAL int  DRCstatTiles;
 extern int  DRCstatInteractions;
 extern int  DRCstatIntTiles;
 extern int  DRCstatCifTiles;
 extern int  DRCstatSquares;
 extern int  DRCstatArrayTiles;
+extern int  DRCstatCacheCells;
+extern int  DRCstatCacheAreas;
 
 #ifdef	DRCRULESHISTO
 #	define	DRC_MAXRULESHISTO 30	/* Max rules per edge for statistics */
@@ -206,6 +256,9 @@ extern unsigned char DRCBackGround;	/* global flag to enable/disable
 extern bool DRCEuclidean;	/* global flag to enable/disable
 				 * Euclidean distance measure
 				 */
+extern bool DRCStoreFiles;	/* TRUE if the results of checking are
+				 * saved next to each cell's file
+				 */
 extern int  dbDRCDebug;
 extern bool DRCForceReload;	/* TRUE if we have to reload DRC on a
 				 * change of the CIF output style
@@ -215,6 +268,9 @@ extern DRCKeep  *DRCStyleList;	/* List of available DRC styles */
 extern DRCStyle *DRCCurStyle;	/* Current DRC style in effect */
 extern CellDef  *DRCdef;	/* Current cell being checked for DRC */
 extern CellUse  *DRCuse, *DRCDummyUse;
+extern bool drcBatchActive;	/* TRUE while the batch checker is
+				 * collecting paint to check.
+				 */
 
 /* 
  * Internal procedures
@@ -225,6 +281,20 @@ extern void drcPrintError();
 extern int drcIncludeArea();
 extern int drcExactOverlapTile();
 extern void drcInitRulesTbl();
+extern int drcCheckPaint();
+extern bool drcBatchDefer();
+extern void drcSquareDone();
+extern int drcCachedCheck();
+extern bool drcCacheSkip();
+extern void drcCacheRecord();
+extern void drcCacheForget();
+extern void drcCacheFlush();
+extern void drcCacheFlushSigs();
+extern void drcArrayFlush();
+extern void drcStoreFlush();
+extern void drcStoreForget();
+extern bool drcStoreRead();
+extern void drcStoreLoad();
 
 /*
  * Exported procedures
@@ -254,7 +324,14 @@ extern void DRCCheck();
 extern DRCCountList *DRCCount();
 extern int DRCFind();
 extern void DRCCatchUp();
+extern bool DRCBatchCheck();
 extern bool DRCFindInteractions();
+extern bool DRCCellSignature();
+extern void DRCStyleSignature();
+extern int DRCStoreCount();
+extern bool DRCStoreTile();
+extern bool DRCStoreWhy();
+extern void DRCStoreWrite();
 
 extern void DRCPrintStyle();
 extern void DRCSetStyle();
@@ -825,8 +825,7 @@ efFlatGlobCmp(hierName1, hierName2)
 	return FALSE;
 
     return ((bool)(hierName1 == NULL || hierName2 == NULL
-		   || hierName1->hn_hash != hierName2->hn_hash
-		   || strcmp(hierName1->hn_name, hierName2->hn_name) != 0
+		   || hierName1->hn_name != hierName2->hn_name
 		  ));
 }
 
@@ -837,9 +836,9 @@ efFlatGlobCopy(hierName)
     HierName *hNew;
     int size;
 
-    size = HIERNAMESIZE(strlen(hierName->hn_name));
+    size = sizeof (HierName);
     hNew = (HierName *) mallocMagic((unsigned)(size));
-    (void) strcpy(hNew->hn_name, hierName->hn_name);
+    hNew->hn_name = hierName->hn_name;
     hNew->hn_parent = (HierName *) NULL;
     hNew->hn_hash = hierName->hn_hash;
     if (efHNStats)
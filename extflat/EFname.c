@@ -170,11 +170,11 @@ EFHNConcat(prefix, suffix)
 	    suffix;
 	    prev = new, suffix = suffix->hn_parent)
     {
-	size = HIERNAMESIZE(strlen(suffix->hn_name));
+	size = sizeof (HierName);
 	new = (HierName *) mallocMagic((unsigned)(size));
 	if (efHNStats) efHNRecord(size, HN_CONCAT);
 	new->hn_hash = suffix->hn_hash;
-	(void) strcpy(new->hn_name, suffix->hn_name);
+	new->hn_name = suffix->hn_name;
 	if (prev)
 	    prev->hn_parent = new;
 	else
@@ -232,7 +232,7 @@ EFStrToHN(prefix, suffixStr)
     {
 	if (*cp == '/' || *cp == '\0')
 	{
-	    size = HIERNAMESIZE(cp - slashPtr);
+	    size = sizeof (HierName);
 	    hierName = (HierName *) mallocMagic((unsigned)(size));
 	    if (efHNStats) efHNRecord(size, HN_ALLOC);
 	    efHNInit(hierName, slashPtr, cp);
@@ -462,10 +462,7 @@ EFHNFree(hierName, prefix, type)
 
 	freeMagic((char *) hn);
 	if (efHNStats)
-	{
-	    int len = strlen(hn->hn_name);
-	    efHNRecord(-HIERNAMESIZE(len), type);
-	}
+	    efHNRecord(-(int) sizeof (HierName), type);
     }
 }
 
@@ -648,7 +645,7 @@ efHNFromUse(hc, prefix)
 	*dstp = '\0';
     }
 
-    size = HIERNAMESIZE(strlen(namePtr));
+    size = sizeof (HierName);
     hierName = (HierName *) mallocMagic ((unsigned)(size));
     if (efHNStats) efHNRecord(size, HN_FROMUSE);
     efHNInit(hierName, namePtr, (char *) NULL);
@@ -676,7 +673,8 @@ efHNFromUse(hc, prefix)
  *	Compare two HierNames for equality, but using a different sense
  *	of comparison than efHNCompare: two names are considered equal
  *	only if their hn_parent fields are equal and their hn_name strings
- *	are identical.
+ *	are identical (which, since they are interned, means the same
+ *	pointer).
  *
  * Results: Returns 0 if they are equal, 1 if not.
  *
@@ -700,7 +698,7 @@ efHNUseCompare(hierName1, hierName2)
     HierName *hierName1, *hierName2;
 {
     return ((bool)(hierName1->hn_parent != hierName2->hn_parent
-	           || strcmp(hierName1->hn_name, hierName2->hn_name)
+	           || hierName1->hn_name != hierName2->hn_name
 		  ));
 }
 
@@ -716,16 +714,16 @@ efHNUseHash(hierName)
  *
  * efHNInit --
  *
- * Copy the string 'cp' into hierName->hn_name, also initializing
- * the hn_hash fields of hierName.  If 'endp' is NULL, copy all
- * characters in 'cp' up to a trailing NULL byte; otherwise, copy
- * up to 'endp'.
+ * Set hierName->hn_name to the interned copy of the string 'cp',
+ * also initializing the hn_hash fields of hierName.  If 'endp' is
+ * NULL, use all characters in 'cp' up to a trailing NULL byte;
+ * otherwise, use those up to 'endp'.
  *
  * Results:
  *	None.
  *
  * Side effects:
- *	See above.
+ *	See above.  May add a string to the StrIntern() table.
  *
  * ----------------------------------------------------------------------------
  */
@@ -737,22 +735,30 @@ efHNInit(hierName, cp, endp)
     char *endp;	/* End of name if non-NULL; else, see above */
 {
     unsigned hashsum;
-    char *dstp;
+    char name[256], *namePtr, *dstp;
 
     hashsum = 0;
-    dstp = hierName->hn_name;
     if (endp)
     {
+	/* Copy the component so it is NULL-terminated for StrIntern() */
+	namePtr = name;
+	if (endp - cp >= sizeof name)
+	    namePtr = mallocMagic((unsigned) (endp - cp + 1));
+	dstp = namePtr;
 	while (cp < endp)
 	{
 	    hashsum = HASHADDVAL(hashsum, *cp);
 	    *dstp++ = *cp++;
 	}
 	*dstp = '\0';
+	hierName->hn_name = StrIntern(namePtr);
+	if (namePtr != name)
+	    freeMagic(namePtr);
     }
     else
     {
-	while (*dstp++ = *cp)
+	hierName->hn_name = StrIntern(cp);
+	while (*cp)
 	    hashsum = HASHADDVAL(hashsum, *cp++);
     }
 
@@ -797,8 +803,7 @@ efHNCompare(hierName1, hierName2)
 	    return 0;
 
 	if (hierName2 == NULL
-		|| hierName1->hn_hash != hierName2->hn_hash
-		|| strcmp(hierName1->hn_name, hierName2->hn_name) != 0)
+		|| hierName1->hn_name != hierName2->hn_name)
 	    return 1;
 	hierName1 = hierName1->hn_parent;
 	hierName2 = hierName2->hn_parent;
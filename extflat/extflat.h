@@ -68,15 +68,12 @@ typedef struct hiername
 {
     struct hiername	*hn_parent;	/* Back-pointer toward root */
     int			 hn_hash;	/* For speed in hashing */
-    char		 hn_name[4];	/* String is allocated here */
+    char		*hn_name;	/* Interned string (see StrIntern()),
+					 * so equal components share storage
+					 * and compare equal as pointers.
+					 */
 } HierName;
 
-/*
- * Size of a HierName big enough to hold a string containing
- * n bytes (not including the NULL byte).
- */
-#define	HIERNAMESIZE(n)	((n) + sizeof (HierName) - 3)
-
 /* Indicates where the HierName was allocated: passed to EFHNFree() */
 #define	HN_ALLOC	0	/* Normal name (FromStr) */
 #define	HN_CONCAT	1	/* Concatenation of two HierNames */
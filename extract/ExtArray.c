@@ -40,6 +40,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "utils/styles.h"
 #include "windows/windows.h"
 #include "dbwind/dbwind.h"
+#include "utils/utils.h"
 
 /* Canonical interaction areas */
 #define	AREA_A	0
@@ -108,6 +109,7 @@ extOutputGeneratedLabels(parentUse, f)
 	putc('\n', f);
 	freeMagic(lab);
 	parentDef->cd_labels = lab->lab_next;
+	DBLabelIndexFree(parentDef);
     }
 }
 
@@ -657,7 +659,9 @@ extArrayAdjust(ha, et1, et2)
     HashEntry *he;
     NodeName *nn;
     HashSearch hs;
+    CapLine *lines;
     char *name;
+    int n;
 
     /*
      * Initialize the capacitance, perimeter, and area values
@@ -684,6 +688,10 @@ extArrayAdjust(ha, et1, et2)
     extHierAdjustments(ha, &ha->ha_cumFlat, et1, et1);
     extHierAdjustments(ha, &ha->ha_cumFlat, et2, et2);
 
+    lines = (CapLine *) mallocMagic(
+		(HashGetNumEntries(&ha->ha_cumFlat.et_coupleHash) + 1)
+		* sizeof (CapLine));
+    n = 0;
     HashStartSearch(&hs);
     while (he = HashNext(&ha->ha_cumFlat.et_coupleHash, &hs))
     {
@@ -692,11 +700,12 @@ extArrayAdjust(ha, et1, et2)
 	    continue;
 
 	ck = (CoupleKey *) he->h_key.h_words;
-	name = extArrayNodeName(ck->ck_1, ha, et1, et2);
-	fprintf(ha->ha_outf, "cap \"%s\" ", name);
-	name = extArrayNodeName(ck->ck_2, ha, et1, et2);
-	fprintf(ha->ha_outf, "\"%s\" %lg\n", name, cap);
+	name = StrDup((char **) NULL, extArrayNodeName(ck->ck_1, ha, et1, et2));
+	extCapLineSet(&lines[n++], name,
+		extArrayNodeName(ck->ck_2, ha, et1, et2), cap);
+	freeMagic(name);
     }
+    extOutputCapLines(lines, n, ha->ha_outf);
 }
 
 char *
@@ -971,6 +980,7 @@ extArrayHardNode(tp, pNum, def, ha)
 	ll->ll_label = arg.hw_label;
 	arg.hw_label->lab_next = def->cd_labels;
 	def->cd_labels = arg.hw_label;
+	DBLabelIndexFree(def);
 	return (lreg);
     }
 
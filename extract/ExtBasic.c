@@ -2213,13 +2213,13 @@ extTransFindSubsFunc1(tile, sn)
      * regions under the same device)
      */
 
-    if (tile->ti_client != (ClientData) extUnInit)
+    if (TiGetClient(tile) != (ClientData) extUnInit)
     {
-	if ((*sn != (NodeRegion *)NULL) && (*sn != tile->ti_client))
+	if ((*sn != (NodeRegion *)NULL) && (*sn != TiGetClient(tile)))
 	    TxError("Warning:  Split substrate under device at (%d %d)\n",
 			tile->ti_ll.p_x, tile->ti_ll.p_y);
 
-	*sn = (NodeRegion *) tile->ti_client;
+	*sn = (NodeRegion *) TiGetClient(tile);
 	return 1;
     }
     return 0;
@@ -3265,9 +3265,9 @@ extNodeAreaFunc(tile, arg)
 	 * been visited in the meantime.  If it's still unvisited,
 	 * visit it and process its neighbors.
 	 */
-	if (tile->ti_client == (ClientData) reg)
+	if (TiGetClient(tile) == (ClientData) reg)
 	    continue;
-	tile->ti_client = (ClientData) reg;
+	TiSetClient(tile, (ClientData) reg);
 	if (DebugIsSet(extDebugID, extDebNeighbor))
 	    extShowTile(tile, "neighbor", 1);
 
@@ -3364,21 +3364,21 @@ topside:
             if (IsSplit(tp))
 	    {
         	t = SplitBottomType(tp);
-		if (tp->ti_client == extUnInit && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extUnInit && TTMaskHasType(mask, t))
 		{
 		    PUSHTILEBOTTOM(tp, tilePlaneNum);
 		}
-		else if (tp->ti_client != (ClientData)reg && TTMaskHasType(mask, t))
+		else if (TiGetClient(tp) != (ClientData)reg && TTMaskHasType(mask, t))
 		{
 		    /* Count split tile twice, once for each node it belongs to. */
-		    tp->ti_client = extUnInit;
+		    TiSetClient(tp, extUnInit);
 		    PUSHTILEBOTTOM(tp, tilePlaneNum);
 		}
 	    }
             else
 	    {
 		t = TiGetTypeExact(tp);
-		if (tp->ti_client == extUnInit && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extUnInit && TTMaskHasType(mask, t))
 		{
 		    PUSHTILE(tp, tilePlaneNum);
 		}
@@ -3409,21 +3409,21 @@ leftside:
             if (IsSplit(tp))
 	    {
                 t = SplitRightType(tp);
-		if (tp->ti_client == extUnInit && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extUnInit && TTMaskHasType(mask, t))
 		{
 		    PUSHTILERIGHT(tp, tilePlaneNum);
 		}
-		else if (tp->ti_client != (ClientData)reg && TTMaskHasType(mask, t))
+		else if (TiGetClient(tp) != (ClientData)reg && TTMaskHasType(mask, t))
 		{
 		    /* Count split tile twice, once for each node it belongs to. */
-		    tp->ti_client = extUnInit;
+		    TiSetClient(tp, extUnInit);
 		    PUSHTILERIGHT(tp, tilePlaneNum);
 		}
 	    }
             else
 	    {
 		t = TiGetTypeExact(tp);
-		if (tp->ti_client == extUnInit && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extUnInit && TTMaskHasType(mask, t))
 		{
 		    PUSHTILE(tp, tilePlaneNum);
 		}
@@ -3455,21 +3455,21 @@ bottomside:
             if (IsSplit(tp))
 	    {
                 t = SplitTopType(tp);
-		if (tp->ti_client == extUnInit && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extUnInit && TTMaskHasType(mask, t))
 		{
 		    PUSHTILETOP(tp, tilePlaneNum);
 		}
-		else if (tp->ti_client != (ClientData)reg && TTMaskHasType(mask, t))
+		else if (TiGetClient(tp) != (ClientData)reg && TTMaskHasType(mask, t))
 		{
 		    /* Count split tile twice, once for each node it belongs to. */
-		    tp->ti_client = extUnInit;
+		    TiSetClient(tp, extUnInit);
 		    PUSHTILETOP(tp, tilePlaneNum);
 		}
 	    }
             else
 	    {
 		t = TiGetTypeExact(tp);
-		if (tp->ti_client == extUnInit && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extUnInit && TTMaskHasType(mask, t))
 		{
 		    PUSHTILE(tp, tilePlaneNum);
 		}
@@ -3500,21 +3500,21 @@ rightside:
             if (IsSplit(tp))
 	    {
                 t = SplitLeftType(tp);
-		if (tp->ti_client == extUnInit && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extUnInit && TTMaskHasType(mask, t))
 		{
 		    PUSHTILELEFT(tp, tilePlaneNum);
 		}
-		else if (tp->ti_client != (ClientData)reg && TTMaskHasType(mask, t))
+		else if (TiGetClient(tp) != (ClientData)reg && TTMaskHasType(mask, t))
 		{
 		    /* Count split tile twice, once for each node it belongs to	*/
-		    tp->ti_client = extUnInit;
+		    TiSetClient(tp, extUnInit);
 		    PUSHTILELEFT(tp, tilePlaneNum);
 		}
 	    }
             else
 	    {
 		t = TiGetTypeExact(tp);
-		if (tp->ti_client == extUnInit && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extUnInit && TTMaskHasType(mask, t))
 		{
 		    PUSHTILE(tp, tilePlaneNum);
 		}
@@ -3545,7 +3545,7 @@ donesides:
 		    GOTOPOINT(tp, &tile->ti_ll);
 		    plane->pl_hint = tp;
 
-		    if (tp->ti_client != extUnInit) continue;
+		    if (TiGetClient(tp) != extUnInit) continue;
 
 		    /* tp and tile should have the same geometry for a contact */
 		    if (IsSplit(tile) && IsSplit(tp))
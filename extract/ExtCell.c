@@ -244,9 +244,18 @@ extCellFile(def, f, doLength)
 			 */
 {
     NodeRegion *reg;
+    bool planeSearch = DBCellPlaneSearch;
 
     UndoDisable();
 
+    /*
+     * Node names, and the coupling capacitance charged to each use,
+     * depend on the order in which subcells are visited.  Search them
+     * in the subcell tile plane, which keeps that order the same as
+     * it has always been, rather than in the cell index.
+     */
+    DBCellPlaneSearch = TRUE;
+
     /* Output the header: timestamp, technology, calls on cell uses */
     if (!SigInterruptPending) extHeader(def, f);
 
@@ -267,6 +276,7 @@ extCellFile(def, f, doLength)
     if (!SigInterruptPending && doLength && (ExtOptions & EXT_DOLENGTH))
 	extLength(extParentUse, f);
 
+    DBCellPlaneSearch = planeSearch;
     UndoEnable();
 }
 
@@ -22,6 +22,8 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #endif  /* not lint */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "utils/magic.h"
 #include "utils/geometry.h"
@@ -29,6 +31,8 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "tiles/tile.h"
 #include "utils/hash.h"
 #include "database/database.h"
+#include "utils/malloc.h"
+#include "utils/utils.h"
 #include "extract/extract.h"
 #include "extract/extractInt.h"
 
@@ -268,9 +272,14 @@ extOutputCoupling(table, outFile)
     HashEntry *he;
     CoupleKey *ck;
     HashSearch hs;
-    char *text;
+    CapLine *lines;
+    char *name;
+    int n;
     CapValue cap;  /* value of capacitance. */
 
+    lines = (CapLine *) mallocMagic((HashGetNumEntries(table) + 1)
+		* sizeof (CapLine));
+    n = 0;
     HashStartSearch(&hs);
     while (he = HashNext(table, &hs))
     {
@@ -279,13 +288,103 @@ extOutputCoupling(table, outFile)
 	    continue;
 
 	ck = (CoupleKey *) he->h_key.h_words;
-	text = extNodeName((LabRegion *) ck->ck_1);
-	fprintf(outFile, "cap \"%s\" ", text);
-	text = extNodeName((LabRegion *) ck->ck_2);
-	fprintf(outFile, "\"%s\" %lg\n", text, cap);
+	name = StrDup((char **) NULL, extNodeName((LabRegion *) ck->ck_1));
+	extCapLineSet(&lines[n++], name,
+		extNodeName((LabRegion *) ck->ck_2), cap);
+	freeMagic(name);
     }
+    extOutputCapLines(lines, n, outFile);
 }
-
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * extCapLineSet --
+ *
+ * Fill in a CapLine for a coupling capacitance of 'cap' between the
+ * nodes named 'name1' and 'name2'.  The names are copied, since they
+ * may be in a static buffer (see extNodeName()), and stored in
+ * alphabetical order.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Allocates memory for the names; extOutputCapLines() frees it.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+extCapLineSet(cl, name1, name2, cap)
+    CapLine *cl;
+    char *name1, *name2;
+    CapValue cap;
+{
+    char *name;
+
+    cl->cl_name1 = StrDup((char **) NULL, name1);
+    cl->cl_name2 = StrDup((char **) NULL, name2);
+    if (strcmp(cl->cl_name1, cl->cl_name2) > 0)
+    {
+	name = cl->cl_name1;
+	cl->cl_name1 = cl->cl_name2;
+	cl->cl_name2 = name;
+    }
+    cl->cl_cap = cap;
+}
+
+/*
+ * Comparison procedure for qsort() used by extOutputCapLines()
+ */
+
+int
+extCapLineCmp(cl1, cl2)
+    CapLine *cl1, *cl2;
+{
+    int cmp;
+
+    if (cmp = strcmp(cl1->cl_name1, cl2->cl_name1))
+	return cmp;
+    return strcmp(cl1->cl_name2, cl2->cl_name2);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * extOutputCapLines --
+ *
+ * Sort the 'n' CapLines in 'lines' by node name and output a "cap"
+ * record for each to 'outFile'.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Frees the names and the array 'lines' itself.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+extOutputCapLines(lines, n, outFile)
+    CapLine *lines;
+    int n;
+    FILE *outFile;
+{
+    int i;
+
+    qsort((char *) lines, n, sizeof (CapLine), extCapLineCmp);
+    for (i = 0; i < n; i++)
+    {
+	fprintf(outFile, "cap \"%s\" \"%s\" %lg\n",
+		lines[i].cl_name1, lines[i].cl_name2, lines[i].cl_cap);
+	freeMagic(lines[i].cl_name1);
+	freeMagic(lines[i].cl_name2);
+    }
+    freeMagic((char *) lines);
+}
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -343,6 +343,7 @@ extHierConnectFunc1(oneTile, ha)
 		
 		    newlab->lab_next = ha->ha_parentUse->cu_def->cd_labels;
 		    ha->ha_parentUse->cu_def->cd_labels = newlab;
+		    DBLabelIndexFree(ha->ha_parentUse->cu_def);
 		}
 #endif
 	    }
@@ -687,7 +687,7 @@ int
 extPathResetClient(tile)
     Tile *tile;
 {
-    tile->ti_client = (ClientData) CLIENTDEFAULT;
+    TiSetClient(tile, (ClientData) CLIENTDEFAULT);
     return (0);
 }
 
@@ -779,7 +779,7 @@ extPathFlood(tile, p, distance, epa)
     Rect r;
 
     /* Mark the tile as being visited */
-    tile->ti_client = MARKED;
+    TiSetClient(tile, MARKED);
 
     /*
      * Are we at the destination yet?
@@ -819,22 +819,22 @@ extPathFlood(tile, p, distance, epa)
 
 	/* TOP */
     for (tp = RT(tile); RIGHT(tp) > LEFT(tile); tp = BL(tp))
-	if (tp->ti_client != MARKED && DBConnectsTo(TiGetType(tp), type))
+	if (TiGetClient(tp) != MARKED && DBConnectsTo(TiGetType(tp), type))
 	    extPathFloodTile(tile, p, distance, tp, epa);
 
 	/* RIGHT */
     for (tp = TR(tile); TOP(tp) > BOTTOM(tile); tp = LB(tp))
-	if (tp->ti_client != MARKED && DBConnectsTo(TiGetType(tp), type))
+	if (TiGetClient(tp) != MARKED && DBConnectsTo(TiGetType(tp), type))
 	    extPathFloodTile(tile, p, distance, tp, epa);
 
 	/* BOTTOM */
     for (tp = LB(tile); LEFT(tp) < RIGHT(tile); tp = TR(tp))
-	if (tp->ti_client != MARKED && DBConnectsTo(TiGetType(tp), type))
+	if (TiGetClient(tp) != MARKED && DBConnectsTo(TiGetType(tp), type))
 	    extPathFloodTile(tile, p, distance, tp, epa);
 
 	/* LEFT */
     for (tp = BL(tile); BOTTOM(tp) < TOP(tile); tp = RT(tp))
-	if (tp->ti_client != MARKED && DBConnectsTo(TiGetType(tp), type))
+	if (TiGetClient(tp) != MARKED && DBConnectsTo(TiGetType(tp), type))
 	    extPathFloodTile(tile, p, distance, tp, epa);
 
     /* Try connections to other planes */
@@ -855,7 +855,7 @@ extPathFlood(tile, p, distance, epa)
 		plane->pl_hint = tp;
 
 		/* If not yet visited, process tp */
-		if (tp->ti_client == (ClientData) CLIENTDEFAULT
+		if (TiGetClient(tp) == (ClientData) CLIENTDEFAULT
 			&& DBConnectsTo(type, TiGetType(tp)))
 		{
 		    epa->epa_pNum = pNum;
@@ -117,9 +117,9 @@ ExtFindNeighbors(tile, tilePlaneNum, arg)
 	 * been visited in the meantime.  If it's still unvisited,
 	 * visit it and process its neighbors.
 	 */
-	if (tile->ti_client == (ClientData) arg->fra_region)
+	if (TiGetClient(tile) == (ClientData) arg->fra_region)
 	    continue;
-	tile->ti_client = (ClientData) arg->fra_region;
+	TiSetClient(tile, (ClientData) arg->fra_region);
 	tilesfound++;
 	if (DebugIsSet(extDebugID, extDebNeighbor))
 	    extShowTile(tile, "neighbor", 1);
@@ -133,7 +133,7 @@ topside:
 	    {
                 t = SplitBottomType(tp);
 		// if (tp->ti_client == extNbrUn && TTMaskHasType(mask, t))
-		if (tp->ti_client != (ClientData)arg->fra_region && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) != (ClientData)arg->fra_region && TTMaskHasType(mask, t))
 		{
 		    PUSHTILEBOTTOM(tp, tilePlaneNum);
 		}
@@ -141,7 +141,7 @@ topside:
             else
 	    {
         	t = TiGetTypeExact(tp);
-		if (tp->ti_client == extNbrUn && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extNbrUn && TTMaskHasType(mask, t))
 		{
 		    PUSHTILE(tp, tilePlaneNum);
 		}
@@ -157,7 +157,7 @@ leftside:
 	    {
                 t = SplitRightType(tp);
 		// if (tp->ti_client == extNbrUn && TTMaskHasType(mask, t))
-		if (tp->ti_client != (ClientData)arg->fra_region && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) != (ClientData)arg->fra_region && TTMaskHasType(mask, t))
 		{
 		    PUSHTILERIGHT(tp, tilePlaneNum);
 		}
@@ -165,7 +165,7 @@ leftside:
             else
 	    {
 		t = TiGetTypeExact(tp);
-		if (tp->ti_client == extNbrUn && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extNbrUn && TTMaskHasType(mask, t))
 		{
 		    PUSHTILE(tp, tilePlaneNum);
 		}
@@ -182,7 +182,7 @@ bottomside:
 	    {
                 t = SplitTopType(tp);
 		// if (tp->ti_client == extNbrUn && TTMaskHasType(mask, t))
-		if (tp->ti_client != (ClientData)arg->fra_region && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) != (ClientData)arg->fra_region && TTMaskHasType(mask, t))
 		{
 		    PUSHTILETOP(tp, tilePlaneNum);
 		}
@@ -190,7 +190,7 @@ bottomside:
             else
 	    {
         	t = TiGetTypeExact(tp);
-		if (tp->ti_client == extNbrUn && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extNbrUn && TTMaskHasType(mask, t))
 		{
 		    PUSHTILE(tp, tilePlaneNum);
 		}
@@ -206,7 +206,7 @@ rightside:
 	    {
                 t = SplitLeftType(tp);
 		// if (tp->ti_client == extNbrUn && TTMaskHasType(mask, t))
-		if (tp->ti_client != (ClientData)arg->fra_region && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) != (ClientData)arg->fra_region && TTMaskHasType(mask, t))
 		{
 		    PUSHTILELEFT(tp, tilePlaneNum);
 		}
@@ -214,7 +214,7 @@ rightside:
             else
 	    {
 		t = TiGetTypeExact(tp);
-		if (tp->ti_client == extNbrUn && TTMaskHasType(mask, t))
+		if (TiGetClient(tp) == extNbrUn && TTMaskHasType(mask, t))
 		{
 		    PUSHTILE(tp, tilePlaneNum);
 		}
@@ -240,7 +240,7 @@ donesides:
 		    tp = plane->pl_hint;
 		    GOTOPOINT(tp, &tile->ti_ll);
 		    plane->pl_hint = tp;
-		    if (tp->ti_client != extNbrUn) continue;
+		    if (TiGetClient(tp) != extNbrUn) continue;
 
                     /* tp and tile should have the same geometry for a contact */
                     if (IsSplit(tile) && IsSplit(tp))
@@ -317,7 +317,7 @@ fail:
     while (!StackEmpty(extNodeStack))
     {
 	POPTILE(tile, tilePlaneNum);
-	tile->ti_client = (ClientData) arg->fra_region;
+	TiSetClient(tile, (ClientData) arg->fra_region);
     }
     return -1;
 }
@@ -356,7 +356,7 @@ extNbrPushFunc(tile, pla)
     tileArea = &pla->area;
 
     /* Ignore tile if it's already been visited */
-    if (tile->ti_client != extNbrUn)
+    if (TiGetClient(tile) != extNbrUn)
 	return 0;
 
     /* Only consider tile if it overlaps tileArea or shares part of a side */
@@ -44,6 +44,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "windows/windows.h"
 #include "dbwind/dbwind.h"
 #include "utils/styles.h"
+#include "utils/utils.h"
 
 #ifdef	exactinteractions
 /*
@@ -602,8 +603,14 @@ extSubtreeOutputCoupling(ha)
     HashEntry *he;
     Tile *tp;
     HashSearch hs;
-    char *name;
+    CapLine *lines;
+    char *name1, *name2;
+    int n;
 
+    lines = (CapLine *) mallocMagic(
+		(HashGetNumEntries(&ha->ha_cumFlat.et_coupleHash) + 1)
+		* sizeof (CapLine));
+    n = 0;
     HashStartSearch(&hs);
     while (he = HashNext(&ha->ha_cumFlat.et_coupleHash, &hs))
     {
@@ -614,13 +621,16 @@ extSubtreeOutputCoupling(ha)
 	ck = (CoupleKey *) he->h_key.h_words;
 
 	tp = extNodeToTile(ck->ck_1, &ha->ha_cumFlat);
-	name = extSubtreeTileToNode(tp, ck->ck_1->nreg_pnum, &ha->ha_cumFlat, ha, TRUE);
-	fprintf(ha->ha_outf, "cap \"%s\" ", name);
+	name1 = StrDup((char **) NULL, extSubtreeTileToNode(tp,
+		ck->ck_1->nreg_pnum, &ha->ha_cumFlat, ha, TRUE));
 
 	tp = extNodeToTile(ck->ck_2, &ha->ha_cumFlat);
-	name = extSubtreeTileToNode(tp, ck->ck_2->nreg_pnum, &ha->ha_cumFlat, ha, TRUE);
-	fprintf(ha->ha_outf, "\"%s\" %lg\n", name, cap);
+	name2 = extSubtreeTileToNode(tp, ck->ck_2->nreg_pnum,
+		&ha->ha_cumFlat, ha, TRUE);
+	extCapLineSet(&lines[n++], name1, name2, cap);
+	freeMagic(name1);
     }
+    extOutputCapLines(lines, n, ha->ha_outf);
 }
 
 /*
@@ -726,6 +736,7 @@ extSubtreeFunc(scx, ha)
 		newlab->lab_next = cumUse->cu_def->cd_labels;
 		cumUse->cu_def->cd_labels = newlab;
 	    }
+	    DBLabelIndexFree(cumUse->cu_def);
 	}
 	extFirstPass = FALSE;
     }
@@ -1120,6 +1131,7 @@ extSubtreeHardNode(tp, pNum, et, ha)
 	ll->ll_label = arg.hw_label;
 	arg.hw_label->lab_next = def->cd_labels;
 	def->cd_labels = arg.hw_label;
+	DBLabelIndexFree(def);
 	return (lreg);
     }
 
@@ -91,6 +91,7 @@ extHierCopyLabels(sourceDef, targetDef)
     {
 	lastLab->lab_next = targetDef->cd_labels;
 	targetDef->cd_labels = firstLab;
+	DBLabelIndexFree(targetDef);
     }
 }
 
@@ -120,6 +121,7 @@ extHierFreeLabels(def)
 {
     Label *lab;
 
+    DBLabelIndexFree(def);
     for (lab = def->cd_labels; lab; lab = lab->lab_next)
 	freeMagic((char *) lab);
     def->cd_labels = (Label *) NULL;
@@ -240,6 +242,7 @@ extHierLabelFunc(scx, label, tpath, targetDef)
 
     newlab->lab_next = targetDef->cd_labels;
     targetDef->cd_labels = newlab;
+    DBLabelIndexFree(targetDef);
 
     /* Add paint inside label if this is a subcircuit */
     /* Caveat:  If label has zero area, it will be extended by 1 unit */
@@ -440,6 +440,21 @@ typedef struct
 
 extern void extCoupleHashZero(); /* Clears out all pointers to data in table */
 
+/*
+ * The "cap" lines of a .ext file are collected in an array of these
+ * and sorted by node name before they are written, so the output does
+ * not depend on the order of the coupling hash table or on which of
+ * the two NodeRegions has the lower address.
+ */
+typedef struct
+{
+    char	*cl_name1, *cl_name2;	/* Node names, each from StrDup() */
+    CapValue	 cl_cap;		/* Coupling capacitance */
+} CapLine;
+
+extern void extCapLineSet();	/* Fill in one CapLine */
+extern void extOutputCapLines(); /* Sort and output an array of CapLines */
+
 /* ------------------ Interface to debugging module ------------------- */
 
 extern ClientData extDebugID;	/* Identifier returned by the debug module */
@@ -930,8 +945,8 @@ typedef struct node
  */
 extern ClientData extUnInit;
 
-#define extGetRegion(tp)	( (tp)->ti_client )
-#define extHasRegion(tp,und)	( (tp)->ti_client != (und) )
+#define extGetRegion(tp)	( TiGetClient((tp)) )
+#define extHasRegion(tp,und)	( TiGetClient((tp)) != (und) )
 
 
 /* For non-recursive flooding algorithm */
@@ -945,7 +960,7 @@ extern ClientData extUnInit;
 /* time the tile is pushed and the time that it is popped.	*/
 
 #define	PUSHTILE(tp, pl) \
-	(tp)->ti_client = VISITPENDING; \
+	TiSetClient((tp), VISITPENDING); \
 	STACKPUSH((ClientData)(pointertype)(pl | \
 		((TileType)(spointertype)(tp)->ti_body & TT_SIDE)), extNodeStack); \
 	STACKPUSH((ClientData)(pointertype)tp, extNodeStack)
@@ -963,24 +978,24 @@ extern ClientData extUnInit;
 /* Variations of "pushtile" to force a specific value on TT_SIDE */
 
 #define PUSHTILEBOTTOM(tp, pl) \
-	(tp)->ti_client = VISITPENDING; \
+	TiSetClient((tp), VISITPENDING); \
 	STACKPUSH((ClientData)(pointertype)(pl | \
 		((SplitDirection(tp)) ? 0 : TT_SIDE)), extNodeStack) ;\
 	STACKPUSH((ClientData)(pointertype)tp, extNodeStack)
 
 #define PUSHTILETOP(tp, pl) \
-	(tp)->ti_client = VISITPENDING; \
+	TiSetClient((tp), VISITPENDING); \
 	STACKPUSH((ClientData)(pointertype)(pl | \
 		((SplitDirection(tp)) ? TT_SIDE : 0)), extNodeStack) ;\
 	STACKPUSH((ClientData)(pointertype)tp, extNodeStack)
 
 #define PUSHTILELEFT(tp, pl) \
-	(tp)->ti_client = VISITPENDING; \
+	TiSetClient((tp), VISITPENDING); \
 	STACKPUSH((ClientData)(pointertype)(pl), extNodeStack); \
 	STACKPUSH((ClientData)(pointertype)tp, extNodeStack)
 
 #define PUSHTILERIGHT(tp, pl) \
-	(tp)->ti_client = VISITPENDING; \
+	TiSetClient((tp), VISITPENDING); \
 	STACKPUSH((ClientData)(pointertype)(pl | TT_SIDE), extNodeStack); \
 	STACKPUSH((ClientData)(pointertype)tp, extNodeStack)
 
@@ -477,7 +477,7 @@ gaSetClient(tile, cdata)
     Tile *tile;
     ClientData cdata;
 {
-    tile->ti_client = (ClientData) cdata;
+    TiSetClient(tile, (ClientData) cdata);
     return (0);
 }
 
@@ -347,7 +347,7 @@ gaStemContainingChannelFunc(tile, pCh)
 {
     GCRChannel *ch;
 
-    if (ch = (GCRChannel *) tile->ti_client)
+    if (ch = (GCRChannel *) TiGetClient(tile))
     {
 	if (*pCh)
 	{
@@ -277,7 +277,7 @@ glChanFreeMap()
     DBFreePaintPlane(glChanPlane);
 
     /* Allocate a new central space tile */
-    newCenterTile = TiAlloc();
+    newCenterTile = TiPlaneAlloc(glChanPlane);
     glChanPlane->pl_hint = newCenterTile;
     TiSetBody(newCenterTile, CHAN_BLOCKED);
     dbSetPlaneTile(glChanPlane, newCenterTile);
@@ -360,11 +360,11 @@ glChanCheckFunc(tile, ch)
 	    DBWFeedbackAdd(&r, mesg, EditCellUse->cu_def,
 		    1, STYLE_MEDIUMHIGHLIGHTS);
 	}
-	if (tile->ti_client != (ClientData) ch)
+	if (TiGetClient(tile) != (ClientData) ch)
 	{
 	    TITORECT(tile, &r);
 	    (void) sprintf(mesg, "Tile client 0x%"DLONG_PREFIX"x doesn't match chan %p",
-		    (dlong) tile->ti_client, ch);
+		    (dlong) TiGetClient(tile), ch);
 	    DBWFeedbackAdd(&r, mesg, EditCellUse->cu_def,
 		    1, STYLE_MEDIUMHIGHLIGHTS);
 	}
@@ -433,7 +433,7 @@ glChanSetClient(tile, cdata)
     Tile *tile;
     ClientData cdata;
 {
-    tile->ti_client = cdata;
+    TiSetClient(tile, cdata);
     return 0;
 }
 
@@ -464,12 +464,12 @@ glChanShowFunc(tile)
     TITORECT(tile, &r);
     ShowRect(EditCellUse->cu_def, &r, STYLE_PALEHIGHLIGHTS);
     (void) sprintf(mesg, "tile ch=%"DLONG_PREFIX"x type=%d",
-		(dlong) tile->ti_client, TiGetType(tile));
+		(dlong) TiGetClient(tile), TiGetType(tile));
     TxMore(mesg);
     ShowRect(EditCellUse->cu_def, &r, STYLE_ERASEHIGHLIGHTS);
-    if (tile->ti_client == (ClientData) CLIENTDEFAULT)
+    if (TiGetClient(tile) == (ClientData) CLIENTDEFAULT)
 	return 0;
-    ch = (GCRChannel *) tile->ti_client;
+    ch = (GCRChannel *) TiGetClient(tile);
     ShowRect(EditCellUse->cu_def, &ch->gcr_area, STYLE_MEDIUMHIGHLIGHTS);
     (void) sprintf(mesg, "chan %p type=%d", ch, ch->gcr_type);
     TxMore(mesg);
@@ -502,7 +502,7 @@ glChanClipFunc(tile, area)
     Tile *tile;
     Rect *area;
 {
-    ClientData tileClient = tile->ti_client;
+    ClientData tileClient = TiGetClient(tile);
     TileType type = TiGetType(tile);
     Tile *newTile;
     int ret;
@@ -512,28 +512,28 @@ glChanClipFunc(tile, area)
     {
 	tile = TiSplitX(tile, area->r_xbot);
 	TiSetBody(tile, type);
-	tile->ti_client = tileClient;
+	TiSetClient(tile, tileClient);
 	ret = 1;
     }
     if (BOTTOM(tile) < area->r_ybot)
     {
 	tile = TiSplitY(tile, area->r_ybot);
 	TiSetBody(tile, type);
-	tile->ti_client = tileClient;
+	TiSetClient(tile, tileClient);
 	ret = 1;
     }
     if (RIGHT(tile) > area->r_xtop)
     {
 	newTile = TiSplitX(tile, area->r_xtop);
 	TiSetBody(newTile, type);
-	newTile->ti_client = tileClient;
+	TiSetClient(newTile, tileClient);
 	ret = 1;
     }
     if (TOP(tile) > area->r_ytop)
     {
 	newTile = TiSplitY(tile, area->r_ytop);
 	TiSetBody(newTile, type);
-	newTile->ti_client = tileClient;
+	TiSetClient(newTile, tileClient);
 	ret = 1;
     }
 
@@ -570,7 +570,7 @@ int
 glChanMergeFunc(tile)
     Tile *tile;
 {
-    GCRChannel *ch = (GCRChannel *) tile->ti_client;
+    GCRChannel *ch = (GCRChannel *) TiGetClient(tile);
     Tile *tp;
     int ret;
 
@@ -927,7 +927,7 @@ int
 glChanSplitRiver(tile)
     Tile *tile;
 {
-    ClientData tileClient = tile->ti_client;
+    ClientData tileClient = TiGetClient(tile);
     Tile *tp, *newTile;
     int ret;
 
@@ -940,7 +940,7 @@ glChanSplitRiver(tile)
 	    {
 		tile = TiSplitY(tile, TOP(tp));
 		TiSetBody(tile, CHAN_HRIVER);
-		tile->ti_client = tileClient;
+		TiSetClient(tile, tileClient);
 		ret = 1;
 	    }
 	}
@@ -950,7 +950,7 @@ glChanSplitRiver(tile)
 	    {
 		newTile = TiSplitY(tile, BOTTOM(tp));
 		TiSetBody(newTile, CHAN_HRIVER);
-		newTile->ti_client = tileClient;
+		TiSetClient(newTile, tileClient);
 		ret = 1;
 	    }
 	}
@@ -963,7 +963,7 @@ glChanSplitRiver(tile)
 	    {
 		newTile = TiSplitX(tile, LEFT(tp));
 		TiSetBody(newTile, CHAN_VRIVER);
-		newTile->ti_client = tileClient;
+		TiSetClient(newTile, tileClient);
 		ret = 1;
 	    }
 	}
@@ -973,7 +973,7 @@ glChanSplitRiver(tile)
 	    {
 		tile = TiSplitX(tile, RIGHT(tp));
 		TiSetBody(tile, CHAN_VRIVER);
-		tile->ti_client = tileClient;
+		TiSetClient(tile, tileClient);
 		ret = 1;
 	    }
 	}
@@ -1012,7 +1012,7 @@ glChanRiverBlock(tile)
     GCRChannel *ch;
     int lo, hi;
 
-    ch = (GCRChannel *) tile->ti_client;
+    ch = (GCRChannel *) TiGetClient(tile);
     if (TiGetType(tile) == CHAN_HRIVER)
     {
 	lo = (BOTTOM(tile) - ch->gcr_origin.p_y) / RtrGridSpacing;
@@ -1089,8 +1089,8 @@ glChanPinToTile(hintTile, pin)
     if (TiGetType(tp) == CHAN_BLOCKED)
 	return (Tile *) NULL;
 
-    ASSERT(tp->ti_client != (ClientData) CLIENTDEFAULT, "glChanPinToTile");
-    ch = (GCRChannel *) tp->ti_client;
+    ASSERT(TiGetClient(tp) != (ClientData) CLIENTDEFAULT, "glChanPinToTile");
+    ch = (GCRChannel *) TiGetClient(tp);
     TITORECT(tp, &r);
     ASSERT(GEO_SURROUND(&ch->gcr_area, &r), "glChanPinToTile");
 
@@ -301,8 +301,8 @@ glCrossEnum(inPt, tp, func, cdata)
     GCRPin *pins, *pin;
 
     /* Sanity checks: callers should ensure that these are true */
-    ASSERT(tp->ti_client != (ClientData) CLIENTDEFAULT, "glCrossEnum");
-    ASSERT((GCRChannel *) tp->ti_client != ch, "glCrossEnum");
+    ASSERT(TiGetClient(tp) != (ClientData) CLIENTDEFAULT, "glCrossEnum");
+    ASSERT((GCRChannel *) TiGetClient(tp) != ch, "glCrossEnum");
 
     /*
      * Find out the direction from inTile to tp.
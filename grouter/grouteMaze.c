@@ -366,7 +366,7 @@ glMazeTile(inPt, tile, dir)
     Tile *tile;	/* Tile adjacent to inPt->gl_tile */
     int dir;			/* Direction from inPt->gl_tile to tile */
 {
-    GCRChannel *ch = (GCRChannel *) tile->ti_client;
+    GCRChannel *ch = (GCRChannel *) TiGetClient(tile);
     TileType type = TiGetType(tile);
     Tile *tp;
 
@@ -222,7 +222,7 @@ glPinArrayInit(ch, side, pins, nPins)
 	    if (side == GEO_WEST) p.p_x--;
 	    if (side == GEO_SOUTH) p.p_y--;
 	    tp = TiSrPointNoHint(RtrChannelPlane, &p);
-	    if (adjacent = (GCRChannel *) tp->ti_client)
+	    if (adjacent = (GCRChannel *) TiGetClient(tp))
 	    {
 		/* Only link if entering the linked channel from a legal side */
 		linked = glPointToPin(adjacent, otherSide, &point);
@@ -396,16 +396,35 @@ endCoord:
 	}
     }
 
-    /* Process each segment and paint into the layout */
+    /* Process each segment and paint into the layout.  Runs of	*/
+    /* segments on the same layer are painted together.		*/
 
-    while (routeTop != NULL)
+    if (routeTop != NULL)
     {
-	/* paint */
-	DBPaint(rootDef, &routeTop->r_r, routeTop->r_type);
+	Rect *runRects;
+	int nSegs = 0, nRun;
 
-	/* advance to next point and free record (1-delayed) */
-	freeMagic((char *)routeTop);
-	routeTop = routeTop->r_next;
+	for (routeList = routeTop; routeList; routeList = routeList->r_next)
+	    nSegs++;
+	runRects = (Rect *)mallocMagic(nSegs * sizeof(Rect));
+
+	while (routeTop != NULL)
+	{
+	    paintLayer = routeTop->r_type;
+	    nRun = 0;
+	    while (routeTop != NULL && routeTop->r_type == paintLayer)
+	    {
+		runRects[nRun++] = routeTop->r_r;
+
+		/* advance to next point and free record (1-delayed) */
+		freeMagic((char *)routeTop);
+		routeTop = routeTop->r_next;
+	    }
+
+	    /* paint */
+	    DBPaintBatch(rootDef, runRects, nRun, paintLayer);
+	}
+	freeMagic((char *)runRects);
     }
     return token;	/* Pass back the last token found */
 }
@@ -592,7 +592,11 @@ defWriteNets(f, rootDef, oscale, MagicToLefTable, specialmode)
     defdata.outcolumn = 0;
     defdata.specialmode = specialmode;
 
+    /* Every node is looked up with DBSrConnect(), so index the	*/
+    /* connectivity of the cell once for all of them.		*/
+    DBConnIndexBuild(rootDef, DBConnectTbl);
     EFVisitNodes(defnodeVisit, (ClientData)&defdata);
+    DBConnIndexFree(rootDef);
 }
 
 int
@@ -383,7 +383,7 @@ lefYankGeometry(tile, cdata)
     bool iscut;
 
     /* Ignore marked tiles */
-    if (tile->ti_client != (ClientData)CLIENTDEFAULT) return 0;
+    if (TiGetClient(tile) != (ClientData)CLIENTDEFAULT) return 0;
 
     otype = TiGetTypeExact(tile);
     if (IsSplit(tile))
@@ -473,7 +473,7 @@ lefWriteGeometry(tile, cdata)
     LefMapping *lefMagicToLefLayer = lefdata->lefMagicMap;
 
     /* Ignore tiles that have already been output */
-    if (tile->ti_client != (ClientData)CLIENTDEFAULT)
+    if (TiGetClient(tile) != (ClientData)CLIENTDEFAULT)
 	return 0;
 
     /* Mark this tile as visited */
@@ -533,7 +533,7 @@ mzDumpTagsFunc(tile, cxp)
     Rect r;
 
     /* if tile has no client data attached, skip it */
-    if (tile->ti_client == (ClientData)CLIENTDEFAULT)
+    if (TiGetClient(tile) == (ClientData)CLIENTDEFAULT)
         return 0;
 	
     /* Get boundary of tile */
@@ -546,7 +546,7 @@ mzDumpTagsFunc(tile, cxp)
     /* dump rects attached to client field */
     {
 	List *l;
-        for(l=(List *) (tile->ti_client); l!=NULL; l=LIST_TAIL(l))
+        for(l=(List *) (TiGetClient(tile)); l!=NULL; l=LIST_TAIL(l))
         {
 	    Rect *rTerm = (Rect *) LIST_FIRST(l);
 	    
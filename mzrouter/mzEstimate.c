@@ -490,9 +490,9 @@ mzReclaimTCFunc(tile, notUsed)
     Tile *tile;
     ClientData notUsed;
 {
-    if (tile->ti_client != (ClientData)CLIENTDEFAULT)
+    if (TiGetClient(tile) != (ClientData)CLIENTDEFAULT)
     {
-	TileCosts *tc = ((TileCosts *) (tile->ti_client));
+	TileCosts *tc = ((TileCosts *) (TiGetClient(tile)));
 	Estimate *e;
 	
 	/* free estimates attached to tilecosts struc */
@@ -502,10 +502,10 @@ mzReclaimTCFunc(tile, notUsed)
 	}
 	
 	/* free tilecosts struc */
-	freeMagic((char *) (tile->ti_client));
+	freeMagic((char *) (TiGetClient(tile)));
 
 	/* reset client field in tile */
-	tile->ti_client = ((ClientData) CLIENTDEFAULT);
+	TiSetClient(tile, ((ClientData) CLIENTDEFAULT));
     }
 
     /* return 0 - to continue traversal of old estimate plane */
@@ -771,7 +771,7 @@ mzAssignCostsFunc(tile, spaceCosts)
 
     /* Alloc TileCosts struc for this tile, and attach it */
     newCosts = (TileCosts *) mallocMagic((unsigned) (sizeof(TileCosts)));
-    tile->ti_client = (ClientData) newCosts;
+    TiSetClient(tile, (ClientData) newCosts);
 
     /* Assign hor and vert costs for tile */
     switch(TiGetType(tile))
@@ -867,7 +867,7 @@ mzDestInitialAssignFunc(tile, cdarg)
     Vertex *v;
 
     /* get lower left vertex */
-    v = &(((TileCosts *)(tile->ti_client))->tc_vxLLeft);
+    v = &(((TileCosts *)(TiGetClient(tile)))->tc_vxLLeft);
 
     /* cost from dest is zero */
     v->vx_cost = 0;
@@ -934,7 +934,7 @@ void
 mzBuildCornerEstimators(tile)
     Tile *tile;
 {
-    TileCosts *tc = (TileCosts *) (tile->ti_client);
+    TileCosts *tc = (TileCosts *) (TiGetClient(tile));
     Vertex *vLLeft = NULL; 
     Vertex *vULeft = NULL; 
     Vertex *vLRight = NULL;
@@ -967,7 +967,7 @@ mzBuildCornerEstimators(tile)
 		else
 		{
 		    /* no 'T', stored with tUp  */
-		    vULeft = &(((TileCosts *)(tUp->ti_client))->tc_vxLLeft);
+		    vULeft = &(((TileCosts *)(TiGetClient(tUp)))->tc_vxLLeft);
 		}
 	    }
 	}
@@ -986,7 +986,7 @@ mzBuildCornerEstimators(tile)
 		else
 		{   
 		    /* no 'T', stored with tRight */
-		    vLRight = &(((TileCosts *)(tRight->ti_client))->tc_vxLLeft);
+		    vLRight = &(((TileCosts *)(TiGetClient(tRight)))->tc_vxLLeft);
 		}
 	    }
 
@@ -998,18 +998,18 @@ mzBuildCornerEstimators(tile)
 		if(RIGHT(tRT)>RIGHT(tile))
 		{
 		    /* upper right at 'T'  stored with tTR */
-		    vURight = &(((TileCosts *)(tTR->ti_client))->tc_vxULeft);
+		    vURight = &(((TileCosts *)(TiGetClient(tTR)))->tc_vxULeft);
 		}
 		else if (TOP(tTR)>TOP(tile))
 		{
 		    /* upper right at 'T'  stored with tRT */
-		    vURight = &(((TileCosts *)(tRT->ti_client))->tc_vxLRight);
+		    vURight = &(((TileCosts *)(TiGetClient(tRT)))->tc_vxLRight);
 		}
 		else 
 		{
 		    /* no 'T', stored in own tile */
 		    NEXT_TILE_UP(tDiag, tTR, RIGHT(tile));
-		    vURight = &(((TileCosts *)(tDiag->ti_client))->tc_vxLLeft);
+		    vURight = &(((TileCosts *)(TiGetClient(tDiag)))->tc_vxLLeft);
 		}
 	    }
 	}
@@ -1095,7 +1095,7 @@ void
 mzBuildStraightShotEstimators(tile)
     Tile *tile;
 {
-    TileCosts *tc = (TileCosts *) (tile->ti_client);
+    TileCosts *tc = (TileCosts *) (TiGetClient(tile));
 
     /* straight right */
     {
@@ -1317,7 +1317,7 @@ mzTrimEstimatesFunc(tile, notUsed)
     Tile *tile;
     ClientData notUsed;
 {
-    TileCosts *tc = (TileCosts *) (tile->ti_client);
+    TileCosts *tc = (TileCosts *) (TiGetClient(tile));
     Estimate *e;
     Estimate *reqEstimates = NULL;
 
@@ -1631,7 +1631,7 @@ mzAddVertex(vxThis, adjHeap)
 	if(TOP(tLeft) < TOP(tLoc))
 	{
 	    /* T from left */
-	    vxAbove = &(((TileCosts *)(RT(tLeft)->ti_client))->tc_vxLRight);
+	    vxAbove = &(((TileCosts *)(TiGetClient(RT(tLeft))))->tc_vxLRight);
 	    yAbove = TOP(tLeft);
 	}
 	else
@@ -1639,13 +1639,13 @@ mzAddVertex(vxThis, adjHeap)
 	    if(LEFT(tAbove)==LEFT(tLoc))
 	    {
 		/* no T */
-		vxAbove = &(((TileCosts *)(tAbove->ti_client))->tc_vxLLeft);
+		vxAbove = &(((TileCosts *)(TiGetClient(tAbove)))->tc_vxLLeft);
 		yAbove = BOTTOM(tAbove);
 	    }
 	    else
 	    { 
 		/* T from bottom */
-		vxAbove = &(((TileCosts *)(tLoc->ti_client))->tc_vxULeft);
+		vxAbove = &(((TileCosts *)(TiGetClient(tLoc)))->tc_vxULeft);
 		yAbove = BOTTOM(tAbove);
 	    }
 	}
@@ -1657,8 +1657,8 @@ mzAddVertex(vxThis, adjHeap)
 
 	    if(yAbove > MAX_FINITE_COORDINATE) goto noAbove;
 
-	    rate =  MIN(((TileCosts *)(tLoc->ti_client))->tc_vCost,
-		    ((TileCosts *)(tLeft->ti_client))->tc_vCost);
+	    rate =  MIN(((TileCosts *)(TiGetClient(tLoc)))->tc_vCost,
+		    ((TileCosts *)(TiGetClient(tLeft)))->tc_vCost);
 
 	    if(rate == INT_MAX) goto noAbove;
 
@@ -1688,7 +1688,7 @@ mzAddVertex(vxThis, adjHeap)
 	if(RIGHT(tBelow) < RIGHT(tLoc))
 	{
 	    /* T from below */
-	    vxRight = &(((TileCosts *)(TR(tBelow)->ti_client))->tc_vxULeft);
+	    vxRight = &(((TileCosts *)(TiGetClient(TR(tBelow))))->tc_vxULeft);
 	    xRight = RIGHT(tBelow);
 	}
 	else
@@ -1696,13 +1696,13 @@ mzAddVertex(vxThis, adjHeap)
 	    if(BOTTOM(tRight)==BOTTOM(tLoc))
 	    {
 		/* no T */
-		vxRight = &(((TileCosts *)(tRight->ti_client))->tc_vxLLeft);
+		vxRight = &(((TileCosts *)(TiGetClient(tRight)))->tc_vxLLeft);
 		xRight = LEFT(tRight);
 	    }
 	    else
 	    { 
 		/* T from left */
-		vxRight = &(((TileCosts *)(tLoc->ti_client))->tc_vxLRight);
+		vxRight = &(((TileCosts *)(TiGetClient(tLoc)))->tc_vxLRight);
 		xRight = LEFT(tRight);
 	    }
 	}
@@ -1715,8 +1715,8 @@ mzAddVertex(vxThis, adjHeap)
 	    if(xRight > MAX_FINITE_COORDINATE) goto noRight;
 
 	    rate =  MIN(
-		    ((TileCosts *)(tLoc->ti_client))->tc_hCost,
-		    ((TileCosts *)(tBelow->ti_client))->tc_hCost);
+		    ((TileCosts *)(TiGetClient(tLoc)))->tc_hCost,
+		    ((TileCosts *)(TiGetClient(tBelow)))->tc_hCost);
 
 	    if(rate == INT_MAX) goto noRight;
 
@@ -1772,13 +1772,13 @@ mzAddVertex(vxThis, adjHeap)
 	if(BOTTOM(tRight) >= BOTTOM(tLoc))
 	{
 	    /* LowerLeft of tRight */
-	    vxBelow = &(((TileCosts *)(tRight->ti_client))->tc_vxLLeft);
+	    vxBelow = &(((TileCosts *)(TiGetClient(tRight)))->tc_vxLLeft);
 	    yBelow = BOTTOM(tRight);
 	}
 	else
 	{
 	    /* T from Left */
-	    vxBelow = &(((TileCosts *)(tLoc->ti_client))->tc_vxLRight);
+	    vxBelow = &(((TileCosts *)(TiGetClient(tLoc)))->tc_vxLRight);
 	    yBelow = BOTTOM(tLoc);
 	}
 
@@ -1790,8 +1790,8 @@ mzAddVertex(vxThis, adjHeap)
 	    if(yBelow < MIN_FINITE_COORDINATE) goto noBelow;
 
 	    rate =  MIN(
-		    ((TileCosts *)(tLoc->ti_client))->tc_vCost,
-		    ((TileCosts *)(tRight->ti_client))->tc_vCost);
+		    ((TileCosts *)(TiGetClient(tLoc)))->tc_vCost,
+		    ((TileCosts *)(TiGetClient(tRight)))->tc_vCost);
 
 	    if(rate == INT_MAX) goto noBelow;
 
@@ -1820,13 +1820,13 @@ mzAddVertex(vxThis, adjHeap)
 	if(LEFT(tAbove) >= LEFT(tLoc))
 	{
 	    /* LowerLeft of tAbove */
-	    vxLeft = &(((TileCosts *)(tAbove->ti_client))->tc_vxLLeft);
+	    vxLeft = &(((TileCosts *)(TiGetClient(tAbove)))->tc_vxLLeft);
 	    xLeft = LEFT(tAbove);
 	}
 	else
 	{
 	    /* T from Bottom */
-	    vxLeft = &(((TileCosts *)(tLoc->ti_client))->tc_vxULeft);
+	    vxLeft = &(((TileCosts *)(TiGetClient(tLoc)))->tc_vxULeft);
 	    xLeft = LEFT(tLoc);
 	}
 
@@ -1838,8 +1838,8 @@ mzAddVertex(vxThis, adjHeap)
 	    if(xLeft < MIN_FINITE_COORDINATE) goto noLeft;
 
 	    rate =  MIN(
-		    ((TileCosts *)(tLoc->ti_client))->tc_hCost,
-		    ((TileCosts *)(tAbove->ti_client))->tc_hCost);
+		    ((TileCosts *)(TiGetClient(tLoc)))->tc_hCost,
+		    ((TileCosts *)(TiGetClient(tAbove)))->tc_hCost);
 
 	    if(rate == INT_MAX) goto noLeft;
 
@@ -1877,7 +1877,7 @@ mzEstimatedCost(point)
     Point *point;
 {
     Tile *t = TiSrPointNoHint(mzEstimatePlane, point);
-    TileCosts *tc = ((TileCosts *) t->ti_client);
+    TileCosts *tc = ((TileCosts *) TiGetClient(t));
     Estimate *e;
     dlong bestCost;
 
@@ -1968,7 +1968,7 @@ mzDumpEstFunc(tile, fd)
     FILE *fd;
 {
     Rect r;
-    TileCosts *tilec = (TileCosts *) tile->ti_client;
+    TileCosts *tilec = (TileCosts *) TiGetClient(tile);
  
     /* Get boundary of tile */
     TITORECT(tile, &r);
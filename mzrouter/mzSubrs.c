@@ -423,7 +423,7 @@ mzConnectedTileFunc(tile, cxp)
      * MZAddStart() and MZAddDest().
      */
 
-    if ((int)tile->ti_client != mzMakeEndpoints)
+    if ((int)TiGetClient(tile) != mzMakeEndpoints)
     {
 	SearchContext *scx = cxp->tc_scx;
 	List *expandList = (List *) (cxp->tc_filter->tf_arg);
@@ -434,7 +434,7 @@ mzConnectedTileFunc(tile, cxp)
 	GEOTRANSRECT(&scx->scx_trans, &rRaw, &r);
 
 	/* mark tile with destination type */
-	tile->ti_client = (ClientData) mzMakeEndpoints;
+	TiSetClient(tile, (ClientData) mzMakeEndpoints);
 
 	/* Add tiles connected to Start to mzStartTerms */
 	/* (Added by Tim, August 2006)			*/
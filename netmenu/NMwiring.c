@@ -1030,7 +1030,15 @@ NMVerify()
      */
     
     nmwVerifyErrors = 0;
+
+    /* Each terminal of each net floods its wiring, so index the
+     * connectivity of the edit cell once for all of them.
+     */
+    if (EditCellUse != NULL)
+	(void) DBConnIndexBuild(EditCellUse->cu_def, DBConnectTbl);
     (void) NMEnumNets(nmwVerifyNetFunc, (ClientData) NULL);
+    if (EditCellUse != NULL)
+	DBConnIndexFree(EditCellUse->cu_def);
 
     /* Free the space allocated for error reporting
     */
@@ -1079,7 +1087,11 @@ NMCull()
      * of finding bad nets and reporting them, find good nets and remove them.
      */
     nmwCullDone = 0;  /* Number of correctly wired nets */
+    if (EditCellUse != NULL)
+	(void) DBConnIndexBuild(EditCellUse->cu_def, DBConnectTbl);
     (void) NMEnumNets(nmwCullNetFunc, (ClientData) NULL);
+    if (EditCellUse != NULL)
+	DBConnIndexFree(EditCellUse->cu_def);
 
     if (nmwCullDone == 0)
 	TxPrintf("No fully-wired nets found.\n");
@@ -314,7 +314,7 @@ plowYankUpdatePaint(yankTp, pNum)
 		(void) plowSplitY(spareTp, TOP(yankTp));
 	    if (BOTTOM(spareTp) < BOTTOM(yankTp))
 		spareTp = plowSplitY(spareTp, BOTTOM(yankTp));
-	    spareTp->ti_client = yankTp->ti_client;
+	    TiSetClient(spareTp, TiGetClient(yankTp));
 	}
 
 	startPoint.p_y = BOTTOM(spareTp) - 1;
@@ -392,6 +392,7 @@ plowUpdateLabels(yankDef, origDef, origArea)
 	    lu.lu_rect.r_xtop += lu.lu_adjust;
 	    DBUndoEraseLabel(origDef, origLab);
 	    GeoTransRect(&plowInverseTrans, &lu.lu_rect, &origLab->lab_rect);
+	    DBLabelIndexUpdate(origDef, origLab);
 	    DBUndoPutLabel(origDef, origLab);
 	    plowLabelsChanged = TRUE;
 	}
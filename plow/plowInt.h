@@ -161,11 +161,11 @@ typedef struct
  * of the tile to its right.
  */
 #define	TRAIL_UNINIT	CLIENTDEFAULT
-#define	TRAILING(tp)	(((tp)->ti_client == (ClientData)TRAIL_UNINIT) \
-				? LEFT(tp) : ((int)(tp)->ti_client))
+#define	TRAILING(tp)	((TiGetClient((tp)) == (ClientData)TRAIL_UNINIT) \
+				? LEFT(tp) : ((int)TiGetClient((tp))))
 #define	LEADING(tp)	TRAILING(TR(tp))
 
-#define	plowSetTrailing(tp, n)	((tp)->ti_client = (ClientData) (n))
+#define	plowSetTrailing(tp, n)	(TiSetClient((tp), (ClientData) (n)))
 
 /* ------------------ Design rules used by plowing -------------------- */
 
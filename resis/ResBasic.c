@@ -48,7 +48,7 @@ resNodeIsPort(node, x, y, tile)
     Rect 	*rect;
     Point 	p;
     resPort 	*pl, *lp;
-    tileJunk	*junk = (tileJunk *)(tile->ti_client);
+    tileJunk	*junk = (tileJunk *)(TiGetClient(tile));
 
     p.p_x = x;
     p.p_y = y;
@@ -92,7 +92,7 @@ resAllPortNodes(tile, list)
     int		x, y;
     resNode	*resptr;
     resPort 	*pl;
-    tileJunk	*junk = (tileJunk *)(tile->ti_client);
+    tileJunk	*junk = (tileJunk *)(TiGetClient(tile));
 
     for (pl = junk->portList; pl; pl = pl->rp_nextPort)
     {
@@ -138,7 +138,7 @@ ResEachTile(tile, startpoint)
     int		xj, yj, i;
     bool	merged;
     tElement	*tcell;
-    tileJunk	*tstructs= (tileJunk *)(tile->ti_client);
+    tileJunk	*tstructs= (tileJunk *)(TiGetClient(tile));
       
     ResTileCount++;
 
@@ -360,7 +360,7 @@ resSubTranFunc(tile,tp)
 	
 
 {
-     tileJunk	*junk = (tileJunk *)(tile->ti_client);
+     tileJunk	*junk = (tileJunk *)(TiGetClient(tile));
      resNode	*resptr;
      tElement	*tcell;
      int	x,y;
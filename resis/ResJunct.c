@@ -57,7 +57,7 @@ ResNewSDTransistor(tile,tp,xj,yj,direction,PendingList)
 	tileJunk	*j;
 	
 	newnode = FALSE;
-	j = (tileJunk *) tp->ti_client;
+	j = (tileJunk *) TiGetClient(tp);
 	resFet = j->transistorList;
 	if ((j->sourceEdge & direction) != 0)
 	{
@@ -120,8 +120,8 @@ ResProcessJunction(tile, tp, xj, yj, NodeList)
 	ResJunction  	*junction;
 	resNode	     	*resptr;
 	jElement     	*jcell;
-	tileJunk	*j0 = (tileJunk *)tile->ti_client;
-	tileJunk	*j2 = (tileJunk *)tp->ti_client;
+	tileJunk	*j0 = (tileJunk *)TiGetClient(tile);
+	tileJunk	*j2 = (tileJunk *)TiGetClient(tp);
 
 #ifdef PARANOID
 	if (tile == tp)
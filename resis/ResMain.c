@@ -284,7 +284,7 @@ ResAddBreakpointFunc(tile, node)
 {
     tileJunk *junk;
 
-    if (tile->ti_client == (ClientData) CLIENTDEFAULT)
+    if (TiGetClient(tile) == (ClientData) CLIENTDEFAULT)
 	return 0;
 
     NEWPORT(node, tile);
@@ -333,7 +333,7 @@ ResFindNewContactTiles(contacts)
 		  if ((IsSplit(tile) && TTMaskHasType(&mask, TiGetRightType(tile)))
 			|| TTMaskHasType(&mask, TiGetType(tile)))
 		  {
-		       tileJunk	*j = (tileJunk *)tile->ti_client;
+		       tileJunk	*j = (tileJunk *)TiGetClient(tile);
 		       cElement *ce;
 		       
 		       ce = (cElement *) mallocMagic((unsigned) (sizeof(cElement)));
@@ -433,7 +433,7 @@ ResProcessTiles(goodies, origin)
 	 {
       	      Tile	*tile = fix->fp_tile;
 
-	      if (tile != NULL && (((tileJunk *)tile->ti_client)->tj_status & 
+	      if (tile != NULL && (((tileJunk *)TiGetClient(tile))->tj_status & 
 			RES_TILE_DONE) == 0)
 	      {
 	           resCurrentNode = fix->fp_node;
@@ -472,7 +472,7 @@ ResProcessTiles(goodies, origin)
 		   for (tilenum = 0; tilenum < TILES_PER_JUNCTION; tilenum++)
 		   {
 	      	        Tile	*tile = rj->rj_Tile[tilenum];
-			tileJunk *j = (tileJunk *) tile->ti_client;
+			tileJunk *j = (tileJunk *) TiGetClient(tile);
 			
 			if ((j->tj_status & RES_TILE_DONE) == 0)
 			{
@@ -499,7 +499,7 @@ ResProcessTiles(goodies, origin)
 		   for (tilenum = 0; tilenum < cp->cp_currentcontact; tilenum++)
 		   {
 	      	        Tile	 *tile = cp->cp_tile[tilenum];
-			tileJunk *j    = (tileJunk *) tile->ti_client;
+			tileJunk *j    = (tileJunk *) TiGetClient(tile);
 
 			if ((j->tj_status & RES_TILE_DONE) == 0)
 			{
@@ -989,11 +989,11 @@ ResGetTransistor(pt)
 	  {
               if (TTMaskHasType(&ExtCurStyle->exts_transMask, TiGetLeftType(tile))
               	   || TTMaskHasType(&ExtCurStyle->exts_transMask, TiGetRightType(tile)))
-                  return(((tileJunk *)tile->ti_client)->transistorList);
+                  return(((tileJunk *)TiGetClient(tile))->transistorList);
 	  }
 	  else if (TTMaskHasType(&ExtCurStyle->exts_transMask, TiGetType(tile)))
           {
-               return(((tileJunk *)tile->ti_client)->transistorList);
+               return(((tileJunk *)TiGetClient(tile))->transistorList);
           }
      }
      return (NULL);
@@ -129,7 +129,7 @@ ResCalcEastWest(tile, pendingList, doneList, resList)
     resElement	*element;
     resNode	*currNode;
     float	rArea;
-    tileJunk	*junk = (tileJunk *)tile->ti_client;
+    tileJunk	*junk = (tileJunk *)TiGetClient(tile);
      
     merged = FALSE;
     height = TOP(tile) - BOTTOM(tile);
@@ -299,7 +299,7 @@ ResCalcNorthSouth(tile, pendingList, doneList, resList)
     resElement	*element;
     resNode	*currNode;
     float	rArea;
-    tileJunk	*junk = (tileJunk *)tile->ti_client;
+    tileJunk	*junk = (tileJunk *)TiGetClient(tile);
      
     merged = FALSE;
     width = RIGHT(tile)-LEFT(tile);
@@ -468,7 +468,7 @@ ResCalcNearTransistor(tile, pendingList, doneList, resList)
      bool 		merged;
      int		trancount,tranedge,deltax,deltay;
      Breakpoint		*p1,*p2,*p3;
-     tileJunk		*junk = (tileJunk *)tile->ti_client;
+     tileJunk		*junk = (tileJunk *)TiGetClient(tile);
      
      
      merged = FALSE;
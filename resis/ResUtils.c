@@ -149,7 +149,7 @@ ResAddPlumbing(tile, arg)
      {
      	  resTransStack = StackNew(64);
      }
-     if (tile->ti_client == (ClientData) CLIENTDEFAULT)
+     if (TiGetClient(tile) == (ClientData) CLIENTDEFAULT)
      {
 	if (IsSplit(tile))
 	{
@@ -339,12 +339,12 @@ ResAddPlumbing(tile, arg)
 		    else
 		        t1 = TiGetTypeExact(tp1);
 
-		    j0 = (tileJunk *) tp1->ti_client;
+		    j0 = (tileJunk *) TiGetClient(tp1);
 		    /* top */
 		    for (tp2= RT(tp1); RIGHT(tp2) > LEFT(tp1); tp2 = BL(tp2))
 		    {
 		     	  if ((TiGetBottomType(tp2) == t1) &&
-			      (tp2->ti_client == (ClientData) CLIENTDEFAULT))
+			      (TiGetClient(tp2) == (ClientData) CLIENTDEFAULT))
 			       {
      	  			    Junk = resAddField(tp2);
 				    STACKPUSH((ClientData)(tp2),resTransStack);
@@ -366,7 +366,7 @@ ResAddPlumbing(tile, arg)
 		     for (tp2= LB(tp1); LEFT(tp2) < RIGHT(tp1); tp2 = TR(tp2))
 		     {
 		     	  if ((TiGetTopType(tp2) == t1) &&
-			      (tp2->ti_client == (ClientData) CLIENTDEFAULT))
+			      (TiGetClient(tp2) == (ClientData) CLIENTDEFAULT))
 			       {
      	  			    Junk = resAddField(tp2);
 				    STACKPUSH((ClientData)(tp2),resTransStack);
@@ -387,7 +387,7 @@ ResAddPlumbing(tile, arg)
 		     for (tp2= TR(tp1); TOP(tp2) > BOTTOM(tp1); tp2 = LB(tp2))
 		     {
 		     	  if ((TiGetLeftType(tp2) == t1) &&
-			      (tp2->ti_client == (ClientData) CLIENTDEFAULT))
+			      (TiGetClient(tp2) == (ClientData) CLIENTDEFAULT))
 			       {
      	  			    Junk = resAddField(tp2);
 				    STACKPUSH((ClientData)(tp2),resTransStack);
@@ -408,7 +408,7 @@ ResAddPlumbing(tile, arg)
 		     for (tp2= BL(tp1); BOTTOM(tp2) < TOP(tp1); tp2 = RT(tp2))
 		     {
 		     	  if ((TiGetRightType(tp2) == t1) &&
-			      (tp2->ti_client == (ClientData) CLIENTDEFAULT))
+			      (TiGetClient(tp2) == (ClientData) CLIENTDEFAULT))
 			       {
      	  			    Junk = resAddField(tp2);
 				    STACKPUSH((ClientData)(tp2),resTransStack);
@@ -431,7 +431,7 @@ ResAddPlumbing(tile, arg)
 
 	       if (source != (Tile *) NULL)
 	       {
-	            tileJunk	*j = (tileJunk *) source->ti_client;
+	            tileJunk	*j = (tileJunk *) TiGetClient(source);
 
 		    STACKPUSH((ClientData) (source),resTransStack);
 		    j->tj_status &= ~RES_TILE_SD;
@@ -450,7 +450,7 @@ ResAddPlumbing(tile, arg)
 		     /* top */
 		     for (tp2= RT(tp1); RIGHT(tp2) > LEFT(tp1); tp2 = BL(tp2))
 		     {
-		          tileJunk	*j2 = (tileJunk *) tp2->ti_client;
+		          tileJunk	*j2 = (tileJunk *) TiGetClient(tp2);
 			  if (TiGetBottomType(tp2) == t1)
 		          {
 			       if (j2->tj_status & RES_TILE_SD)
@@ -463,7 +463,7 @@ ResAddPlumbing(tile, arg)
 		     /*bottom*/
 		     for(tp2= LB(tp1); LEFT(tp2) < RIGHT(tp1); tp2 = TR(tp2))
 		     {
-		          tileJunk	*j2 = (tileJunk *) tp2->ti_client;
+		          tileJunk	*j2 = (tileJunk *) TiGetClient(tp2);
 		          if (TiGetTopType(tp2) == t1)
 		          {
 			       if (j2->tj_status & RES_TILE_SD)
@@ -476,7 +476,7 @@ ResAddPlumbing(tile, arg)
 		     /*right*/
 		     for (tp2= TR(tp1); TOP(tp2) > BOTTOM(tp1); tp2 = LB(tp2))
 		     {
-		          tileJunk	*j2 = (tileJunk *) tp2->ti_client;
+		          tileJunk	*j2 = (tileJunk *) TiGetClient(tp2);
 		          if (TiGetLeftType(tp2) == t1)
 		          {
 			       if (j2->tj_status & RES_TILE_SD)
@@ -489,7 +489,7 @@ ResAddPlumbing(tile, arg)
 		     /*left*/
 		     for (tp2= BL(tp1); BOTTOM(tp2) < TOP(tp1); tp2 = RT(tp2))
 		     {
-		          tileJunk	*j2 = (tileJunk *) tp2->ti_client;
+		          tileJunk	*j2 = (tileJunk *) TiGetClient(tp2);
 		          if (TiGetRightType(tp2) == t1)
 		          {
 			       if (j2->tj_status & RES_TILE_SD)
@@ -524,10 +524,10 @@ ResRemovePlumbing(tile, arg)
 
 {
      
-     if (tile->ti_client != (ClientData) CLIENTDEFAULT)
+     if (TiGetClient(tile) != (ClientData) CLIENTDEFAULT)
      {
-          freeMagic(((char *)(tile->ti_client)));
-	  tile->ti_client = (ClientData) CLIENTDEFAULT;
+          freeMagic(((char *)(TiGetClient(tile))));
+	  TiSetClient(tile, (ClientData) CLIENTDEFAULT);
      }
      return(0);
 }
@@ -592,7 +592,7 @@ ResPreProcessTransistors(TileList, TransistorList, Def)
 	GOTOPOINT(tile, &(TileList->area.r_ll));
 
 	tt = TiGetType(tile);
-	tstruct = (tileJunk *) tile->ti_client;
+	tstruct = (tileJunk *) TiGetClient(tile);
 
 	if (!TTMaskHasType(&ExtCurStyle->exts_transMask, tt) ||
 				tstruct->transistorList == NULL)
@@ -715,11 +715,11 @@ resAddField(tile)
 
 {
         tileJunk *Junk;
-	if ((Junk=(tileJunk *)tile->ti_client) == (tileJunk *) CLIENTDEFAULT)
+	if ((Junk=(tileJunk *)TiGetClient(tile)) == (tileJunk *) CLIENTDEFAULT)
 	{
      	      Junk = (tileJunk *) mallocMagic((unsigned) (sizeof(tileJunk)));
 	      ResJunkInit(Junk);
-	      tile->ti_client = (ClientData) Junk;
+	      TiSetClient(tile, (ClientData) Junk);
 	}
 	return Junk;
 }
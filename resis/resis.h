@@ -660,7 +660,7 @@ extern void			ResSortBreaks();
 #define NEWBREAK(node,tile,px,py,crect)\
 {\
 	Breakpoint	*bp;\
-	tileJunk *jX_ = (tileJunk *)((tile)->ti_client); \
+	tileJunk *jX_ = (tileJunk *)(TiGetClient((tile))); \
 	bp = (Breakpoint *) mallocMagic((unsigned)(sizeof(Breakpoint))); \
         bp->br_next= jX_->breakList; \
 	bp->br_this = (node); \
@@ -673,7 +673,7 @@ extern void			ResSortBreaks();
 #define NEWPORT(node,tile)\
 {\
 	resPort		*rp;\
-	tileJunk *pX_ = (tileJunk *)((tile)->ti_client); \
+	tileJunk *pX_ = (tileJunk *)(TiGetClient((tile))); \
 	rp = (resPort *) mallocMagic((unsigned)(sizeof(resPort))); \
 	rp->rp_nextPort = pX_->portList; \
 	rp->rp_bbox = node->rs_bbox; \
@@ -286,7 +286,7 @@ rtrSideInitClient(tile, client)
     Tile *tile;
     ClientData client;
 {
-    tile->ti_client = client;
+    TiSetClient(tile, client);
     return (0);
 }
 
@@ -320,7 +320,7 @@ rtrEnumSidesFunc(tile)
     Side side;
 
     /* Skip if already processed, out of the area, or not a cell tile */
-    yprev = (int) tile->ti_client;
+    yprev = (int) TiGetClient(tile);
     ybot = MAX(BOTTOM(tile), rtrSideArea.r_ybot);
     if (yprev <= ybot || tile->ti_body == (ClientData) NULL
 	    || RIGHT(tile) >= rtrSideArea.r_xtop)
@@ -389,7 +389,7 @@ rtrEnumSidesFunc(tile)
 	if (LEFT(tp) != RIGHT(tile) || TOP(tp) <= ybot)
 	{
 	    /* Processed this tile completely */
-	    tile->ti_client = (ClientData) ybot;
+	    TiSetClient(tile, (ClientData) ybot);
 	    return (0);
 	}
     }
@@ -438,7 +438,7 @@ rtrEnumSidesFunc(tile)
 	    else
 	    {
 		side.side_line.r_ytop = MIN(TOP(tp), ytop);
-		tp->ti_client = (ClientData) ybot;
+		TiSetClient(tp, (ClientData) ybot);
 	    }
 	}
     }
@@ -559,7 +559,7 @@ rtrStemTryPin(loc, dir, p, use)
     tp = TiSrPointNoHint(RtrChannelPlane, &pSearch);
     if (TiGetType(tp) != TT_SPACE)
 	return ((GCRPin *) NULL);
-    ch = (GCRChannel *) tp->ti_client;
+    ch = (GCRChannel *) TiGetClient(tp);
     if (ch == (GCRChannel *) NULL || ch->gcr_type != CHAN_NORMAL)
 	return ((GCRPin *) NULL);
 
@@ -946,7 +946,7 @@ rtrStemSearch(center, dir, point)
 	tile = TiSrPointNoHint(RtrChannelPlane, point);
 	if (TiGetType(tile) == TT_SPACE)
 	{
-	    if (ch = (GCRChannel *) tile->ti_client)
+	    if (ch = (GCRChannel *) TiGetClient(tile))
 		break;
 	    return ((GCRChannel *) NULL);
 	}
@@ -288,13 +288,13 @@ rtrSrTraverseFunc(tile, ts)
 
     if (csa->csa_clear)
     {
-	if (tile->ti_client == (ClientData) CLIENTDEFAULT) return 0;
-	tile->ti_client = (ClientData) CLIENTDEFAULT;
+	if (TiGetClient(tile) == (ClientData) CLIENTDEFAULT) return 0;
+	TiSetClient(tile, (ClientData) CLIENTDEFAULT);
     }
     else
     {
-	if (tile->ti_client != (ClientData) CLIENTDEFAULT) return 0;
-	tile->ti_client = (ClientData) 1;
+	if (TiGetClient(tile) != (ClientData) CLIENTDEFAULT) return 0;
+	TiSetClient(tile, (ClientData) 1);
     }
 
     /* Call the client function, if there is one. */
@@ -320,9 +320,9 @@ rtrSrTraverseFunc(tile, ts)
 	{
 	    if (csa->csa_clear)
 	    {
-		if (t2->ti_client == (ClientData) CLIENTDEFAULT) continue;
+		if (TiGetClient(t2) == (ClientData) CLIENTDEFAULT) continue;
 	    }
-	    else if (t2->ti_client != (ClientData) CLIENTDEFAULT) continue;
+	    else if (TiGetClient(t2) != (ClientData) CLIENTDEFAULT) continue;
 	    if (rtrSrTraverseFunc(t2, &nts) != 0) return 1;
 	}
     }
@@ -335,9 +335,9 @@ rtrSrTraverseFunc(tile, ts)
 	{
 	    if (csa->csa_clear)
 	    {
-		if (t2->ti_client == (ClientData) CLIENTDEFAULT) continue;
+		if (TiGetClient(t2) == (ClientData) CLIENTDEFAULT) continue;
 	    }
-	    else if (t2->ti_client != (ClientData) CLIENTDEFAULT) continue;
+	    else if (TiGetClient(t2) != (ClientData) CLIENTDEFAULT) continue;
 	    if (rtrSrTraverseFunc(t2, &nts) != 0) return 1;
 	}
     }
@@ -350,9 +350,9 @@ rtrSrTraverseFunc(tile, ts)
 	{
 	    if (csa->csa_clear)
 	    {
-		if (t2->ti_client == (ClientData) CLIENTDEFAULT) goto nextRight;
+		if (TiGetClient(t2) == (ClientData) CLIENTDEFAULT) goto nextRight;
 	    }
-	    else if (t2->ti_client != (ClientData) CLIENTDEFAULT) goto nextRight;
+	    else if (TiGetClient(t2) != (ClientData) CLIENTDEFAULT) goto nextRight;
 	    if (rtrSrTraverseFunc(t2, &nts) != 0) return 1;
 	}
 	nextRight: if (BOTTOM(t2) <= tileArea.r_ybot) break;
@@ -366,9 +366,9 @@ rtrSrTraverseFunc(tile, ts)
 	{
 	    if (csa->csa_clear)
 	    {
-		if (t2->ti_client == (ClientData) CLIENTDEFAULT) goto nextTop;
+		if (TiGetClient(t2) == (ClientData) CLIENTDEFAULT) goto nextTop;
 	    }
-	    else if (t2->ti_client != (ClientData) CLIENTDEFAULT) goto nextTop;
+	    else if (TiGetClient(t2) != (ClientData) CLIENTDEFAULT) goto nextTop;
 	    if (rtrSrTraverseFunc(t2, &nts) != 0) return 1;
 	}
 	nextTop: if (LEFT(t2) <= tileArea.r_xbot) break;
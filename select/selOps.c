@@ -22,6 +22,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #endif  /* not lint */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "utils/magic.h"
 #include "utils/geometry.h"
@@ -275,7 +276,7 @@ SelectFlat()
     scx.scx_use = SelectUse;
     scx.scx_area = SelectUse->cu_bbox;
     GeoTransTrans(&GeoIdentityTransform, &SelectUse->cu_transform, &scx.scx_trans);
-    DBCellCopyAllPaint(&scx, &DBAllButSpaceAndDRCBits, CU_DESCEND_ALL, Select2Use);
+    DBCellShareAllPaint(&scx, &DBAllButSpaceAndDRCBits, CU_DESCEND_ALL, Select2Use);
     FlatCopyAllLabels(&scx, &DBAllTypeBits, CU_DESCEND_ALL, Select2Use);
     DBReComputeBbox(Select2Def);
     UndoEnable();
@@ -379,7 +380,7 @@ selShortFindPath(tile, pnum, rlist, fdir)
     newrrec->r_next = *rlist;
     *rlist = newrrec;
 
-    if ((int)tile->ti_client == 0) return 0;	/* We're done */
+    if ((int)TiGetClient(tile) == 0) return 0;	/* We're done */
     // if (mincost == 0) return 0;		/* We're done */
     minp = pnum;
 
@@ -393,10 +394,10 @@ selShortFindPath(tile, pnum, rlist, fdir)
 
     for (tp = RT(tile); RIGHT(tp) > LEFT(tile); tp = BL(tp))
     {
-	if (tp->ti_client == (ClientData)CLIENTDEFAULT) continue;
-	if ((int)tp->ti_client < mincost)
+	if (TiGetClient(tp) == (ClientData)CLIENTDEFAULT) continue;
+	if ((int)TiGetClient(tp) < mincost)
 	{
-	    mincost = (int)tp->ti_client;
+	    mincost = (int)TiGetClient(tp);
 	    mintp = tp;
 	    mindir = GEO_NORTH;
 	}
@@ -413,10 +414,10 @@ leftside:
 
     for (tp = BL(tile); BOTTOM(tp) < TOP(tile); tp = RT(tp))
     {
-	if (tp->ti_client == (ClientData)CLIENTDEFAULT) continue;
-	if ((int)tp->ti_client < mincost)
+	if (TiGetClient(tp) == (ClientData)CLIENTDEFAULT) continue;
+	if ((int)TiGetClient(tp) < mincost)
 	{
-	    mincost = (int)tp->ti_client;
+	    mincost = (int)TiGetClient(tp);
 	    mintp = tp;
 	    mindir = GEO_WEST;
 	}
@@ -433,10 +434,10 @@ bottomside:
 
     for (tp = LB(tile); LEFT(tp) < RIGHT(tile); tp = TR(tp))
     {
-	if (tp->ti_client == (ClientData)CLIENTDEFAULT) continue;
-	if ((int)tp->ti_client < mincost)
+	if (TiGetClient(tp) == (ClientData)CLIENTDEFAULT) continue;
+	if ((int)TiGetClient(tp) < mincost)
 	{
-	    mincost = (int)tp->ti_client;
+	    mincost = (int)TiGetClient(tp);
 	    mintp = tp;
 	    mindir = GEO_SOUTH;
 	}
@@ -453,10 +454,10 @@ rightside:
 
     for (tp = TR(tile); TOP(tp) > BOTTOM(tile); tp = LB(tp))
     {
-	if (tp->ti_client == (ClientData)CLIENTDEFAULT) continue;
-	if ((int)tp->ti_client < mincost)
+	if (TiGetClient(tp) == (ClientData)CLIENTDEFAULT) continue;
+	if ((int)TiGetClient(tp) < mincost)
 	{
-	    mincost = (int)tp->ti_client;
+	    mincost = (int)TiGetClient(tp);
 	    mintp = tp;
 	    mindir = GEO_EAST;
 	}
@@ -475,10 +476,10 @@ donesides:
 	    {
 		tp = SelectDef->cd_planes[p]->pl_hint;
 		GOTOPOINT(tp, &tile->ti_ll);
-		if (tp->ti_client == (ClientData)CLIENTDEFAULT) continue;
-		if ((int)tp->ti_client < mincost)
+		if (TiGetClient(tp) == (ClientData)CLIENTDEFAULT) continue;
+		if ((int)TiGetClient(tp) < mincost)
 		{
-		    mincost = (int)tp->ti_client;
+		    mincost = (int)TiGetClient(tp);
 		    mintp = tp;
 		    minp = p;
 		    mindir = GEO_CENTER;
@@ -495,7 +496,7 @@ donesides:
 
     /* Stopgap measure:  Error should not happen, but it does!	*/
     /* Remove client data of current tile and take minimum.	*/
-    if (mincost == (int)tile->ti_client) TiSetClient(tile, CLIENTDEFAULT);
+    if (mincost == (int)TiGetClient(tile)) TiSetClient(tile, CLIENTDEFAULT);
 
     /* Now we have the minimum cost neighboring tile;  recursively search it */
 
@@ -569,9 +570,9 @@ selShortFindNext(tile, pnum, ldest, cost, best, fdir, mask)
     /* If this tile is unvisited, or has a lower cost, then return and	*/
     /* keep going.  Otherwise, return 1 to stop the search this direction */
 
-    if (tile->ti_client == (ClientData)CLIENTDEFAULT)
+    if (TiGetClient(tile) == (ClientData)CLIENTDEFAULT)
 	TiSetClient(tile, cost);
-    else if ((int)tile->ti_client > cost)
+    else if ((int)TiGetClient(tile) > cost)
 	TiSetClient(tile, cost);
     else
 	return 0;
@@ -693,6 +694,20 @@ donesrch:
  * ----------------------------------------------------------------------------
  */
 
+/*
+ * Function called by DBSrLabelName() for SelectShort() to record the
+ * first label found with a given name.
+ */
+
+int
+selShortLabelFunc(lab, plab)
+    Label *lab;
+    Label **plab;
+{
+    *plab = lab;
+    return 1;
+}
+
 ExtRectList *
 SelectShort(char *lab1, char *lab2)
 {
@@ -704,16 +719,27 @@ SelectShort(char *lab1, char *lab2)
     ExtRectList *rlist;
 
     /* Step one: find the tiles containing the labels.  If not found,	*/
-    /* return NULL.							*/
+    /* return NULL.  Plain names are looked up directly;  patterns	*/
+    /* have to be matched against every label.				*/
 
-    for (selLabel = SelectDef->cd_labels; selLabel != NULL; selLabel =
-	selLabel->lab_next)
+    if (strpbrk(lab1, "*?[\\") == NULL && strpbrk(lab2, "*?[\\") == NULL)
+    {
+	(void) DBSrLabelName(SelectDef, lab1, selShortLabelFunc,
+		(ClientData) &srclab);
+	(void) DBSrLabelName(SelectDef, lab2, selShortLabelFunc,
+		(ClientData) &destlab);
+    }
+    else
     {
-	if ((srclab == NULL) && Match(lab1, selLabel->lab_text))
-	    srclab = selLabel;
+	for (selLabel = SelectDef->cd_labels; selLabel != NULL; selLabel =
+		selLabel->lab_next)
+	{
+	    if ((srclab == NULL) && Match(lab1, selLabel->lab_text))
+		srclab = selLabel;
 
-	if ((destlab == NULL) && Match(lab2, selLabel->lab_text))
-	    destlab = selLabel;
+	    if ((destlab == NULL) && Match(lab2, selLabel->lab_text))
+		destlab = selLabel;
+	}
     }
 
     /* Must be able to find both labels */
@@ -750,7 +776,7 @@ SelectShort(char *lab1, char *lab2)
 	}
     }
 
-    if (tile->ti_client == (ClientData)CLIENTDEFAULT) return NULL;
+    if (TiGetClient(tile) == (ClientData)CLIENTDEFAULT) return NULL;
 
     /* Now find the shortest path between source and destination */
     rlist = NULL;
@@ -959,6 +959,7 @@ SimPutLabel(cellDef, rect, align, text, type)
 	cellDef->cd_lastLabel->lab_next = lab;
     }
     cellDef->cd_lastLabel = lab;
+    DBLabelIndexFree(cellDef);
 
     DBUndoPutLabel(cellDef, lab);
     return align;
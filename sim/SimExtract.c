@@ -366,7 +366,7 @@ int SimTransTerms( bp, trans )
     TransTerm	*term;
     Tile	*tile = bp->b_outside;
     TileType	type;
-    NodeRegion	*reg = (NodeRegion *) tile->ti_client;
+    NodeRegion	*reg = (NodeRegion *) TiGetClient(tile);
     int		pNum;
     int		i;
 
@@ -582,7 +582,7 @@ SimFindOneNode( sx, tile )
 	transistor.t_pnum = DBNumPlanes;
 	transistor.t_do_terms = FALSE;
 
-	gateTile->ti_client = (ClientData) extUnInit;
+	TiSetClient(gateTile, (ClientData) extUnInit);
 	arg.fra_connectsTo = &SimTransMask;
 
 	if (IsSplit(tile))
@@ -631,7 +631,7 @@ SimFindOneNode( sx, tile )
 	    loctype = TiGetTypeExact(sdTile);
 
 	arg.fra_pNum = DBPlane(loctype);
-	arg.fra_uninit = (ClientData) sdTile->ti_client;
+	arg.fra_uninit = (ClientData) TiGetClient(sdTile);
 	arg.fra_region = (Region *) &ret;
 	arg.fra_each = SimTransistorTile;
 	(void) ExtFindNeighbors( sdTile, arg.fra_pNum, &arg );
@@ -710,7 +710,7 @@ SimGetNodeName(sx, tp, path)
 
     /* check to see if this tile has been extracted before */
 
-    if (tp->ti_client == extUnInit)
+    if (TiGetClient(tp) == extUnInit)
     {
 	NodeSpec  *ns;
 
@@ -724,7 +724,7 @@ SimGetNodeName(sx, tp, path)
     }
     else
     {
-	nodeList = (NodeRegion *)(tp->ti_client);
+	nodeList = (NodeRegion *)(TiGetClient(tp));
     }
 
     /* generate the node name from the label region and the path name */
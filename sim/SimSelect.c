@@ -331,7 +331,7 @@ SimSelectFunc(tile, pHead)
 
     /* check to see if the node has already been extracted */
 
-    if (tile->ti_client == (ClientData) 1) {
+    if (TiGetClient(tile) == (ClientData) 1) {
 	return(0);
     }
 
@@ -0,0 +1,626 @@
+/*
+ * build.c --
+ *
+ * Construction of a whole tile plane at once.
+ *
+ * Many operations fill an empty plane with a copy of the contents
+ * of another plane, possibly transformed:  scaling, yanking into a
+ * buffer cell, and so on.  Painting the tiles in one by one means
+ * that every rectangle splits and re-merges the tiles it lands in.
+ * The procedures here instead collect the rectangles, and then
+ * generate the final maximal horizontal strips, with all of their
+ * corner stitches, in a single top-to-bottom sweep.
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/magic.h"
+#include "utils/malloc.h"
+#include "utils/geometry.h"
+#include "tiles/tile.h"
+
+/* A rectangle waiting to be built into the plane */
+
+typedef struct
+{
+    Rect	 br_rect;	/* Area, clipped to TiPlaneRect */
+    ClientData	 br_body;	/* Body of the tiles that will cover it */
+} BuildRect;
+
+/* A piece of one row of tiles:  an interval and its body */
+
+typedef struct
+{
+    int		 bs_xbot, bs_xtop;
+    ClientData	 bs_body;
+} BuildSeg;
+
+struct tileBuilder
+{
+    Plane	 *tb_plane;	/* Plane being built */
+    Tile	 *tb_space;	/* The plane's only tile when building started */
+    BuildRect	 *tb_rects;	/* Rectangles added so far */
+    int		  tb_count;	/* Entries used in tb_rects */
+    int		  tb_size;	/* Entries allocated in tb_rects */
+
+    /* The remaining fields are used only by TiBuildFinish() */
+
+    BuildRect	**tb_active;	/* Rectangles crossing the current row,
+				 * sorted by left edge.
+				 */
+    int		  tb_nActive;
+    Tile	**tb_row;	/* Tiles crossing the current row, left
+				 * to right.
+				 */
+    int		  tb_nRow, tb_rowSize;
+    Tile	**tb_newRow;	/* Tiles of the next row down */
+    int		  tb_nNewRow, tb_newRowSize;
+    BuildSeg	 *tb_dirty;	/* X ranges changing at this row boundary */
+    int		  tb_nDirty, tb_dirtySize;
+    BuildSeg	 *tb_segs;	/* Contents of the row over one range */
+    int		  tb_nSegs, tb_segsSize;
+    Tile	**tb_closed;	/* Tiles ending at this row boundary */
+    int		  tb_nClosed, tb_closedSize;
+    int		 *tb_created;	/* Indices in tb_newRow of new tiles */
+    int		  tb_nCreated, tb_createdSize;
+};
+
+/* -------------------- Local function headers ------------------------ */
+
+static void tiBuildRow();
+static void *tiBuildGrow();
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiBuildStart --
+ *
+ * Begin building the contents of an empty plane.  The rectangles of
+ * the new contents are then given to TiBuildRect(), in any order, and
+ * TiBuildFinish() creates the tiles.  The plane must not be searched
+ * or modified until TiBuildFinish() has been called.
+ *
+ * Results:
+ *	A TileBuilder for the plane, or NULL if the plane is not
+ *	empty, i.e., does not consist of one single tile.  In the
+ *	latter case the caller has to paint into the plane instead.
+ *
+ * Side effects:
+ *	Allocates memory.
+ *
+ * --------------------------------------------------------------------
+ */
+
+TileBuilder *
+TiBuildStart(plane)
+    Plane *plane;	/* Plane to be filled */
+{
+    TileBuilder *tb;
+    Tile *tile;
+
+    TiPlaneModify(plane);
+    tile = TR(plane->pl_left);
+    if (TR(tile) != plane->pl_right || RT(tile) != plane->pl_top
+	    || LB(tile) != plane->pl_bottom || BL(tile) != plane->pl_left)
+	return (TileBuilder *) NULL;
+
+    tb = (TileBuilder *) mallocMagic(sizeof (TileBuilder));
+    bzero((char *) tb, sizeof (TileBuilder));
+    tb->tb_plane = plane;
+    tb->tb_space = tile;
+    return tb;
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiBuildRect --
+ *
+ * Add a rectangle to the contents of a plane being built.  All the
+ * rectangles given to one TileBuilder must be disjoint (they may
+ * share edges);  where two of them do overlap, the one whose left
+ * edge is further left covers the overlap.  Rectangles whose body
+ * is the same as that of the plane's original tile are ignored, as
+ * are rectangles of zero area.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Records the rectangle, clipped to TiPlaneRect.
+ *
+ * --------------------------------------------------------------------
+ */
+
+void
+TiBuildRect(tb, rect, body)
+    TileBuilder *tb;	/* Builder from TiBuildStart() */
+    Rect *rect;		/* Area to be covered */
+    ClientData body;	/* Body for the tiles covering it */
+{
+    BuildRect *br;
+    Rect r;
+
+    if (body == TiGetBody(tb->tb_space)) return;
+
+    r = *rect;
+    GeoClip(&r, &TiPlaneRect);
+    if (r.r_xbot >= r.r_xtop || r.r_ybot >= r.r_ytop) return;
+
+    if (tb->tb_count == tb->tb_size)
+	tb->tb_rects = (BuildRect *) tiBuildGrow(tb->tb_rects, tb->tb_count,
+		&tb->tb_size, sizeof (BuildRect));
+    br = &tb->tb_rects[tb->tb_count++];
+    br->br_rect = r;
+    br->br_body = body;
+}
+
+/* Sort orders:  by top and by bottom, both descending, and by left edge */
+
+static int
+tiBuildCmpTop(p1, p2)
+    BuildRect **p1, **p2;
+{
+    int y1 = (*p1)->br_rect.r_ytop, y2 = (*p2)->br_rect.r_ytop;
+
+    return (y1 > y2) ? -1 : (y1 < y2) ? 1 : 0;
+}
+
+static int
+tiBuildCmpBot(p1, p2)
+    BuildRect **p1, **p2;
+{
+    int y1 = (*p1)->br_rect.r_ybot, y2 = (*p2)->br_rect.r_ybot;
+
+    return (y1 > y2) ? -1 : (y1 < y2) ? 1 : 0;
+}
+
+static int
+tiBuildCmpSeg(s1, s2)
+    BuildSeg *s1, *s2;
+{
+    return (s1->bs_xbot < s2->bs_xbot) ? -1 :
+		(s1->bs_xbot > s2->bs_xbot) ? 1 : 0;
+}
+
+/*
+ * tiBuildGrow --
+ *
+ * Double the size of a growable array, keeping its first "count"
+ * entries.  Returns the new array and updates *size.
+ */
+
+static void *
+tiBuildGrow(array, count, size, elsize)
+    void *array;	/* Array to grow, or NULL */
+    int count;		/* Entries in use */
+    int *size;		/* Entries allocated;  updated */
+    int elsize;		/* Size of one entry */
+{
+    char *newarray;
+
+    *size = (*size == 0) ? 16 : (*size * 2);
+    newarray = (char *) mallocMagic((unsigned) (*size * elsize));
+    if (count > 0)
+	memcpy(newarray, array, count * elsize);
+    if (array != NULL)
+	freeMagic((char *) array);
+    return (void *) newarray;
+}
+
+/*
+ * tiBuildFind --
+ *
+ * Return the index of the tile of a row (sorted left to right) that
+ * contains the x coordinate "x".
+ */
+
+static int
+tiBuildFind(row, nRow, x)
+    Tile **row;
+    int nRow;
+    int x;
+{
+    int lo = 0, hi = nRow - 1, mid;
+
+    while (lo < hi)
+    {
+	mid = (lo + hi + 1) / 2;
+	if (LEFT(row[mid]) <= x)
+	    lo = mid;
+	else
+	    hi = mid - 1;
+    }
+    return lo;
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiBuildFinish --
+ *
+ * Create the tiles for all the rectangles given to TiBuildRect(),
+ * and free the TileBuilder.
+ *
+ * The plane is swept from top to bottom, stopping at each y where
+ * some rectangle starts or ends.  Between stops, the tiles crossing
+ * the sweep line are kept in a row, left to right.  At a stop, only
+ * the parts of the row that change are rebuilt:  the tiles there
+ * get their bottom edge, and new tiles are started below them,
+ * unless a tile below would have exactly the same extent and body
+ * as the one above, in which case the tile above simply continues.
+ * Since every row is made of maximal horizontal strips, the result
+ * is the same plane that painting the rectangles one at a time
+ * would have produced.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Fills the plane.  The plane's original tile is kept as the
+ *	top-most tile.  New tiles have their client field set to
+ *	CLIENTDEFAULT.
+ *
+ * --------------------------------------------------------------------
+ */
+
+void
+TiBuildFinish(tb)
+    TileBuilder *tb;	/* Builder from TiBuildStart();  freed */
+{
+    Plane *plane = tb->tb_plane;
+    BuildRect **byTop, **byBot, *br;
+    Tile *tp;
+    int n = tb->tb_count;
+    int ti, bi, i, j, lo, hi, y;
+
+    if (n == 0) goto done;
+
+    byTop = (BuildRect **) mallocMagic((unsigned) (n * sizeof (BuildRect *)));
+    byBot = (BuildRect **) mallocMagic((unsigned) (n * sizeof (BuildRect *)));
+    tb->tb_active = (BuildRect **) mallocMagic((unsigned)
+		(n * sizeof (BuildRect *)));
+    for (i = 0; i < n; i++)
+	byTop[i] = byBot[i] = &tb->tb_rects[i];
+    qsort((char *) byTop, n, sizeof (BuildRect *), tiBuildCmpTop);
+    qsort((char *) byBot, n, sizeof (BuildRect *), tiBuildCmpBot);
+
+    /* The first row is the plane's original tile, all the way across */
+    tb->tb_row = (Tile **) tiBuildGrow((char *) NULL, 0, &tb->tb_rowSize,
+		sizeof (Tile *));
+    tb->tb_row[0] = tb->tb_space;
+    tb->tb_nRow = 1;
+    tb->tb_nActive = 0;
+
+    ti = bi = 0;
+    while (bi < n)
+    {
+	y = byBot[bi]->br_rect.r_ybot;
+	if (ti < n && byTop[ti]->br_rect.r_ytop > y)
+	    y = byTop[ti]->br_rect.r_ytop;
+
+	/* Nothing is ever built below the bottom of TiPlaneRect */
+	if (y <= TiPlaneRect.r_ybot) break;
+
+	tb->tb_nDirty = 0;
+
+	/* Rectangles ending at y leave the active list */
+	for ( ; bi < n && byBot[bi]->br_rect.r_ybot == y; bi++)
+	{
+	    br = byBot[bi];
+	    lo = 0;
+	    hi = tb->tb_nActive;
+	    while (lo < hi)
+	    {
+		j = (lo + hi) / 2;
+		if (tb->tb_active[j]->br_rect.r_xbot < br->br_rect.r_xbot)
+		    lo = j + 1;
+		else
+		    hi = j;
+	    }
+	    while (tb->tb_active[lo] != br) lo++;
+	    tb->tb_nActive--;
+	    memmove(&tb->tb_active[lo], &tb->tb_active[lo + 1],
+			(tb->tb_nActive - lo) * sizeof (BuildRect *));
+
+	    if (tb->tb_nDirty == tb->tb_dirtySize)
+		tb->tb_dirty = (BuildSeg *) tiBuildGrow(tb->tb_dirty,
+			tb->tb_nDirty, &tb->tb_dirtySize, sizeof (BuildSeg));
+	    tb->tb_dirty[tb->tb_nDirty].bs_xbot = br->br_rect.r_xbot;
+	    tb->tb_dirty[tb->tb_nDirty++].bs_xtop = br->br_rect.r_xtop;
+	}
+
+	/* Rectangles starting at y join it */
+	for ( ; ti < n && byTop[ti]->br_rect.r_ytop == y; ti++)
+	{
+	    br = byTop[ti];
+	    lo = 0;
+	    hi = tb->tb_nActive;
+	    while (lo < hi)
+	    {
+		j = (lo + hi) / 2;
+		if (tb->tb_active[j]->br_rect.r_xbot <= br->br_rect.r_xbot)
+		    lo = j + 1;
+		else
+		    hi = j;
+	    }
+	    memmove(&tb->tb_active[lo + 1], &tb->tb_active[lo],
+			(tb->tb_nActive - lo) * sizeof (BuildRect *));
+	    tb->tb_active[lo] = br;
+	    tb->tb_nActive++;
+
+	    if (tb->tb_nDirty == tb->tb_dirtySize)
+		tb->tb_dirty = (BuildSeg *) tiBuildGrow(tb->tb_dirty,
+			tb->tb_nDirty, &tb->tb_dirtySize, sizeof (BuildSeg));
+	    tb->tb_dirty[tb->tb_nDirty].bs_xbot = br->br_rect.r_xbot;
+	    tb->tb_dirty[tb->tb_nDirty++].bs_xtop = br->br_rect.r_xtop;
+	}
+
+	tiBuildRow(tb, y);
+    }
+
+    /* Close off the last row at the bottom of the plane */
+    for (j = 0; j < tb->tb_nRow; j++)
+    {
+	tp = tb->tb_row[j];
+	BOTTOM(tp) = TiPlaneRect.r_ybot;
+	TiSetLB(tp, plane->pl_bottom);
+	TiSetBL(tp, (j > 0) ? tb->tb_row[j - 1] : plane->pl_left);
+    }
+    tp = tb->tb_row[tb->tb_nRow - 1];
+    TiSetRT(plane->pl_bottom, tp);
+    TiSetBL(plane->pl_right, tp);
+    plane->pl_hint = tb->tb_row[0];
+
+    freeMagic((char *) byTop);
+    freeMagic((char *) byBot);
+    freeMagic((char *) tb->tb_active);
+    freeMagic((char *) tb->tb_row);
+    if (tb->tb_newRow) freeMagic((char *) tb->tb_newRow);
+    if (tb->tb_dirty) freeMagic((char *) tb->tb_dirty);
+    if (tb->tb_segs) freeMagic((char *) tb->tb_segs);
+    if (tb->tb_closed) freeMagic((char *) tb->tb_closed);
+    if (tb->tb_created) freeMagic((char *) tb->tb_created);
+
+done:
+    if (tb->tb_rects) freeMagic((char *) tb->tb_rects);
+    freeMagic((char *) tb);
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * tiBuildRow --
+ *
+ * Move the sweep line of TiBuildFinish() down to y.  The active list
+ * has already been updated, and tb_dirty holds the x ranges of all
+ * rectangles starting or ending at y;  outside those ranges the row
+ * below y looks the same as the row above it.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Closes and creates tiles, sets their stitches, and replaces
+ *	tb_row with the row of tiles just below y.
+ *
+ * --------------------------------------------------------------------
+ */
+
+static void
+tiBuildRow(tb, y)
+    TileBuilder *tb;
+    int y;		/* New position of the sweep line */
+{
+    Plane *plane = tb->tb_plane;
+    ClientData space = TiGetBody(tb->tb_space);
+    Tile **row = tb->tb_row, **swap, *tp;
+    int nRow = tb->tb_nRow;
+    int d, i0, i1, j, j1, fi, k, x, xtop, left, right, closeFrom;
+    ClientData body;
+    BuildSeg *seg;
+
+    qsort((char *) tb->tb_dirty, tb->tb_nDirty, sizeof (BuildSeg),
+		tiBuildCmpSeg);
+
+    tb->tb_nNewRow = 0;
+    tb->tb_nClosed = 0;
+    tb->tb_nCreated = 0;
+    fi = 0;
+
+    for (d = 0; d < tb->tb_nDirty; )
+    {
+	/*
+	 * The tiles to be rebuilt run from the one just left of the
+	 * dirty range (so that the new row can merge with what is to
+	 * its left) to the one just right of it.  Dirty ranges whose
+	 * tiles touch or overlap are rebuilt together.
+	 */
+	x = tb->tb_dirty[d].bs_xbot;
+	i0 = tiBuildFind(row, nRow, (x > TiPlaneRect.r_xbot) ? x - 1 : x);
+	i1 = tiBuildFind(row, nRow, tb->tb_dirty[d].bs_xtop);
+	for (d++; d < tb->tb_nDirty; d++)
+	{
+	    if (tiBuildFind(row, nRow, tb->tb_dirty[d].bs_xbot - 1) > i1 + 1)
+		break;
+	    j1 = tiBuildFind(row, nRow, tb->tb_dirty[d].bs_xtop);
+	    if (j1 > i1) i1 = j1;
+	}
+	left = LEFT(row[i0]);
+	right = RIGHT(row[i1]);
+
+	/* Tiles left of the range stay as they are */
+	for ( ; fi < i0; fi++)
+	{
+	    if (tb->tb_nNewRow == tb->tb_newRowSize)
+		tb->tb_newRow = (Tile **) tiBuildGrow(tb->tb_newRow,
+			tb->tb_nNewRow, &tb->tb_newRowSize, sizeof (Tile *));
+	    tb->tb_newRow[tb->tb_nNewRow++] = row[fi];
+	}
+
+	/* Find the contents of the new row from left to right */
+	tb->tb_nSegs = 0;
+	{
+	    int lo = 0, hi = tb->tb_nActive, mid;
+
+	    while (lo < hi)
+	    {
+		mid = (lo + hi) / 2;
+		if (tb->tb_active[mid]->br_rect.r_xbot <= left)
+		    lo = mid + 1;
+		else
+		    hi = mid;
+	    }
+	    k = lo - 1;
+	    if (k < 0 || tb->tb_active[k]->br_rect.r_xtop <= left) k++;
+	}
+	for (x = left; x < right; x = xtop)
+	{
+	    if (k < tb->tb_nActive && tb->tb_active[k]->br_rect.r_xtop <= x)
+	    {
+		/* Overlapped by the rectangle before it:  skip */
+		k++;
+		xtop = x;
+		continue;
+	    }
+	    if (k < tb->tb_nActive && tb->tb_active[k]->br_rect.r_xbot <= x)
+	    {
+		xtop = MIN(tb->tb_active[k]->br_rect.r_xtop, right);
+		body = tb->tb_active[k]->br_body;
+		k++;
+	    }
+	    else
+	    {
+		xtop = (k < tb->tb_nActive) ?
+			MIN(tb->tb_active[k]->br_rect.r_xbot, right) : right;
+		body = space;
+	    }
+	    if (tb->tb_nSegs > 0 && tb->tb_segs[tb->tb_nSegs - 1].bs_body == body)
+		tb->tb_segs[tb->tb_nSegs - 1].bs_xtop = xtop;
+	    else
+	    {
+		if (tb->tb_nSegs == tb->tb_segsSize)
+		    tb->tb_segs = (BuildSeg *) tiBuildGrow(tb->tb_segs,
+			    tb->tb_nSegs, &tb->tb_segsSize, sizeof (BuildSeg));
+		seg = &tb->tb_segs[tb->tb_nSegs++];
+		seg->bs_xbot = x;
+		seg->bs_xtop = xtop;
+		seg->bs_body = body;
+	    }
+	}
+
+	/*
+	 * Each piece either continues the tile above it, if that has
+	 * the same extent and body, or becomes a new tile.  Tiles of
+	 * the old row that do not continue end at y.
+	 */
+	j = closeFrom = i0;
+	for (seg = tb->tb_segs; seg < tb->tb_segs + tb->tb_nSegs; seg++)
+	{
+	    while (j <= i1 && LEFT(row[j]) < seg->bs_xbot) j++;
+
+	    if (tb->tb_nNewRow == tb->tb_newRowSize)
+		tb->tb_newRow = (Tile **) tiBuildGrow(tb->tb_newRow,
+			tb->tb_nNewRow, &tb->tb_newRowSize, sizeof (Tile *));
+
+	    if (j <= i1 && LEFT(row[j]) == seg->bs_xbot
+		    && RIGHT(row[j]) == seg->bs_xtop
+		    && TiGetBody(row[j]) == seg->bs_body)
+	    {
+		for ( ; closeFrom < j; closeFrom++)
+		{
+		    if (tb->tb_nClosed == tb->tb_closedSize)
+			tb->tb_closed = (Tile **) tiBuildGrow(tb->tb_closed,
+				tb->tb_nClosed, &tb->tb_closedSize,
+				sizeof (Tile *));
+		    tp = row[closeFrom];
+		    BOTTOM(tp) = y;
+		    TiSetBL(tp, (closeFrom > 0) ? row[closeFrom - 1]
+				: plane->pl_left);
+		    tb->tb_closed[tb->tb_nClosed++] = tp;
+		}
+		closeFrom = j + 1;
+		tb->tb_newRow[tb->tb_nNewRow++] = row[j];
+	    }
+	    else
+	    {
+		if (tb->tb_nCreated == tb->tb_createdSize)
+		    tb->tb_created = (int *) tiBuildGrow(tb->tb_created,
+			    tb->tb_nCreated, &tb->tb_createdSize, sizeof (int));
+		tp = TiPlaneAlloc(plane);
+		TiSetBody(tp, seg->bs_body);
+		TiSetClient(tp, CLIENTDEFAULT);
+		LEFT(tp) = seg->bs_xbot;
+		tb->tb_created[tb->tb_nCreated++] = tb->tb_nNewRow;
+		tb->tb_newRow[tb->tb_nNewRow++] = tp;
+	    }
+	}
+	for ( ; closeFrom <= i1; closeFrom++)
+	{
+	    if (tb->tb_nClosed == tb->tb_closedSize)
+		tb->tb_closed = (Tile **) tiBuildGrow(tb->tb_closed,
+			tb->tb_nClosed, &tb->tb_closedSize, sizeof (Tile *));
+	    tp = row[closeFrom];
+	    BOTTOM(tp) = y;
+	    TiSetBL(tp, (closeFrom > 0) ? row[closeFrom - 1] : plane->pl_left);
+	    tb->tb_closed[tb->tb_nClosed++] = tp;
+	}
+	fi = i1 + 1;
+    }
+
+    /* Tiles right of the last range stay as they are */
+    for ( ; fi < nRow; fi++)
+    {
+	if (tb->tb_nNewRow == tb->tb_newRowSize)
+	    tb->tb_newRow = (Tile **) tiBuildGrow(tb->tb_newRow,
+		    tb->tb_nNewRow, &tb->tb_newRowSize, sizeof (Tile *));
+	tb->tb_newRow[tb->tb_nNewRow++] = row[fi];
+    }
+
+    /*
+     * Now that both rows are complete, stitch the new tiles to their
+     * neighbors on the right and above, and the closed tiles to
+     * their neighbors below.  The right stitches must come first,
+     * since they determine where the new tiles end.
+     */
+    for (k = 0; k < tb->tb_nCreated; k++)
+    {
+	j = tb->tb_created[k];
+	TiSetTR(tb->tb_newRow[j], (j + 1 < tb->tb_nNewRow)
+		? tb->tb_newRow[j + 1] : plane->pl_right);
+    }
+    for (k = 0; k < tb->tb_nCreated; k++)
+    {
+	tp = tb->tb_newRow[tb->tb_created[k]];
+	TiSetRT(tp, row[tiBuildFind(row, nRow, RIGHT(tp) - 1)]);
+    }
+    for (k = 0; k < tb->tb_nClosed; k++)
+    {
+	tp = tb->tb_closed[k];
+	TiSetLB(tp, tb->tb_newRow[tiBuildFind(tb->tb_newRow,
+		tb->tb_nNewRow, LEFT(tp))]);
+    }
+
+    /* The new row becomes the current one */
+    swap = tb->tb_row;
+    tb->tb_row = tb->tb_newRow;
+    tb->tb_newRow = swap;
+    k = tb->tb_rowSize;
+    tb->tb_rowSize = tb->tb_newRowSize;
+    tb->tb_newRowSize = k;
+    tb->tb_nRow = tb->tb_nNewRow;
+}
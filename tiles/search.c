@@ -61,3 +61,33 @@ TiSrPoint(hintTile, plane, point)
     plane->pl_hint = tp;
     return(tp);
 }
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiSrPointCursor --
+ *
+ * Search for a point, like TiSrPoint(), but starting from and
+ * updating a caller-owned cursor instead of the plane's hint.
+ *
+ * Results:
+ *	A pointer to the tile containing the point.
+ *
+ * Side effects:
+ *	Sets the cursor's hint to the tile found.  The plane
+ *	itself is not modified.
+ *
+ * --------------------------------------------------------------------
+ */
+
+Tile *
+TiSrPointCursor(cursor, point)
+    TileCursor *cursor;		/* Hint for the search, updated */
+    Point *point;		/* Point for which to search */
+{
+    Tile *tp = cursor->tc_hint;
+
+    GOTOPOINT(tp, point);
+    cursor->tc_hint = tp;
+    return(tp);
+}
@@ -147,6 +147,77 @@ TiSrArea(hintTile, plane, rect, func, arg)
     return 0;
 }
 
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiSrAreaCursor --
+ *
+ * Reentrant form of TiSrArea():  find all tiles contained in or
+ * incident upon a given area, starting from the hint held in a
+ * caller-owned cursor rather than the plane's own hint.  The
+ * procedure is of the same form as for TiSrArea().
+ *
+ * Several threads may search the same plane at once with their own
+ * cursors.  In that case the procedure must not modify the plane
+ * (nor, in particular, the ti_client fields of the tiles it is
+ * passed);  DBSrPaintAreaCursor() shows how to keep per-tile marks
+ * outside of the plane.
+ *
+ * Results:
+ *	0 is returned if the search completed normally.  1 is returned
+ *	if it aborted.
+ *
+ * Side effects:
+ *	Updates the cursor's hint.  Otherwise, whatever side effects
+ *	result from application of the supplied procedure.
+ *
+ * --------------------------------------------------------------------
+ */
+
+int
+TiSrAreaCursor(cursor, rect, func, arg)
+    TileCursor *cursor;	/* Hint for the search, updated to the last
+			 * tile visited along the left edge of rect.
+			 */
+    Rect *rect;		/* Area to search */
+    int (*func)();	/* Function to apply at each tile */
+    ClientData arg;	/* Additional argument to pass to (*func)() */
+{
+    Point here;
+    Tile *tp, *enumTR, *enumTile;
+    int enumRight, enumBottom;
+
+    here.p_x = rect->r_xbot;
+    here.p_y = rect->r_ytop - 1;
+    enumTile = cursor->tc_hint;
+    GOTOPOINT(enumTile, &here);
+    cursor->tc_hint = enumTile;
+
+    while (here.p_y >= rect->r_ybot)
+    {
+	if (SigInterruptPending) return 1;
+
+	/* As for TiSrArea(), find the next tile down before	*/
+	/* the current one is passed to the client.		*/
+
+	here.p_y = BOTTOM(enumTile) - 1;
+	tp = enumTile;
+	GOTOPOINT(tp, &here);
+	cursor->tc_hint = tp;
+
+	enumRight = RIGHT(enumTile);
+	enumBottom = BOTTOM(enumTile);
+	enumTR = TR(enumTile);
+	if ((*func)(enumTile, arg)) return 1;
+
+	if (enumRight < rect->r_xtop)
+	    if (tiSrAreaEnum(enumTR, enumBottom, rect, func, arg))
+		return 1;
+	enumTile = tp;
+    }
+    return 0;
+}
+
 /*
  * --------------------------------------------------------------------
  *
@@ -23,6 +23,10 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
+#ifdef WORKER_THREADS
+#include <pthread.h>
+#endif
 
 #include "utils/magic.h"
 #include "utils/malloc.h"
@@ -58,17 +62,60 @@ global Rect TiPlaneRect = { MINFINITY+2, MINFINITY+2, INFINITY-2, INFINITY-2 };
 
 #ifdef HAVE_SYS_MMAN_H
 
-global Tile *TileStoreFreeList = NULL;
-global Tile *TileStoreFreeList_end = NULL;
-
 /* The new Tile Allocation scheme (Magic 8.0) */
 
 static void *_block_begin = NULL;
 static void *_current_ptr = NULL;
 static void *_block_end = NULL;
 
+/* Chunks released by planes, indexed by size class (see tile.h) */
+
+static char **tileChunkFree[TILE_CHUNK_CLASSES];
+static int tileChunkFreeCount[TILE_CHUNK_CLASSES];
+static int tileChunkFreeMax[TILE_CHUNK_CLASSES];
+static pointertype tilePageSize = 0;
+
+/* Arena for tiles not belonging to any one plane (see TiAlloc()) */
+
+static TileArena tileSharedArena;
+
+/*
+ * Planes of different cells may be filled by pool threads at the same
+ * time (see utils/workers.c).  Each arena belongs to a single plane,
+ * so only the chunks shared between arenas need a lock.
+ */
+
+#ifdef WORKER_THREADS
+static pthread_mutex_t tileStoreLock = PTHREAD_MUTEX_INITIALIZER;
+#define	TILE_STORE_LOCK()	pthread_mutex_lock(&tileStoreLock)
+#define	TILE_STORE_UNLOCK()	pthread_mutex_unlock(&tileStoreLock)
+#else
+#define	TILE_STORE_LOCK()
+#define	TILE_STORE_UNLOCK()
+#endif
+
+static void tileChunkPut();
+static TileArena *tileArenaNew();
+static Tile *tileArenaAlloc();
+static void tileArenaRelease();
+
 #endif /* HAVE_SYS_MMAN_H */
 
+static void tiNewBounds();
+static void tiDetachPlane();
+static void tiCopyPlane();
+
+#ifdef COMPACT_TILES
+
+/*
+ * Base of the address range reserved for all tiles.  Corner stitches
+ * are stored as offsets from this address (see tile.h).
+ */
+
+global char *TileStoreBase = NULL;
+
+#endif /* COMPACT_TILES */
+
 
 /*
  * --------------------------------------------------------------------
@@ -84,7 +131,11 @@ static void *_block_end = NULL;
  * Side effects:
  *	Adjusts the corner stitches of the Tile supplied to
  *	point to the appropriate bounding tile in the newly
- *	created Plane.
+ *	created Plane.  Since all tiles of a plane must come
+ *	from the plane's own arena, the supplied tile is first
+ *	moved into it:  the caller must not use the tile pointer
+ *	afterwards, but should use the plane's hint tile instead.
+ *	The four boundary tiles come from the shared arena.
  *
  * --------------------------------------------------------------------
  */
@@ -96,13 +147,70 @@ TiNewPlane(tile)
 			 */
 {
     Plane *newplane;
-    static Tile *infinityTile = (Tile *) NULL;
 
     newplane = (Plane *) mallocMagic((unsigned) (sizeof (Plane)));
-    newplane->pl_top = TiAlloc();
-    newplane->pl_right = TiAlloc();
-    newplane->pl_bottom = TiAlloc();
-    newplane->pl_left = TiAlloc();
+    newplane->pl_owner = (Plane *) NULL;
+    newplane->pl_views = (Plane *) NULL;
+    newplane->pl_generation = 0;
+#ifdef HAVE_SYS_MMAN_H
+    newplane->pl_arena = tileArenaNew();
+    if (tile)
+    {
+	Tile *newtile = tileArenaAlloc(newplane->pl_arena);
+
+	TiSetBody(newtile, TiGetBody(tile));
+	TiSetClient(newtile, TiGetClient(tile));
+	newtile->ti_ll = tile->ti_ll;
+	TiFree(tile);
+	tile = newtile;
+    }
+#else
+    newplane->pl_arena = (TileArena *) NULL;
+#endif
+    tiNewBounds(newplane, tile);
+
+    if (tile)
+    {
+	TiSetRT(tile, newplane->pl_top);
+	TiSetTR(tile, newplane->pl_right);
+	TiSetLB(tile, newplane->pl_bottom);
+	TiSetBL(tile, newplane->pl_left);
+    }
+
+    newplane->pl_hint = tile;
+    return (newplane);
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * tiNewBounds --
+ *
+ * Give a plane four new boundary tiles.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Allocates the boundary tiles from the shared arena and stitches
+ *	them to each other and to the tile supplied, which is to be the
+ *	only tile of the plane (it may be NULL;  the caller must then set
+ *	the stitches to the interior tiles itself).
+ *
+ * --------------------------------------------------------------------
+ */
+
+static void
+tiNewBounds(plane, tile)
+    Plane *plane;
+    Tile *tile;
+{
+    static Tile *infinityTile = (Tile *) NULL;
+
+    plane->pl_top = TiAlloc();
+    plane->pl_right = TiAlloc();
+    plane->pl_bottom = TiAlloc();
+    plane->pl_left = TiAlloc();
 
     /*
      * Since the lower left coordinates of the TR and RT
@@ -119,57 +227,51 @@ TiNewPlane(tile)
 	BOTTOM(infinityTile) = INFINITY+1;
     }
 
-    if (tile)
-    {
-	RT(tile) = newplane->pl_top;
-	TR(tile) = newplane->pl_right;
-	LB(tile) = newplane->pl_bottom;
-	BL(tile) = newplane->pl_left;
-    }
-
-    LEFT(newplane->pl_bottom) = MINFINITY;
-    BOTTOM(newplane->pl_bottom) = MINFINITY;
-    RT(newplane->pl_bottom) = tile;
-    TR(newplane->pl_bottom) = newplane->pl_right;
-    LB(newplane->pl_bottom) = BADTILE;
-    BL(newplane->pl_bottom) = newplane->pl_left;
-    TiSetBody(newplane->pl_bottom, -1);
-
-    LEFT(newplane->pl_top) = MINFINITY;
-    BOTTOM(newplane->pl_top) = INFINITY;
-    RT(newplane->pl_top) = infinityTile;
-    TR(newplane->pl_top) = newplane->pl_right;
-    LB(newplane->pl_top) = tile;
-    BL(newplane->pl_top) = newplane->pl_left;
-    TiSetBody(newplane->pl_top, -1);
-
-    LEFT(newplane->pl_left) = MINFINITY;
-    BOTTOM(newplane->pl_left) = MINFINITY;
-    RT(newplane->pl_left) = newplane->pl_top;
-    TR(newplane->pl_left) = tile;
-    LB(newplane->pl_left) = newplane->pl_bottom;
-    BL(newplane->pl_left) = BADTILE;
-    TiSetBody(newplane->pl_left, -1);
-
-    LEFT(newplane->pl_right) = INFINITY;
-    BOTTOM(newplane->pl_right) = MINFINITY;
-    RT(newplane->pl_right) = newplane->pl_top;
-    TR(newplane->pl_right) = infinityTile;
-    LB(newplane->pl_right) = newplane->pl_bottom;
-    BL(newplane->pl_right) = tile;
-    TiSetBody(newplane->pl_right, -1);
-
-    newplane->pl_hint = tile;
-    return (newplane);
+    LEFT(plane->pl_bottom) = MINFINITY;
+    BOTTOM(plane->pl_bottom) = MINFINITY;
+    TiSetRT(plane->pl_bottom, tile);
+    TiSetTR(plane->pl_bottom, plane->pl_right);
+    TiSetLB(plane->pl_bottom, BADTILE);
+    TiSetBL(plane->pl_bottom, plane->pl_left);
+    TiSetBody(plane->pl_bottom, -1);
+
+    LEFT(plane->pl_top) = MINFINITY;
+    BOTTOM(plane->pl_top) = INFINITY;
+    TiSetRT(plane->pl_top, infinityTile);
+    TiSetTR(plane->pl_top, plane->pl_right);
+    TiSetLB(plane->pl_top, tile);
+    TiSetBL(plane->pl_top, plane->pl_left);
+    TiSetBody(plane->pl_top, -1);
+
+    LEFT(plane->pl_left) = MINFINITY;
+    BOTTOM(plane->pl_left) = MINFINITY;
+    TiSetRT(plane->pl_left, plane->pl_top);
+    TiSetTR(plane->pl_left, tile);
+    TiSetLB(plane->pl_left, plane->pl_bottom);
+    TiSetBL(plane->pl_left, BADTILE);
+    TiSetBody(plane->pl_left, -1);
+
+    LEFT(plane->pl_right) = INFINITY;
+    BOTTOM(plane->pl_right) = MINFINITY;
+    TiSetRT(plane->pl_right, plane->pl_top);
+    TiSetTR(plane->pl_right, infinityTile);
+    TiSetLB(plane->pl_right, plane->pl_bottom);
+    TiSetBL(plane->pl_right, tile);
+    TiSetBody(plane->pl_right, -1);
 }
-
+
 /*
  * --------------------------------------------------------------------
  *
  * TiFreePlane --
  *
- * Free the storage associated with a tile plane.
- * Only the plane itself and its four border tiles are deallocated.
+ * Free the storage associated with a tile plane:  the plane itself,
+ * its four border tiles, and all tiles remaining in its arena.  Tile
+ * bodies are not touched, so planes whose bodies point to allocated
+ * memory (such as the subcell plane) must have them freed first.
+ * Without mmap() support planes have no arena, and the caller must
+ * free the interior tiles with TiClearPlane() first.  If the tiles
+ * are shared with other planes, they are left to those planes.
  *
  * Results:
  *	None.
@@ -184,13 +286,359 @@ void
 TiFreePlane(plane)
     Plane *plane;	/* Plane to be freed */
 {
+    if (TiPlaneIsShared(plane))
+	tiDetachPlane(plane);
     TiFree(plane->pl_left);
     TiFree(plane->pl_right);
     TiFree(plane->pl_top);
     TiFree(plane->pl_bottom);
+#ifdef HAVE_SYS_MMAN_H
+    tileArenaRelease(plane->pl_arena);
+    freeMagic((char *) plane->pl_arena);
+#endif
     freeMagic((char *) plane);
 }
-
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiClearPlane --
+ *
+ * Deallocate all tiles of a plane except for its four boundary tiles.
+ * The boundary tiles are left pointing at deallocated tiles, so the
+ * caller must either free the plane or give it a new central tile
+ * (see dbSetPlaneTile()).  With mmap() support this simply releases
+ * all chunks of the plane's arena and takes time proportional to the
+ * number of chunks, not the number of tiles.  If the tiles are shared
+ * with other planes, the plane merely stops sharing them and gets
+ * new boundary tiles.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Deallocates a lot of memory.
+ *
+ *			*** WARNING ***
+ *
+ * Without mmap() support, this procedure uses a carefully constructed
+ * non-recursive area enumeration algorithm.  Care is taken to not access
+ * a tile that has been deallocated.  The only exception is for a tile
+ * that has just been passed to free(), but no more calls to free() or
+ * malloc() have been made.  Magic's malloc allows this.
+ *
+ * --------------------------------------------------------------------
+ */
+
+void
+TiClearPlane(plane)
+    Plane *plane;	/* Plane whose tiles are to be freed */
+{
+    plane->pl_generation++;
+#ifdef HAVE_SYS_MMAN_H
+    if (TiPlaneIsShared(plane))
+	tiDetachPlane(plane);
+    else
+	tileArenaRelease(plane->pl_arena);
+#else
+    Tile *tp, *tpnew;
+    Rect *rect = &TiPlaneRect;
+
+    if (TiPlaneIsShared(plane))
+    {
+	tiDetachPlane(plane);
+	return;
+    }
+
+    /* Start with the bottom-right non-infinity tile in the plane */
+    tp = BL(plane->pl_right);
+
+    /* Each iteration visits another tile on the RHS of the search area */
+    while (BOTTOM(tp) < rect->r_ytop)
+    {
+enumerate:
+
+#define	CLIP_TOP(t)	(MIN(TOP(t),rect->r_ytop))
+
+	/* Move along to the next tile to the left */
+	if (LEFT(tp) > rect->r_xbot)
+	{
+	    tpnew = BL(tp);
+	    while (TOP(tpnew) <= rect->r_ybot) tpnew = RT(tpnew);
+	    if (CLIP_TOP(tpnew) <= CLIP_TOP(tp))
+	    {
+		tp = tpnew;
+		goto enumerate;
+	    }
+	}
+
+	/* Each iteration returns one tile further to the right */
+	while (RIGHT(tp) < rect->r_xtop)
+	{
+	    TiFree(tp); 
+	    tpnew = RT(tp);
+	    tp = TR(tp);
+	    if (CLIP_TOP(tpnew) <= CLIP_TOP(tp) && BOTTOM(tpnew) < rect->r_ytop)
+	    {
+		tp = tpnew;
+		goto enumerate;
+	    }
+	}
+
+	TiFree(tp); 
+	/* At right edge -- walk up to next tile along the right edge */
+	tp = RT(tp);
+	if (BOTTOM(tp) < rect->r_ytop) {
+	    while(LEFT(tp) >= rect->r_xtop) tp = BL(tp);
+	}
+    }
+#endif /* !HAVE_SYS_MMAN_H */
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiSharePlane --
+ *
+ * Make a plane share all the tiles of another one, instead of having
+ * tiles of its own.  This takes constant time, and makes the plane
+ * look exactly like a copy of the other plane to anybody who only
+ * searches it.  Either plane gets a copy of its own when it is next
+ * modified (see TiUnsharePlane()).
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Frees all tiles of "plane", which is linked to "owner" (or to
+ *	the plane whose tiles "owner" shares itself).
+ *
+ * --------------------------------------------------------------------
+ */
+
+void
+TiSharePlane(plane, owner)
+    Plane *plane;	/* Plane to give the tiles of owner */
+    Plane *owner;	/* Plane whose tiles are to be shared */
+{
+    if (owner->pl_owner != NULL)
+	owner = owner->pl_owner;
+    if (plane == owner || plane->pl_owner == owner)
+	return;
+
+    TiClearPlane(plane);
+    TiFree(plane->pl_left);
+    TiFree(plane->pl_right);
+    TiFree(plane->pl_top);
+    TiFree(plane->pl_bottom);
+
+    plane->pl_left = owner->pl_left;
+    plane->pl_right = owner->pl_right;
+    plane->pl_top = owner->pl_top;
+    plane->pl_bottom = owner->pl_bottom;
+    plane->pl_hint = owner->pl_hint;
+    plane->pl_owner = owner;
+    plane->pl_views = owner->pl_views;
+    owner->pl_views = plane;
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiUnsharePlane --
+ *
+ * Give a plane that shares its tiles with other planes a copy of
+ * them of its own.  This is normally called through TiPlaneModify()
+ * before a plane is changed.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Allocates a copy of all tiles of the plane from its own arena,
+ *	with new boundary tiles.  The ti_client fields of the new tiles
+ *	are set to CLIENTDEFAULT.
+ *
+ * --------------------------------------------------------------------
+ */
+
+void
+TiUnsharePlane(plane)
+    Plane *plane;	/* Plane to be given its own tiles */
+{
+    Plane *source;
+
+    if (!TiPlaneIsShared(plane))
+	return;
+
+    /*
+     * An owner passes its tiles on to the first of its views and
+     * copies them back from there, so either way "plane" ends up
+     * as the one making the copy.
+     */
+    source = (plane->pl_owner != NULL) ? plane->pl_owner : plane->pl_views;
+    tiDetachPlane(plane);
+    tiCopyPlane(plane, source);
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * tiDetachPlane --
+ *
+ * Stop a plane from sharing tiles with any other plane, and give it
+ * new boundary tiles.  If the plane owns the tiles, they go to the
+ * first plane sharing them, which then owns them and its arena.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The plane is left with an empty arena and boundary tiles that
+ *	do not point at any interior tile;  the caller must either free
+ *	it or give it new tiles.
+ *
+ * --------------------------------------------------------------------
+ */
+
+static void
+tiDetachPlane(plane)
+    Plane *plane;
+{
+    Plane *owner, **pp;
+
+    if (plane->pl_owner != NULL)
+    {
+	owner = plane->pl_owner;
+	for (pp = &owner->pl_views; *pp != plane; pp = &(*pp)->pl_views)
+	    /* Nothing */;
+	*pp = plane->pl_views;
+	plane->pl_owner = (Plane *) NULL;
+	plane->pl_views = (Plane *) NULL;
+    }
+    else if (plane->pl_views != NULL)
+    {
+	Plane *heir = plane->pl_views, *view;
+	TileArena *arena;
+
+	heir->pl_owner = (Plane *) NULL;
+	for (view = heir->pl_views; view; view = view->pl_views)
+	    view->pl_owner = heir;
+	plane->pl_views = (Plane *) NULL;
+
+	arena = heir->pl_arena;
+	heir->pl_arena = plane->pl_arena;
+	plane->pl_arena = arena;
+    }
+    else return;
+
+    tiNewBounds(plane, (Tile *) NULL);
+    plane->pl_hint = (Tile *) NULL;
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * tiCopyPlane --
+ *
+ * Copy all tiles of one plane into another one, which has been
+ * emptied by tiDetachPlane().  The ti_client field of each source
+ * tile is used to point to its copy while the stitches of the copies
+ * are set, and is restored afterwards.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Fills in the plane "dst".
+ *
+ * --------------------------------------------------------------------
+ */
+
+static void
+tiCopyPlane(dst, src)
+    Plane *dst, *src;
+{
+    Tile *bounds[4][2];
+    int tiCopyNewFunc(), tiCopyStitchFunc(), tiCopyRestoreFunc();
+    Tile *tp;
+
+    (void) TiSrArea((Tile *) NULL, src, &TiPlaneRect,
+		tiCopyNewFunc, (ClientData) dst);
+
+    /* Map the boundary tiles of src to those of dst */
+    bounds[0][0] = src->pl_left;	bounds[0][1] = dst->pl_left;
+    bounds[1][0] = src->pl_right;	bounds[1][1] = dst->pl_right;
+    bounds[2][0] = src->pl_top;		bounds[2][1] = dst->pl_top;
+    bounds[3][0] = src->pl_bottom;	bounds[3][1] = dst->pl_bottom;
+    (void) TiSrArea((Tile *) NULL, src, &TiPlaneRect,
+		tiCopyStitchFunc, (ClientData) bounds);
+
+    tp = (Tile *) TiGetClient(TR(src->pl_left));
+    TiSetTR(dst->pl_left, tp);
+    TiSetRT(dst->pl_bottom, (Tile *) TiGetClient(RT(src->pl_bottom)));
+    TiSetLB(dst->pl_top, (Tile *) TiGetClient(LB(src->pl_top)));
+    TiSetBL(dst->pl_right, (Tile *) TiGetClient(BL(src->pl_right)));
+    dst->pl_hint = tp;
+
+    (void) TiSrArea((Tile *) NULL, src, &TiPlaneRect,
+		tiCopyRestoreFunc, (ClientData) NULL);
+}
+
+/*
+ * Filter functions for tiCopyPlane():  the first pass allocates the
+ * copy of each tile and saves the client field of the original in it,
+ * the second pass sets the stitches of the copies, and the third pass
+ * restores the client fields of the originals.
+ */
+
+int
+tiCopyNewFunc(tile, dst)
+    Tile *tile;
+    Plane *dst;
+{
+    Tile *newtile = TiPlaneAlloc(dst);
+
+    TiSetBody(newtile, TiGetBody(tile));
+    newtile->ti_ll = tile->ti_ll;
+    TiSetClient(newtile, TiGetClient(tile));
+    TiSetClient(tile, newtile);
+    return 0;
+}
+
+#define	tiCopyMap(tp, bounds) \
+	(((tp) == (bounds)[0][0]) ? (bounds)[0][1] : \
+	 ((tp) == (bounds)[1][0]) ? (bounds)[1][1] : \
+	 ((tp) == (bounds)[2][0]) ? (bounds)[2][1] : \
+	 ((tp) == (bounds)[3][0]) ? (bounds)[3][1] : \
+	 (Tile *) TiGetClient(tp))
+
+int
+tiCopyStitchFunc(tile, bounds)
+    Tile *tile;
+    Tile *bounds[4][2];
+{
+    Tile *newtile = (Tile *) TiGetClient(tile);
+
+    TiSetLB(newtile, tiCopyMap(LB(tile), bounds));
+    TiSetBL(newtile, tiCopyMap(BL(tile), bounds));
+    TiSetTR(newtile, tiCopyMap(TR(tile), bounds));
+    TiSetRT(newtile, tiCopyMap(RT(tile), bounds));
+    return 0;
+}
+
+int
+tiCopyRestoreFunc(tile, cdata)
+    Tile *tile;
+    ClientData cdata;
+{
+    Tile *newtile = (Tile *) TiGetClient(tile);
+
+    TiSetClient(tile, TiGetClient(newtile));
+    TiSetClient(newtile, CLIENTDEFAULT);
+    return 0;
+}
+
 /*
  * --------------------------------------------------------------------
  *
@@ -248,31 +696,31 @@ TiSplitX(tile, x)
 
     ASSERT(x > LEFT(tile) && x < RIGHT(tile), "TiSplitX");
 
-    newtile = TiAlloc();
+    newtile = TiAllocNear(tile);
     TiSetClient(newtile, CLIENTDEFAULT);
     TiSetBody(newtile, 0);
 
     LEFT(newtile) = x;
     BOTTOM(newtile) = BOTTOM(tile);
-    BL(newtile) = tile;
-    TR(newtile) = TR(tile);
-    RT(newtile) = RT(tile);
+    TiSetBL(newtile, tile);
+    TiSetTR(newtile, TR(tile));
+    TiSetRT(newtile, RT(tile));
 
     /*
      * Adjust corner stitches along the right edge
      */
 
     for (tp = TR(tile); BL(tp) == tile; tp = LB(tp))
-	BL(tp) = newtile;
-    TR(tile) = newtile;
+	TiSetBL(tp, newtile);
+    TiSetTR(tile, newtile);
 
     /*
      * Adjust corner stitches along the top edge
      */
 
     for (tp = RT(tile); LEFT(tp) >= x; tp = BL(tp))
-	LB(tp) = newtile;
-    RT(tile) = tp;
+	TiSetLB(tp, newtile);
+    TiSetRT(tile, tp);
 
     /*
      * Adjust corner stitches along the bottom edge
@@ -280,10 +728,10 @@ TiSplitX(tile, x)
 
     for (tp = LB(tile); RIGHT(tp) <= x; tp = TR(tp))
 	/* nothing */;
-    LB(newtile) = tp;
+    TiSetLB(newtile, tp);
     while (RT(tp) == tile)
     {
-	RT(tp) = newtile;
+	TiSetRT(tp, newtile);
 	tp = TR(tp);
     }
 
@@ -320,31 +768,31 @@ TiSplitY(tile, y)
 
     ASSERT(y > BOTTOM(tile) && y < TOP(tile), "TiSplitY");
 
-    newtile = TiAlloc();
+    newtile = TiAllocNear(tile);
     TiSetClient(newtile, CLIENTDEFAULT);
     TiSetBody(newtile, 0);
 
     LEFT(newtile) = LEFT(tile);
     BOTTOM(newtile) = y;
-    LB(newtile) = tile;
-    RT(newtile) = RT(tile);
-    TR(newtile) = TR(tile);
+    TiSetLB(newtile, tile);
+    TiSetRT(newtile, RT(tile));
+    TiSetTR(newtile, TR(tile));
 
     /*
      * Adjust corner stitches along top edge
      */
 
     for (tp = RT(tile); LB(tp) == tile; tp = BL(tp))
-	LB(tp) = newtile;
-    RT(tile) = newtile;
+	TiSetLB(tp, newtile);
+    TiSetRT(tile, newtile);
 
     /*
      * Adjust corner stitches along right edge
      */
 
     for (tp = TR(tile); BOTTOM(tp) >= y; tp = LB(tp))
-	BL(tp) = newtile;
-    TR(tile) = tp;
+	TiSetBL(tp, newtile);
+    TiSetTR(tile, tp);
 
     /*
      * Adjust corner stitches along left edge
@@ -352,10 +800,10 @@ TiSplitY(tile, y)
 
     for (tp = BL(tile); TOP(tp) <= y; tp = RT(tp))
 	/* nothing */;
-    BL(newtile) = tp;
+    TiSetBL(newtile, tp);
     while (TR(tp) == tile)
     {
-	TR(tp) = newtile;
+	TiSetTR(tp, newtile);
 	tp = RT(tp);
     }
 
@@ -393,7 +841,7 @@ TiSplitX_Left(tile, x)
 
     ASSERT(x > LEFT(tile) && x < RIGHT(tile), "TiSplitX");
 
-    newtile = TiAlloc();
+    newtile = TiAllocNear(tile);
     TiSetClient(newtile, CLIENTDEFAULT);
     TiSetBody(newtile, 0);
 
@@ -401,26 +849,26 @@ TiSplitX_Left(tile, x)
     LEFT(tile) = x;
     BOTTOM(newtile) = BOTTOM(tile);
 
-    BL(newtile) = BL(tile);
-    LB(newtile) = LB(tile);
-    TR(newtile) = tile;
-    BL(tile) = newtile;
+    TiSetBL(newtile, BL(tile));
+    TiSetLB(newtile, LB(tile));
+    TiSetTR(newtile, tile);
+    TiSetBL(tile, newtile);
 
     /* Adjust corner stitches along the left edge */
     for (tp = BL(newtile); TR(tp) == tile; tp = RT(tp))
-	TR(tp) = newtile;
+	TiSetTR(tp, newtile);
 
     /* Adjust corner stitches along the top edge */
     for (tp = RT(tile); LEFT(tp) >= x; tp = BL(tp))
 	/* nothing */;
-    RT(newtile) = tp;
+    TiSetRT(newtile, tp);
     for ( ; LB(tp) == tile; tp = BL(tp))
-	LB(tp) = newtile;
+	TiSetLB(tp, newtile);
 
     /* Adjust corner stitches along the bottom edge */
     for (tp = LB(tile); RIGHT(tp) <= x; tp = TR(tp))
-	RT(tp) = newtile;
-    LB(tile) = tp;
+	TiSetRT(tp, newtile);
+    TiSetLB(tile, tp);
 
     return (newtile);
 }
@@ -456,7 +904,7 @@ TiSplitY_Bottom(tile, y)
 
     ASSERT(y > BOTTOM(tile) && y < TOP(tile), "TiSplitY");
 
-    newtile = TiAlloc();
+    newtile = TiAllocNear(tile);
     TiSetClient(newtile, CLIENTDEFAULT);
     TiSetBody(newtile, 0);
 
@@ -464,26 +912,26 @@ TiSplitY_Bottom(tile, y)
     BOTTOM(newtile) = BOTTOM(tile);
     BOTTOM(tile) = y;
 
-    RT(newtile) = tile;
-    LB(newtile) = LB(tile);
-    BL(newtile) = BL(tile);
-    LB(tile) = newtile;
+    TiSetRT(newtile, tile);
+    TiSetLB(newtile, LB(tile));
+    TiSetBL(newtile, BL(tile));
+    TiSetLB(tile, newtile);
 
     /* Adjust corner stitches along bottom edge */
     for (tp = LB(newtile); RT(tp) == tile; tp = TR(tp))
-	RT(tp) = newtile;
+	TiSetRT(tp, newtile);
 
     /* Adjust corner stitches along right edge */
     for (tp = TR(tile); BOTTOM(tp) >= y; tp = LB(tp))
 	/* nothing */;
-    TR(newtile) = tp;
+    TiSetTR(newtile, tp);
     for ( ; BL(tp) == tile; tp = LB(tp))
-	BL(tp) = newtile;
+	TiSetBL(tp, newtile);
 
     /* Adjust corner stitches along left edge */
     for (tp = BL(tile); TOP(tp) <= y; tp = RT(tp))
-	TR(tp) = newtile;
-    BL(tile) = tp;
+	TiSetTR(tp, newtile);
+    TiSetBL(tile, tp);
 
     return (newtile);
 }
@@ -537,14 +985,14 @@ TiJoinX(tile1, tile2, plane)
      */
 
     for (tp = RT(tile2); LB(tp) == tile2; tp = BL(tp))
-	LB(tp) = tile1;
+	TiSetLB(tp, tile1);
 
     /*
      * Update stitches along bottom of tile
      */
 
     for (tp = LB(tile2); RT(tp) == tile2; tp = TR(tp))
-	RT(tp) = tile1;
+	TiSetRT(tp, tile1);
 
     /*
      * Update stitches along either left or right, depending
@@ -555,16 +1003,16 @@ TiJoinX(tile1, tile2, plane)
     if (LEFT(tile1) < LEFT(tile2))
     {
 	for (tp = TR(tile2); BL(tp) == tile2; tp = LB(tp))
-	    BL(tp) = tile1;
-	TR(tile1) = TR(tile2);
-	RT(tile1) = RT(tile2);
+	    TiSetBL(tp, tile1);
+	TiSetTR(tile1, TR(tile2));
+	TiSetRT(tile1, RT(tile2));
     }
     else
     {
 	for (tp = BL(tile2); TR(tp) == tile2; tp = RT(tp))
-	    TR(tp) = tile1;
-	BL(tile1) = BL(tile2);
-	LB(tile1) = LB(tile2);
+	    TiSetTR(tp, tile1);
+	TiSetBL(tile1, BL(tile2));
+	TiSetLB(tile1, LB(tile2));
 	LEFT(tile1) = LEFT(tile2);
     }
 
@@ -622,14 +1070,14 @@ TiJoinY(tile1, tile2, plane)
      */
 
     for (tp = TR(tile2); BL(tp) == tile2; tp = LB(tp))
-	BL(tp) = tile1;
+	TiSetBL(tp, tile1);
 
     /*
      * Update stitches along left of tile.
      */
 
     for (tp = BL(tile2); TR(tp) == tile2; tp = RT(tp))
-	TR(tp) = tile1;
+	TiSetTR(tp, tile1);
 
     /*
      * Update stitches along either top or bottom, depending
@@ -640,16 +1088,16 @@ TiJoinY(tile1, tile2, plane)
     if (BOTTOM(tile1) < BOTTOM(tile2))
     {
 	for (tp = RT(tile2); LB(tp) == tile2; tp = BL(tp))
-	    LB(tp) = tile1;
-	RT(tile1) = RT(tile2);
-	TR(tile1) = TR(tile2);
+	    TiSetLB(tp, tile1);
+	TiSetRT(tile1, RT(tile2));
+	TiSetTR(tile1, TR(tile2));
     }
     else
     {
 	for (tp = LB(tile2); RT(tp) == tile2; tp = TR(tp))
-	    RT(tp) = tile1;
-	LB(tile1) = LB(tile2);
-	BL(tile1) = BL(tile2);
+	    TiSetRT(tp, tile1);
+	TiSetLB(tile1, LB(tile2));
+	TiSetBL(tile1, BL(tile2));
 	BOTTOM(tile1) = BOTTOM(tile2);
     }
 
@@ -660,6 +1108,53 @@ TiJoinY(tile1, tile2, plane)
 
 #ifdef HAVE_SYS_MMAN_H
 
+#ifdef COMPACT_TILES
+
+/*
+ * MMAP the tile store.  All tiles must lie within TILE_STORE_RESERVE
+ * bytes of TileStoreBase, so the whole range is reserved without access
+ * on the first call, and each subsequent call commits the next block of
+ * it.  Blocks are contiguous, so _current_ptr is not reset.  The range
+ * starts with a granule header, so no tile ever has index 0.
+ */
+
+static signed char
+mmapTileStore()
+{
+    int prot = PROT_READ | PROT_WRITE;
+    unsigned long map_len = TILE_STORE_BLOCK_SIZE;
+
+    if (TileStoreBase == NULL)
+    {
+	TileStoreBase = (char *) mmap(NULL, TILE_STORE_RESERVE, PROT_NONE,
+		MAP_ANON | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+	if ((void *) TileStoreBase == MAP_FAILED)
+	{
+	    TxError("TileStore: Unable to reserve tile address space\n");
+	    _exit(1);
+	}
+	_block_begin = (void *) TileStoreBase;
+	_block_end = (void *) TileStoreBase;
+	_current_ptr = (void *) TileStoreBase;
+    }
+
+    if ((unsigned long)_block_end + map_len >
+		(unsigned long)TileStoreBase + TILE_STORE_RESERVE)
+    {
+	TxError("TileStore: Tile address space exhausted\n");
+	_exit(1);
+    }
+    if (mprotect(_block_end, map_len, prot) != 0)
+    {
+	TxError("TileStore: Unable to commit tile store block\n");
+	_exit(1);
+    }
+    _block_end = (void *) ((unsigned long) _block_end + map_len);
+    return 0;
+}
+
+#else
+
 /* MMAP the tile store */
 static signed char
 mmapTileStore()
@@ -679,80 +1174,441 @@ mmapTileStore()
     return 0;
 }
 
-Tile *
-getTileFromTileStore()
+#endif /* !COMPACT_TILES */
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * tileChunkGet --
+ *
+ * Obtain a chunk of (1 << class) granules from the tile store, either
+ * from the list of chunks released by earlier planes or by carving it
+ * out of the current mmap'd block.  Chunks are aligned on the smaller
+ * of their own size and the page size, so that chunks of one page or
+ * more can be handed back to the operating system when released.
+ *
+ * Results:
+ *	Pointer to the start of the chunk.
+ *
+ * Side effects:
+ *	May map a new block for the tile store.
+ *
+ * --------------------------------------------------------------------
+ */
+
+static char *
+tileChunkGet(class)
+    int class;
 {
-    Tile *_return_tile = NULL;
+    char *chunk;
+    pointertype size, align;
+
+    if (tileChunkFreeCount[class] > 0)
+	return tileChunkFree[class][--tileChunkFreeCount[class]];
+
+    if (tilePageSize == 0)
+	tilePageSize = getpagesize();
+
+    size = (pointertype) TILE_GRANULE_SIZE << class;
+    align = (size < tilePageSize) ? size : tilePageSize;
 
     if (!_block_begin && !_block_end)
+	mmapTileStore();
+
+    while (TRUE)
     {
+	chunk = (char *) (((pointertype) _current_ptr + align - 1) & ~(align - 1));
+	if (chunk + size <= (char *) _block_end)
+	    break;
+
+#ifndef COMPACT_TILES
+	/* Don't waste the tail end of the old block */
+	while ((char *) _current_ptr + TILE_GRANULE_SIZE <= (char *) _block_end)
+	{
+	    tileChunkPut((char *) _current_ptr, 0);
+	    _current_ptr = (void *) ((char *) _current_ptr + TILE_GRANULE_SIZE);
+	}
+#endif
 	mmapTileStore();
     }
 
-    /* Check if we can get the tile from the 
-     * Free list
-     */
+    /* Granules skipped for alignment are kept for single-granule chunks */
+    while ((char *) _current_ptr < chunk)
+    {
+	tileChunkPut((char *) _current_ptr, 0);
+	_current_ptr = (void *) ((char *) _current_ptr + TILE_GRANULE_SIZE);
+    }
+    _current_ptr = (void *) (chunk + size);
+    return chunk;
+}
 
-    if (TileStoreFreeList)
+/*
+ * --------------------------------------------------------------------
+ *
+ * tileChunkPut --
+ *
+ * Return a chunk of (1 << class) granules to the tile store.  The
+ * chunk's pages are given back to the operating system if it spans
+ * whole pages;  they are mapped again, zero-filled, on next use.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Adds the chunk to the free list for its size class.
+ *
+ * --------------------------------------------------------------------
+ */
+
+static void
+tileChunkPut(chunk, class)
+    char *chunk;
+    int class;
+{
+    pointertype size = (pointertype) TILE_GRANULE_SIZE << class;
+
+#ifdef MADV_DONTNEED
+    if (tilePageSize != 0 && (size % tilePageSize) == 0
+		&& ((pointertype) chunk % tilePageSize) == 0)
+	(void) madvise((void *) chunk, size, MADV_DONTNEED);
+#endif
+
+    if (tileChunkFreeCount[class] == tileChunkFreeMax[class])
     {
-	_return_tile = TileStoreFreeList;
-	TileStoreFreeList = (Tile *)TileStoreFreeList->ti_client;
-	return _return_tile;
+	char **newlist;
+	int newmax = (tileChunkFreeMax[class] == 0) ? 64
+			: tileChunkFreeMax[class] * 2;
+
+	newlist = (char **) mallocMagic((unsigned) (newmax * sizeof (char *)));
+	if (tileChunkFreeCount[class] > 0)
+	    memcpy(newlist, tileChunkFree[class],
+			tileChunkFreeCount[class] * sizeof (char *));
+	if (tileChunkFree[class] != NULL)
+	    freeMagic((char *) tileChunkFree[class]);
+	tileChunkFree[class] = newlist;
+	tileChunkFreeMax[class] = newmax;
     }
+    tileChunkFree[class][tileChunkFreeCount[class]++] = chunk;
+}
 
-    /* Get it from the mmap */
+/*
+ * --------------------------------------------------------------------
+ *
+ * tileArenaNew --
+ *
+ * Create a new, empty arena.  No memory is taken from the tile store
+ * until the first tile is allocated.
+ *
+ * Results:
+ *	Pointer to the new arena.
+ *
+ * Side effects:
+ *	Allocates memory.
+ *
+ * --------------------------------------------------------------------
+ */
+
+static TileArena *
+tileArenaNew()
+{
+    TileArena *arena;
+
+    arena = (TileArena *) mallocMagic((unsigned) (sizeof (TileArena)));
+#ifdef COMPACT_TILES
+    arena->ta_free = NULL;
+    arena->ta_free_first = arena->ta_free_count = arena->ta_free_size = 0;
+#else
+    arena->ta_free = arena->ta_free_end = NULL;
+#endif
+    arena->ta_next = arena->ta_end = arena->ta_limit = NULL;
+    arena->ta_chunks = NULL;
+    arena->ta_class = 0;
+    return arena;
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * tileArenaAlloc --
+ *
+ * Allocate a tile from an arena.  Tiles freed with TiFree() are reused
+ * first, oldest first, so that a tile just freed stays intact for a
+ * while (some callers read the stitches of a tile right after freeing
+ * it).  Otherwise the next slot of the arena's current granule is used,
+ * moving on to the next granule of the chunk or to a new chunk when the
+ * granule is full.
+ *
+ * Results:
+ *	Pointer to an initialized tile.
+ *
+ * Side effects:
+ *	May add a chunk to the arena.
+ *
+ * --------------------------------------------------------------------
+ */
 
-    if (((unsigned long)_current_ptr + sizeof(Tile)) 
-		 > (unsigned long)_block_end)
+static Tile *
+tileArenaAlloc(arena)
+    TileArena *arena;
+{
+    Tile *newtile;
+    TileGranule *granule;
+    char *next;
+#ifdef COMPACT_TILES
+    int i;
+
+    if (arena->ta_free_count > 0)
     {
-	 mmapTileStore();
+	newtile = TiIndexToTile(arena->ta_free[arena->ta_free_first]);
+	if (++arena->ta_free_first == arena->ta_free_size)
+	    arena->ta_free_first = 0;
+	arena->ta_free_count--;
     }
-    _current_ptr  = (void *)((unsigned long)_current_ptr + sizeof(Tile));
-	
-    if ((unsigned long)_current_ptr > (unsigned long) _block_end)
+#else
+    if (arena->ta_free != NULL)
     {
-	fprintf(stderr,"TileStore: internal assertion failure...");
-	_exit(1);
+	newtile = arena->ta_free;
+	arena->ta_free = (Tile *) newtile->ti_client;
+	if (arena->ta_free == NULL)
+	    arena->ta_free_end = NULL;
+    }
+#endif
+    else
+    {
+	if (arena->ta_next + sizeof (Tile) > arena->ta_end)
+	{
+	    /* Move to the next granule of the chunk, or to a new chunk */
+	    next = (char *) (((pointertype) arena->ta_next + TILE_GRANULE_SIZE - 1)
+			& ~((pointertype) TILE_GRANULE_SIZE - 1));
+	    if (arena->ta_next == NULL || next >= arena->ta_limit)
+	    {
+		TILE_STORE_LOCK();
+		next = tileChunkGet(arena->ta_class);
+		TILE_STORE_UNLOCK();
+		granule = (TileGranule *) next;
+		granule->tg_next = arena->ta_chunks;
+		granule->tg_class = arena->ta_class;
+#ifdef COMPACT_TILES
+		for (i = 0; i < (1 << arena->ta_class); i++)
+		    ((TileGranule *) (next + i * TILE_GRANULE_SIZE))->tg_client
+				= NULL;
+#endif
+		arena->ta_chunks = granule;
+		arena->ta_limit = next + (TILE_GRANULE_SIZE << arena->ta_class);
+		if (arena->ta_class < TILE_CHUNK_CLASSES - 1)
+		    arena->ta_class++;
+	    }
+	    ((TileGranule *) next)->tg_arena = arena;
+	    arena->ta_next = next + sizeof (Tile);
+	    arena->ta_end = next + (TILE_GRANULE_SIZE / sizeof (Tile))
+			* sizeof (Tile);
+	}
+	newtile = (Tile *) arena->ta_next;
+	arena->ta_next += sizeof (Tile);
     }
-    return (Tile *)((unsigned long)_current_ptr - sizeof(Tile));
+
+    TiSetClient(newtile, CLIENTDEFAULT);
+    TiSetBody(newtile, 0);
+    return (newtile);
 }
 
+/*
+ * --------------------------------------------------------------------
+ *
+ * tileArenaRelease --
+ *
+ * Return all chunks owned by an arena to the tile store and leave the
+ * arena empty, but still usable.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Every tile allocated from the arena becomes invalid.
+ *
+ * --------------------------------------------------------------------
+ */
+
 static void
-TileStoreFree(ptr)
-    Tile *ptr;
+tileArenaRelease(arena)
+    TileArena *arena;
 {
-    if (!TileStoreFreeList_end || !TileStoreFreeList)
+    TileGranule *granule, *next;
+#ifdef COMPACT_TILES
+    TileGranule *g;
+    int i;
+
+    /* Client tables are attached to individual granules */
+    for (granule = arena->ta_chunks; granule != NULL; granule = granule->tg_next)
+	for (i = 0; i < (1 << granule->tg_class); i++)
+	{
+	    g = (TileGranule *) ((char *) granule + i * TILE_GRANULE_SIZE);
+	    if (g->tg_client != NULL)
+		freeMagic((char *) g->tg_client);
+	}
+#endif
+
+    TILE_STORE_LOCK();
+    for (granule = arena->ta_chunks; granule != NULL; granule = next)
     {
-	TileStoreFreeList_end = ptr;
-	ptr->ti_client = (unsigned long)0;
-	TileStoreFreeList = TileStoreFreeList_end;
-    }
-    else
-    {
-	TileStoreFreeList_end->ti_client = (unsigned long)ptr;
-	TileStoreFreeList_end = ptr;
-	TileStoreFreeList_end->ti_client = (unsigned long) 0;
+	next = granule->tg_next;
+	tileChunkPut((char *) granule, granule->tg_class);
     }
+    TILE_STORE_UNLOCK();
+    arena->ta_chunks = NULL;
+#ifdef COMPACT_TILES
+    if (arena->ta_free != NULL)
+	freeMagic((char *) arena->ta_free);
+    arena->ta_free = NULL;
+    arena->ta_free_first = arena->ta_free_count = arena->ta_free_size = 0;
+#else
+    arena->ta_free = arena->ta_free_end = NULL;
+#endif
+    arena->ta_next = arena->ta_end = arena->ta_limit = NULL;
+    arena->ta_class = 0;
 }
 
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiAlloc, TiPlaneAlloc, TiAllocNear --
+ *
+ *	Memory allocation for tiles.  TiAlloc() takes the tile from the
+ *	shared arena, TiPlaneAlloc() from the arena of the given plane,
+ *	and TiAllocNear() from the same arena as an existing tile.  Any
+ *	tile that will become part of a plane must be allocated by one of
+ *	the latter two, or it will not be released with the plane.
+ *
+ * Results:
+ *	Pointer to an initialized tile.
+ *
+ * --------------------------------------------------------------------
+ */
+
 Tile *
 TiAlloc()
 {
-    Tile *newtile;
+    return tileArenaAlloc(&tileSharedArena);
+}
 
-    newtile = getTileFromTileStore();
-    TiSetClient(newtile, CLIENTDEFAULT);
-    TiSetBody(newtile, 0);
-    return (newtile);
+Tile *
+TiPlaneAlloc(plane)
+    Plane *plane;
+{
+    return tileArenaAlloc(plane->pl_arena);
 }
 
+Tile *
+TiAllocNear(tp)
+    Tile *tp;
+{
+    return tileArenaAlloc(TiGetArena(tp));
+}
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiFree ---
+ *
+ *	Return a tile to the free list of its arena.  Only the client
+ *	word is overwritten, so the tile's stitches may still be read
+ *	until the next tile allocation from the same arena.
+ *
+ * Results:
+ *	None.
+ *
+ * --------------------------------------------------------------------
+ */
+
 void
 TiFree(tp)
     Tile *tp;
 {
-    TileStoreFree(tp);
+    TileArena *arena = TiGetArena(tp);
+#ifdef COMPACT_TILES
+    TileIndex *newq;
+    int i, n;
+
+    if (arena->ta_free_count == arena->ta_free_size)
+    {
+	/* Grow the queue, unwrapping it at the same time */
+	n = (arena->ta_free_size == 0) ? 64 : arena->ta_free_size * 2;
+	newq = (TileIndex *) mallocMagic((unsigned) (n * sizeof (TileIndex)));
+	for (i = 0; i < arena->ta_free_count; i++)
+	    newq[i] = arena->ta_free[(arena->ta_free_first + i)
+			% arena->ta_free_size];
+	if (arena->ta_free != NULL)
+	    freeMagic((char *) arena->ta_free);
+	arena->ta_free = newq;
+	arena->ta_free_first = 0;
+	arena->ta_free_size = n;
+    }
+    arena->ta_free[(arena->ta_free_first + arena->ta_free_count)
+		% arena->ta_free_size] = TiTileToIndex(tp);
+    arena->ta_free_count++;
+
+    /* The next user of the slot expects the default client value */
+    if (TiClientTable(tp) != NULL)
+	TiClientTable(tp)[TiClientSlot(tp)] = (ClientData) CLIENTDEFAULT;
+#else
+
+    tp->ti_client = (ClientData) NULL;
+    if (arena->ta_free_end != NULL)
+	arena->ta_free_end->ti_client = (ClientData) tp;
+    else
+	arena->ta_free = tp;
+    arena->ta_free_end = tp;
+#endif
+}
+
+#ifdef COMPACT_TILES
+
+/*
+ * --------------------------------------------------------------------
+ *
+ * TiAttachClient --
+ *
+ *	Store a client value for a tile whose granule has no client table
+ *	yet (see TiSetClient() in tile.h).  Storing CLIENTDEFAULT needs no
+ *	table.  Tiles of one granule may be marked by several pool threads
+ *	at once, so the table is installed with an atomic swap and a
+ *	thread losing the race discards its own.
+ *
+ * Results:
+ *	The value stored.
+ *
+ * Side effects:
+ *	May allocate the client table of the tile's granule.
+ *
+ * --------------------------------------------------------------------
+ */
+
+ClientData
+TiAttachClient(tp, value)
+    Tile *tp;
+    ClientData value;
+{
+    TileGranule *granule;
+    ClientData *table;
+    int i, n = TILE_GRANULE_SIZE / sizeof (Tile);
+
+    if (value == (ClientData) CLIENTDEFAULT)
+	return value;
+
+    granule = (TileGranule *) ((pointertype) tp
+		& ~((pointertype) TILE_GRANULE_SIZE - 1));
+    table = (ClientData *) mallocMagic((unsigned) (n * sizeof (ClientData)));
+    for (i = 0; i < n; i++)
+	table[i] = (ClientData) CLIENTDEFAULT;
+    if (!__sync_bool_compare_and_swap(&granule->tg_client,
+		(ClientData *) NULL, table))
+	freeMagic((char *) table);
+    granule->tg_client[TiClientSlot(tp)] = value;
+    return value;
 }
 
+#endif /* COMPACT_TILES */
+
 #else
 
 /*
@@ -779,6 +1635,22 @@ TiAlloc()
     return (newtile);
 }
 
+/* Without mmap() support there are no arenas */
+
+Tile *
+TiPlaneAlloc(plane)
+    Plane *plane;
+{
+    return TiAlloc();
+}
+
+Tile *
+TiAllocNear(tp)
+    Tile *tp;
+{
+    return TiAlloc();
+}
+
 /*
  * --------------------------------------------------------------------
  *
@@ -824,5 +1696,5 @@ tiPrintAll(tp)
     printf("UR=(%d,%d)\n", RIGHT(tp), TOP(tp));
 
     /* The following is for plowing debugging */
-    printf("LEAD=%d\n", (int) tp->ti_client);
+    printf("LEAD=%d\n", (int) TiGetClient(tp));
 }
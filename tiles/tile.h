@@ -52,8 +52,37 @@
  *
  * Space tiles are distinguished at a higher level by having a distinguished
  * tile body.
+ *
+ * When compiled with COMPACT_TILES, the four corner stitches are stored
+ * as 32-bit indices instead of pointers.  All tiles are then allocated
+ * out of a single address range reserved by the tile store, and an index
+ * is the offset of the tile from the base of that range in units of
+ * TILE_INDEX_UNIT bytes.  Index 0 is never a tile and represents a NULL
+ * stitch.  The ti_client word is moved out of the tile into a side table
+ * that is only attached to a granule of tiles (see below) when one of
+ * them is given a value other than CLIENTDEFAULT.  This shrinks each tile
+ * from 56 to 32 bytes on 64-bit machines.  Code outside of this module
+ * must use the LB/BL/TR/RT macros to read stitches, the TiSetLB/TiSetBL/
+ * TiSetTR/TiSetRT macros to write them, and TiGetClient/TiSetClient to
+ * access the client word.
  */
 
+#ifdef COMPACT_TILES
+
+typedef unsigned int TileIndex;
+
+typedef struct tile
+{
+    ClientData	 ti_body;	/* Body of tile */
+    TileIndex	 ti_lb;		/* Left bottom corner stitch */
+    TileIndex	 ti_bl;		/* Bottom left corner stitch */
+    TileIndex	 ti_tr;		/* Top right corner stitch */
+    TileIndex	 ti_rt;		/* Right top corner stitch */
+    Point	 ti_ll;		/* Lower left coordinate */
+} Tile;
+
+#else
+
 typedef struct tile
 {
     ClientData	 ti_body;	/* Body of tile */
@@ -69,6 +98,8 @@ typedef struct tile
 				 */
 } Tile;
 
+#endif /* COMPACT_TILES */
+
     /*
      * The following macros make it appear as though both
      * the lower left and upper right coordinates of a tile
@@ -79,27 +110,131 @@ typedef struct tile
 #include <sys/mman.h>
 #include <unistd.h>
 
-/* This is an on-demand Free List management */
-typedef Tile *TileStore;
-
 /* Page size is 4KB so we mmap a segment equal to 64 pages */
 #define TILE_STORE_BLOCK_SIZE (4 * 1024 * 64)
 
-extern Tile *TileStoreFreeList;
-extern Tile *TileStoreFreeList_end;
-
 #endif /* HAVE_SYS_MMAN_H */
 
-#define	BOTTOM(tp)		((tp)->ti_ll.p_y)
-#define	LEFT(tp)		((tp)->ti_ll.p_x)
-#define	TOP(tp)			(BOTTOM(RT(tp)))
-#define	RIGHT(tp)		(LEFT(TR(tp)))
+/* ----------------------- Tile arenas -------------------------------- */
+
+/*
+ * Each plane allocates its tiles from its own arena, so that tiles of
+ * one plane are kept together in memory and the whole plane can be
+ * released at once.  An arena takes chunks of memory from the tile
+ * store, starting with a single granule of TILE_GRANULE_SIZE bytes and
+ * doubling the chunk size up to TILE_CHUNK_MAX granules as the plane
+ * grows.  The first tile-sized slot of every granule is a TileGranule
+ * header pointing back to the arena, which lets TiFree() and the tile
+ * splitting procedures find the arena of a tile from its address alone.
+ * Tiles allocated with TiAlloc() come from a shared arena that is never
+ * released.  Without mmap() support, tiles are allocated one at a time
+ * with mallocMagic() and planes have no arena.
+ */
+
+typedef struct tileGranule
+{
+    struct tileArena	*tg_arena;	/* Arena owning this granule */
+    struct tileGranule	*tg_next;	/* Next chunk of the same arena.  Only
+					 * valid in the first granule of a chunk.
+					 */
+    int			 tg_class;	/* Chunk size is (1 << tg_class)
+					 * granules.  Only valid in the first
+					 * granule of a chunk.
+					 */
+#ifdef COMPACT_TILES
+    ClientData		*tg_client;	/* Client words of the tiles in this
+					 * granule, indexed by slot, or NULL
+					 * if all of them are CLIENTDEFAULT.
+					 */
+#endif
+} TileGranule;
+
+typedef struct tileArena
+{
+#ifdef COMPACT_TILES
+    TileIndex	*ta_free;	/* Queue of the tiles returned by TiFree(),
+				 * reused oldest first.
+				 */
+    int		 ta_free_first;	/* Position of the oldest tile in ta_free */
+    int		 ta_free_count;	/* Number of tiles in ta_free */
+    int		 ta_free_size;	/* Allocated size of ta_free */
+#else
+    Tile	*ta_free;	/* Tiles returned by TiFree(), linked through
+				 * ti_client and reused oldest first.
+				 */
+    Tile	*ta_free_end;	/* Last tile on the free list */
+#endif
+    char	*ta_next;	/* Next unused slot in the current granule */
+    char	*ta_end;	/* End of the usable slots in that granule */
+    char	*ta_limit;	/* End of the current chunk */
+    TileGranule	*ta_chunks;	/* List of all chunks owned by this arena */
+    int		 ta_class;	/* Size class of the next chunk */
+} TileArena;
+
+#define	TILE_GRANULE_SIZE	1024
+#define	TILE_CHUNK_CLASSES	7
+#define	TILE_CHUNK_MAX		(1 << (TILE_CHUNK_CLASSES - 1))
+
+#define	TiGetArena(tp) \
+	(((TileGranule *) ((pointertype)(tp) & \
+		~((pointertype) TILE_GRANULE_SIZE - 1)))->tg_arena)
+
+#ifdef COMPACT_TILES
+
+#ifndef HAVE_SYS_MMAN_H
+#error "COMPACT_TILES requires mmap() support"
+#endif
+
+/*
+ * Tiles are aligned on TILE_INDEX_UNIT byte boundaries, so a 32-bit
+ * index can address (4G * TILE_INDEX_UNIT) bytes of tiles.  The tile
+ * store reserves (but does not commit) that much address space up front.
+ */
+
+#define TILE_INDEX_SHIFT	3
+#define TILE_INDEX_UNIT		(1 << TILE_INDEX_SHIFT)
+#define TILE_STORE_RESERVE	((pointertype)1 << (32 + TILE_INDEX_SHIFT))
+#define TILE_INDEX_BAD		((TileIndex) 0xffffffff)
+
+extern char *TileStoreBase;
+
+#define TiIndexToTile(i) \
+	(((i) == 0) ? (Tile *) NULL : ((i) == TILE_INDEX_BAD) ? BADTILE : \
+	 (Tile *)(TileStoreBase + ((pointertype)(i) << TILE_INDEX_SHIFT)))
+#define TiTileToIndex(tp) \
+	(((tp) == (Tile *) NULL) ? (TileIndex) 0 : \
+	 ((tp) == BADTILE) ? TILE_INDEX_BAD : \
+	 (TileIndex)(((char *)(tp) - TileStoreBase) >> TILE_INDEX_SHIFT))
+
+#define	LB(tp)		(TiIndexToTile((tp)->ti_lb))
+#define	BL(tp)		(TiIndexToTile((tp)->ti_bl))
+#define	TR(tp)		(TiIndexToTile((tp)->ti_tr))
+#define	RT(tp)		(TiIndexToTile((tp)->ti_rt))
+
+#define	TiSetLB(tp, t)	((tp)->ti_lb = TiTileToIndex(t))
+#define	TiSetBL(tp, t)	((tp)->ti_bl = TiTileToIndex(t))
+#define	TiSetTR(tp, t)	((tp)->ti_tr = TiTileToIndex(t))
+#define	TiSetRT(tp, t)	((tp)->ti_rt = TiTileToIndex(t))
+
+#else
 
 #define	LB(tp)		((tp)->ti_lb)
 #define	BL(tp)		((tp)->ti_bl)
 #define	TR(tp)		((tp)->ti_tr)
 #define	RT(tp)		((tp)->ti_rt)
 
+#define	TiSetLB(tp, t)	((tp)->ti_lb = (t))
+#define	TiSetBL(tp, t)	((tp)->ti_bl = (t))
+#define	TiSetTR(tp, t)	((tp)->ti_tr = (t))
+#define	TiSetRT(tp, t)	((tp)->ti_rt = (t))
+
+#endif /* COMPACT_TILES */
+
+#define	BOTTOM(tp)		((tp)->ti_ll.p_y)
+#define	LEFT(tp)		((tp)->ti_ll.p_x)
+#define	TOP(tp)			(BOTTOM(RT(tp)))
+#define	RIGHT(tp)		(LEFT(TR(tp)))
+
 
 /* ----------------------- Tile planes -------------------------------- */
 
@@ -128,7 +263,7 @@ extern Tile *TileStoreFreeList_end;
  *	 --------------------------------------
  */
 
-typedef struct
+typedef struct plane
 {
     Tile	*pl_left;	/* Left pseudo-tile */
     Tile	*pl_top;	/* Top pseudo-tile */
@@ -137,8 +272,70 @@ typedef struct
     Tile	*pl_hint;	/* Pointer to a "hint" at which to
 				 * begin searching.
 				 */
+    TileArena	*pl_arena;	/* Arena from which the tiles of this
+				 * plane are allocated.
+				 */
+    struct plane *pl_owner;	/* If non-NULL, this plane has no tiles of
+				 * its own, but shares those of pl_owner.
+				 */
+    struct plane *pl_views;	/* If this plane owns tiles, the first of
+				 * the planes sharing them;  if it shares
+				 * the tiles of another plane, the next
+				 * plane sharing those tiles.
+				 */
+    unsigned int pl_generation;	/* Advanced by TiPlaneModify() and
+				 * TiClearPlane(), so code that keeps
+				 * pointers to the tiles can tell when
+				 * they may have changed.
+				 */
 } Plane;
 
+/*
+ * A plane may share all of its tiles with another plane (see
+ * TiSharePlane()), so that a copy of a whole plane costs nothing
+ * until one of the two is changed.  Planes sharing their tiles
+ * must only be searched.  Any procedure that changes the tiles of
+ * a plane must first call TiPlaneModify(), which gives the plane
+ * a private copy of its tiles if they are shared, and advances the
+ * plane's pl_generation.  The procedures
+ * of the tile module and the paint procedures of the database do
+ * this;  code that splits, joins, or retypes the tiles of a plane
+ * directly must not be used on planes that may be shared.  Note
+ * that the ti_client fields of shared tiles are shared as well.
+ */
+
+#define	TiPlaneIsShared(plane) \
+	((plane)->pl_owner != NULL || (plane)->pl_views != NULL)
+#define	TiPlaneModify(plane) \
+	((plane)->pl_generation++, \
+	 TiPlaneIsShared(plane) ? TiUnsharePlane(plane) : (void) 0)
+
+/*
+ * A TileCursor carries the hint for a sequence of reentrant searches
+ * (TiSrPointCursor(), TiSrAreaCursor(), DBSrPaintAreaCursor()).  It
+ * plays the part of pl_hint, but belongs to the caller, so that any
+ * number of threads may search the same plane at once, each with
+ * its own cursor, provided that nobody modifies the plane meanwhile.
+ * The plane's own pl_hint is read to start the cursor, never written.
+ */
+
+typedef struct
+{
+    Plane	*tc_plane;	/* Plane being searched */
+    Tile	*tc_hint;	/* Tile at which the next search starts */
+} TileCursor;
+
+#define	TiCursorInit(tc, plane) \
+	((tc)->tc_plane = (plane), (tc)->tc_hint = (plane)->pl_hint)
+
+/*
+ * A TileBuilder collects the rectangles that are to make up the
+ * contents of an empty plane, and then creates all of its tiles at
+ * once (see build.c).  Its contents are private to the tile module.
+ */
+
+typedef struct tileBuilder TileBuilder;
+
 /*
  * The following coordinate, INFINITY, is used to represent a
  * tile location outside of the tile plane.
@@ -178,6 +375,9 @@ typedef struct
 
 extern Plane *TiNewPlane(Tile *);
 extern void TiFreePlane(Plane *);
+extern void TiClearPlane(Plane *);
+extern void TiSharePlane(Plane *, Plane *);
+extern void TiUnsharePlane(Plane *);
 extern void TiToRect(Tile *, Rect *);
 extern Tile *TiSplitX(Tile *, int);
 extern Tile *TiSplitY(Tile *, int);
@@ -187,6 +387,11 @@ extern void  TiJoinX(Tile *, Tile *, Plane *);
 extern void  TiJoinY(Tile *, Tile *, Plane *);
 extern int   TiSrArea();
 extern Tile *TiSrPoint(Tile *, Plane *, Point *);
+extern int   TiSrAreaCursor();
+extern Tile *TiSrPointCursor(TileCursor *, Point *);
+extern TileBuilder *TiBuildStart(Plane *);
+extern void  TiBuildRect(TileBuilder *, Rect *, ClientData);
+extern void  TiBuildFinish(TileBuilder *);
 
 #define	TiBottom(tp)		(BOTTOM(tp))
 #define	TiLeft(tp)		(LEFT(tp))
@@ -240,10 +445,45 @@ extern Tile *TiSrPoint(Tile *, Plane *, Point *);
 #define	TiGetBody(tp)		((tp)->ti_body)
 /* See diagnostic subroutine version in tile.c */
 #define	TiSetBody(tp, b)	((tp)->ti_body = (ClientData)(pointertype) (b))
+
+#ifdef COMPACT_TILES
+
+/*
+ * The client words of the tiles of a granule are kept in a table hung
+ * off the granule header, one word per tile-sized slot of the granule.
+ * A granule without a table has all of its client words equal to
+ * CLIENTDEFAULT, and TiSetClient() only attaches a table (through
+ * TiAttachClient()) when some other value is stored.  Both macros may
+ * evaluate tp more than once.
+ */
+
+#define	TiClientTable(tp) \
+	(((TileGranule *) ((pointertype)(tp) & \
+		~((pointertype) TILE_GRANULE_SIZE - 1)))->tg_client)
+#define	TiClientSlot(tp) \
+	(((pointertype)(tp) & ((pointertype) TILE_GRANULE_SIZE - 1)) \
+		/ sizeof (Tile))
+#define	TiGetClient(tp) \
+	((TiClientTable(tp) != NULL) ? TiClientTable(tp)[TiClientSlot(tp)] \
+		: (ClientData) CLIENTDEFAULT)
+#define	TiSetClient(tp,b) \
+	((TiClientTable(tp) != NULL) ? \
+		(TiClientTable(tp)[TiClientSlot(tp)] = \
+			(ClientData)(pointertype) (b)) : \
+		TiAttachClient(tp, (ClientData)(pointertype) (b)))
+
+extern ClientData TiAttachClient(Tile *, ClientData);
+
+#else
+
 #define	TiGetClient(tp)		((tp)->ti_client)
 #define	TiSetClient(tp,b)	((tp)->ti_client = (ClientData)(pointertype) (b))
 
+#endif /* COMPACT_TILES */
+
 Tile *TiAlloc(void);
+Tile *TiPlaneAlloc(Plane *);
+Tile *TiAllocNear(Tile *);
 void TiFree(Tile *);
 
 #define EnclosePoint(tile,point)	((LEFT(tile)   <= (point)->p_x ) && \
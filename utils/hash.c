@@ -16,6 +16,14 @@
  * See hash.h for a definition of the structure of the hash
  * table.  Hash tables grow automatically as the amount of
  * information increases.
+ *
+ * Tables use open addressing with Robin Hood insertion:  each key
+ * lives in the first free slot at or after its home slot, and an
+ * entry that is further from its home slot than the one occupying
+ * a slot takes that slot over.  This keeps probe sequences short,
+ * and lets a search for a missing key stop as soon as it reaches
+ * an entry closer to home than the key would be.  The entries
+ * themselves are allocated from a per-table slab and never move.
  */
 
 #ifndef lint
@@ -29,14 +37,28 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include "utils/hash.h"
 #include "utils/malloc.h"
 
-/* Used before it's defined: */
-void rebuild();
+/* Used before they're defined: */
+void rebuild(), hashMove();
+
+/*
+ * The table grows when more than HT_LOADNUM/HT_LOADDEN of its slots
+ * are in use.  While the old slots are being moved into the grown
+ * table, each new entry moves HT_MOVESTEP of them;  this finishes
+ * the move well before the grown table fills up in turn.
+ */
+#define HT_LOADNUM	3
+#define HT_LOADDEN	4
+#define HT_MOVESTEP	4
 
 /*
- * The following defines the ratio of # entries to # buckets
- * at which we rebuild the table to make it larger.
+ * Entries are allocated from chunks that start at HT_SLABMIN bytes
+ * and double for each new chunk, up to HT_SLABMAX bytes.  Each chunk
+ * begins with a pointer to the previous one.
  */
-static int rebuildLimit = 3;
+#define HT_SLABMIN	256
+#define HT_SLABMAX	65536
+#define HT_SLABALIGN	(sizeof (double))
+#define HT_SLABHEAD	((sizeof (char *) + HT_SLABALIGN - 1) & ~(HT_SLABALIGN - 1))
 
 /*
  * An invalid pointer, guaranteed to cause a coredump if 
@@ -45,7 +67,10 @@ static int rebuildLimit = 3;
  */
 #define NIL ((HashEntry *) (1<<29))
 
-
+/* Distance of slot 'i' from the home slot of hash value 'h' */
+#define HT_DIST(i, h, mask)	(((i) - ((h) & (mask))) & (mask))
+
+
 /*---------------------------------------------------------
  *
  * HashInit --
@@ -56,17 +81,17 @@ static int rebuildLimit = 3;
  * if it's desired to provide the hash module with procedures to
  * use for comparing and copying hash table keys, use HashInitClient().
  *
- * The number of buckets in the table at the start is 'nBuckets',
+ * The number of slots in the table at the start is 'nBuckets',
  * which is automatically rounded up to a power of two.  This isn't
- * a limit on the number of buckets the table will eventually contain,
- * though, since more buckets are automatically created if the table
- * gets too full (the number of buckets increases by 4x).
+ * a limit on the number of entries the table will eventually contain,
+ * though, since the table is automatically doubled in size when it
+ * becomes three-quarters full.
  *
  * Results:
  *	None.
  *
  * Side Effects:
- *	Memory is allocated for the initial bucket area.
+ *	Memory is allocated for the initial array of slots.
  *
  * Table Organization:
  *	Tables can be organized in either of four ways, depending
@@ -145,7 +170,7 @@ static int rebuildLimit = 3;
 void
 HashInit(table, nBuckets, ptrKeys)
     HashTable *table;		/* Table to be initialized */
-    int nBuckets;		/* How many buckets to create for starters */
+    int nBuckets;		/* How many slots to create for starters */
     int ptrKeys;		/* See comments above */
 {
     ASSERT(ptrKeys != HT_CLIENTKEYS, "HashInit: should use HashInitClient");
@@ -157,16 +182,13 @@ HashInit(table, nBuckets, ptrKeys)
 void
 HashInitClient(table, nBuckets, ptrKeys, compareFn, copyFn, hashFn, killFn)
     HashTable *table;		/* Table to be initialized */
-    int nBuckets;		/* How many buckets to create for starters */
+    int nBuckets;		/* How many slots to create for starters */
     int ptrKeys;		/* See comments above */
     int (*compareFn)();		/* Function to compare two keys */
     char *(*copyFn)();		/* Function to copy a key */
     int (*hashFn)();		/* For hashing */
     int (*killFn)();		/* For hashing */
 {
-    HashEntry ** ptr;
-    int i;
-
     table->ht_nEntries = 0;
     table->ht_ptrKeys = ptrKeys;
     table->ht_compareFn = compareFn;
@@ -174,93 +196,317 @@ HashInitClient(table, nBuckets, ptrKeys, compareFn, copyFn, hashFn, killFn)
     table->ht_hashFn = hashFn;
     table->ht_killFn = killFn;
 
+    table->ht_oldTable = (HashEntry **) NULL;
+    table->ht_oldHashes = (unsigned *) NULL;
+    table->ht_oldSize = 0;
+    table->ht_moved = 0;
+    table->ht_first = table->ht_last = (HashEntry *) NULL;
+    table->ht_slab = table->ht_slabFree = table->ht_slabEnd = (char *) NULL;
+
     /* Round up the size to a power of two */
     if (nBuckets < 0) nBuckets = -nBuckets;
-    table->ht_size = 2;
-    table->ht_mask = 1;
-    table->ht_downShift = 29;
+    table->ht_size = 4;
     while (table->ht_size < nBuckets)
-    {
 	table->ht_size <<= 1;
-	table->ht_mask = (table->ht_mask<<1) + 1;
-	table->ht_downShift--;
-    }
+    table->ht_mask = table->ht_size - 1;
 
-    /* Allocate and initialize the buckets */
+    /* Allocate and initialize the slots */
     table->ht_table = (HashEntry **) mallocMagic(
 		(unsigned) (sizeof (HashEntry *)  * table->ht_size));
-    ptr = table->ht_table;
-    for (i = 0; i < table->ht_size; i++)
-	*ptr++ = NIL;
+    table->ht_hashes = (unsigned *) mallocMagic(
+		(unsigned) (sizeof (unsigned)  * table->ht_size));
+    memset(table->ht_hashes, 0, sizeof (unsigned) * table->ht_size);
 }
-
+
 /*---------------------------------------------------------
  *
  * hash --
  *
- * This is a local procedure to compute a hash table
- * bucket address based on a key value.
+ * This is a local procedure to compute the hash value
+ * of a key.
  *
  * Results:
- *	The return value is an integer between 0 and size-1.
+ *	A nonzero 32-bit hash value.  The low-order bits
+ *	select the key's home slot, so every bit of the key
+ *	is mixed into them.
  *
  * Side Effects:
  *	None.
  *
  * Design:
- *	The randomizing code is stolen straight from the rand()
- *	library routine.
+ *	Strings use FNV-1a.  Word and struct keys are folded
+ *	into a single value and scrambled with the finalizer
+ *	from MurmurHash3, which also spreads out the aligned
+ *	(low-order zero) bits of pointer keys.
  *
  *---------------------------------------------------------
  */
 
-int
+unsigned
 hash(table, key)
     HashTable *table;
     char *key;
 {
     unsigned *up;
-    int i, j;
+    unsigned i;
+    int j;
+    pointertype w;
 
-    i = 0;
     switch (table->ht_ptrKeys)
     {
-	/* Add up the characters as though this were a number */
 	case HT_STRINGKEYS:
-	    while (*key != 0) i = (i*10) + (*key++ - '0');
-	    break;
+	    i = 2166136261U;
+	    while (*key != 0)
+	    {
+		i ^= (unsigned char) *key++;
+		i *= 16777619U;
+	    }
+	    return (i == 0) ? 1 : i;
 
 	/* Map the key into another 32-bit value if necessary */
 	case HT_CLIENTKEYS:
 	    if (table->ht_hashFn)
 	    {
-		i = (*(table->ht_hashFn))(key);
+		w = (pointertype) (unsigned) (*(table->ht_hashFn))(key);
 		break;
 	    }
 	    /* Fall through to ... */
 
-	/* Just use the 32-bit key value */
+	/* Just use the key value */
 	case HT_WORDKEYS:
-	    i = (spointertype) key;
+	    w = (pointertype) key;
 	    break;
 
 	/* Special case for two-word structs */
 	case HT_STRUCTKEYS:
-	    i = ((unsigned *) key)[0] + ((unsigned *) key)[1];
+	    up = (unsigned *) key;
+	    w = ((pointertype) up[0] * 0x9e3779b1U) ^ up[1];
 	    break;
 
 	/* General case of multi-word structs */
 	default:
 	    j = table->ht_ptrKeys;
 	    up = (unsigned *) key;
-	    do { i += *up++; } while (--j);
+	    w = 0;
+	    do { w = (w * 0x9e3779b1U) ^ *up++; } while (--j);
 	    break;
     }
 
     /* Randomize! */
-    return ((i*1103515245 + 12345) >> table->ht_downShift) & table->ht_mask;
+#if SIZEOF_VOID_P == 8
+    w ^= w >> 33;
+    w *= 0xff51afd7ed558ccdUL;
+    w ^= w >> 33;
+    w *= 0xc4ceb9fe1a85ec53UL;
+    w ^= w >> 33;
+#else
+    w ^= w >> 16;
+    w *= 0x85ebca6bU;
+    w ^= w >> 13;
+    w *= 0xc2b2ae35U;
+    w ^= w >> 16;
+#endif
+    i = (unsigned) w;
+    return (i == 0) ? 1 : i;
+}
+
+/*---------------------------------------------------------
+ *
+ * hashKeyEqual --
+ *
+ * Local procedure to compare the key of an entry with a key
+ * passed to HashFind() or HashLookOnly().
+ *
+ * Results:
+ *	TRUE if the keys are the same, FALSE otherwise.
+ *
+ * Side Effects:
+ *	None.
+ *
+ *---------------------------------------------------------
+ */
+
+bool
+hashKeyEqual(table, h, key)
+    HashTable *table;
+    HashEntry *h;
+    char *key;
+{
+    unsigned *up, *kp;
+    int n;
+
+    switch (table->ht_ptrKeys)
+    {
+	case HT_STRINGKEYS:
+	    return (strcmp(h->h_key.h_name, key) == 0);
+	case HT_CLIENTKEYS:
+	    if (table->ht_compareFn)
+		return ((*table->ht_compareFn)(h->h_key.h_ptr, key) == 0);
+	    /* Fall through to ... */
+	case HT_WORDKEYS:
+	    return (h->h_key.h_ptr == key);
+	case HT_STRUCTKEYS:
+	    up = h->h_key.h_words;
+	    kp = (unsigned *) key;
+	    return (up[0] == kp[0] && up[1] == kp[1]);
+	default:
+	    n = table->ht_ptrKeys;
+	    up = h->h_key.h_words;
+	    kp = (unsigned *) key;
+	    do { if (*up++ != *kp++) return FALSE; } while (--n);
+	    return TRUE;
+    }
 }
-
+
+/*---------------------------------------------------------
+ *
+ * hashProbe --
+ *
+ * Local procedure to look for a key in one array of slots.
+ *
+ * Results:
+ *	The entry for key, or NULL if it isn't in these slots.
+ *
+ * Side Effects:
+ *	None.
+ *
+ *---------------------------------------------------------
+ */
+
+HashEntry *
+hashProbe(table, slots, hashes, mask, key, hval)
+    HashTable *table;		/* Table being searched */
+    HashEntry **slots;		/* Slots to look in ... */
+    unsigned *hashes;		/* ... and their hash values */
+    int mask;			/* Number of slots - 1 */
+    char *key;			/* Key to look for ... */
+    unsigned hval;		/* ... and its hash value */
+{
+    unsigned sh;
+    int i, dist;
+
+    i = hval & mask;
+    for (dist = 0; ; dist++)
+    {
+	sh = hashes[i];
+
+	/*
+	 * Stop at an empty slot, or at one whose entry is closer to
+	 * its home than the key would be:  Robin Hood insertion would
+	 * have put the key there.
+	 */
+	if (sh == 0 || HT_DIST(i, sh, mask) < dist)
+	    return ((HashEntry *) NULL);
+	if (sh == hval && hashKeyEqual(table, slots[i], key))
+	    return slots[i];
+	i = (i + 1) & mask;
+    }
+}
+
+/*---------------------------------------------------------
+ *
+ * hashInsert --
+ *
+ * Local procedure to put an entry into the table's current
+ * array of slots.  The entry must not already be present.
+ *
+ * Results:
+ *	None.
+ *
+ * Side Effects:
+ *	Entries may be shifted to later slots.
+ *
+ *---------------------------------------------------------
+ */
+
+void
+hashInsert(table, h, hval)
+    HashTable *table;
+    HashEntry *h;		/* Entry to insert ... */
+    unsigned hval;		/* ... and the hash value of its key */
+{
+    HashEntry **slots = table->ht_table, *th;
+    unsigned *hashes = table->ht_hashes, sh;
+    int mask = table->ht_mask;
+    int i, dist, sdist;
+
+    i = hval & mask;
+    for (dist = 0; ; dist++)
+    {
+	sh = hashes[i];
+	if (sh == 0)
+	{
+	    hashes[i] = hval;
+	    slots[i] = h;
+	    return;
+	}
+
+	/* Take the slot from an entry closer to home, and carry on
+	 * looking for a place for that entry instead.
+	 */
+	sdist = HT_DIST(i, sh, mask);
+	if (sdist < dist)
+	{
+	    hashes[i] = hval;
+	    th = slots[i];
+	    slots[i] = h;
+	    hval = sh;
+	    h = th;
+	    dist = sdist;
+	}
+	i = (i + 1) & mask;
+    }
+}
+
+/*---------------------------------------------------------
+ *
+ * hashAlloc --
+ *
+ * Local procedure to allocate space for an entry from the
+ * table's slab.
+ *
+ * Results:
+ *	Pointer to 'size' bytes of storage, suitably aligned.
+ *
+ * Side Effects:
+ *	A new chunk may be added to the slab.
+ *
+ *---------------------------------------------------------
+ */
+
+HashEntry *
+hashAlloc(table, size)
+    HashTable *table;
+    unsigned size;
+{
+    char *chunk;
+    unsigned chunkSize;
+
+    size = (size + HT_SLABALIGN - 1) & ~(HT_SLABALIGN - 1);
+    if (table->ht_slabFree == NULL
+	    || table->ht_slabEnd - table->ht_slabFree < size)
+    {
+	if (table->ht_slab == NULL)
+	    chunkSize = HT_SLABMIN;
+	else
+	{
+	    chunkSize = 2 * (table->ht_slabEnd - table->ht_slab);
+	    if (chunkSize > HT_SLABMAX) chunkSize = HT_SLABMAX;
+	}
+	if (chunkSize < HT_SLABHEAD + size)
+	    chunkSize = HT_SLABHEAD + size;
+
+	chunk = (char *) mallocMagic(chunkSize);
+	*((char **) chunk) = table->ht_slab;
+	table->ht_slab = chunk;
+	table->ht_slabFree = chunk + HT_SLABHEAD;
+	table->ht_slabEnd = chunk + chunkSize;
+    }
+    chunk = table->ht_slabFree;
+    table->ht_slabFree += size;
+    return (HashEntry *) chunk;
+}
+
 /*---------------------------------------------------------
  *
  * HashLookOnly --
@@ -286,50 +532,19 @@ HashLookOnly(table, key)
 				 */
 {
     HashEntry *h;
-    unsigned *up, *kp;
-    int n;
-    int bucket;
+    unsigned hval;
 
-    bucket = hash(table, key);
-    h = *(table->ht_table + bucket);
-    while (h != NIL)
-    {
-	switch (table->ht_ptrKeys)
-	{
-	    case HT_STRINGKEYS:
-		if (strcmp(h->h_key.h_name, key) == 0) return h;
-		break;
-	    case HT_CLIENTKEYS:
-		if (table->ht_compareFn)
-		{
-		    if ((*table->ht_compareFn)(h->h_key.h_ptr, key) == 0)
-			return h;
-		    break;
-		}
-		/* Fall through to ... */
-	    case HT_WORDKEYS:
-		if (h->h_key.h_ptr == key) return h;
-		break;
-	    case HT_STRUCTKEYS:
-		up = h->h_key.h_words;
-		kp = (unsigned *) key;
-		if (*up++ == *kp++ && *up == *kp) return h;
-		break;
-	    default:
-		n = table->ht_ptrKeys;
-		up = h->h_key.h_words;
-		kp = (unsigned *) key;
-		do { if (*up++ != *kp++) goto next; } while (--n);
-		return h;
-	}
-next:
-	h = h->h_next;
-    }
+    hval = hash(table, key);
+    h = hashProbe(table, table->ht_table, table->ht_hashes,
+		table->ht_mask, key, hval);
 
-    /* The desired entry isn't there */
-    return ((HashEntry *) NULL);
+    /* Keys not yet moved since the table last grew are in the old slots */
+    if (h == NULL && table->ht_oldTable != NULL)
+	h = hashProbe(table, table->ht_oldTable, table->ht_oldHashes,
+		table->ht_oldSize - 1, key, hval);
+    return h;
 }
-
+
 /*---------------------------------------------------------
  *
  * HashFind --
@@ -343,7 +558,8 @@ next:
  *	of the entry we return is zero.
  *
  * Side Effects:
- *	Memory is allocated, and the hash buckets may be modified.
+ *	Memory is allocated, and entries may move between
+ *	slots.  Entries themselves never move.
  *
  *---------------------------------------------------------
  */
@@ -357,55 +573,27 @@ HashFind(table, key)
 {
     unsigned *up, *kp;
     HashEntry *h;
+    unsigned hval;
     int n;
-    int bucket;
 
-    bucket = hash(table, key);
-    h = *(table->ht_table + bucket);
-    while (h != NIL)
+    hval = hash(table, key);
+    h = hashProbe(table, table->ht_table, table->ht_hashes,
+		table->ht_mask, key, hval);
+    if (h != NULL) return h;
+    if (table->ht_oldTable != NULL)
     {
-	switch (table->ht_ptrKeys)
-	{
-	    case HT_STRINGKEYS:
-		if (strcmp(h->h_key.h_name, key) == 0) return h;
-		break;
-	    case HT_CLIENTKEYS:
-		if (table->ht_compareFn)
-		{
-		    if ((*table->ht_compareFn)(h->h_key.h_ptr, key) == 0)
-			return h;
-		    break;
-		}
-		/* Fall through to ... */
-	    case HT_WORDKEYS:
-		if (h->h_key.h_ptr == key) return h;
-		break;
-	    case HT_STRUCTKEYS:
-		up = h->h_key.h_words;
-		kp = (unsigned *) key;
-		if (*up++ == *kp++ && *up == *kp) return h;
-		break;
-	    default:
-		n = table->ht_ptrKeys;
-		up = h->h_key.h_words;
-		kp = (unsigned *) key;
-		do { if (*up++ != *kp++) goto next; } while (--n);
-		return h;
-	}
-next:
-	h = h->h_next;
+	h = hashProbe(table, table->ht_oldTable, table->ht_oldHashes,
+		table->ht_oldSize - 1, key, hval);
+	if (h != NULL) return h;
     }
 
     /*
      * The desired entry isn't there.  Before allocating a new entry,
-     * see if we're overloading the buckets.  If so, then make a
-     * bigger table (4x as big).
+     * see if we're overloading the slots.  If so, then make a
+     * bigger table (2x as big).
      */
-    if (table->ht_nEntries >= rebuildLimit*table->ht_size)
-    {
+    if ((table->ht_nEntries + 1) * HT_LOADDEN > table->ht_size * HT_LOADNUM)
 	rebuild(table);
-	bucket = hash(table, key);
-    }
     table->ht_nEntries += 1;
 
     /*
@@ -417,23 +605,23 @@ next:
     switch (table->ht_ptrKeys)
     {
 	case HT_STRINGKEYS:
-	    h = (HashEntry *) mallocMagic((unsigned) (sizeof(HashEntry)+strlen(key)-3));
+	    h = hashAlloc(table, (unsigned) (sizeof(HashEntry)+strlen(key)-3));
 	    (void) strcpy(h->h_key.h_name, key);
 	    break;
 	case HT_CLIENTKEYS:
 	    if (table->ht_copyFn)
 	    {
-		h = (HashEntry *) mallocMagic((unsigned) (sizeof (HashEntry)));
+		h = hashAlloc(table, (unsigned) (sizeof (HashEntry)));
 		h->h_key.h_ptr = (*table->ht_copyFn)(key);
 		break;
 	    }
 	    /* Fall through to ... */
 	case HT_WORDKEYS:
-	    h = (HashEntry *) mallocMagic((unsigned) (sizeof (HashEntry)));
+	    h = hashAlloc(table, (unsigned) (sizeof (HashEntry)));
 	    h->h_key.h_ptr = key;
 	    break;
 	case HT_STRUCTKEYS:
-	    h = (HashEntry *) mallocMagic(
+	    h = hashAlloc(table,
 		    (unsigned) (sizeof (HashEntry) + sizeof (unsigned)));
 	    up = h->h_key.h_words;
 	    kp = (unsigned *) key;
@@ -442,7 +630,7 @@ next:
 	    break;
 	default:
 	    n = table->ht_ptrKeys;
-	    h = (HashEntry *) mallocMagic(
+	    h = hashAlloc(table,
 		    (unsigned) (sizeof(HashEntry) + (n-1) * sizeof (unsigned)));
 	    up = h->h_key.h_words;
 	    kp = (unsigned *) key;
@@ -451,24 +639,33 @@ next:
     }
 
     h->h_pointer = 0;
-    h->h_next = *(table->ht_table + bucket);
-    *(table->ht_table + bucket) = h;
+    h->h_next = (HashEntry *) NULL;
+    if (table->ht_last)
+	table->ht_last->h_next = h;
+    else
+	table->ht_first = h;
+    table->ht_last = h;
+
+    hashInsert(table, h, hval);
+    if (table->ht_oldTable != NULL)
+	hashMove(table, HT_MOVESTEP);
     return h;
 }
-
+
 /*---------------------------------------------------------
  *
  * rebuild --
  *
- * This local routine makes a new hash table that
- * is 4x larger than the old one.
+ * This local routine makes a new array of slots that
+ * is 2x larger than the old one.  The entries in the
+ * old slots are moved over gradually by hashMove().
  *
  * Results:
  *	None.
  *
  * Side Effects:
- *	The entire hash table is moved, so any bucket numbers
- *	from the old table are invalid.
+ *	Any move left over from the previous rebuild is
+ *	finished first.
  *
  *---------------------------------------------------------
  */
@@ -477,52 +674,69 @@ void
 rebuild(table)
     HashTable *table;		/* Table to be enlarged. */
 {
-    HashEntry **oldTable, **old2, *h, *next;
-    int oldSize, bucket;
-
-    oldTable = table->ht_table;
-    old2 = oldTable;
-    oldSize = table->ht_size;
-
-    /* Build a new table 4 times as large as the old one. */
-    HashInitClient(table, table->ht_size*4, table->ht_ptrKeys,
-		table->ht_compareFn, table->ht_copyFn,
-		table->ht_hashFn, table->ht_killFn);
-    for ( ; oldSize > 0; oldSize--)
+    if (table->ht_oldTable != NULL)
+	hashMove(table, table->ht_oldSize);
+
+    table->ht_oldTable = table->ht_table;
+    table->ht_oldHashes = table->ht_hashes;
+    table->ht_oldSize = table->ht_size;
+    table->ht_moved = 0;
+
+    table->ht_size *= 2;
+    table->ht_mask = table->ht_size - 1;
+    table->ht_table = (HashEntry **) mallocMagic(
+		(unsigned) (sizeof (HashEntry *)  * table->ht_size));
+    table->ht_hashes = (unsigned *) mallocMagic(
+		(unsigned) (sizeof (unsigned)  * table->ht_size));
+    memset(table->ht_hashes, 0, sizeof (unsigned) * table->ht_size);
+}
+
+/*---------------------------------------------------------
+ *
+ * hashMove --
+ *
+ * Local procedure to move entries from the slots the table
+ * had before it last grew into its current slots.
+ *
+ * Results:
+ *	None.
+ *
+ * Side Effects:
+ *	Up to 'count' old slots are moved.  Once they are all
+ *	moved, the old slots are freed.
+ *
+ *---------------------------------------------------------
+ */
+
+void
+hashMove(table, count)
+    HashTable *table;
+    int count;			/* Number of old slots to move */
+{
+    int i;
+
+    for (i = table->ht_moved; i < table->ht_oldSize && count > 0; i++, count--)
+	if (table->ht_oldHashes[i] != 0)
+	    hashInsert(table, table->ht_oldTable[i], table->ht_oldHashes[i]);
+    table->ht_moved = i;
+
+    if (table->ht_moved >= table->ht_oldSize)
     {
-	h = *old2++;
-	while (h != NIL)
-	{
-	    next = h->h_next;
-	    switch (table->ht_ptrKeys)
-	    {
-		case HT_STRINGKEYS:
-		    bucket = hash(table, h->h_key.h_name);
-		    break;
-		case HT_WORDKEYS:
-		case HT_CLIENTKEYS:
-		    bucket = hash(table, h->h_key.h_ptr);
-		    break;
-		default:
-		    bucket = hash(table, (char *) h->h_key.h_words);
-		    break;
-	    }
-	    h->h_next = *(table->ht_table + bucket);
-	    *(table->ht_table + bucket) = h;
-	    table->ht_nEntries += 1;
-	    h = next;
-	}
+	freeMagic((char *) table->ht_oldTable);
+	freeMagic((char *) table->ht_oldHashes);
+	table->ht_oldTable = (HashEntry **) NULL;
+	table->ht_oldHashes = (unsigned *) NULL;
+	table->ht_oldSize = 0;
     }
-
-    freeMagic((char *) oldTable);
 }
-
+
 /*---------------------------------------------------------
  *
  * HashStats --
  *
  * This routine merely prints statistics about the
- * current bucket situation.
+ * current slot situation:  how far each entry is from
+ * the slot its key hashes to.
  *
  * Results:
  *	None.
@@ -540,24 +754,25 @@ HashStats(table)
     HashTable *table;
 {
     int count[MAXCOUNT], overflow, i, j;
-    HashEntry *h;
+    unsigned sh;
 
     overflow = 0;
     for (i = 0; i < MAXCOUNT; i++) count[i] = 0;
     for (i = 0; i < table->ht_size; i++)
     {
-	j = 0;
-	for (h = *(table->ht_table+i); h != NIL; h = h->h_next)
-	    j++;
+	sh = table->ht_hashes[i];
+	if (sh == 0) continue;
+	j = HT_DIST(i, sh, table->ht_mask);
 	if (j < MAXCOUNT) count[j]++;
 	else overflow++;
     }
 
+    printf("%d entries in %d slots.\n", table->ht_nEntries, table->ht_size);
     for (i = 0;  i < MAXCOUNT; i++)
-	printf("# of buckets with %d entries: %d.\n", i, count[i]);
-    printf("# of buckets with >%d entries: %d.\n", MAXCOUNT-1, overflow);
+	printf("# of entries %d slots from home: %d.\n", i, count[i]);
+    printf("# of entries >%d slots from home: %d.\n", MAXCOUNT-1, overflow);
 }
-
+
 /*---------------------------------------------------------
  *
  * HashStartSearch --
@@ -582,13 +797,15 @@ HashStartSearch(hs)
     hs->hs_nextIndex = 0;
     hs->hs_h = NIL;
 }
-
+
 /*---------------------------------------------------------
  *
  * HashNext --
  *
  * This procedure returns successive entries in the
- * hash table.
+ * hash table, in the order in which they were created.
+ * Entries created during the search will be returned
+ * too, unless the search has already reached the end.
  *
  * Results:
  *	The return value is a pointer to the next HashEntry
@@ -609,17 +826,16 @@ HashNext(table, hs)
 {
     HashEntry *h;
 
-    while (hs->hs_h == NIL)
+    if (hs->hs_nextIndex == 0)
     {
-	if (hs->hs_nextIndex >= table->ht_size) return NULL;
-	hs->hs_h = *(table->ht_table + hs->hs_nextIndex);
-	hs->hs_nextIndex += 1;
+	hs->hs_h = table->ht_first;
+	hs->hs_nextIndex = 1;
     }
     h = hs->hs_h;
-    hs->hs_h = h->h_next;
+    if (h != NULL) hs->hs_h = h->h_next;
     return h;
 }
-
+
 /*---------------------------------------------------------
  *
  * HashKill --
@@ -639,24 +855,36 @@ void
 HashKill(table)
     HashTable *table;	/* Hash table whose space is to be freed */
 {
-    HashEntry *h, **hp, **hend;
+    HashEntry *h;
+    char *chunk;
     int (*killFn)() = (int (*)()) NULL;
 
     if (table->ht_ptrKeys == HT_CLIENTKEYS) killFn = table->ht_killFn;
-    for (hp = table->ht_table, hend = &hp[table->ht_size]; hp < hend; hp++)
-	for (h = *hp; h != NIL; h = h->h_next)
-	{
-	    freeMagic((char *) h);
-	    if (killFn)
-		(*killFn)(h->h_key.h_ptr);
-	}
+    if (killFn)
+	for (h = table->ht_first; h != NULL; h = h->h_next)
+	    (*killFn)(h->h_key.h_ptr);
+
+    while ((chunk = table->ht_slab) != NULL)
+    {
+	table->ht_slab = *((char **) chunk);
+	freeMagic(chunk);
+    }
     freeMagic((char *) table->ht_table);
+    freeMagic((char *) table->ht_hashes);
+    if (table->ht_oldTable != NULL)
+    {
+	freeMagic((char *) table->ht_oldTable);
+	freeMagic((char *) table->ht_oldHashes);
+    }
 
     /*
      * Set up the hash table to cause memory faults on any future
      * access attempts until re-initialization.
      */
     table->ht_table = (HashEntry **) (1<<29);
+    table->ht_hashes = (unsigned *) (1<<29);
+    table->ht_oldTable = (HashEntry **) NULL;
+    table->ht_first = table->ht_last = NIL;
 }
 
 /*---------------------------------------------------------
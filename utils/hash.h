@@ -27,12 +27,15 @@
  *---------------------------------------------------------
  */
 
-/* The following defines one entry in the hash table. */
+/* The following defines one entry in the hash table.  Entries are
+ * carved out of a slab belonging to the table, and never move once
+ * created, so clients may hold on to HashEntry pointers.
+ */
 
 typedef struct h1
 {
     char *h_pointer;		/* Pointer to anything. */
-    struct h1 *h_next;		/* Next element, zero for end. */
+    struct h1 *h_next;		/* Next entry created, zero for end. */
     union
     {
 	char *h_ptr;		/* One-word key value to identify entry. */
@@ -48,19 +51,38 @@ typedef struct h1
     } h_key;
 } HashEntry;
 
-/* A hash table consists of an array of pointers to hash
- * lists:
+/* A hash table is an open-addressed array of slots, each holding
+ * a pointer to an entry and the full hash value of the entry's key
+ * (kept in a separate array, so that probing rarely has to look at
+ * the entries themselves).  When the table grows, the old slots are
+ * moved into the new array a few at a time by later insertions, and
+ * lookups check both arrays until the move is finished.
  */
 
 typedef struct h3
 {
-    HashEntry **ht_table;	/* Pointer to array of pointers. */
-    int ht_size;		/* Actual size of array. */
+    HashEntry **ht_table;	/* Pointer to array of slots. */
+    unsigned *ht_hashes;	/* Hash value for each slot, zero if empty. */
+    int ht_size;		/* Actual size of array (a power of two). */
     int ht_nEntries;		/* Number of entries in the table. */
-    int ht_downShift;		/* Shift count, used in hashing function. */
-    int ht_mask;		/* Used to select bits for hashing. */
+    int ht_mask;		/* ht_size - 1, selects a slot from a hash. */
     int ht_ptrKeys;		/* See below */
 
+    /* Slots of the table before it last grew, while being moved */
+    HashEntry **ht_oldTable;	/* Old array of slots, or NULL. */
+    unsigned *ht_oldHashes;	/* Hash values for the old slots. */
+    int ht_oldSize;		/* Size of the old array. */
+    int ht_moved;		/* Number of old slots already moved. */
+
+    /* All entries, in the order they were created (see HashNext) */
+    HashEntry *ht_first;	/* First entry created. */
+    HashEntry *ht_last;		/* Most recent entry created. */
+
+    /* Slab from which entries are allocated */
+    char *ht_slab;		/* Most recent chunk, or NULL. */
+    char *ht_slabFree;		/* First free byte in that chunk. */
+    char *ht_slabEnd;		/* End of that chunk. */
+
     /* Used if ht_ptrKeys == HT_CLIENTKEYS */
     char *(*ht_copyFn)();	/* Used for copying a key value */
     int (*ht_compareFn)();	/* Used for comparing two keys for equality */
@@ -89,7 +111,7 @@ typedef struct h3
 #define	HT_STRUCTKEYS	2
 
 /*
- * Default initial size (number of buckets) in a hash table.
+ * Default initial size (number of slots) in a hash table.
  * May be passed to HashInit() or HashInitClient().
  */
 #define	HT_DEFAULTSIZE	32
@@ -100,8 +122,8 @@ typedef struct h3
 
 typedef struct h2
 {
-    int hs_nextIndex;		/* Next bucket to check (after current). */
-    HashEntry * hs_h;		/* Next entry to check in current bucket. */
+    int hs_nextIndex;		/* Zero until the search has started. */
+    HashEntry * hs_h;		/* Next entry to return. */
 } HashSearch;
 
 /*---------------------------------------------------------
@@ -64,8 +64,15 @@ extern char *TxGetLine();
  * would no further references would be made to free'ed storage.
  */
 
-/* Delay free'ing by one call, to accommodate Magic's needs. */
+/* Delay free'ing by one call, to accommodate Magic's needs.  The	*/
+/* delayed item is kept per thread, so that the one-object grace	*/
+/* period holds for each of the worker threads (see utils/workers.c)	*/
+/* independently.							*/
+#ifdef WORKER_THREADS
+static __thread char *freeDelayedItem = NULL;
+#else
 static char *freeDelayedItem = NULL;
+#endif
 
 /* Local definitions */
 
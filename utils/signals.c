@@ -73,7 +73,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #endif
 
 /* specially imported */
-extern bool DBWriteBackup();
+extern bool DBWriteBackupFinal();
 
 /* macs support BSD4.2 signals, so turn off the SYSV flag for this module */
 #ifdef __APPLE__
@@ -468,7 +468,8 @@ sigOnInterrupt(int signo)
  *	Function does not return.
  *
  * Side effects:
- *	Writes cells out to disk (by calling DBWriteBackup()).
+ *	Writes cells out to disk (by calling DBWriteBackupFinal(), which
+ *	does not touch the worker threads).
  *	Exits.
  * ----------------------------------------------------------------------------
  */
@@ -476,7 +477,7 @@ sigOnInterrupt(int signo)
 sigRetVal
 sigOnTerm(int signo)
 {
-    DBWriteBackup(NULL);
+    DBWriteBackupFinal();
     exit (1);
 }
 
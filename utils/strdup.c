@@ -26,6 +26,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #include <ctype.h>
 
 #include "utils/magic.h"
+#include "utils/hash.h"
 #include "utils/malloc.h"
 
 
@@ -73,6 +74,42 @@ StrDup(oldstr, str)
     return (newstr);
 }
 
+/*
+ * ----------------------------------------------------------------------------
+ * StrIntern --
+ *
+ * Return the one shared copy of a string.  Every call with equal
+ * strings returns the same pointer, so interned strings can be
+ * compared with == instead of strcmp(), and a name that occurs many
+ * times is stored only once.
+ *
+ * Results:
+ *	Returns a pointer to the interned copy of str.  The copy must
+ *	never be modified or freed;  it lasts for the rest of the run.
+ *
+ * Side effects:
+ *	Adds str to the table of interned strings if it is not already
+ *	there.  Not safe to call from worker threads.
+ * ----------------------------------------------------------------------------
+ */
+
+char *
+StrIntern(str)
+    char *str;
+{
+    static HashTable strInternTable;
+    static bool strInternInit = FALSE;
+
+    if (!strInternInit)
+    {
+	HashInit(&strInternTable, 1024, HT_STRINGKEYS);
+	strInternInit = TRUE;
+    }
+
+    /* Hash entries never move, so the key stored in the entry is the copy */
+    return HashFind(&strInternTable, str)->h_key.h_name;
+}
+
 
 /*
  * ----------------------------------------------------------------------------
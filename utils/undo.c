@@ -27,6 +27,7 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 #endif  /* not lint */
 
 #include <stdio.h>
+#include <string.h>
 #include <sys/types.h>
 
 #include "utils/magic.h"
@@ -58,53 +59,87 @@ static char rcsid[] __attribute__ ((unused)) = "$Header: /usr/cvsroot/magic-8.0/
 /* ------------------------------------------------------------------------ */
 
 /*
- * The following structure describes the basic information
- * required by the undo package for each event it stores.
- * This information is NOT intended to be visible to any of
- * the clients of the undo package and is susceptible to being
- * changed arbitrarily.
- *
- * To enforce the absolute ignorance of undo's clients, when
- * we allocate an internalUndoEvent, we only give the client
- * a pointer to the iue_client part, which is of a size determined
- * by the client when it calls UndoNewEvent().  This pointer is
- * what the client sees as an (UndoEvent *) (really a (char *)).
+ * Events are stored back to back in large chunks of memory rather
+ * than being allocated one at a time.  Each event is a record made
+ * of the header below followed by the client data, padded so that
+ * the next record is suitably aligned.  The header holds the size
+ * of the record and that of the record before it in the same chunk,
+ * so the log can be walked in either direction.
+ *
+ * This information is NOT intended to be visible to any of the
+ * clients of the undo package and is susceptible to being changed
+ * arbitrarily.  The client only ever sees a pointer to the data
+ * following the header, which it knows as an (UndoEvent *).
  */
 
-    typedef struct ue
+    typedef struct
     {
-	UndoType	 iue_type;	/* Event type */
-	struct ue	*iue_back;	/* Previous event on list */
-	struct ue	*iue_forw;	/* Next event on list */
-	int		 iue_client;	/* Client data area.  This is merely a
-					 * dummy placeholder; the actual size
-					 * of one of these structures is
-					 * determined at the time of
-					 * UndoNewEvent().
+	UndoType	 ur_type;	/* Event type */
+	unsigned int	 ur_size;	/* Size of this record in bytes */
+	unsigned int	 ur_prev;	/* Size of the record before this one
+					 * in the same chunk, or 0 if this is
+					 * the first record in the chunk.
 					 */
-    } internalUndoEvent;
+    } undoRecord;
 
 #define	UT_DELIM	(-1)
 
+#define	UNDOALIGN(n)	(((n) + 7) & ~7)
+#define	UNDOHDRSIZE	UNDOALIGN(sizeof (undoRecord))
+
 /*
- * The following macro is used to compute the number of bytes we must
- * allocate in order to give the user an UndoEvent capable of holding
- * n bytes.
+ * The following macro is used to compute the number of bytes a record
+ * takes up when it gives the client an UndoEvent of n bytes.
  */
 
-#define	undoSize(n)	(sizeof (struct ue) + (n) \
-			    - sizeof (((struct ue *) 0)->iue_client))
+#define	undoSize(n)	(UNDOHDRSIZE + UNDOALIGN(n))
 
 /*
- * Mapping between internal and external undo event pointers.
- * When the undo package hands an (UndoEvent *) to a client, it is
- * really a pointer to the iue_client part of the structure
- * above.
+ * Mapping between records and external undo event pointers.
  */
 
-#define	CLIENTOFFSET	((int) &((internalUndoEvent) 0)->iue_client)
-#define	undoExport(p)	((UndoEvent *) (&(p)->iue_client))
-#define	undoImport(p)	((internalUndoEvent) (((char *) (p)) - CLIENTOFFSET))
+#define	undoExport(rp)	((UndoEvent *) (((char *) (rp)) + UNDOHDRSIZE))
+
+    /*
+     * Records are appended to chunks of UNDOCHUNKSIZE bytes.  A record
+     * that will not fit in a chunk of that size gets a chunk of its own.
+     *
+     * Chunks other than the newest one may be written out to a temporary
+     * file ("spilled") when the log has more than undoMemLimit bytes in
+     * main memory.  A spilled chunk is read back in when undo or redo
+     * gets to it.  An undoMemLimit of zero means no limit.
+     */
+
+#define	UNDOCHUNKSIZE	(64 * 1024)
+
+    typedef struct undochunk
+    {
+	struct undochunk *uk_prev;	/* Next older chunk */
+	struct undochunk *uk_next;	/* Next newer chunk */
+	char		 *uk_data;	/* Records, or NULL if spilled */
+	int		  uk_size;	/* Number of bytes allocated to uk_data */
+	int		  uk_used;	/* Number of bytes of records in uk_data */
+	int		  uk_last;	/* Offset of the last record */
+	long		  uk_spill;	/* Offset of a copy of uk_data in the
+					 * spill file, or -1 if there is none.
+					 */
+	int		 *uk_delims;	/* Offsets of the UT_DELIM records */
+	int		  uk_ndelims;	/* Number of entries in uk_delims */
+	int		  uk_maxdelims;	/* Number of entries allocated */
+    } undoChunk;
+
+    /*
+     * A position in the log is a chunk and the offset of a record in it.
+     * A NULL chunk denotes the position before the first event.  Since
+     * chunks may be spilled and read back in at a different address,
+     * positions, not pointers, are kept across calls.
+     */
+
+    typedef struct
+    {
+	undoChunk	*up_chunk;	/* Chunk holding the record */
+	int		 up_off;	/* Offset of the record in the chunk */
+    } undoPos;
 
 /*
  * The following table is used to record the information about clients
@@ -143,36 +178,59 @@ global int UndoDisableCount = 0;
 /*
  * Log of events kept in main memory.
  *
- *	undoLogHead	Pointer to first entry stored in main memory.
- *			    - NULL, indicating no events are in memory
- *			    - a pointer to the first event of a command
- *	undoLogTail	Pointer to last entry stored in main memory.
- *			    - Undefined (if undoLogHead == NULL)
- *			    - a pointer to a UT_DELIM event if
- *			      undoNumRecentEvents == 0
- *			    - a pointer to a non-UT_DELIM event if
- *			      undoNumRecentEvents != 0
- *	undoLogCur	Pointer to "current" event, ie, one after which
+ *	undoLogHead	Position of first entry in the log.
+ *			    - NULL, indicating no events are in the log
+ *			    - the first event of a command
+ *	undoLogTail	Position of last entry in the log.
+ *			    - Undefined (if undoLogHead is NULL)
+ *			    - a UT_DELIM event if undoNumRecentEvents == 0
+ *			    - a non-UT_DELIM event if undoNumRecentEvents != 0
+ *	undoLogCur	Position of "current" event, ie, one after which
  *			next event will be added.
  *			    - NULL if at beginning of event list
- *			    - a pointer to a UT_DELIM event if
- *			      undoNumRecentEvents == 0
- *			    - a pointer to a non-UT_DELIM event if
- *			      undoNumRecentEvents != 0
+ *			    - a UT_DELIM event if undoNumRecentEvents == 0
+ *			    - a non-UT_DELIM event if undoNumRecentEvents != 0
+ *
+ *	undoFirstChunk, undoLastChunk
+ *			Oldest and newest chunks, holding undoLogHead and
+ *			undoLogTail respectively.
+ *	undoHeadDelim	Index in the delimiter list of undoFirstChunk of
+ *			the first delimiter after undoLogHead.
+ *	undoOpenChunk	Chunk holding the first event of the command being
+ *			recorded (undefined if undoNumRecentEvents == 0).
  *
  *	undoNumRecentEvents
  *			Number of events written since last call to
  *			UndoNext().
  *	undoNumCommands
- *			Number of complete commands in main memory.
+ *			Number of complete commands in the log.
  */
 
-internalUndoEvent *undoLogCur;
-internalUndoEvent *undoLogHead;
-internalUndoEvent *undoLogTail;
+undoPos undoLogCur;
+undoPos undoLogHead;
+undoPos undoLogTail;
+undoChunk *undoFirstChunk = NULL;
+undoChunk *undoLastChunk = NULL;
+undoChunk *undoOpenChunk = NULL;
+int undoHeadDelim;
 int undoNumRecentEvents;
 int undoNumCommands;
 
+/*
+ * Memory used by the log.
+ *
+ *	undoMemLimit	Number of bytes of chunks allowed in main memory
+ *			before older chunks are spilled, or 0 for no limit.
+ *	undoMemUsed	Number of bytes of chunks currently in main memory.
+ *	undoSpillFile	Temporary file holding spilled chunks, or NULL.
+ *	undoSpillFailed	Set if a spilled chunk could not be read back.
+ */
+
+long undoMemLimit = 0;
+long undoMemUsed = 0;
+FILE *undoSpillFile = NULL;
+bool undoSpillFailed = FALSE;
+
 /*
  * ============================================================================
  *
@@ -182,10 +240,14 @@ int undoNumCommands;
  * ============================================================================
  */
 
-extern internalUndoEvent *undoGetForw();
-extern internalUndoEvent *undoGetBack();
+extern undoRecord *undoGetRecord();
+extern bool undoGetForw();
+extern bool undoGetBack();
 extern void undoFreeHead();
 extern void undoMemTruncate();
+extern undoRecord *undoAppend();
+extern void undoFreeAll();
+extern void undoSpill();
 
 /*
  * ----------------------------------------------------------------------------
@@ -232,21 +294,13 @@ UndoInit(logFileName, mode)
     char *mode;		/* Mode for opening.  Must be "r", "rw", or "w" */
 {
     UndoDisableCount = 0;
-    undoLogTail = NULL;
-    undoLogCur = NULL;
     undoNumRecentEvents = 0;
-    undoNumCommands = 0;
 
     /*
      * Deallocate any events stored in main memory
      */
 
-    while (undoLogHead != (internalUndoEvent *) NULL)
-    {
-	freeMagic((char *) undoLogHead);
-	undoLogHead = undoLogHead->iue_forw;
-    }
-
+    undoFreeAll();
     return (TRUE);
 }
 
@@ -364,19 +418,7 @@ UndoAddClient(init, done, readEvent, writeEvent, forwEvent, backEvent, name)
 void
 UndoFlush()
 {
-    if (undoLogHead == (internalUndoEvent *) NULL)
-	return;
-
-    while (undoLogTail != undoLogHead)
-    {
-	freeMagic((char *) undoLogTail);
-	undoLogTail = undoLogTail->iue_back;
-	ASSERT(undoLogTail != (internalUndoEvent *) NULL, "UndoFlush");
-    }
-    freeMagic((char *) undoLogHead);
-
-    undoLogHead = undoLogTail = undoLogCur = (internalUndoEvent *) NULL;
-    undoNumCommands = 0;
+    undoFreeAll();
     undoNumRecentEvents = 0;
 }
 
@@ -461,42 +503,78 @@ UndoNewEvent(clientType, size)
     UndoType clientType;	/* Type of event to allocate */
     unsigned int size;		/* Number of bytes of client data to allocate */
 {
-    internalUndoEvent *iup;
-    int usize;
+    undoRecord *rp;
 
     if (UndoDisableCount > 0)
 	return ((UndoEvent *) NULL);
 
-    usize = undoSize(size);
-    iup = (internalUndoEvent *) mallocMagic((unsigned) usize);
     ASSERT(clientType >= 0 && clientType < undoNumClients, "UndoNewEvent");
-    iup->iue_type = clientType;
-    if (undoState == US_APPEND)
+    if (undoState != US_APPEND)
+	return ((UndoEvent *) NULL);
+
+    /*
+     * Normal state:
+     * Append the new event after the event at undoLogCur,
+     * first discarding anything that follows it.
+     */
+    if (undoLogCur.up_chunk == NULL)
     {
-	/*
-	 * Normal state:
-	 * Append the new event after the event pointed to by
-	 * undoLogCur.
-	 */
-	iup->iue_forw = (internalUndoEvent *) NULL;
-	iup->iue_back = undoLogCur;
-	if (undoLogCur == (internalUndoEvent *) NULL)
-	{
-	    if (undoLogHead != (internalUndoEvent *) NULL)
-		undoMemTruncate();
-	    undoLogHead = undoLogCur = undoLogTail = iup;
-	}
-	else
-	{
-	    if (undoLogCur->iue_forw != (internalUndoEvent *) NULL)
-		undoMemTruncate();
-	    undoLogCur->iue_forw = iup;
-	    undoLogCur = undoLogTail = iup;
-	}
-	undoNumRecentEvents++;
+	if (undoLogHead.up_chunk != NULL)
+	    undoMemTruncate();
     }
+    else if (undoLogCur.up_chunk != undoLogTail.up_chunk
+	    || undoLogCur.up_off != undoLogTail.up_off)
+	undoMemTruncate();
+
+    rp = undoAppend(clientType, size);
+    undoLogCur = undoLogTail;
+    if (undoNumRecentEvents++ == 0)
+	undoOpenChunk = undoLogTail.up_chunk;
+
+    return (undoExport(rp));
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * UndoLastEvent --
+ *
+ * Return the most recent event of the command being recorded, so
+ * that a client may fold a new change into it instead of logging a
+ * separate event.  The client must leave the event in a state that
+ * plays backward and forward as if both changes had been logged.
+ *
+ * Results:
+ *	A pointer to the client data of the last event, if that event
+ *	has the given type and belongs to the command currently being
+ *	recorded.  NULL otherwise, or if undoing is disabled.
+ *
+ * WARNING:
+ *	As for UndoNewEvent(), the pointer must not be retained past
+ *	the next call to any of the routines in the undo package.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+UndoEvent *
+UndoLastEvent(clientType)
+    UndoType clientType;	/* Type of event wanted */
+{
+    undoRecord *rp;
 
-    return (undoExport(iup));
+    if (UndoDisableCount > 0 || undoState != US_APPEND
+	    || undoNumRecentEvents == 0)
+	return ((UndoEvent *) NULL);
+
+    /* With recent events, undoLogCur is the tail, which is never spilled */
+    rp = (undoRecord *) (undoLastChunk->uk_data + undoLogTail.up_off);
+    if (rp->ur_type != clientType)
+	return ((UndoEvent *) NULL);
+
+    return (undoExport(rp));
 }
 
 /*
@@ -521,24 +599,16 @@ UndoNewEvent(clientType, size)
 void
 UndoNext()
 {
-    internalUndoEvent *iup;
-    int usize;
-
     if (UndoDisableCount > 0 || undoNumRecentEvents == 0)
 	return;
 
     undoNumRecentEvents = 0;
     undoNumCommands++;
-    usize = undoSize(0);
-    iup = (internalUndoEvent *) mallocMagic((unsigned) usize);
-    iup->iue_type = UT_DELIM;
-    iup->iue_back = undoLogTail;
-    iup->iue_forw = (internalUndoEvent *) NULL;
-    if (undoLogTail != (internalUndoEvent *) NULL)
-	undoLogTail->iue_forw = iup;
-    undoLogCur = undoLogTail = iup;
+    (void) undoAppend(UT_DELIM, 0);
+    undoLogCur = undoLogTail;
     if (undoNumCommands >= MAXCOMMANDS)
 	undoFreeHead();
+    undoSpill();
 }
 
 /*
@@ -563,7 +633,8 @@ int
 UndoBackward(n)
     int n;		/* Number of events to unplay */
 {
-    internalUndoEvent *iup;
+    undoPos pos;
+    undoRecord *rp;
     int client, count;
 
 #ifdef MAGIC_WRAPPER
@@ -586,43 +657,42 @@ UndoBackward(n)
 	if (undoClientTable[client].uc_init)
 	    (*undoClientTable[client].uc_init)();
 
-    iup = undoLogCur;
+    pos = undoLogCur;
     undoNumRecentEvents = 0;
     UndoDisableCount++;
-    for (count = 0; (count < n) && (iup != NULL); count++)
+    for (count = 0; (count < n) && (pos.up_chunk != NULL); count++)
     {
 	do
 	{
-	    if (iup->iue_type != UT_DELIM)
-		if (undoClientTable[iup->iue_type].uc_back != NULL)
-		    (*undoClientTable[iup->iue_type].uc_back)(undoExport(iup));
-
-	    /* fprintf(stderr, "Undo record: type=%d back=0x%x, forw=0x%x\n",
-	     *	iup->iue_type, iup->iue_back, iup->iue_forw);
-	     * fprintf(stderr, "   UndoDisableCount = %d, undoNumRecentEvents = %d\n",
-	     *		UndoDisableCount, undoNumRecentEvents);
-	     * fflush(stderr);
-	     */
-
-	    iup = undoGetBack(iup);
+	    rp = undoGetRecord(&pos);
+	    if (rp == NULL) break;
+	    if (rp->ur_type != UT_DELIM)
+		if (undoClientTable[rp->ur_type].uc_back != NULL)
+		    (*undoClientTable[rp->ur_type].uc_back)(undoExport(rp));
+
+	    if (!undoGetBack(&pos))
+		break;
+	    rp = undoGetRecord(&pos);
 	}
-	while ((iup != (internalUndoEvent *) NULL) && (iup->iue_type != UT_DELIM));
+	while ((rp != NULL) && (rp->ur_type != UT_DELIM));
+	if (rp == NULL) break;
     }
     UndoDisableCount--;
 
-    undoLogCur = iup;
-
-    /* fprintf(stderr, "UndoBackward: undoLogCur set to 0x%x\n", undoLogCur);
-     * fflush(stderr);
-     */
+    undoLogCur = pos;
 
     /* Call the termination routines of all clients */
     for (client = 0; client < undoNumClients; client++)
 	if (undoClientTable[client].uc_done)
 	    (*undoClientTable[client].uc_done)();
+
+    if (undoSpillFailed)
+	UndoFlush();
+    else
+	undoSpill();
     return (count);
 }
-
+
 /*
  * ----------------------------------------------------------------------------
  *
@@ -645,7 +715,8 @@ int
 UndoForward(n)
     int n;		/* Number of events to replay */
 {
-    internalUndoEvent *iup;
+    undoPos pos;
+    undoRecord *rp;
     int count, client;
 
     /* Call the initialization routines of all clients */
@@ -654,8 +725,8 @@ UndoForward(n)
 	    (*undoClientTable[client].uc_init)();
 
     count = 0;
-    iup = undoGetForw(undoLogCur);
-    if (iup == NULL) goto done;
+    pos = undoLogCur;
+    if (!undoGetForw(&pos)) goto done;
 
     undoNumRecentEvents = 0;
     UndoDisableCount++;
@@ -663,30 +734,75 @@ UndoForward(n)
     {
 	do
 	{
-	    if (iup->iue_type != UT_DELIM)
-		if (undoClientTable[iup->iue_type].uc_forw != NULL)
-		    (*undoClientTable[iup->iue_type].uc_forw)(undoExport(iup));
-	    iup = undoGetForw(iup);
+	    rp = undoGetRecord(&pos);
+	    if (rp == NULL) break;
+	    if (rp->ur_type != UT_DELIM)
+		if (undoClientTable[rp->ur_type].uc_forw != NULL)
+		    (*undoClientTable[rp->ur_type].uc_forw)(undoExport(rp));
+	    if (!undoGetForw(&pos))
+	    {
+		rp = NULL;
+		break;
+	    }
+	    rp = undoGetRecord(&pos);
 	}
-	while (iup != (internalUndoEvent *) NULL && iup->iue_type != UT_DELIM);
-	if (iup == (internalUndoEvent *) NULL)
+	while (rp != NULL && rp->ur_type != UT_DELIM);
+	if (rp == NULL)
 	{
-	    iup = undoLogTail;
+	    pos = undoLogTail;
 	    break;
 	}
     }
     UndoDisableCount--;
 
-    undoLogCur = iup;
+    undoLogCur = pos;
 
 done:
     /* Call the termination routines of all clients */
     for (client = 0; client < undoNumClients; client++)
 	if (undoClientTable[client].uc_done)
 	    (*undoClientTable[client].uc_done)();
+
+    if (undoSpillFailed)
+	UndoFlush();
+    else
+	undoSpill();
     return (count);
 }
-
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * UndoSetMemLimit --
+ * UndoGetMemLimit --
+ *
+ * Set or return the number of bytes of undo log kept in main memory
+ * before older parts of the log are moved to a temporary file.  A
+ * limit of zero keeps the whole log in memory.
+ *
+ * Results:
+ *	UndoGetMemLimit() returns the current limit in bytes.
+ *
+ * Side effects:
+ *	UndoSetMemLimit() may spill part of the log right away.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+UndoSetMemLimit(limit)
+    long limit;		/* Limit in bytes, or 0 for none */
+{
+    undoMemLimit = (limit < 0) ? 0 : limit;
+    undoSpill();
+}
+
+long
+UndoGetMemLimit()
+{
+    return undoMemLimit;
+}
+
 /*
  * ============================================================================
  *
@@ -696,108 +812,387 @@ done:
  * ============================================================================
  */
 
-
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * undoGetRecord --
+ *
+ * Return a pointer to the record at a position in the log, reading
+ * its chunk back in from the spill file if need be.
+ *
+ * Results:
+ *	A pointer to the record, or NULL if the position is NULL or
+ *	the chunk could not be read back in.
+ *
+ * Side effects:
+ *	May allocate memory for a spilled chunk.  Sets undoSpillFailed
+ *	if the spill file cannot be read.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+undoRecord *
+undoGetRecord(pos)
+    undoPos *pos;
+{
+    undoChunk *uk = pos->up_chunk;
+
+    if (uk == NULL) return ((undoRecord *) NULL);
+    if (uk->uk_data == NULL)
+    {
+	uk->uk_data = (char *) mallocMagic((unsigned) uk->uk_size);
+	if (fseek(undoSpillFile, uk->uk_spill, SEEK_SET) != 0
+		|| fread(uk->uk_data, uk->uk_used, 1, undoSpillFile) != 1)
+	{
+	    if (!undoSpillFailed)
+		TxError("Cannot read back the undo log; "
+			"undo information has been lost.\n");
+	    undoSpillFailed = TRUE;
+	    freeMagic(uk->uk_data);
+	    uk->uk_data = NULL;
+	    return ((undoRecord *) NULL);
+	}
+	undoMemUsed += uk->uk_size;
+    }
+    return ((undoRecord *) (uk->uk_data + pos->up_off));
+}
+
 /*
  * ----------------------------------------------------------------------------
  *
  * undoGetForw --
  *
- * Return a pointer to the next undo event in the list.
+ * Advance a position to the next undo event in the log.  A NULL
+ * position advances to the first event in the log.
  *
  * Results:
- *	A pointer to an undo event.
+ *	TRUE if there was a next event, FALSE otherwise, in which case
+ *	the position is left unchanged.
  *
  * Side effects:
- *	None.
+ *	Modifies *pos.
  *
- * Directly modifies:
- *	undoLogHead, undoLogTail
- *	undoNumCommands
- *	undoNumRecentEvents = 0
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+undoGetForw(pos)
+    undoPos *pos;
+{
+    undoRecord *rp;
+    undoChunk *uk = pos->up_chunk;
+
+    if (uk == NULL)
+    {
+	if (undoLogHead.up_chunk == NULL) return FALSE;
+	*pos = undoLogHead;
+	return TRUE;
+    }
+    if (pos->up_off == uk->uk_last)
+    {
+	if (uk->uk_next == NULL) return FALSE;
+	pos->up_chunk = uk->uk_next;
+	pos->up_off = 0;
+	return TRUE;
+    }
+    rp = undoGetRecord(pos);
+    if (rp == NULL) return FALSE;
+    pos->up_off += rp->ur_size;
+    return TRUE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * undoGetBack --
  *
- * Indirectly modifies:
- *	Nothing.
+ * Move a position back to the previous undo event in the log.
+ *
+ * Results:
+ *	TRUE if there was a previous event.  Otherwise FALSE, and the
+ *	position is set to NULL (the beginning of the log).
+ *
+ * Side effects:
+ *	Modifies *pos.
  *
  * ----------------------------------------------------------------------------
  */
 
-internalUndoEvent *
-undoGetForw(iup)
-    internalUndoEvent *iup;
+bool
+undoGetBack(pos)
+    undoPos *pos;
 {
-    if (iup != (internalUndoEvent *) NULL)
+    undoRecord *rp;
+    undoChunk *uk = pos->up_chunk;
+
+    if (uk == NULL
+	    || (uk == undoLogHead.up_chunk && pos->up_off == undoLogHead.up_off))
     {
-	/*
-	 * Return the next event in memory if there is one.
-	 */
-	if (iup->iue_forw != (internalUndoEvent *) NULL)
-	    return (iup->iue_forw);
+	pos->up_chunk = NULL;
+	return FALSE;
     }
-    else
+    if (pos->up_off == 0)
     {
-	/*
-	 * A NULL initial iup means to start at the very beginning of
-	 * the main-memory undo list.  If there is anything there, return
-	 * it; otherwise return NULL.
-	 */
-	if (undoLogHead != (internalUndoEvent *) NULL)
-	    return (undoLogHead);
+	pos->up_chunk = uk->uk_prev;
+	pos->up_off = uk->uk_prev->uk_last;
+	return TRUE;
+    }
+    rp = undoGetRecord(pos);
+    if (rp == NULL)
+    {
+	pos->up_chunk = NULL;
+	return FALSE;
     }
+    pos->up_off -= rp->ur_prev;
+    return TRUE;
+}
 
-    return ((internalUndoEvent *) NULL);
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * undoAppend --
+ *
+ * Append a record to the end of the log, starting a new chunk if
+ * the newest one is full.
+ *
+ * Results:
+ *	A pointer to the new record, with its header filled in.
+ *
+ * Side effects:
+ *	Updates undoLogTail and, for a new chunk, undoLastChunk and
+ *	possibly undoLogHead.  May spill older chunks.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+undoRecord *
+undoAppend(type, size)
+    UndoType type;
+    unsigned int size;
+{
+    undoChunk *uk = undoLastChunk;
+    undoRecord *rp;
+    int rsize = undoSize(size);
+
+    /* The newest chunk is never spilled, so uk_data is always valid */
+    if (uk == NULL || uk->uk_used + rsize > uk->uk_size)
+    {
+	uk = (undoChunk *) mallocMagic((unsigned) sizeof (undoChunk));
+	uk->uk_size = MAX(UNDOCHUNKSIZE, rsize);
+	uk->uk_data = (char *) mallocMagic((unsigned) uk->uk_size);
+	uk->uk_used = 0;
+	uk->uk_last = 0;
+	uk->uk_spill = -1;
+	uk->uk_delims = (int *) NULL;
+	uk->uk_ndelims = uk->uk_maxdelims = 0;
+	uk->uk_next = (undoChunk *) NULL;
+	uk->uk_prev = undoLastChunk;
+	if (undoLastChunk != NULL)
+	    undoLastChunk->uk_next = uk;
+	else
+	{
+	    undoFirstChunk = uk;
+	    undoLogHead.up_chunk = uk;
+	    undoLogHead.up_off = 0;
+	    undoHeadDelim = 0;
+	}
+	undoLastChunk = uk;
+	undoMemUsed += uk->uk_size;
+	undoSpill();
+    }
+
+    /* Any copy in the spill file no longer matches */
+    uk->uk_spill = -1;
+
+    rp = (undoRecord *) (uk->uk_data + uk->uk_used);
+    rp->ur_type = type;
+    rp->ur_size = rsize;
+    rp->ur_prev = (uk->uk_used == 0) ? 0 : uk->uk_used - uk->uk_last;
+
+    if (type == UT_DELIM)
+    {
+	if (uk->uk_ndelims == uk->uk_maxdelims)
+	{
+	    int *newdelims;
+
+	    uk->uk_maxdelims = (uk->uk_maxdelims == 0) ? 64 : 2 * uk->uk_maxdelims;
+	    newdelims = (int *) mallocMagic((unsigned) (uk->uk_maxdelims
+			* sizeof (int)));
+	    if (uk->uk_ndelims > 0)
+	    {
+		memcpy(newdelims, uk->uk_delims, uk->uk_ndelims * sizeof (int));
+		freeMagic((char *) uk->uk_delims);
+	    }
+	    uk->uk_delims = newdelims;
+	}
+	uk->uk_delims[uk->uk_ndelims++] = uk->uk_used;
+    }
+
+    undoLogTail.up_chunk = uk;
+    undoLogTail.up_off = uk->uk_used;
+    uk->uk_last = uk->uk_used;
+    uk->uk_used += rsize;
+    return rp;
 }
-
+
 /*
  * ----------------------------------------------------------------------------
  *
- * undoGetBack --
+ * undoFreeChunk --
  *
- * Return a pointer to the previous undo event in the list.
+ * Deallocate a chunk.  The caller is responsible for unlinking it.
  *
  * Results:
- *	A pointer to an undo event.
+ *	None.
  *
  * Side effects:
+ *	Frees memory and updates undoMemUsed.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+undoFreeChunk(uk)
+    undoChunk *uk;
+{
+    if (uk->uk_data != NULL)
+    {
+	freeMagic(uk->uk_data);
+	undoMemUsed -= uk->uk_size;
+    }
+    if (uk->uk_delims != NULL)
+	freeMagic((char *) uk->uk_delims);
+    freeMagic((char *) uk);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * undoFreeAll --
+ *
+ * Delete every event in the log.
+ *
+ * Results:
  *	None.
  *
- * Directly modifies:
+ * Side effects:
+ *	Frees all chunks and closes the spill file.  Resets undoLogHead,
+ *	undoLogTail, undoLogCur and undoNumCommands.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+undoFreeAll()
+{
+    undoChunk *uk;
+
+    while (undoFirstChunk != NULL)
+    {
+	uk = undoFirstChunk;
+	undoFirstChunk = uk->uk_next;
+	undoFreeChunk(uk);
+    }
+    undoLastChunk = NULL;
+    undoLogHead.up_chunk = undoLogTail.up_chunk = undoLogCur.up_chunk = NULL;
+    undoNumCommands = 0;
+
+    if (undoSpillFile != NULL)
+    {
+	fclose(undoSpillFile);
+	undoSpillFile = NULL;
+    }
+    undoSpillFailed = FALSE;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * undoSpill --
+ *
+ * If the log is using more than undoMemLimit bytes of main memory,
+ * write the oldest chunks out to the spill file and free their
+ * memory.  The newest chunk, which is being appended to, always
+ * stays in memory, and so do the events of the command still being
+ * recorded:  some clients (the selection, for one) fill in an
+ * earlier event of a command when they log a later one.  A chunk
+ * that was read back in and has not changed since is simply
+ * dropped, as its copy on file is still good.
  *
- * Indirectly modifies:
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	May create and write to the spill file.
  *
  * ----------------------------------------------------------------------------
  */
 
-internalUndoEvent *
-undoGetBack(iup)
-    internalUndoEvent *iup;
+void
+undoSpill()
 {
-    if (iup == (internalUndoEvent *) NULL) return (iup);
-    if (iup->iue_back != (internalUndoEvent *) NULL) return (iup->iue_back);
-    return ((internalUndoEvent *) NULL);
+    undoChunk *uk;
+
+    if (undoMemLimit == 0) return;
+
+    for (uk = undoFirstChunk; uk != undoLastChunk && undoMemUsed > undoMemLimit;
+		uk = uk->uk_next)
+    {
+	if (undoNumRecentEvents > 0 && uk == undoOpenChunk) break;
+	if (uk->uk_data == NULL) continue;
+	if (uk->uk_spill < 0)
+	{
+	    if (undoSpillFile == NULL)
+	    {
+		undoSpillFile = tmpfile();
+		if (undoSpillFile == NULL)
+		{
+		    TxError("Cannot create a file for the undo log; "
+			    "keeping it all in memory.\n");
+		    undoMemLimit = 0;
+		    return;
+		}
+	    }
+	    if (fseek(undoSpillFile, 0L, SEEK_END) != 0
+		    || (uk->uk_spill = ftell(undoSpillFile)) < 0
+		    || fwrite(uk->uk_data, uk->uk_used, 1, undoSpillFile) != 1)
+	    {
+		TxError("Cannot write the undo log to disk; "
+			"keeping it all in memory.\n");
+		uk->uk_spill = -1;
+		undoMemLimit = 0;
+		return;
+	    }
+	}
+	freeMagic(uk->uk_data);
+	uk->uk_data = NULL;
+	undoMemUsed -= uk->uk_size;
+    }
 }
-
+
 /*
  * ----------------------------------------------------------------------------
  *
  * undoFreeHead --
  *
- * Free up space by throwing away events from the front of the in-memory
- * event list until the total number of in-memory commands falls below
- * LOWCOMMANDS
+ * Free up space by throwing away events from the front of the
+ * event list until the total number of commands falls below
+ * LOWCOMMANDS.  The delimiter lists kept with each chunk let
+ * this be done without reading spilled chunks back in.
  *
  * Results:
  *	None.
  *
  * Side effects:
- *	Deallocates events from the front of the in-memory event list.
+ *	Deallocates chunks from the front of the event list.
  *	Updates undoLogHead, undoNumCommands.
  *	Guaranteed to leave undoLogHead pointing to the first event
  *	in a command (not of type UT_DELIM).
  *
  * WARNING:
  *	It is important that undoLogCur point beyond the region
- *	to be freed.  Also, it is important that the in-core list
- *	be terminated by an UT_DELIM event.
+ *	to be freed.  Also, it is important that the log be
+ *	terminated by an UT_DELIM event.
  *
  * ----------------------------------------------------------------------------
  */
@@ -805,32 +1200,39 @@ undoGetBack(iup)
 void
 undoFreeHead()
 {
-    if (undoNumCommands <= LOWCOMMANDS)
-	return;
+    undoChunk *uk;
 
     while (undoNumCommands > LOWCOMMANDS)
     {
-	do
+	uk = undoFirstChunk;
+	if (undoHeadDelim < uk->uk_ndelims)
 	{
-	    ASSERT(undoLogHead != undoLogCur, "undoFreeHead");
-	    freeMagic((char *) undoLogHead);
-	    undoLogHead = undoLogHead->iue_forw;
-	    ASSERT(undoLogHead != (internalUndoEvent *) NULL, "undoFreeHead");
+	    undoLogHead.up_off = uk->uk_delims[undoHeadDelim++] + undoSize(0);
+	    undoNumCommands--;
+	}
+	else
+	    undoLogHead.up_off = uk->uk_used;
+
+	if (undoLogHead.up_off >= uk->uk_used)
+	{
+	    ASSERT(uk->uk_next != NULL, "undoFreeHead");
+	    ASSERT(undoLogCur.up_chunk != uk, "undoFreeHead");
+	    undoFirstChunk = uk->uk_next;
+	    undoFirstChunk->uk_prev = NULL;
+	    undoFreeChunk(uk);
+	    undoLogHead.up_chunk = undoFirstChunk;
+	    undoLogHead.up_off = 0;
+	    undoHeadDelim = 0;
 	}
-	while (undoLogHead->iue_type != UT_DELIM);
-	undoNumCommands--;
     }
-    freeMagic((char *) undoLogHead);
-    undoLogHead = undoLogHead->iue_forw;
-    undoLogHead->iue_back = (internalUndoEvent *) NULL;
 }
-
+
 /*
  * ----------------------------------------------------------------------------
  *
  * undoMemTruncate --
  *
- * Delete events in memory which are later than the current event.
+ * Delete events in the log which are later than the current event.
  * NOTE: This expects to be called only when undoNumRecentEvents == 0.
  *
  * Results:
@@ -847,46 +1249,50 @@ undoFreeHead()
 void
 undoMemTruncate()
 {
-    internalUndoEvent *up;
+    undoChunk *uk;
+    undoRecord *rp;
 
     /*
      * If there are events forward of the current event that
-     * will get overwritten by the new event, delete them from
-     * memory.
+     * will get overwritten by the new event, delete them.
      */
 
-    if (undoLogCur == (internalUndoEvent *) NULL)
+    if (undoLogCur.up_chunk == NULL)
     {
 	/*
-	 * Delete ALL events from memory
+	 * Delete ALL events
 	 */
-	up = undoLogHead;
-	while (up != (internalUndoEvent *) NULL)
-	{
-	    freeMagic((char *) up);
-	    up = up->iue_forw;
-	}
-	undoLogTail = undoLogHead = (internalUndoEvent *) NULL;
-	undoNumCommands = 0;
+	undoFreeAll();
+	return;
     }
-    else
+
+    rp = undoGetRecord(&undoLogCur);
+    if (rp == NULL)
     {
-	ASSERT(undoLogCur->iue_type == UT_DELIM, "undoMemTruncate");
-	/*
-	 * Delete only some of the events in main memory.
-	 */
-	up = undoLogCur->iue_forw;
-	while (up != (internalUndoEvent *) NULL)
-	{
-	    if (up->iue_type == UT_DELIM)
-		undoNumCommands--;
-	    freeMagic((char *) up);
-	    up = up->iue_forw;
-	}
-	undoLogCur->iue_forw = (internalUndoEvent *) NULL;
-	undoLogTail = undoLogCur;
+	undoFreeAll();
+	return;
     }
+    ASSERT(rp->ur_type == UT_DELIM, "undoMemTruncate");
 
+    /*
+     * Delete only some of the events.
+     */
+    while ((uk = undoLastChunk) != undoLogCur.up_chunk)
+    {
+	undoNumCommands -= uk->uk_ndelims;
+	undoLastChunk = uk->uk_prev;
+	undoLastChunk->uk_next = NULL;
+	undoFreeChunk(uk);
+    }
+    while (uk->uk_ndelims > 0
+	    && uk->uk_delims[uk->uk_ndelims - 1] > undoLogCur.up_off)
+    {
+	uk->uk_ndelims--;
+	undoNumCommands--;
+    }
+    uk->uk_used = undoLogCur.up_off + rp->ur_size;
+    uk->uk_last = undoLogCur.up_off;
+    undoLogTail = undoLogCur;
 }
 
 /*
@@ -898,62 +1304,73 @@ undoMemTruncate()
  */
 
 void
-undoPrintEvent(iup)
-    internalUndoEvent *iup;
+undoPrintEvent(pos)
+    undoPos *pos;
 {
+    undoRecord *rp;
     char *client_name;
-    if (iup->iue_type < 0)
+
+    rp = undoGetRecord(pos);
+    if (rp == NULL) return;
+    if (rp->ur_type < 0)
 	client_name = "(delimiter)";
     else
-	client_name = undoClientTable[iup->iue_type].uc_name;
+	client_name = undoClientTable[rp->ur_type].uc_name;
 
-    (void) TxPrintf("0x%x: \t%s \tf=0x%x \tb=0x%x\n",
-		iup, client_name, iup->iue_forw, iup->iue_back);
+    (void) TxPrintf("0x%lx+%d: \t%s \tsize=%d\n",
+		(unsigned long) pos->up_chunk, pos->up_off, client_name,
+		rp->ur_size);
 }
 
-/* Print events forward from "iup".  If n is 0 or negative, print to	*/
+/* Print events forward from "pos".  If n is 0 or negative, print to	*/
 /* the end of the stack.  Otherwise, print the next n events.		*/
 
 void
-undoPrintForw(iup, n)
-    internalUndoEvent *iup;
+undoPrintForw(pos, n)
+    undoPos pos;
     int n;
 {
     int i = 0;
 
-    (void) TxPrintf("head=0x%x\ttail=0x%x\tcur=0x%x\n",
-		undoLogHead, undoLogTail, undoLogCur);
-    if (iup == (internalUndoEvent *) NULL)
-	iup = undoLogHead;
-    while (iup != (internalUndoEvent *) NULL)
+    (void) TxPrintf("head=0x%lx+%d\ttail=0x%lx+%d\tcur=0x%lx+%d\n",
+		(unsigned long) undoLogHead.up_chunk, undoLogHead.up_off,
+		(unsigned long) undoLogTail.up_chunk, undoLogTail.up_off,
+		(unsigned long) undoLogCur.up_chunk, undoLogCur.up_off);
+    (void) TxPrintf("%ld bytes in memory, limit %ld\n",
+		undoMemUsed, undoMemLimit);
+    if (pos.up_chunk == NULL)
+	pos = undoLogHead;
+    while (pos.up_chunk != NULL)
     {
-	undoPrintEvent(iup);
-	iup = iup->iue_forw;
+	undoPrintEvent(&pos);
 	i++;
-	if (i == n) break;
+	if (i == n || !undoGetForw(&pos)) break;
     }
 }
 
-/* Print events backward from "iup".  If n is 0 or negative, print to	*/
+/* Print events backward from "pos".  If n is 0 or negative, print to	*/
 /* the beginning of the stack.  Otherwise, print the previous n events.	*/
 
 void
-undoPrintBack(iup, n)
-    internalUndoEvent *iup;
+undoPrintBack(pos, n)
+    undoPos pos;
     int n;
 {
     int i = 0;
 
-    (void) TxPrintf("head=0x%x\ttail=0x%x\tcur=0x%x\n",
-		undoLogHead, undoLogTail, undoLogCur);
-    if (iup == (internalUndoEvent *) NULL)
-	iup = undoLogTail;
-    while (iup != (internalUndoEvent *) NULL)
+    (void) TxPrintf("head=0x%lx+%d\ttail=0x%lx+%d\tcur=0x%lx+%d\n",
+		(unsigned long) undoLogHead.up_chunk, undoLogHead.up_off,
+		(unsigned long) undoLogTail.up_chunk, undoLogTail.up_off,
+		(unsigned long) undoLogCur.up_chunk, undoLogCur.up_off);
+    (void) TxPrintf("%ld bytes in memory, limit %ld\n",
+		undoMemUsed, undoMemLimit);
+    if (pos.up_chunk == NULL)
+	pos = undoLogTail;
+    while (pos.up_chunk != NULL)
     {
-	undoPrintEvent(iup);
-	iup = iup->iue_back;
+	undoPrintEvent(&pos);
 	i++;
-	if (i == n) break;
+	if (i == n || !undoGetBack(&pos)) break;
     }
 }
 
@@ -49,6 +49,9 @@ typedef char	 UndoEvent;	/* Externally visible undo event */
  *			   undo log.  The client should not retain this
  *			   new event past the next call to the undo package.  
  *			   If undoing is disabled, returns NULL.
+ *	UndoLastEvent	-- returns the last event of the command being
+ *			   recorded if it is of the given type, so that
+ *			   the client may extend it in place.
  *	UndoNext	-- used by a client to inform the undo package that
  *			   all events since the last call to UndoNext are
  *			   to be treated as a single unit by UndoForward()
@@ -59,16 +62,21 @@ typedef char	 UndoEvent;	/* Externally visible undo event */
  *	UndoDisable	-- turn off the undo package until the next UndoEnable.
  *	UndoEnable	-- turn the undo package back on.
  *	UndoFlush	-- throw away all undo information.
+ *	UndoSetMemLimit	-- set the number of bytes of log kept in memory
+ *			   before older events are moved to a temporary file.
  */
 
 extern bool UndoInit(char *, char *);
 extern UndoType UndoAddClient();
 extern UndoEvent *UndoNewEvent(UndoType, unsigned int);
+extern UndoEvent *UndoLastEvent(UndoType);
 /* extern UndoEvent *UndoCopyEvent(); */
 extern void UndoNext(void);
 extern int UndoBackward(int), UndoForward(int);
 extern void UndoDisable(void), UndoEnable(void);
 extern void UndoFlush(void);
+extern void UndoSetMemLimit(long);
+extern long UndoGetMemLimit(void);
 extern void UndoStackTrace(int);
 
 /*
@@ -46,6 +46,7 @@ extern char *nextName();
 extern FILE *PaOpen(char *, char *, char *, char *, char *, char **);
 extern FILE *PaLockOpen(char *, char *, char *, char *, char *, char **, bool *);
 extern char *StrDup(char **, char *);
+extern char *StrIntern(char *);
 extern int Match();
 extern char *ArgStr();
 extern bool StrIsWhite(char *, bool);
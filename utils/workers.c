@@ -0,0 +1,483 @@
+/*
+ * workers.c --
+ *
+ * A small fork/join pool of worker threads.  A caller hands
+ * WorkerRun() a number of independent tasks and a procedure to
+ * run on each of them; the tasks are shared out between the
+ * calling thread and the worker threads, and WorkerRun() returns
+ * only when every task has finished.
+ *
+ * The pool is meant for read-only walks over the database (area
+ * searches and the like).  Procedures run by the pool must not
+ * modify any shared Magic structure, and must not call anything
+ * that prints or touches the interpreter (TxPrintf, TxError,
+ * Tcl_*):  collect results in per-task storage and report them
+ * from the calling thread afterwards.
+ *
+ * If Magic is compiled without WORKER_THREADS, or the pool size
+ * is set to 1, all tasks simply run in order in the caller.
+ *
+ * WorkerBackground() runs a single job on a thread of its own while
+ * the caller carries on, for work such as writing a file that need
+ * not hold up the user.  The same rules apply to its procedure.
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#ifdef WORKER_THREADS
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#include "utils/magic.h"
+#include "utils/workers.h"
+
+/* Number of threads, including the caller, used by WorkerRun().	*/
+/* Zero means "not yet decided";  see WorkerGetCount().			*/
+
+static int workerCount = 0;
+
+#ifdef WORKER_THREADS
+
+/* Index of the current thread within the pool:  0 for any thread	*/
+/* that is not a pool thread, 1 .. WORKER_MAX-1 for pool threads.	*/
+
+static __thread int workerSelf = 0;
+
+/* Set while the calling thread is running its share of a job, so	*/
+/* that nested calls to WorkerRun() fall back to serial execution.	*/
+
+static __thread bool workerBusy = FALSE;
+
+/*
+ * The job currently being run.  All fields are written by the
+ * calling thread while holding workerLock, and only while no pool
+ * thread is working on the previous job (wj_busy == 0).
+ */
+
+static struct
+{
+    int		(*wj_proc)();	/* Procedure applied to each task */
+    ClientData	  wj_cdata;	/* Client data passed to wj_proc */
+    int		  wj_tasks;	/* Number of tasks in the job */
+    int		  wj_threads;	/* Number of threads allowed to help */
+    int		  wj_next;	/* Next task to hand out (atomic) */
+    int		  wj_result;	/* Nonzero once any task returned nonzero */
+    int		  wj_busy;	/* Pool threads still inside this job */
+    unsigned long wj_gen;	/* Incremented for each new job */
+} workerJob;
+
+static pthread_mutex_t workerLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t workerStartCond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t workerDoneCond = PTHREAD_COND_INITIALIZER;
+
+static int workerStarted = 1;	/* Threads in the pool, counting the caller */
+
+/* The background job, if any (see WorkerBackground()) */
+
+static pthread_t workerBgThread;
+static bool workerBgRunning = FALSE;
+
+#endif	/* WORKER_THREADS */
+
+static int (*workerBgProc)();	/* Procedure of the background job */
+static ClientData workerBgData;	/* Its client data */
+static int workerBgResult = 0;	/* What it returned */
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * WorkerGetCount --
+ *
+ * Return the number of threads that WorkerRun() will use.  Unless
+ * it has been set explicitly with WorkerSetCount(), this is the
+ * number of processors on line, capped at WORKER_MAX.
+ *
+ * Results:
+ *	Number of threads, at least 1.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+WorkerGetCount()
+{
+#ifdef WORKER_THREADS
+    if (workerCount == 0)
+    {
+	long n = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	workerCount = (n < 1) ? 1 : (n > WORKER_MAX) ? WORKER_MAX : (int) n;
+    }
+    return workerCount;
+#else
+    return 1;
+#endif
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * WorkerSetCount --
+ *
+ * Set the number of threads used by WorkerRun().  A count of
+ * zero restores the default (one per processor).
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Changes the size of subsequent jobs.  Pool threads are
+ *	started lazily, so shrinking the count just leaves the
+ *	extra threads idle.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+WorkerSetCount(count)
+    int count;
+{
+    if (count < 0) count = 0;
+    if (count > WORKER_MAX) count = WORKER_MAX;
+    workerCount = count;
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * WorkerInside --
+ *
+ * Report whether the current thread is running a task on behalf
+ * of WorkerRun().  Code that is not safe to run in parallel can
+ * use this to check its assumptions.
+ *
+ * Results:
+ *	TRUE if called from within a pool task, FALSE otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+bool
+WorkerInside()
+{
+#ifdef WORKER_THREADS
+    return (workerSelf != 0 || workerBusy);
+#else
+    return FALSE;
+#endif
+}
+
+#ifdef WORKER_THREADS
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * workerDoTasks --
+ *
+ * Take tasks from the current job and run them until there are
+ * none left, or until some task has returned nonzero.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Whatever the job's procedure does.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+workerDoTasks()
+{
+    int task;
+
+    while (workerJob.wj_result == 0)
+    {
+	task = __sync_fetch_and_add(&workerJob.wj_next, 1);
+	if (task >= workerJob.wj_tasks) break;
+	if ((*workerJob.wj_proc)(task, workerSelf, workerJob.wj_cdata))
+	    workerJob.wj_result = 1;
+    }
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * workerMain --
+ *
+ * Body of each pool thread:  wait for a new job, help with it if
+ * this thread is among the ones the job asked for, then wait
+ * again.  Pool threads never exit.
+ *
+ * Results:
+ *	None (never returns).
+ *
+ * Side effects:
+ *	Runs job procedures.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void *
+workerMain(arg)
+    void *arg;
+{
+    unsigned long seen;
+    sigset_t mask;
+
+    /* Leave all signal handling (interrupts, timers) to the main thread */
+    sigfillset(&mask);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+    workerSelf = (int)(spointertype) arg;
+
+    pthread_mutex_lock(&workerLock);
+    seen = workerJob.wj_gen;
+    while (TRUE)
+    {
+	while (workerJob.wj_gen == seen)
+	    pthread_cond_wait(&workerStartCond, &workerLock);
+	seen = workerJob.wj_gen;
+	if (workerSelf >= workerJob.wj_threads) continue;
+
+	workerJob.wj_busy++;
+	pthread_mutex_unlock(&workerLock);
+	workerDoTasks();
+	pthread_mutex_lock(&workerLock);
+	if (--workerJob.wj_busy == 0)
+	    pthread_cond_signal(&workerDoneCond);
+    }
+    /* NOTREACHED */
+    return NULL;
+}
+
+#endif	/* WORKER_THREADS */
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * WorkerRun --
+ *
+ * Run "nTasks" independent tasks, numbered 0 to nTasks - 1, on the
+ * worker pool.  The procedure should be of the following form:
+ *
+ *	int
+ *	proc(task, worker, cdata)
+ *	    int task;		(Task number)
+ *	    int worker;		(Thread index, 0 .. WorkerGetCount() - 1)
+ *	    ClientData cdata;
+ *	{
+ *	}
+ *
+ * Two tasks never run at the same time on the same worker index,
+ * so the worker index may be used to select per-thread scratch
+ * storage.  Tasks are started in increasing order, but may finish
+ * in any order.  If a task returns nonzero, no further tasks are
+ * started.
+ *
+ * When called from inside a task, or when only one thread is
+ * configured, the tasks are run serially in the calling thread.
+ *
+ * Results:
+ *	0 if every task returned 0, 1 if any task returned nonzero.
+ *
+ * Side effects:
+ *	Whatever the procedure does.  Starts pool threads the
+ *	first time they are needed.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+WorkerRun(nTasks, proc, cdata)
+    int nTasks;			/* Number of tasks */
+    int (*proc)();		/* Procedure to run for each task */
+    ClientData cdata;		/* Passed to (*proc)() */
+{
+    int task, nThreads;
+
+    nThreads = WorkerGetCount();
+    if (nThreads > nTasks) nThreads = nTasks;
+
+#ifdef WORKER_THREADS
+    if (nThreads > 1 && !WorkerInside())
+    {
+	int result;
+
+	pthread_mutex_lock(&workerLock);
+
+	/* Start any pool threads not yet running */
+	while (workerStarted < nThreads)
+	{
+	    pthread_t thread;
+
+	    if (pthread_create(&thread, NULL, workerMain,
+			(void *)(spointertype) workerStarted) != 0)
+		break;
+	    pthread_detach(thread);
+	    workerStarted++;
+	}
+	if (nThreads > workerStarted) nThreads = workerStarted;
+
+	/* Stragglers from the previous job must be gone before	*/
+	/* the job description is overwritten.			*/
+	while (workerJob.wj_busy > 0)
+	    pthread_cond_wait(&workerDoneCond, &workerLock);
+
+	workerJob.wj_proc = proc;
+	workerJob.wj_cdata = cdata;
+	workerJob.wj_tasks = nTasks;
+	workerJob.wj_threads = nThreads;
+	workerJob.wj_next = 0;
+	workerJob.wj_result = 0;
+	workerJob.wj_gen++;
+	pthread_cond_broadcast(&workerStartCond);
+	pthread_mutex_unlock(&workerLock);
+
+	/* The caller takes its share of the tasks as worker 0 */
+	workerBusy = TRUE;
+	workerDoTasks();
+	workerBusy = FALSE;
+
+	pthread_mutex_lock(&workerLock);
+	while (workerJob.wj_busy > 0)
+	    pthread_cond_wait(&workerDoneCond, &workerLock);
+	result = workerJob.wj_result;
+	pthread_mutex_unlock(&workerLock);
+	return result;
+    }
+#endif	/* WORKER_THREADS */
+
+    for (task = 0; task < nTasks; task++)
+	if ((*proc)(task, 0, cdata))
+	    return 1;
+    return 0;
+}
+
+#ifdef WORKER_THREADS
+
+/*
+ * workerBgMain --
+ *
+ * Body of the thread started by WorkerBackground().
+ */
+
+void *
+workerBgMain(arg)
+    void *arg;
+{
+    sigset_t mask;
+
+    sigfillset(&mask);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+    workerBgResult = (*workerBgProc)(workerBgData);
+    return NULL;
+}
+
+#endif	/* WORKER_THREADS */
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * WorkerBackground --
+ *
+ * Start running "proc" on a thread of its own, and return without
+ * waiting for it.  The procedure should be of the following form:
+ *
+ *	int
+ *	proc(cdata)
+ *	    ClientData cdata;
+ *	{
+ *	}
+ *
+ * Only one background job runs at a time:  if the previous one has
+ * not finished, this waits for it first.  Without WORKER_THREADS the
+ * procedure is simply called before returning.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Whatever the procedure does.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+void
+WorkerBackground(proc, cdata)
+    int (*proc)();		/* Procedure to run */
+    ClientData cdata;		/* Passed to (*proc)() */
+{
+    (void) WorkerWaitBackground();
+
+    workerBgProc = proc;
+    workerBgData = cdata;
+    workerBgResult = 0;
+
+#ifdef WORKER_THREADS
+    if (pthread_create(&workerBgThread, NULL, workerBgMain, NULL) == 0)
+    {
+	workerBgRunning = TRUE;
+	return;
+    }
+#endif	/* WORKER_THREADS */
+
+    workerBgResult = (*proc)(cdata);
+}
+
+/*
+ * ----------------------------------------------------------------------------
+ *
+ * WorkerWaitBackground --
+ *
+ * Wait for the job started by WorkerBackground(), if any, to finish.
+ *
+ * Results:
+ *	The value returned by the procedure of the last background job,
+ *	or 0 if there has been none.  The result is only reported once.
+ *
+ * Side effects:
+ *	None.
+ *
+ * ----------------------------------------------------------------------------
+ */
+
+int
+WorkerWaitBackground()
+{
+    int result;
+
+#ifdef WORKER_THREADS
+    if (workerBgRunning)
+    {
+	pthread_join(workerBgThread, NULL);
+	workerBgRunning = FALSE;
+    }
+#endif	/* WORKER_THREADS */
+
+    result = workerBgResult;
+    workerBgResult = 0;
+    return result;
+}
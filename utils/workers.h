@@ -0,0 +1,41 @@
+/*
+ * workers.h --
+ *
+ * Interface to the pool of worker threads used to run independent,
+ * read-mostly database operations in parallel.
+ *
+ *     *********************************************************************
+ *     * Copyright (C) 1985, 1990 Regents of the University of California. *
+ *     * Permission to use, copy, modify, and distribute this              *
+ *     * software and its documentation for any purpose and without        *
+ *     * fee is hereby granted, provided that the above copyright          *
+ *     * notice appear in all copies.  The University of California        *
+ *     * makes no representations about the suitability of this            *
+ *     * software for any purpose.  It is provided "as is" without         *
+ *     * express or implied warranty.  Export of this software outside     *
+ *     * of the United States of America may require an export license.    *
+ *     *********************************************************************
+ *
+ * Needs to include magic.h
+ */
+
+#ifndef	_WORKERS_H
+#define	_WORKERS_H
+
+#include "utils/magic.h"
+
+/* Upper limit on the number of threads (including the caller) that	*/
+/* take part in a WorkerRun().						*/
+
+#define	WORKER_MAX	64
+
+/* --------------------- Procedure headers ---------------------------- */
+
+extern int WorkerRun();
+extern int WorkerGetCount();
+extern void WorkerSetCount();
+extern bool WorkerInside();
+extern void WorkerBackground();
+extern int WorkerWaitBackground();
+
+#endif	/* _WORKERS_H */
@@ -776,7 +776,8 @@ windClientInit()
 	"underneath		move a window underneath the rest",
 	windUnderCmd, FALSE);
     WindAddCommand(windClientID,
-	"undo [count]		undo commands",
+	"undo [count|memory [MB]]\n\
+			undo commands, or limit memory used by undo",
 	windUndoCmd, FALSE);
     WindAddCommand(windClientID,
 #ifdef MAGIC_WRAPPER
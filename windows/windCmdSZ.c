@@ -614,9 +614,12 @@ windUnderCmd(w, cmd)
  *
  * Usage:
  *	undo [count]
+ *	undo memory [megabytes]
  *
  * If a count is supplied, the last count events are undone.  The default
- * count if none is given is 1.
+ * count if none is given is 1.  "undo memory" reports or sets how much of
+ * the undo log is kept in main memory before older events are moved to a
+ * temporary file;  0 means no limit.
  *
  * Results:
  *	None.
@@ -639,6 +642,27 @@ windUndoCmd(w, cmd)
 	TxError("Usage: undo [count]\n");
 	TxError("       undo print [count]\n");
 	TxError("       undo enable|disable\n");
+	TxError("       undo memory [megabytes]\n");
+	return;
+    }
+    else if (cmd->tx_argc >= 2 && !strcmp(cmd->tx_argv[1], "memory"))
+    {
+	if (cmd->tx_argc == 2)
+	{
+	    long limit = UndoGetMemLimit();
+#ifdef MAGIC_WRAPPER
+	    Tcl_SetObjResult(magicinterp, Tcl_NewLongObj(limit >> 20));
+#else
+	    if (limit == 0)
+		TxPrintf("Undo log is kept in memory without limit.\n");
+	    else
+		TxPrintf("Undo log memory limit is %ld megabytes.\n", limit >> 20);
+#endif
+	}
+	else if (!StrIsInt(cmd->tx_argv[2]) || atoi(cmd->tx_argv[2]) < 0)
+	    TxError("Usage: undo memory [megabytes]\n");
+	else
+	    UndoSetMemLimit((long) atoi(cmd->tx_argv[2]) << 20);
 	return;
     }
     else if (cmd->tx_argc == 3)